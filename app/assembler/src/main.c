@@ -54,6 +54,7 @@ void printHelp( void ) {
         "    -h              Display this message\n"
         "    -l              Link result (emit executable)\n"
         "    -o <filename>   Write output to <filename>\n"
+        "    -z              Write output in compressed format\n"
     );
 } // printHelp
 
@@ -76,13 +77,14 @@ int main( const int _argc, const char **_argv ) {
     }
 
     // it's obviously NOT overengineering
-    const int optionCount = 3;
-    CfCommandLineOptionInfo optionInfos[3] = {
-        {"o", "output", 1},
-        {"l", "link",   0},
-        {"h", "help",   0},
+    const int optionCount = 4;
+    CfCommandLineOptionInfo optionInfos[4] = {
+        {"o", "output",   1},
+        {"l", "link",     0},
+        {"h", "help",     0},
+        {"z", "compress", 0},
     };
-    int optionIndices[3];
+    int optionIndices[4];
 
     if (!cfParseCommandLineOptions(argc - 2, argv + 1, optionCount, optionInfos, optionIndices)) {
         // it's ok for cli utils to display something in stdout, so corresponding error message is already displayed.
@@ -98,10 +100,12 @@ int main( const int _argc, const char **_argv ) {
         const char *inputFileName;
         const char *outputFileName;
         bool linkOutput;
+        bool compressOutput;
     } options = {
         .inputFileName = argv[argc - 1],
         .outputFileName = "out.cfexe",
         .linkOutput = (optionIndices[1] != -1),
+        .compressOutput = (optionIndices[3] != -1),
     };
 
     // read filename from options
@@ -160,7 +164,11 @@ int main( const int _argc, const char **_argv ) {
             return 0;
         }
 
-        if (!cfExecutableWrite(output, &executable))
+        const bool writeSuccess = options.compressOutput
+            ? cfExecutableWriteCompressed(output, &executable)
+            : cfExecutableWrite(output, &executable);
+
+        if (!writeSuccess)
             printf("executable writing failed.\n");
 
         fclose(output);
@@ -172,7 +180,11 @@ int main( const int _argc, const char **_argv ) {
             return 0;
         }
 
-        if (!cfObjectWrite(output, &object))
+        const bool writeSuccess = options.compressOutput
+            ? cfObjectWriteCompressed(output, &object)
+            : cfObjectWrite(output, &object);
+
+        if (!writeSuccess)
             printf("object writing failed.\n");
 
         fclose(output);
@@ -9,6 +9,7 @@
 #include <cf_deque.h>
 
 #include "compiler.h"
+#include "compiler_cache.h"
 
 /// @brief compiler file
 typedef struct CompilerFile_ {
@@ -23,6 +24,7 @@ typedef struct Compiler_ {
     CfArena * dataArena;      ///< arena, used for compiler data allocation
     CfArena * tempArena;      ///< temporary allocation arena
     CfDeque * inputFileDeque; ///< input file deque
+    CompilerCache cache;      ///< compilation cache
 } Compiler;
 
 Compiler * compilerCtor( void ) {
@@ -48,11 +50,23 @@ Compiler * compilerCtor( void ) {
         .dataArena      = dataArena,
         .tempArena      = tempArena,
         .inputFileDeque = inputFileDeque,
+        .cache          = { .directory = NULL },
     };
 
     return compiler;
 } // compilerCtor
 
+bool compilerSetCache( Compiler *const self, const char *directory, const uint64_t maxSize ) {
+    size_t directoryLength = strlen(directory);
+    char *directoryCopy = (char *)cfArenaAlloc(self->dataArena, sizeof(char) * (directoryLength + 1));
+
+    if (directoryCopy == NULL)
+        return false;
+    memcpy(directoryCopy, directory, directoryLength + 1);
+
+    return compilerCacheOpen(&self->cache, directoryCopy, maxSize);
+} // compilerSetCache
+
 CompilerAddCfFileResult compilerAddCfFile( Compiler *const self, const char *sourceName, const char *source ) {
     size_t sourceLength = strlen(source);
     size_t sourceNameLength = strlen(sourceName);
@@ -71,6 +85,28 @@ CompilerAddCfFileResult compilerAddCfFile( Compiler *const self, const char *sou
         .name = sourceNameCopy,
     };
 
+    // whole front end is skipped if file is already compiled
+    const CfHash cacheKey = compilerCacheKey(file.text, sourceLength);
+
+    if (compilerCacheLoad(&self->cache, &cacheKey, &file.object)) {
+        // the same text may be compiled from another file
+        char *objectSourceName = cfStrOwnedCopy(CF_STR(sourceName));
+
+        if (objectSourceName == NULL) {
+            cfObjectDtor(&file.object);
+            return (CompilerAddCfFileResult) { COMPILER_ADD_CF_FILE_STATUS_INTERNAL_ERROR };
+        }
+        free((char *)file.object.sourceName);
+        file.object.sourceName = objectSourceName;
+
+        if (!cfDequePushBack(self->inputFileDeque, &file)) {
+            cfObjectDtor(&file.object);
+            return (CompilerAddCfFileResult) { COMPILER_ADD_CF_FILE_STATUS_INTERNAL_ERROR };
+        }
+
+        return (CompilerAddCfFileResult) { COMPILER_ADD_CF_FILE_STATUS_OK };
+    }
+
     CfLexerToken * tokenList       = NULL;
     size_t         tokenListLength = 0;
     CfAst        * ast             = NULL;
@@ -127,6 +163,8 @@ CompilerAddCfFileResult compilerAddCfFile( Compiler *const self, const char *sou
     cfAstDtor(ast);
     free(tokenList);
 
+    compilerCacheStore(&self->cache, &cacheKey, &file.object);
+
     // 
     if (!cfDequePushBack(self->inputFileDeque, &file)) {
         cfObjectDtor(&file.object);
@@ -189,6 +227,9 @@ void compilerDtor( Compiler *const self ) {
         cfDequeCursorDtor(&inputFileCursor);
     }
 
+    // cache is trimmed once per compiler, because all its entries are checked
+    compilerCacheTrim(&self->cache);
+
     cfArenaDtor(self->tempArena);
     cfArenaDtor(self->dataArena);
 } // compilerDtor
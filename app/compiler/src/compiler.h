@@ -28,6 +28,20 @@ Compiler * compilerCtor( void );
  */
 void compilerDtor( Compiler *const self );
 
+/**
+ * @brief compilation cache setting function
+ *
+ * @param[in] self      compiler pointer
+ * @param[in] directory cache directory (it's created if it doesn't exist)
+ * @param[in] maxSize   cache size limit (in bytes, least recently used entries are removed to fit it)
+ *
+ * @return true if succeeded, false if cache can't be used
+ *
+ * @note objects of files added after cache setting are looked up in cache by source text hash
+ * (so their lexing, parsing, TIR building and code generation are skipped) and stored into it.
+ */
+bool compilerSetCache( Compiler *const self, const char *directory, uint64_t maxSize );
+
 /// @brief CF source file adding stauts
 typedef enum CompmilrAddCfFileStatus_ {
     COMPILER_ADD_CF_FILE_STATUS_OK,             ///< 
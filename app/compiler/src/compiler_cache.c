@@ -0,0 +1,293 @@
+/**
+ * @brief compilation cache implementation file
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef COMPILER_CACHE
+    #include <dirent.h>
+    #include <sys/stat.h>
+    #include <sys/types.h>
+    #include <unistd.h>
+    #include <utime.h>
+#endif
+
+#include <cf_darr.h>
+
+#include "compiler_cache.h"
+
+/// @brief cache entry file name extension
+#define COMPILER_CACHE_EXTENSION ".cfobj"
+
+/// @brief cache entry file name length (hex key and extension)
+#define COMPILER_CACHE_NAME_LENGTH (sizeof(CfHash) * 2 + sizeof(COMPILER_CACHE_EXTENSION) - 1)
+
+/// @brief cache key prefix (it's hashed before source text)
+typedef struct CompilerCacheKeyPrefix_ {
+    char     magic[8]; ///< key magic
+    uint32_t version;  ///< cache version
+    uint32_t options;  ///< compilation options (there are no options affecting compiler output yet)
+} CompilerCacheKeyPrefix;
+
+CfHash compilerCacheKeyVersioned(
+    const char *const source,
+    const size_t      sourceLength,
+    const uint32_t    version,
+    const uint32_t    options
+) {
+    const CompilerCacheKeyPrefix prefix = {
+        .magic   = { 'C', 'F', 'C', 'A', 'C', 'H', 'E', '\0' },
+        .version = version,
+        .options = options,
+    };
+    CfHasher hasher;
+
+    cfHasherInitialize(&hasher);
+    cfHasherStep(&hasher, &prefix, sizeof(prefix));
+    cfHasherStep(&hasher, source, sourceLength);
+    return cfHasherTerminate(&hasher);
+} // compilerCacheKeyVersioned
+
+CfHash compilerCacheKey( const char *const source, const size_t sourceLength ) {
+    return compilerCacheKeyVersioned(source, sourceLength, COMPILER_CACHE_VERSION, 0);
+} // compilerCacheKey
+
+#ifdef COMPILER_CACHE
+
+/// @brief cache entry description (used during trimming)
+typedef struct CompilerCacheEntry_ {
+    int64_t  mtimeSec;                               ///< modification (last use) time (seconds)
+    int64_t  mtimeNsec;                              ///< modification (last use) time (nanoseconds)
+    uint64_t size;                                   ///< entry size
+    char     name[COMPILER_CACHE_NAME_LENGTH + 1];   ///< entry file name
+} CompilerCacheEntry;
+
+/**
+ * @brief cache entry path building function
+ *
+ * @param[in] cache  cache (non-null)
+ * @param[in] name   entry file name (non-null)
+ * @param[in] suffix path suffix (non-null)
+ *
+ * @return entry path (allocated by malloc, null if allocation failed)
+ */
+static char * compilerCacheGetPath( const CompilerCache *const cache, const char *const name, const char *const suffix ) {
+    const size_t length = strlen(cache->directory) + 1 + strlen(name) + strlen(suffix);
+    char *const path = (char *)malloc(length + 1);
+
+    if (path != NULL)
+        snprintf(path, length + 1, "%s/%s%s", cache->directory, name, suffix);
+    return path;
+} // compilerCacheGetPath
+
+/**
+ * @brief cache entry file name building function
+ *
+ * @param[in]  key cache key
+ * @param[out] dst name destination (COMPILER_CACHE_NAME_LENGTH + 1 bytes)
+ */
+static void compilerCacheGetName( const CfHash *const key, char *const dst ) {
+    for (size_t i = 0; i < 8; i++)
+        snprintf(dst + i * 8, 9, "%08X", key->hash[i]);
+    memcpy(dst + 64, COMPILER_CACHE_EXTENSION, sizeof(COMPILER_CACHE_EXTENSION));
+} // compilerCacheGetName
+
+/**
+ * @brief cache entries by last use time comparator
+ *
+ * @param[in] lhs first entry
+ * @param[in] rhs second entry
+ *
+ * @return comparison result (older entries go first)
+ */
+static int compilerCacheEntryCompare( const void *const lhs, const void *const rhs ) {
+    const CompilerCacheEntry *const l = (const CompilerCacheEntry *)lhs;
+    const CompilerCacheEntry *const r = (const CompilerCacheEntry *)rhs;
+
+    if (l->mtimeSec != r->mtimeSec)
+        return l->mtimeSec < r->mtimeSec ? -1 : 1;
+    if (l->mtimeNsec != r->mtimeNsec)
+        return l->mtimeNsec < r->mtimeNsec ? -1 : 1;
+    return 0;
+} // compilerCacheEntryCompare
+
+#endif
+
+bool compilerCacheOpen( CompilerCache *const cache, const char *const directory, const uint64_t maxSize ) {
+    assert(cache != NULL);
+    assert(directory != NULL);
+
+    *cache = (CompilerCache) {
+        .directory = NULL,
+        .maxSize   = maxSize,
+        .isStored  = false,
+    };
+
+#ifdef COMPILER_CACHE
+    if (0 != mkdir(directory, 0777) && errno != EEXIST)
+        return false;
+
+    cache->directory = directory;
+    return true;
+#else
+    return false;
+#endif
+} // compilerCacheOpen
+
+bool compilerCacheLoad( const CompilerCache *const cache, const CfHash *const key, CfObject *const dst ) {
+    assert(cache != NULL);
+    assert(key != NULL);
+    assert(dst != NULL);
+
+#ifdef COMPILER_CACHE
+    if (cache->directory == NULL)
+        return false;
+
+    char name[COMPILER_CACHE_NAME_LENGTH + 1];
+    compilerCacheGetName(key, name);
+
+    char *const path = compilerCacheGetPath(cache, name, "");
+    if (path == NULL)
+        return false;
+
+    FILE *const file = fopen(path, "rb");
+    bool isLoaded = false;
+
+    if (file != NULL) {
+        // entry with invalid hash (e.g. damaged one) is just replaced after compilation
+        isLoaded = CF_OBJECT_READ_STATUS_OK == cfObjectRead(file, dst);
+        fclose(file);
+    }
+
+    // modification time is last use time, so recently used entries are kept during trimming
+    if (isLoaded)
+        utime(path, NULL);
+
+    free(path);
+    return isLoaded;
+#else
+    (void)cache;
+    (void)key;
+    (void)dst;
+    return false;
+#endif
+} // compilerCacheLoad
+
+void compilerCacheStore( CompilerCache *const cache, const CfHash *const key, const CfObject *const object ) {
+    assert(cache != NULL);
+    assert(key != NULL);
+    assert(object != NULL);
+
+#ifdef COMPILER_CACHE
+    if (cache->directory == NULL)
+        return;
+
+    char name[COMPILER_CACHE_NAME_LENGTH + 1];
+    char suffix[32];
+
+    compilerCacheGetName(key, name);
+    snprintf(suffix, sizeof(suffix), ".%ld.tmp", (long)getpid());
+
+    char *const path = compilerCacheGetPath(cache, name, "");
+    char *const tempPath = compilerCacheGetPath(cache, name, suffix);
+    FILE *const file = tempPath != NULL ? fopen(tempPath, "wb") : NULL;
+
+    if (file != NULL) {
+        const bool isWritten = cfObjectWrite(file, object);
+
+        if (0 == fclose(file) && isWritten && path != NULL && 0 == rename(tempPath, path))
+            cache->isStored = true;
+        else
+            remove(tempPath);
+    }
+
+    free(tempPath);
+    free(path);
+#else
+    (void)cache;
+    (void)key;
+    (void)object;
+#endif
+} // compilerCacheStore
+
+void compilerCacheTrim( CompilerCache *const cache ) {
+    assert(cache != NULL);
+
+#ifdef COMPILER_CACHE
+    if (cache->directory == NULL || !cache->isStored)
+        return;
+    cache->isStored = false;
+
+    DIR *const directory = opendir(cache->directory);
+    CfDarr entries = cfDarrCtor(sizeof(CompilerCacheEntry));
+    uint64_t totalSize = 0;
+
+    if (directory == NULL || entries == NULL) {
+        if (directory != NULL)
+            closedir(directory);
+        cfDarrDtor(entries);
+        return;
+    }
+
+    // collect entries (files of other kinds, e.g. temporary ones, are ignored)
+    for (struct dirent *directoryEntry; (directoryEntry = readdir(directory)) != NULL; ) {
+        const size_t nameLength = strlen(directoryEntry->d_name);
+
+        if (false
+            || nameLength != COMPILER_CACHE_NAME_LENGTH
+            || 0 != strcmp(directoryEntry->d_name + nameLength - (sizeof(COMPILER_CACHE_EXTENSION) - 1), COMPILER_CACHE_EXTENSION)
+        )
+            continue;
+
+        char *const path = compilerCacheGetPath(cache, directoryEntry->d_name, "");
+        struct stat status;
+
+        if (path == NULL || 0 != stat(path, &status) || !S_ISREG(status.st_mode)) {
+            free(path);
+            continue;
+        }
+        free(path);
+
+        CompilerCacheEntry entry = {
+            .mtimeSec  = (int64_t)status.st_mtime,
+            .mtimeNsec = 0,
+            .size      = (uint64_t)status.st_size,
+        };
+#ifdef __APPLE__
+        entry.mtimeNsec = (int64_t)status.st_mtimespec.tv_nsec;
+#else
+        entry.mtimeNsec = (int64_t)status.st_mtim.tv_nsec;
+#endif
+        memcpy(entry.name, directoryEntry->d_name, nameLength + 1);
+
+        if (CF_DARR_OK != cfDarrPush(&entries, &entry))
+            break;
+        totalSize += entry.size;
+    }
+    closedir(directory);
+
+    CompilerCacheEntry *const entryArray = (CompilerCacheEntry *)cfDarrData(entries);
+    const size_t entryCount = cfDarrLength(entries);
+
+    // remove least recently used entries
+    if (totalSize > cache->maxSize) {
+        qsort(entryArray, entryCount, sizeof(CompilerCacheEntry), compilerCacheEntryCompare);
+
+        for (size_t i = 0; i < entryCount && totalSize > cache->maxSize; i++) {
+            char *const path = compilerCacheGetPath(cache, entryArray[i].name, "");
+
+            if (path != NULL && 0 == remove(path))
+                totalSize -= entryArray[i].size;
+            free(path);
+        }
+    }
+
+    cfDarrDtor(entries);
+#endif
+} // compilerCacheTrim
+
+// compiler_cache.c
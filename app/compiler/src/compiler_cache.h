@@ -0,0 +1,101 @@
+/**
+ * @brief compilation cache declaration file
+ *
+ * @note cache is directory of object files named by hex key (hash of cache version and source text),
+ * so unchanged files are not compiled again. Entry modification time is updated on every hit, and
+ * least recently used entries are removed if total entry size exceeds cache size limit.
+ */
+
+#ifndef COMPILER_CACHE_H_
+#define COMPILER_CACHE_H_
+
+#include <cf_hash.h>
+#include <cf_object.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief cache entry format version (it must be increased on every change of compiler output)
+#define COMPILER_CACHE_VERSION 1
+
+/// @brief default cache size limit (in bytes)
+#define COMPILER_CACHE_DEFAULT_MAX_SIZE ((uint64_t)64 << 20)
+
+/// @brief compilation cache
+typedef struct CompilerCache_ {
+    const char * directory; ///< cache directory (null if cache isn't used)
+    uint64_t     maxSize;   ///< total entry size limit
+    bool         isStored;  ///< true if entries are stored, so cache may require trimming
+} CompilerCache;
+
+/**
+ * @brief cache opening function
+ *
+ * @param[out] cache     cache to open (non-null)
+ * @param[in]  directory cache directory (it's created if it doesn't exist, must outlive cache)
+ * @param[in]  maxSize   total entry size limit
+ *
+ * @return true if succeeded, false if directory can't be created or cache isn't supported by host
+ */
+bool compilerCacheOpen( CompilerCache *cache, const char *directory, uint64_t maxSize );
+
+/**
+ * @brief cache key calculation function
+ *
+ * @param[in] source       source text
+ * @param[in] sourceLength source text length
+ *
+ * @return cache key
+ */
+CfHash compilerCacheKey( const char *source, size_t sourceLength );
+
+/**
+ * @brief cache key of specified cache version and compilation options calculation function
+ *
+ * @param[in] source       source text
+ * @param[in] sourceLength source text length
+ * @param[in] version      cache version
+ * @param[in] options      compilation options
+ *
+ * @return cache key (compilerCacheKey result if version is COMPILER_CACHE_VERSION and options are 0)
+ */
+CfHash compilerCacheKeyVersioned( const char *source, size_t sourceLength, uint32_t version, uint32_t options );
+
+/**
+ * @brief cached object loading function
+ *
+ * @param[in]  cache cache (non-null)
+ * @param[in]  key   object key
+ * @param[out] dst   object destination (non-null)
+ *
+ * @return true if object is found and read, false otherwise
+ */
+bool compilerCacheLoad( const CompilerCache *cache, const CfHash *key, CfObject *dst );
+
+/**
+ * @brief object to cache storing function
+ *
+ * @param[in,out] cache  cache (non-null)
+ * @param[in]     key    object key
+ * @param[in]     object object to store (non-null)
+ *
+ * @note entry is written into temporary file and renamed then, so concurrent compilers never read
+ * partially written entries. Failure to store object isn't an error (it's just compiled next time).
+ */
+void compilerCacheStore( CompilerCache *cache, const CfHash *key, const CfObject *object );
+
+/**
+ * @brief cache trimming function (least recently used entries are removed until cache fits size limit)
+ *
+ * @param[in,out] cache cache (non-null)
+ */
+void compilerCacheTrim( CompilerCache *cache );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // !defined(COMPILER_CACHE_H_)
+
+// compiler_cache.h
@@ -9,6 +9,7 @@
 #include <assert.h>
 
 #include "compiler.h"
+#include "compiler_cache.h"
 
 /**
  * @brief text from file reading function
@@ -48,6 +49,9 @@ void printHelp( void ) {
         "Options:\n"
         "    -h             Display help menu\n"
         "    -o <filename>  Write executable to certain file\n"
+        "    -z             Write executable in compressed format\n"
+        "    -c <directory> Cache compiled files in certain directory\n"
+        "    -m <size>      Set cache size limit to <size> bytes (default: 64MB)\n"
     );
 } // printHelp
 
@@ -59,17 +63,7 @@ void printHelp( void ) {
  * 
  * @return exit status (0 on success)
  */
-int main( int argc_, const char **argv_ ) {
-    // int argc = argc_;
-    // const char **argv = argv_;
-    int argc = 4;
-    const char *argv[] = {
-        "amogus",
-        "-o",
-        "temp/main.cfexe",
-        "examples/lang/square_equation_solver.cf",
-    };
-
+int main( int argc, const char **argv ) {
     if (argc <= 1) {
         printHelp();
         return 0;
@@ -79,10 +73,16 @@ int main( int argc_, const char **argv_ ) {
 
     struct {
         bool doHelp;
+        bool doCompress;
         const char *outName;
+        const char *cacheDirectory;
+        uint64_t cacheMaxSize;
     } options = {
         .doHelp = false,
+        .doCompress = false,
         .outName = "out.cfexe",
+        .cacheDirectory = NULL,
+        .cacheMaxSize = COMPILER_CACHE_DEFAULT_MAX_SIZE,
     };
 
     int argumentIndex = 1;
@@ -101,6 +101,29 @@ int main( int argc_, const char **argv_ ) {
             continue;
         }
 
+        if (strcmp(argv[argumentIndex], "-c") == 0) {
+            if (argumentIndex + 1 >= argc) {
+                printf("Invalid flag: \"-c\" key must be followed with cache directory name\n");
+                return 0;
+            }
+            options.cacheDirectory = argv[++argumentIndex];
+            continue;
+        }
+
+        if (strcmp(argv[argumentIndex], "-m") == 0) {
+            if (argumentIndex + 1 >= argc) {
+                printf("Invalid flag: \"-m\" key must be followed with cache size limit\n");
+                return 0;
+            }
+            options.cacheMaxSize = strtoull(argv[++argumentIndex], NULL, 10);
+            continue;
+        }
+
+        if (strcmp(argv[argumentIndex], "-z") == 0) {
+            options.doCompress = true;
+            continue;
+        }
+
         if (argv[argumentIndex][0] == '-') {
             printf("Unknown flag: \"%s\"\n", argv[argumentIndex]);
             return 0;
@@ -120,6 +143,10 @@ int main( int argc_, const char **argv_ ) {
         return 0;
     }
 
+    // compilation just isn't cached if cache can't be used
+    if (options.cacheDirectory != NULL && !compilerSetCache(compiler, options.cacheDirectory, options.cacheMaxSize))
+        printf("Cannot use \"%s\" as compilation cache directory\n", options.cacheDirectory);
+
     // add input files
     for (; argumentIndex < argc; argumentIndex++) {
         const char *fileName = argv[argumentIndex];
@@ -175,7 +202,10 @@ int main( int argc_, const char **argv_ ) {
         return 0;
     }
 
-    cfExecutableWrite(outFile, &executable);
+    if (options.doCompress)
+        cfExecutableWriteCompressed(outFile, &executable);
+    else
+        cfExecutableWrite(outFile, &executable);
     fclose(outFile);
 
     cfExecutableDtor(&executable);
@@ -0,0 +1,294 @@
+/**
+ * @brief batch (multi-instance) execution implementation file
+ */
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <cf_vm.h>
+#include <cf_darr.h>
+
+#include <sandbox_console.h>
+
+#include "batch.h"
+
+/// @brief single job representation structure
+typedef struct BatchJob_ {
+    size_t     inputOffset; ///< offset of job input in batch input number array
+    size_t     inputLength; ///< job input number count
+    CfDarr     output;      ///< numbers written by job (array of doubles, null if job isn't executed)
+    CfTermInfo termInfo;    ///< job termination info
+    bool       isExecuted;  ///< true if job is executed (e.g. VM is started)
+} BatchJob;
+
+/// @brief worker thread context representation structure
+typedef struct BatchWorker_ {
+    struct Batch_ * batch;      ///< batch worker belongs to
+    pthread_t       thread;     ///< worker thread
+    pthread_mutex_t mutex;      ///< job range mutex
+    size_t          rangeBegin; ///< index of first job to execute (is taken by worker)
+    size_t          rangeEnd;   ///< index of job after last one to execute (is taken by thieves)
+} BatchWorker;
+
+/// @brief batch execution context representation structure
+typedef struct Batch_ {
+    const BatchInfo * info;        ///< batch info
+    const CfVmCode  * code;        ///< code shared by all VMs
+    const double    * input;       ///< input numbers of all jobs
+    BatchJob        * jobs;        ///< jobs
+    size_t            jobCount;    ///< job count
+    BatchWorker     * workers;     ///< workers
+    size_t            workerCount; ///< worker count
+} Batch;
+
+/**
+ * @brief job taking function
+ *
+ * @param[in,out] worker worker to take job for (non-null)
+ * @param[out]    dst    job index destination (non-null)
+ *
+ * @return true if job is taken, false if there are no jobs left
+ *
+ * @note if worker has no jobs, half of jobs of the first worker that still has some is stolen.
+ */
+static bool batchTakeJob( BatchWorker *const worker, size_t *const dst ) {
+    Batch *const batch = worker->batch;
+
+    pthread_mutex_lock(&worker->mutex);
+    if (worker->rangeBegin < worker->rangeEnd) {
+        *dst = worker->rangeBegin++;
+        pthread_mutex_unlock(&worker->mutex);
+        return true;
+    }
+    pthread_mutex_unlock(&worker->mutex);
+
+    // jobs are never added, so there's no job left if all other workers have no jobs
+    const size_t workerIndex = worker - batch->workers;
+    for (size_t i = 1; i < batch->workerCount; i++) {
+        BatchWorker *const victim = &batch->workers[(workerIndex + i) % batch->workerCount];
+        size_t stolenBegin, stolenEnd;
+
+        pthread_mutex_lock(&victim->mutex);
+        stolenEnd = victim->rangeEnd;
+        stolenBegin = victim->rangeEnd - (victim->rangeEnd - victim->rangeBegin) / 2;
+        if (stolenBegin == stolenEnd && victim->rangeBegin < victim->rangeEnd)
+            stolenBegin--;
+        victim->rangeEnd = stolenBegin;
+        pthread_mutex_unlock(&victim->mutex);
+
+        if (stolenBegin == stolenEnd)
+            continue;
+
+        // the first stolen job is executed immediately
+        pthread_mutex_lock(&worker->mutex);
+        worker->rangeBegin = stolenBegin + 1;
+        worker->rangeEnd = stolenEnd;
+        pthread_mutex_unlock(&worker->mutex);
+
+        *dst = stolenBegin;
+        return true;
+    }
+
+    return false;
+} // batchTakeJob
+
+/**
+ * @brief single job executing function
+ *
+ * @param[in,out] batch batch to execute job of (non-null)
+ * @param[in,out] job   job to execute (non-null)
+ */
+static void batchExecuteJob( Batch *const batch, BatchJob *const job ) {
+    SandboxConsoleContext context = {
+        .input       = batch->input + job->inputOffset,
+        .inputLength = job->inputLength,
+        .output      = cfDarrCtor(sizeof(double)),
+    };
+
+    if (context.output == NULL)
+        return;
+
+    CfSandbox sandbox = {0};
+    sandboxConsoleConfigure(&sandbox, &context);
+
+    const CfExecuteInfo execInfo = {
+        .executable = batch->info->executable,
+        .sandbox    = &sandbox,
+        .ramSize    = batch->info->ramSize,
+        .useTraces  = true,
+        .code       = batch->code,
+        .imagePath  = batch->info->imagePath,
+    };
+
+    job->isExecuted = cfExecute(&execInfo);
+    job->output = context.output;
+    job->termInfo = context.termInfo;
+} // batchExecuteJob
+
+/**
+ * @brief worker thread function
+ *
+ * @param[in] arg worker pointer
+ *
+ * @return null
+ */
+static void * batchWorkerMain( void *arg ) {
+    BatchWorker *const worker = (BatchWorker *)arg;
+    size_t jobIndex;
+
+    while (batchTakeJob(worker, &jobIndex))
+        batchExecuteJob(worker->batch, &worker->batch->jobs[jobIndex]);
+
+    return NULL;
+} // batchWorkerMain
+
+/**
+ * @brief job file reading function
+ *
+ * @param[in]  file     file to read jobs from (non-null)
+ * @param[out] jobs     job array destination (non-null, array of BatchJob)
+ * @param[out] input    input number array destination (non-null, array of doubles)
+ *
+ * @return true if succeeded, false otherwise
+ */
+static bool batchReadJobs( FILE *const file, CfDarr *const jobs, CfDarr *const input ) {
+    char *line = NULL;
+    size_t lineCapacity = 0;
+    bool isOk = true;
+
+    while (isOk && getline(&line, &lineCapacity, file) != -1) {
+        BatchJob job = { .inputOffset = cfDarrLength(*input) };
+        const char *cursor = line;
+
+        for (;;) {
+            char *end;
+            const double number = strtod(cursor, &end);
+
+            if (end == cursor)
+                break;
+            cursor = end;
+
+            if (CF_DARR_OK != cfDarrPush(input, &number)) {
+                isOk = false;
+                break;
+            }
+        }
+
+        // lines without numbers (e.g. empty ones) are jobs too, so job line indices are preserved
+        job.inputLength = cfDarrLength(*input) - job.inputOffset;
+
+        if (isOk && CF_DARR_OK != cfDarrPush(jobs, &job))
+            isOk = false;
+    }
+
+    free(line);
+    return isOk;
+} // batchReadJobs
+
+bool batchExecute( const BatchInfo *info ) {
+    assert(info != NULL);
+    assert(info->executable != NULL);
+    assert(info->jobFile != NULL);
+    assert(info->outputFile != NULL);
+
+    Batch batch = { .info = info };
+    CfDarr jobArray = cfDarrCtor(sizeof(BatchJob));
+    CfDarr inputArray = cfDarrCtor(sizeof(double));
+    CfVmCode *code = cfVmCodeCtor(info->executable);
+    bool isOk = true;
+    size_t startedWorkerCount = 0;
+
+    if (false
+        || jobArray == NULL
+        || inputArray == NULL
+        || code == NULL
+        || !batchReadJobs(info->jobFile, &jobArray, &inputArray)
+    ) {
+        isOk = false;
+        goto batchExecute__cleanup;
+    }
+
+    batch.code = code;
+    batch.input = (const double *)cfDarrData(inputArray);
+    batch.jobs = (BatchJob *)cfDarrData(jobArray);
+    batch.jobCount = cfDarrLength(jobArray);
+    batch.workerCount = info->threadCount != 0
+        ? info->threadCount
+        : (size_t)sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (batch.workerCount == 0 || batch.workerCount > batch.jobCount)
+        batch.workerCount = batch.jobCount != 0 ? batch.jobCount : 1;
+
+    batch.workers = (BatchWorker *)calloc(batch.workerCount, sizeof(BatchWorker));
+    if (batch.workers == NULL) {
+        isOk = false;
+        goto batchExecute__cleanup;
+    }
+
+    // distribute jobs evenly, imbalance is fixed by stealing
+    for (size_t i = 0; i < batch.workerCount; i++) {
+        BatchWorker *const worker = &batch.workers[i];
+
+        worker->batch = &batch;
+        worker->rangeBegin = batch.jobCount * i / batch.workerCount;
+        worker->rangeEnd = batch.jobCount * (i + 1) / batch.workerCount;
+        pthread_mutex_init(&worker->mutex, NULL);
+    }
+
+    for (; startedWorkerCount < batch.workerCount; startedWorkerCount++) {
+        BatchWorker *const worker = &batch.workers[startedWorkerCount];
+
+        if (0 != pthread_create(&worker->thread, NULL, batchWorkerMain, worker))
+            break;
+    }
+
+    // workers that are started already execute all jobs (by stealing them from not started ones)
+    if (startedWorkerCount == 0)
+        isOk = false;
+
+    for (size_t i = 0; i < startedWorkerCount; i++)
+        pthread_join(batch.workers[i].thread, NULL);
+
+    for (size_t i = 0; i < batch.workerCount; i++)
+        pthread_mutex_destroy(&batch.workers[i].mutex);
+
+    // write job results
+    for (size_t i = 0; startedWorkerCount != 0 && i < batch.jobCount; i++) {
+        const BatchJob *const job = &batch.jobs[i];
+
+        if (!job->isExecuted) {
+            fprintf(info->outputFile, "! job execution failed\n");
+            isOk = false;
+            continue;
+        }
+
+        const double *const output = (const double *)cfDarrData(job->output);
+        const size_t outputLength = cfDarrLength(job->output);
+
+        for (size_t j = 0; j < outputLength; j++)
+            fprintf(info->outputFile, j == 0 ? "%lf" : " %lf", output[j]);
+
+        if (job->termInfo.reason != CF_TERM_REASON_HALT)
+            fprintf(info->outputFile, "%s! terminated (reason %d, offset 0x%zX)",
+                outputLength == 0 ? "" : " ",
+                (int)job->termInfo.reason,
+                job->termInfo.offset
+            );
+        fprintf(info->outputFile, "\n");
+    }
+
+batchExecute__cleanup:
+    for (size_t i = 0; i < batch.jobCount; i++)
+        cfDarrDtor(batch.jobs[i].output);
+    free(batch.workers);
+    cfVmCodeDtor(code);
+    cfDarrDtor(inputArray);
+    cfDarrDtor(jobArray);
+
+    return isOk;
+} // batchExecute
+
+// batch.c
@@ -0,0 +1,45 @@
+/**
+ * @brief batch (multi-instance) execution declaration file
+ */
+
+#ifndef BATCH_H_
+#define BATCH_H_
+
+#include <stdio.h>
+
+#include <cf_executable.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief batch execution info
+typedef struct BatchInfo_ {
+    const CfExecutable * executable;  ///< executable to run jobs by (non-null)
+    FILE               * jobFile;     ///< job file (each line contains numbers one job reads, non-null)
+    FILE               * outputFile;  ///< job results destination (non-null)
+    size_t               threadCount; ///< worker thread count (count of online processors if 0)
+    size_t               ramSize;     ///< RAM size of each VM
+    const char         * imagePath;   ///< snapshot each VM is started from (null if VMs are started from scratch)
+} BatchInfo;
+
+/**
+ * @brief job batch execution function
+ *
+ * @param[in] info batch execution info (non-null)
+ *
+ * @return true if all jobs are executed, false if something went wrong
+ *
+ * @note each job is executed in separate VM (all VMs share single copy of decoded code) with
+ * headless sandbox and its written numbers are displayed in the line of same index as job line.
+ * Jobs are distributed between worker threads evenly and then stolen by workers that run out of them.
+ */
+bool batchExecute( const BatchInfo *info );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // !defined(BATCH_H_)
+
+// batch.h
@@ -6,18 +6,38 @@
 #include <string.h>
 #include <errno.h>
 #include <assert.h>
+#include <stdlib.h>
 
 #include <cf_vm.h>
 #include <cf_executable.h>
 #include <cf_cli.h>
 
 #include <sandbox.h>
+#include <sandbox_console.h>
+#include <sandbox_replay.h>
+
+#include "batch.h"
 
 /**
  * @brief help displaying function
  */
 void printHelp( void ) {
-    printf("Usage: cf_exec executable\n");
+    puts(
+        "Usage:  cf_exec [options] executable\n"
+        "\n"
+        "Options:\n"
+        "    -h              Display this message\n"
+        "    -p <filename>   Interpret executable and write its execution profile to <filename>\n"
+        "    -b <filename>   Run job per line of <filename> (line contains numbers job reads) in headless\n"
+        "                    sandboxes concurrently and display numbers written by each job in its line\n"
+        "    -t <count>      Run batch jobs by <count> threads (default: count of processors)\n"
+        "    -s <filename>   Interpret executable and write VM snapshot to <filename> at each snap instruction\n"
+        "    -i <filename>   Start execution (or each batch job) from VM snapshot <filename>\n"
+        "    -r <filename>   Record time, keyboard and number input of execution to <filename>\n"
+        "    -R <filename>   Replay input recorded to <filename> in headless sandbox (so execution is repeatable)\n"
+        "    -c <filename>   Skip code hash verification of executables whose hashes are already verified\n"
+        "                    and stored in trusted hash cache <filename> (verified ones are added to it)\n"
+    );
 } // printHelp
 
 int main( const int _argc, const char **_argv ) {
@@ -26,41 +46,147 @@ int main( const int _argc, const char **_argv ) {
     const int argc = _argc;
     const char **argv = _argv;
 
-    if (argc < 2) {
+    if (argc < 2 || 0 == strcmp(argv[1], "-h")) {
         printHelp();
         return 0;
     }
 
-    const char *execPath = argv[1];
+    const CfCommandLineOptionInfo optionInfos[9] = {
+        {"h", "help",     0},
+        {"p", "profile",  1},
+        {"b", "batch",    1},
+        {"t", "threads",  1},
+        {"s", "snapshot", 1},
+        {"i", "image",    1},
+        {"r", "record",   1},
+        {"R", "replay",   1},
+        {"c", "cache",    1},
+    };
+    int optionIndices[9];
+    const size_t optionCount = 9;
+    if (!cfParseCommandLineOptions(argc - 2, argv + 1, optionCount, optionInfos, optionIndices))
+        return 0;
+
+    if (optionIndices[0] != -1) {
+        printHelp();
+        return 0;
+    }
 
+    const char *execPath = argv[argc - 1];
+    const char *profilePath = optionIndices[1] != -1
+        ? argv[optionIndices[1] + 1]
+        : NULL;
+    const char *snapshotPath = optionIndices[4] != -1
+        ? argv[optionIndices[4] + 1]
+        : NULL;
+    const char *imagePath = optionIndices[5] != -1
+        ? argv[optionIndices[5] + 1]
+        : NULL;
+    const char *hashCachePath = optionIndices[8] != -1
+        ? argv[optionIndices[8] + 1]
+        : NULL;
+
+    // executable is mapped, so its code isn't copied; hash is verified unless cache already trusts it
     CfExecutable executable;
-    FILE *inputFile = fopen(execPath, "rb");
+    CfExecutableReadStatus readStatus = cfExecutableMap(execPath, hashCachePath, hashCachePath == NULL, &executable);
 
-    if (inputFile == NULL) {
+    if (readStatus == CF_EXECUTABLE_READ_STATUS_FILE_ERROR) {
         printf("input file opening error: %s\n", strerror(errno));
         return 0;
     }
 
-    CfExecutableReadStatus readStatus = cfExecutableRead(inputFile, &executable);
-    fclose(inputFile);
-
     if (readStatus != CF_EXECUTABLE_READ_STATUS_OK) {
         printf("input executable file reading error: %s\n", cfExecutableReadStatusStr(readStatus));
         return 0;
     }
 
+    // batch mode
+    if (optionIndices[2] != -1) {
+        FILE *jobFile = fopen(argv[optionIndices[2] + 1], "r");
+
+        if (jobFile == NULL) {
+            printf("job file opening error: %s\n", strerror(errno));
+            cfExecutableDtor(&executable);
+            return 0;
+        }
+
+        const BatchInfo batchInfo = {
+            .executable  = &executable,
+            .jobFile     = jobFile,
+            .outputFile  = stdout,
+            .threadCount = optionIndices[3] != -1
+                ? (size_t)strtoull(argv[optionIndices[3] + 1], NULL, 10)
+                : 0,
+            .ramSize     = (1 << 24),   // 16MB
+            .imagePath   = imagePath,
+        };
+
+        if (!batchExecute(&batchInfo))
+            printf("batch execution error occured.\n");
+
+        fclose(jobFile);
+        cfExecutableDtor(&executable);
+        return 0;
+    }
+
     SandboxContext context = {0};
+    SandboxConsoleContext consoleContext = {0};
     CfSandbox sandbox = {0};
-    sandboxConfigure(&sandbox, &context);
+
+    // replayed execution doesn't require window, because all its input is taken from log
+    if (optionIndices[7] != -1)
+        sandboxConsoleConfigure(&sandbox, &consoleContext);
+    else
+        sandboxConfigure(&sandbox, &context);
+
+    // input log wraps actual sandbox
+    const bool isReplay = optionIndices[7] != -1;
+    SandboxReplayContext replayContext = {
+        .sandbox = &sandbox,
+        .mode    = isReplay ? SANDBOX_REPLAY_MODE_REPLAY : SANDBOX_REPLAY_MODE_RECORD,
+    };
+    CfSandbox replaySandbox = {0};
+
+    if (optionIndices[6] != -1 || isReplay) {
+        const char *logPath = argv[(isReplay ? optionIndices[7] : optionIndices[6]) + 1];
+
+        replayContext.file = fopen(logPath, isReplay ? "rb" : "wb");
+        if (replayContext.file == NULL) {
+            printf("input log file opening error: %s\n", strerror(errno));
+            cfExecutableDtor(&executable);
+            return 0;
+        }
+        sandboxReplayConfigure(&replaySandbox, &replayContext);
+    }
 
     const CfExecuteInfo execInfo = {
-        .executable = &executable,
-        .sandbox    = &sandbox,
-        .ramSize    = (1 << 24),   // 16MB
+        .executable   = &executable,
+        .sandbox      = replayContext.file != NULL ? &replaySandbox : &sandbox,
+        .ramSize      = (1 << 24),   // 16MB
+        .useJit       = true,
+        .useTraces    = true,      // used if code isn't JIT-compiled (e.g. with snapshots)
+        .profilePath  = profilePath,
+        .snapshotPath = snapshotPath,
+        .imagePath    = imagePath,
     };
 
     if (!cfExecute(&execInfo))
-        printf("sandbox error occured.\n");
+        printf(imagePath != NULL
+            ? "sandbox or snapshot loading error occured.\n"
+            : profilePath != NULL
+                ? "sandbox or profile writing error occured.\n"
+                : "sandbox error occured.\n"
+        );
+
+    if (replayContext.file != NULL) {
+        if (replayContext.isDiverged)
+            printf(isReplay
+                ? "replayed execution diverged from recorded one (after %llu events).\n"
+                : "input log writing error occured (after %llu events).\n",
+                (unsigned long long)replayContext.eventCount
+            );
+        fclose(replayContext.file);
+    }
 
     cfExecutableDtor(&executable);
 
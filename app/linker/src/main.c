@@ -18,6 +18,7 @@ void printHelp( void ) {
         "Options:\n"
         "    -h              Display this message\n"
         "    -o <filename>   Write output to <filename>\n"
+        "    -z              Write output in compressed format\n"
     );
 } // printHelp
 
@@ -38,9 +39,11 @@ int main( const int _argc, const char **_argv ) {
 
     struct {
         bool printHelp;
+        bool compressOutput;
         const char *outFileName;
     } options = {
         .printHelp = false,
+        .compressOutput = false,
         .outFileName = "out.cfexe",
     };
 
@@ -51,6 +54,11 @@ int main( const int _argc, const char **_argv ) {
             continue;
         }
 
+        if (0 == strcmp(argv[argIndex], "-z")) {
+            options.compressOutput = true;
+            continue;
+        }
+
         if (0 == strcmp(argv[argIndex], "-o")) {
             if (argIndex + 1 >= argc) {
                 printf("at least one argument for \"-o\" option required.");
@@ -127,7 +135,11 @@ int main( const int _argc, const char **_argv ) {
             break;
         }
 
-        if (!cfExecutableWrite(file, &executable))
+        const bool writeSuccess = options.compressOutput
+            ? cfExecutableWriteCompressed(file, &executable)
+            : cfExecutableWrite(file, &executable);
+
+        if (!writeSuccess)
             printf("executable write error occured.\n");
         fclose(file);
 
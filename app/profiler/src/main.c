@@ -0,0 +1,347 @@
+/**
+ * @brief execution profile analysis utility
+ *
+ * @note joins profile written by cfExecute (see CfExecuteInfo::profilePath) with labels
+ * of objects executable is linked from, so per-function hot lists are displayed.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cf_object.h>
+#include <cf_darr.h>
+
+/// @brief code point profile is attributed to
+typedef struct Symbol_ {
+    uint32_t offset;              ///< symbol offset in linked code
+    char     name[CF_LABEL_MAX];  ///< symbol name
+    uint64_t count;               ///< total execution count of symbol instructions
+    uint64_t time;                ///< total execution time of symbol instructions
+} Symbol;
+
+/// @brief single opcode profile
+typedef struct OpcodeProfile_ {
+    char     name[32]; ///< opcode name
+    uint64_t count;    ///< opcode execution count
+    uint64_t time;     ///< opcode execution time
+} OpcodeProfile;
+
+/**
+ * @brief help printing function
+ */
+void printHelp( void ) {
+    puts(
+        "Usage:  cf_profiler [options] profile object1 object2 ... objectN\n"
+        "\n"
+        "Objects must be passed in the same order they were passed to linker.\n"
+        "\n"
+        "Options:\n"
+        "    -h              Display this message\n"
+        "    -a              Attribute time to all labels (not only to function ones)\n"
+        "    -n <count>      Display <count> hottest symbols and opcodes (default: 20)\n"
+    );
+} // printHelp
+
+/**
+ * @brief function label checking function
+ *
+ * @param[in] label label to check (non-null)
+ *
+ * @return true if label starts function, false if it's local one
+ *
+ * @note local labels contain double underscore (both assembly "_function__loop"
+ * convention and compiler-generated "__function__loop_0" labels follow it).
+ */
+bool isFunctionLabel( const char *label ) {
+    return NULL == strstr(label, "__");
+} // isFunctionLabel
+
+/**
+ * @brief symbols by offset comparator
+ */
+int compareSymbolOffsets( const void *lhs, const void *rhs ) {
+    const uint32_t l = ((const Symbol *)lhs)->offset;
+    const uint32_t r = ((const Symbol *)rhs)->offset;
+
+    return (l > r) - (l < r);
+} // compareSymbolOffsets
+
+/**
+ * @brief symbols by time (descending) comparator
+ */
+int compareSymbolTimes( const void *lhs, const void *rhs ) {
+    const uint64_t l = ((const Symbol *)lhs)->time;
+    const uint64_t r = ((const Symbol *)rhs)->time;
+
+    return (l < r) - (l > r);
+} // compareSymbolTimes
+
+/**
+ * @brief opcode profiles by time (descending) comparator
+ */
+int compareOpcodeTimes( const void *lhs, const void *rhs ) {
+    const uint64_t l = ((const OpcodeProfile *)lhs)->time;
+    const uint64_t r = ((const OpcodeProfile *)rhs)->time;
+
+    return (l < r) - (l > r);
+} // compareOpcodeTimes
+
+/**
+ * @brief symbol of certain offset finding function
+ *
+ * @param[in] symbols     symbols sorted by offset
+ * @param[in] symbolCount symbol count
+ * @param[in] offset      offset to find symbol of
+ *
+ * @return index of last symbol with offset not greater than offset, symbolCount if there's no such symbol
+ */
+size_t findSymbol( const Symbol *symbols, size_t symbolCount, uint32_t offset ) {
+    size_t left = 0;
+    size_t right = symbolCount;
+
+    // find count of symbols not greater than offset
+    while (left < right) {
+        const size_t middle = left + (right - left) / 2;
+
+        if (symbols[middle].offset <= offset)
+            left = middle + 1;
+        else
+            right = middle;
+    }
+
+    return left == 0 ? symbolCount : left - 1;
+} // findSymbol
+
+/**
+ * @brief main program function
+ */
+int main( const int argc, const char **argv ) {
+    struct {
+        bool printHelp;
+        bool allLabels;
+        size_t displayCount;
+    } options = {
+        .printHelp = false,
+        .allLabels = false,
+        .displayCount = 20,
+    };
+
+    int argIndex;
+    for (argIndex = 1; argIndex < argc; argIndex++) {
+        if (0 == strcmp(argv[argIndex], "-h")) {
+            options.printHelp = true;
+            continue;
+        }
+
+        if (0 == strcmp(argv[argIndex], "-a")) {
+            options.allLabels = true;
+            continue;
+        }
+
+        if (0 == strcmp(argv[argIndex], "-n")) {
+            if (argIndex + 1 >= argc) {
+                printf("at least one argument for \"-n\" option required.\n");
+                return 0;
+            }
+            options.displayCount = strtoull(argv[argIndex + 1], NULL, 10);
+            argIndex++;
+            continue;
+        }
+
+        break;
+    }
+
+    if (options.printHelp || argIndex >= argc) {
+        printHelp();
+        return 0;
+    }
+
+    const char *profilePath = argv[argIndex++];
+
+    CfDarr symbolArray = cfDarrCtor(sizeof(Symbol));
+    CfDarr opcodeArray = cfDarrCtor(sizeof(OpcodeProfile));
+
+    if (symbolArray == NULL || opcodeArray == NULL) {
+        printf("profiler internal error occured.\n");
+        cfDarrDtor(symbolArray);
+        cfDarrDtor(opcodeArray);
+        return 0;
+    }
+
+    bool isOk = true;
+
+    // collect code labels of objects, object code is placed by linker one after another
+    uint32_t codeSize = 0;
+    for (; isOk && argIndex < argc; argIndex++) {
+        CfObject object;
+
+        FILE *file = fopen(argv[argIndex], "rb");
+        if (file == NULL) {
+            printf("\"%s\" input file opening error: %s\n", argv[argIndex], strerror(errno));
+            isOk = false;
+            break;
+        }
+        CfObjectReadStatus readStatus = cfObjectRead(file, &object);
+        fclose(file);
+
+        if (CF_OBJECT_READ_STATUS_OK != readStatus) {
+            printf("object from file reading error: %s\n", cfObjectReadStatusStr(readStatus));
+            isOk = false;
+            break;
+        }
+
+        for (size_t i = 0; i < object.labelCount; i++) {
+            const CfLabel *label = &object.labels[i];
+
+            // constants are not code points
+            if (!label->isRelative || !(options.allLabels || isFunctionLabel(label->label)))
+                continue;
+
+            Symbol symbol = { .offset = label->value + codeSize };
+            memcpy(symbol.name, label->label, sizeof(symbol.name));
+            symbol.name[CF_LABEL_MAX - 1] = '\0';
+
+            if (CF_DARR_OK != cfDarrPush(&symbolArray, &symbol)) {
+                printf("profiler internal error occured.\n");
+                isOk = false;
+                break;
+            }
+        }
+
+        codeSize += (uint32_t)object.codeLength;
+        cfObjectDtor(&object);
+    }
+
+    Symbol *symbols = (Symbol *)cfDarrData(symbolArray);
+    size_t symbolCount = cfDarrLength(symbolArray);
+    qsort(symbols, symbolCount, sizeof(Symbol), compareSymbolOffsets);
+
+    // code not covered by any label (e.g. code before first one)
+    Symbol unknownSymbol = { .offset = 0, .name = "<unknown>" };
+
+    uint64_t totalCount = 0;
+    uint64_t totalTime = 0;
+    char clockName[16] = "";
+
+    // read profile and join it with symbols
+    FILE *profile = isOk ? fopen(profilePath, "r") : NULL;
+    if (isOk && profile == NULL) {
+        printf("\"%s\" profile opening error: %s\n", profilePath, strerror(errno));
+        isOk = false;
+    }
+
+    if (isOk) {
+        int version = 0;
+
+        if (2 != fscanf(profile, "cfprofile %d %15s", &version, clockName) || version != 1) {
+            printf("\"%s\" is not a profile file (or its version is unsupported).\n", profilePath);
+            isOk = false;
+        }
+    }
+
+    while (isOk) {
+        char kind[2];
+        if (1 != fscanf(profile, "%1s", kind))
+            break;
+
+        if (kind[0] == 'i') {
+            unsigned int offset;
+            char opcode[32];
+            unsigned long long count, time;
+
+            if (4 != fscanf(profile, "%u %31s %llu %llu", &offset, opcode, &count, &time)) {
+                printf("profile instruction line reading error.\n");
+                isOk = false;
+                break;
+            }
+
+            const size_t index = findSymbol(symbols, symbolCount, offset);
+            Symbol *symbol = index == symbolCount ? &unknownSymbol : &symbols[index];
+
+            symbol->count += count;
+            symbol->time += time;
+            totalCount += count;
+            totalTime += time;
+        } else if (kind[0] == 'o') {
+            OpcodeProfile opcode;
+            unsigned long long count, time;
+
+            if (3 != fscanf(profile, "%31s %llu %llu", opcode.name, &count, &time)) {
+                printf("profile opcode line reading error.\n");
+                isOk = false;
+                break;
+            }
+            opcode.count = count;
+            opcode.time = time;
+
+            if (CF_DARR_OK != cfDarrPush(&opcodeArray, &opcode)) {
+                printf("profiler internal error occured.\n");
+                isOk = false;
+                break;
+            }
+        } else {
+            printf("unknown profile line kind: '%s'\n", kind);
+            isOk = false;
+        }
+    }
+
+    if (profile != NULL)
+        fclose(profile);
+
+    if (isOk) {
+        // unknown symbol is displayed as common one
+        if (unknownSymbol.count != 0 && CF_DARR_OK != cfDarrPush(&symbolArray, &unknownSymbol)) {
+            printf("profiler internal error occured.\n");
+            isOk = false;
+        }
+        symbols = (Symbol *)cfDarrData(symbolArray);
+        symbolCount = cfDarrLength(symbolArray);
+    }
+
+    if (isOk) {
+        const double timeScale = totalTime != 0 ? 100.0 / (double)totalTime : 0.0;
+
+        qsort(symbols, symbolCount, sizeof(Symbol), compareSymbolTimes);
+
+        printf("total: %llu instructions, %llu %s\n\n",
+            (unsigned long long)totalCount,
+            (unsigned long long)totalTime,
+            clockName
+        );
+
+        printf("%-40s %16s %16s %8s\n", options.allLabels ? "label" : "function", "count", "time", "time, %");
+        for (size_t i = 0; i < symbolCount && i < options.displayCount; i++) {
+            if (symbols[i].count == 0)
+                break;
+            printf("%-40s %16llu %16llu %8.2f\n",
+                symbols[i].name,
+                (unsigned long long)symbols[i].count,
+                (unsigned long long)symbols[i].time,
+                (double)symbols[i].time * timeScale
+            );
+        }
+
+        OpcodeProfile *opcodes = (OpcodeProfile *)cfDarrData(opcodeArray);
+        const size_t opcodeCount = cfDarrLength(opcodeArray);
+
+        qsort(opcodes, opcodeCount, sizeof(OpcodeProfile), compareOpcodeTimes);
+
+        printf("\n%-40s %16s %16s %8s\n", "opcode", "count", "time", "time, %");
+        for (size_t i = 0; i < opcodeCount && i < options.displayCount; i++)
+            printf("%-40s %16llu %16llu %8.2f\n",
+                opcodes[i].name,
+                (unsigned long long)opcodes[i].count,
+                (unsigned long long)opcodes[i].time,
+                (double)opcodes[i].time * timeScale
+            );
+    }
+
+    cfDarrDtor(symbolArray);
+    cfDarrDtor(opcodeArray);
+
+    return 0;
+} // main
+
+// main.c
@@ -0,0 +1,183 @@
+/**
+ * @brief compressed executable container benchmark utility
+ *
+ * @note executable is written in both formats into temporary files, so load time includes
+ * file reading (from page cache), hash verification and decompression (for compressed one).
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <cf_executable.h>
+#include <cf_cli.h>
+
+/**
+ * @brief help printing function
+ */
+void printHelp( void ) {
+    puts(
+        "Usage:  bench_container [options] input\n"
+        "\n"
+        "Options:\n"
+        "    -h              Display this message\n"
+        "    -r <count>      Repeat each measurement <count> times (default: 20)\n"
+    );
+} // printHelp
+
+/**
+ * @brief monotonic time getting function
+ *
+ * @return time (in seconds)
+ */
+static double getTime( void ) {
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+} // getTime
+
+/**
+ * @brief executable loading time measuring function
+ *
+ * @param[in] file     file executable is written to (opened for binary reading)
+ * @param[in] runCount count of measurements
+ * @param[in] expected executable that should be loaded (non-null)
+ *
+ * @return minimal load time (in seconds, negative if executable can't be loaded)
+ */
+static double measureLoad( FILE *const file, const size_t runCount, const CfExecutable *const expected ) {
+    double bestTime = -1.0;
+
+    for (size_t run = 0; run < runCount; run++) {
+        CfExecutable executable;
+
+        rewind(file);
+
+        const double start = getTime();
+        const CfExecutableReadStatus status = cfExecutableRead(file, &executable);
+        const double end = getTime();
+
+        if (status != CF_EXECUTABLE_READ_STATUS_OK) {
+            printf("executable loading error: %s\n", cfExecutableReadStatusStr(status));
+            return -1.0;
+        }
+
+        // both formats must be loaded into the same executable
+        const bool isSame = true
+            && executable.codeLength == expected->codeLength
+            && executable.segmentCount == expected->segmentCount
+            && 0 == memcmp(executable.code, expected->code, expected->codeLength)
+        ;
+        cfExecutableDtor(&executable);
+
+        if (!isSame) {
+            printf("loaded executable mismatch.\n");
+            return -1.0;
+        }
+
+        if (bestTime < 0.0 || end - start < bestTime)
+            bestTime = end - start;
+    }
+
+    return bestTime;
+} // measureLoad
+
+int main( const int argc, const char **argv ) {
+    if (argc < 2 || 0 == strcmp(argv[1], "-h")) {
+        printHelp();
+        return 0;
+    }
+
+    const int optionCount = 2;
+    CfCommandLineOptionInfo optionInfos[2] = {
+        {"h", "help", 0},
+        {"r", "runs", 1},
+    };
+    int optionIndices[2];
+
+    // last argument is treated as input file name
+    if (!cfParseCommandLineOptions(argc - 2, argv + 1, optionCount, optionInfos, optionIndices))
+        return 0;
+
+    if (optionIndices[0] != -1) {
+        printHelp();
+        return 0;
+    }
+
+    struct {
+        const char *inputFileName;
+        size_t runCount;
+    } options = {
+        .inputFileName = argv[argc - 1],
+        .runCount = 20,
+    };
+
+    if (optionIndices[1] != -1)
+        options.runCount = strtoull(argv[optionIndices[1] + 1], NULL, 10);
+    if (options.runCount == 0)
+        options.runCount = 1;
+
+    FILE *input = fopen(options.inputFileName, "rb");
+    if (input == NULL) {
+        printf("input file opening error: %s\n", strerror(errno));
+        return 1;
+    }
+
+    CfExecutable executable;
+    const CfExecutableReadStatus readStatus = cfExecutableRead(input, &executable);
+    fclose(input);
+
+    if (readStatus != CF_EXECUTABLE_READ_STATUS_OK) {
+        printf("input executable reading error: %s\n", cfExecutableReadStatusStr(readStatus));
+        return 1;
+    }
+
+    FILE *rawFile = tmpfile();
+    FILE *compressedFile = tmpfile();
+
+    if (rawFile == NULL || compressedFile == NULL) {
+        printf("temporary file opening error: %s\n", strerror(errno));
+        return 1;
+    }
+
+    const double compressStart = getTime();
+    const bool isCompressedWritten = cfExecutableWriteCompressed(compressedFile, &executable);
+    const double compressEnd = getTime();
+
+    if (!isCompressedWritten || !cfExecutableWrite(rawFile, &executable)) {
+        printf("executable writing failed.\n");
+        return 1;
+    }
+
+    fflush(rawFile);
+    fflush(compressedFile);
+
+    const long rawSize = ftell(rawFile);
+    const long compressedSize = ftell(compressedFile);
+    const double rawTime = measureLoad(rawFile, options.runCount, &executable);
+    const double compressedTime = measureLoad(compressedFile, options.runCount, &executable);
+
+    if (rawTime < 0.0 || compressedTime < 0.0)
+        return 1;
+
+    // machine-readable result line (sizes are in bytes, times are in microseconds)
+    printf("raw=%ld compressed=%ld ratio=%.3f compress=%.1f raw_load=%.1f compressed_load=%.1f\n",
+        rawSize,
+        compressedSize,
+        (double)compressedSize / (double)rawSize,
+        (compressEnd - compressStart) * 1e6,
+        rawTime * 1e6,
+        compressedTime * 1e6
+    );
+
+    fclose(compressedFile);
+    fclose(rawFile);
+    cfExecutableDtor(&executable);
+
+    return 0;
+} // main
+
+// main.c
@@ -0,0 +1,156 @@
+/**
+ * @brief hash throughput benchmark utility
+ *
+ * @note hash implementation is selected at runtime by CPU features, so scalar one is measured
+ * by build with CF_HASH_X86 CMake option turned off.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <cf_hash.h>
+#include <cf_cli.h>
+
+/**
+ * @brief help printing function
+ */
+void printHelp( void ) {
+    puts(
+        "Usage:  bench_hash [options]\n"
+        "\n"
+        "Options:\n"
+        "    -h              Display this message\n"
+        "    -r <count>      Repeat each measurement <count> times (default: 5)\n"
+        "    -s <size>       Set size of each hashed buffer to <size> bytes (default: 1MB)\n"
+        "    -n <count>      Hash <count> buffers (default: 8)\n"
+    );
+} // printHelp
+
+/**
+ * @brief monotonic time getting function
+ *
+ * @return time (in seconds)
+ */
+static double getTime( void ) {
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+} // getTime
+
+int main( const int argc, const char **argv ) {
+    if (argc > 1 && 0 == strcmp(argv[1], "-h")) {
+        printHelp();
+        return 0;
+    }
+
+    const int optionCount = 4;
+    CfCommandLineOptionInfo optionInfos[4] = {
+        {"h", "help",    0},
+        {"r", "runs",    1},
+        {"s", "size",    1},
+        {"n", "buffers", 1},
+    };
+    int optionIndices[4];
+
+    if (!cfParseCommandLineOptions(argc - 1, argv + 1, optionCount, optionInfos, optionIndices))
+        return 0;
+
+    if (optionIndices[0] != -1) {
+        printHelp();
+        return 0;
+    }
+
+    struct {
+        size_t runCount;
+        size_t bufferSize;
+        size_t bufferCount;
+    } options = {
+        .runCount = 5,
+        .bufferSize = (1 << 20), // 1MB
+        .bufferCount = 8,
+    };
+
+    if (optionIndices[1] != -1)
+        options.runCount = strtoull(argv[optionIndices[1] + 1], NULL, 10);
+    if (optionIndices[2] != -1)
+        options.bufferSize = strtoull(argv[optionIndices[2] + 1], NULL, 10);
+    if (optionIndices[3] != -1)
+        options.bufferCount = strtoull(argv[optionIndices[3] + 1], NULL, 10);
+
+    if (options.runCount == 0)
+        options.runCount = 1;
+    if (options.bufferCount == 0)
+        options.bufferCount = 1;
+
+    // buffers have different contents (and slightly different sizes), so multi-buffer lanes don't match
+    uint8_t *storage = (uint8_t *)malloc(options.bufferCount * (options.bufferSize + 64));
+    const void **buffers = (const void **)calloc(options.bufferCount, sizeof(void *));
+    size_t *sizes = (size_t *)calloc(options.bufferCount, sizeof(size_t));
+    CfHash *singleHashes = (CfHash *)calloc(options.bufferCount, sizeof(CfHash));
+    CfHash *manyHashes = (CfHash *)calloc(options.bufferCount, sizeof(CfHash));
+
+    if (storage == NULL || buffers == NULL || sizes == NULL || singleHashes == NULL || manyHashes == NULL) {
+        printf("out of memory.\n");
+        return 1;
+    }
+
+    uint32_t seed = 0x12345678;
+    for (size_t i = 0; i < options.bufferCount * (options.bufferSize + 64); i++) {
+        seed = seed * 1664525 + 1013904223;
+        storage[i] = (uint8_t)(seed >> 24);
+    }
+
+    size_t totalSize = 0;
+    for (size_t i = 0; i < options.bufferCount; i++) {
+        buffers[i] = storage + i * (options.bufferSize + 64);
+        sizes[i] = options.bufferSize + i % 64;
+        totalSize += sizes[i];
+    }
+
+    double singleTime = 0.0;
+    double manyTime = 0.0;
+
+    for (size_t run = 0; run < options.runCount; run++) {
+        const double singleStart = getTime();
+        for (size_t i = 0; i < options.bufferCount; i++)
+            singleHashes[i] = cfHash(buffers[i], sizes[i]);
+        const double singleEnd = getTime();
+
+        cfHashMany(buffers, sizes, options.bufferCount, manyHashes);
+        const double manyEnd = getTime();
+
+        if (run == 0 || singleEnd - singleStart < singleTime)
+            singleTime = singleEnd - singleStart;
+        if (run == 0 || manyEnd - singleEnd < manyTime)
+            manyTime = manyEnd - singleEnd;
+    }
+
+    // both functions must calculate the same hashes
+    for (size_t i = 0; i < options.bufferCount; i++) {
+        if (!cfHashCompare(&singleHashes[i], &manyHashes[i])) {
+            printf("hash mismatch at buffer %zu.\n", i);
+            return 1;
+        }
+    }
+
+    // machine-readable result line (throughput is in MB/s)
+    printf("buffers=%zu size=%zu single=%.1f many=%.1f\n",
+        options.bufferCount,
+        options.bufferSize,
+        totalSize / singleTime / 1e6,
+        totalSize / manyTime / 1e6
+    );
+
+    free(manyHashes);
+    free(singleHashes);
+    free(sizes);
+    free(buffers);
+    free(storage);
+
+    return 0;
+} // main
+
+// main.c
@@ -0,0 +1,171 @@
+/**
+ * @brief VM instruction dispatch benchmark utility
+ * 
+ * @note dispatch mode is selected at VM build time (CF_VM_THREADED_DISPATCH CMake option),
+ * so scripts/bench_vm_dispatch.py builds this utility in both modes and compares results.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <cf_vm.h>
+#include <cf_executable.h>
+#include <cf_cli.h>
+
+#include <sandbox_console.h>
+
+/**
+ * @brief help printing function
+ */
+void printHelp( void ) {
+    puts(
+        "Usage:  bench_vm_dispatch [options] executable\n"
+        "\n"
+        "Options:\n"
+        "    -h              Display this message\n"
+        "    -r <count>      Run executable <count> times (default: 5)\n"
+        "    -f <count>      Stop execution after <count> screen refreshes (default: 0, unlimited)\n"
+        "    -m <size>       Set VM RAM size to <size> bytes (default: 16MB)\n"
+        "    -j              Compile executable into native code before execution (JIT)\n"
+        "    -t              Translate verified executable into register-based code before execution\n"
+        "    -s <count>      Execute by resumable VM yielding every <count> instructions (-j and -t are ignored)\n"
+    );
+} // printHelp
+
+int main( const int argc, const char **argv ) {
+    if (argc < 2 || 0 == strcmp(argv[1], "-h")) {
+        printHelp();
+        return 0;
+    }
+
+    const int optionCount = 7;
+    CfCommandLineOptionInfo optionInfos[7] = {
+        {"r", "runs",      1},
+        {"f", "frames",    1},
+        {"m", "memory",    1},
+        {"h", "help",      0},
+        {"j", "jit",       0},
+        {"t", "translate", 0},
+        {"s", "slice",     1},
+    };
+    int optionIndices[7];
+
+    if (!cfParseCommandLineOptions(argc - 2, argv + 1, optionCount, optionInfos, optionIndices))
+        return 0;
+
+    if (optionIndices[3] != -1) {
+        printHelp();
+        return 0;
+    }
+
+    struct {
+        const char *executablePath;
+        size_t runCount;
+        size_t frameLimit;
+        size_t ramSize;
+        bool useJit;
+        bool useTranslation;
+        uint64_t sliceSize;
+    } options = {
+        .executablePath = argv[argc - 1],
+        .runCount = 5,
+        .frameLimit = 0,
+        .ramSize = (1 << 24), // 16MB
+        .useJit = optionIndices[4] != -1,
+        .useTranslation = optionIndices[5] != -1,
+        .sliceSize = 0,
+    };
+
+    if (optionIndices[0] != -1)
+        options.runCount = strtoull(argv[optionIndices[0] + 1], NULL, 10);
+    if (optionIndices[1] != -1)
+        options.frameLimit = strtoull(argv[optionIndices[1] + 1], NULL, 10);
+    if (optionIndices[2] != -1)
+        options.ramSize = strtoull(argv[optionIndices[2] + 1], NULL, 10);
+    if (optionIndices[6] != -1)
+        options.sliceSize = strtoull(argv[optionIndices[6] + 1], NULL, 10);
+
+    if (options.runCount == 0)
+        options.runCount = 1;
+
+    CfExecutable executable;
+    FILE *inputFile = fopen(options.executablePath, "rb");
+
+    if (inputFile == NULL) {
+        printf("input file opening error: %s\n", strerror(errno));
+        return 1;
+    }
+
+    CfExecutableReadStatus readStatus = cfExecutableRead(inputFile, &executable);
+    fclose(inputFile);
+
+    if (readStatus != CF_EXECUTABLE_READ_STATUS_OK) {
+        printf("input executable file reading error: %s\n", cfExecutableReadStatusStr(readStatus));
+        return 1;
+    }
+
+    double bestTime = 0.0;
+    double totalTime = 0.0;
+    SandboxConsoleContext context = {0};
+
+    for (size_t i = 0; i < options.runCount; i++) {
+        context = (SandboxConsoleContext){ .frameLimit = options.frameLimit };
+
+        CfSandbox sandbox = {0};
+        sandboxConsoleConfigure(&sandbox, &context);
+
+        const CfExecuteInfo execInfo = {
+            .executable     = &executable,
+            .sandbox        = &sandbox,
+            .ramSize        = options.ramSize,
+            .useJit         = options.useJit,
+            .useTranslation = options.useTranslation,
+        };
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        bool executed;
+
+        if (options.sliceSize != 0) {
+            CfVm *vm = cfVmCtor(&execInfo);
+
+            executed = vm != NULL;
+            while (vm != NULL && CF_VM_RESUME_STATUS_YIELDED == cfVmResume(vm, options.sliceSize, 0))
+                ;
+            cfVmDtor(vm);
+        } else {
+            executed = cfExecute(&execInfo);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        if (!executed) {
+            printf("sandbox error occured.\n");
+            cfExecutableDtor(&executable);
+            return 1;
+        }
+
+        const double time = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+        totalTime += time;
+        if (i == 0 || time < bestTime)
+            bestTime = time;
+    }
+
+    // machine-readable result line
+    printf("runs=%zu best=%.6f mean=%.6f frames=%zu term_reason=%d\n",
+        options.runCount,
+        bestTime,
+        totalTime / options.runCount,
+        context.frameCount,
+        (int)context.termInfo.reason
+    );
+
+    cfExecutableDtor(&executable);
+
+    return 0;
+} // main
+
+// main.c
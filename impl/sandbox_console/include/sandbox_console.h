@@ -0,0 +1,54 @@
+/**
+ * @brief headless (stdio-based) sandbox declaration file
+ */
+
+#ifndef SANDBOX_CONSOLE_H_
+#define SANDBOX_CONSOLE_H_
+
+#include <cf_vm.h>
+#include <cf_darr.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief console sandbox context representation structure
+typedef struct SandboxConsoleContext_ {
+    size_t         frameLimit;    ///< count of screen refreshes to stop execution after (0 if unlimited)
+
+    // in-memory number input/output (used instead of stdin/stdout if set)
+    const double * input;         ///< numbers to read (null if numbers are read from stdin)
+    size_t         inputLength;   ///< count of numbers to read
+    CfDarr         output;        ///< written numbers destination (array of doubles, null if numbers are written to stdout)
+
+    // array input/output
+    bool           isArrayBinary; ///< true if arrays are read from stdin and written to stdout as raw (host byte order) elements, not as text
+
+    // execution state
+    size_t         inputPosition; ///< index of next number to read from input
+    size_t         frameCount;    ///< count of screen refreshes performed
+    uint64_t       startTime;     ///< execution start time (monotonic clock, in nanoseconds)
+    CfTermInfo     termInfo;      ///< execution termination info (valid after execution end)
+} SandboxConsoleContext;
+
+/**
+ * @brief VM console sandbox configuration function
+ * 
+ * @param[out] vmSandbox VM sandbox pointer (non-null, zero-initialized)
+ * @param[in]  context   context to configure vm sandbox to be used with (non-null)
+ * 
+ * @note this sandbox has no screen and keyboard: screen refresh is no-op (execution
+ * is stopped after frameLimit refreshes), all keys are released and key waiting fails.
+ * Numbers are read from stdin and written to stdout (or from input and to output if they are set,
+ * so any count of sandboxes may be used concurrently then). Arrays are transferred by single
+ * buffered stream operation per chunk of elements, not by stdio call per element.
+ */
+void sandboxConsoleConfigure( CfSandbox *vmSandbox, SandboxConsoleContext *context );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // !defined(SANDBOX_CONSOLE_H_)
+
+// sandbox_console.h
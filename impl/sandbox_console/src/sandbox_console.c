@@ -0,0 +1,320 @@
+/**
+ * @brief headless (stdio-based) sandbox implementation file
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "sandbox_console.h"
+
+/**
+ * @brief current monotonic time getting function
+ * 
+ * @return time (in nanoseconds)
+ */
+static uint64_t sandboxConsoleGetTime( void ) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+} // sandboxConsoleGetTime
+
+/**
+ * @brief sandbox initialization function
+ * 
+ * @param[in] userContext user context
+ * @param[in] execContext execution context
+ * 
+ * @note matches prototype of 'CfSandbox::initialize' function pointer
+ */
+static bool sandboxConsoleInitialize( void *userContext, const CfExecContext *execContext ) {
+    SandboxConsoleContext *context = (SandboxConsoleContext *)userContext;
+
+    context->inputPosition = 0;
+    context->frameCount = 0;
+    context->startTime = sandboxConsoleGetTime();
+    return true;
+} // sandboxConsoleInitialize
+
+/**
+ * @brief sandbox termination function
+ * 
+ * @param[in] userContext user context
+ * @param[in] termInfo    termination info (non-null)
+ * 
+ * @note matches prototype of 'CfSandbox::terminate' function pointer
+ */
+static void sandboxConsoleTerminate( void *userContext, const CfTermInfo *termInfo ) {
+    assert(termInfo != NULL);
+
+    SandboxConsoleContext *context = (SandboxConsoleContext *)userContext;
+    context->termInfo = *termInfo;
+} // sandboxConsoleTerminate
+
+/**
+ * @brief video mode setting function
+ * 
+ * @note matches prototype of 'CfSandbox::setVideoMode' function pointer
+ */
+static bool sandboxConsoleSetVideoMode(
+    void                 *userContext,
+    CfVideoStorageFormat  storageFormat,
+    CfVideoUpdateMode     updateMode
+) {
+    // there is no screen, so any mode is ok
+    return true;
+} // sandboxConsoleSetVideoMode
+
+/**
+ * @brief screen update function
+ * 
+ * @param[in] userContext user context
+ * 
+ * @return false if frame limit reached, true otherwise
+ * 
+ * @note matches prototype of 'CfSandbox::refreshScreen' function pointer
+ */
+static bool sandboxConsoleRefreshScreen( void *userContext ) {
+    SandboxConsoleContext *context = (SandboxConsoleContext *)userContext;
+
+    context->frameCount++;
+    return context->frameLimit == 0 || context->frameCount < context->frameLimit;
+} // sandboxConsoleRefreshScreen
+
+/**
+ * @brief program execution time (in seconds) getting function
+ * 
+ * @param[in]  userContext user context
+ * @param[out] dst         time destination (non-null)
+ * 
+ * @return true
+ * 
+ * @note matches prototype of 'CfSandbox::getExecutionTime' function pointer
+ */
+static bool sandboxConsoleGetExecutionTime( void *userContext, float *dst ) {
+    SandboxConsoleContext *context = (SandboxConsoleContext *)userContext;
+
+    *dst = (sandboxConsoleGetTime() - context->startTime) / 1e9f;
+    return true;
+} // sandboxConsoleGetExecutionTime
+
+/**
+ * @brief key state getting function
+ * 
+ * @param[in]  userContext user context
+ * @param[in]  key         key to get state of
+ * @param[out] dst         state destination (non-null)
+ * 
+ * @return true if key is valid, false otherwise
+ * 
+ * @note matches prototype of 'CfSandbox::getKeyState' function pointer
+ */
+static bool sandboxConsoleGetKeyState( void *userContext, CfKey key, bool *dst ) {
+    assert(dst != NULL);
+
+    // there is no keyboard, so all keys are released
+    *dst = false;
+    return (uint32_t)key < (uint32_t)_CF_KEY_MAX;
+} // sandboxConsoleGetKeyState
+
+/**
+ * @brief any key press waiting function
+ * 
+ * @return false, because there is no keyboard to wait key press on
+ * 
+ * @note matches prototype of 'CfSandbox::waitKeyDown' function pointer
+ */
+static bool sandboxConsoleWaitKeyDown( void *userContext, CfKey *dst ) {
+    return false;
+} // sandboxConsoleWaitKeyDown
+
+/**
+ * @brief number from stdin (or from input) reading function
+ * 
+ * @param[in] userContext user context
+ * 
+ * @return read number, -1 if reading failed
+ * 
+ * @note matches prototype of 'CfSandbox::readFloat64' function pointer
+ */
+static double sandboxConsoleReadFloat64( void *userContext ) {
+    SandboxConsoleContext *context = (SandboxConsoleContext *)userContext;
+
+    if (context->input != NULL)
+        return context->inputPosition < context->inputLength
+            ? context->input[context->inputPosition++]
+            : -1;
+
+    double number;
+    if (scanf("%lf", &number) != 1)
+        return -1;
+    return number;
+} // sandboxConsoleReadFloat64
+
+/**
+ * @brief number to stdout (or to output) writing function
+ * 
+ * @param[in] userContext user context
+ * @param[in] number      number to write
+ * 
+ * @note matches prototype of 'CfSandbox::writeFloat64' function pointer
+ */
+static void sandboxConsoleWriteFloat64( void *userContext, double number ) {
+    SandboxConsoleContext *context = (SandboxConsoleContext *)userContext;
+
+    // there's no way to report error, so number is just lost if output can't be extended
+    if (context->output != NULL)
+        cfDarrPush(&context->output, &number);
+    else
+        printf("%lf\n", number);
+} // sandboxConsoleWriteFloat64
+
+/**
+ * @brief array element to double converting function
+ *
+ * @param[in] type    element type
+ * @param[in] element element pointer (non-null, may be unaligned)
+ *
+ * @return element value
+ */
+static double sandboxConsoleArrayElementGet( CfArrayType type, const void *element ) {
+    if (type == CF_ARRAY_TYPE_F32) {
+        float number;
+        memcpy(&number, element, sizeof(number));
+        return number;
+    } else {
+        int32_t number;
+        memcpy(&number, element, sizeof(number));
+        return number;
+    }
+} // sandboxConsoleArrayElementGet
+
+/**
+ * @brief array element from double setting function
+ *
+ * @param[in]  type    element type
+ * @param[out] element element pointer (non-null, may be unaligned)
+ * @param[in]  value   value to set
+ */
+static void sandboxConsoleArrayElementSet( CfArrayType type, void *element, double value ) {
+    if (type == CF_ARRAY_TYPE_F32) {
+        const float number = (float)value;
+        memcpy(element, &number, sizeof(number));
+    } else {
+        const int32_t number = (int32_t)value;
+        memcpy(element, &number, sizeof(number));
+    }
+} // sandboxConsoleArrayElementSet
+
+/**
+ * @brief number array from stdin (or from input) reading function
+ *
+ * @param[in]  userContext user context
+ * @param[in]  type        array element type
+ * @param[out] dst         array destination (non-null)
+ * @param[in]  count       count of elements to read
+ *
+ * @return count of elements read
+ *
+ * @note matches prototype of 'CfSandbox::readArray' function pointer
+ */
+static size_t sandboxConsoleReadArray( void *userContext, CfArrayType type, void *dst, size_t count ) {
+    SandboxConsoleContext *context = (SandboxConsoleContext *)userContext;
+    uint8_t *const elements = (uint8_t *)dst;
+
+    if (context->input != NULL) {
+        const size_t left = context->inputLength - context->inputPosition;
+        const size_t readCount = count < left ? count : left;
+
+        for (size_t i = 0; i < readCount; i++)
+            sandboxConsoleArrayElementSet(type, elements + i * 4, context->input[context->inputPosition++]);
+        return readCount;
+    }
+
+    // element sizes match host ones, so binary array is read in place
+    if (context->isArrayBinary)
+        return fread(dst, 4, count, stdin);
+
+    size_t readCount = 0;
+    for (; readCount < count; readCount++) {
+        double number;
+
+        if (scanf("%lf", &number) != 1)
+            break;
+        sandboxConsoleArrayElementSet(type, elements + readCount * 4, number);
+    }
+    return readCount;
+} // sandboxConsoleReadArray
+
+/**
+ * @brief number array to stdout (or to output) writing function
+ *
+ * @param[in] userContext user context
+ * @param[in] type        array element type
+ * @param[in] src         array to write (non-null)
+ * @param[in] count       count of elements to write
+ *
+ * @return true if succeeded, false otherwise
+ *
+ * @note matches prototype of 'CfSandbox::writeArray' function pointer
+ */
+static bool sandboxConsoleWriteArray( void *userContext, CfArrayType type, const void *src, size_t count ) {
+    SandboxConsoleContext *context = (SandboxConsoleContext *)userContext;
+    const uint8_t *const elements = (const uint8_t *)src;
+
+    if (context->output != NULL) {
+        for (size_t i = 0; i < count; i++) {
+            const double number = sandboxConsoleArrayElementGet(type, elements + i * 4);
+
+            if (CF_DARR_OK != cfDarrPush(&context->output, &number))
+                return false;
+        }
+        return true;
+    }
+
+    if (context->isArrayBinary)
+        return fwrite(src, 4, count, stdout) == count;
+
+    // elements are formatted to buffer that is flushed by single call when it's full
+    char buffer[4096];
+    size_t bufferLength = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        // longest float formatted by "%lf" takes less than 64 characters
+        if (sizeof(buffer) - bufferLength < 64) {
+            if (fwrite(buffer, 1, bufferLength, stdout) != bufferLength)
+                return false;
+            bufferLength = 0;
+        }
+
+        const double number = sandboxConsoleArrayElementGet(type, elements + i * 4);
+        bufferLength += type == CF_ARRAY_TYPE_F32
+            ? snprintf(buffer + bufferLength, sizeof(buffer) - bufferLength, "%lf\n", number)
+            : snprintf(buffer + bufferLength, sizeof(buffer) - bufferLength, "%d\n", (int32_t)number);
+    }
+
+    return fwrite(buffer, 1, bufferLength, stdout) == bufferLength;
+} // sandboxConsoleWriteArray
+
+void sandboxConsoleConfigure( CfSandbox *vmSandbox, SandboxConsoleContext *context ) {
+    vmSandbox->userContext = context;
+
+    vmSandbox->initialize = sandboxConsoleInitialize;
+    vmSandbox->terminate = sandboxConsoleTerminate;
+
+    vmSandbox->setVideoMode = sandboxConsoleSetVideoMode;
+    vmSandbox->refreshScreen = sandboxConsoleRefreshScreen;
+    vmSandbox->getExecutionTime = sandboxConsoleGetExecutionTime;
+
+    vmSandbox->getKeyState = sandboxConsoleGetKeyState;
+    vmSandbox->waitKeyDown = sandboxConsoleWaitKeyDown;
+
+    vmSandbox->readFloat64 = sandboxConsoleReadFloat64;
+    vmSandbox->writeFloat64 = sandboxConsoleWriteFloat64;
+
+    vmSandbox->readArray = sandboxConsoleReadArray;
+    vmSandbox->writeArray = sandboxConsoleWriteArray;
+} // sandboxConsoleConfigure
+
+// sandbox_console.c
@@ -0,0 +1,81 @@
+/**
+ * @brief sandbox input recording/replaying wrapper declaration file
+ */
+
+#ifndef SANDBOX_REPLAY_H_
+#define SANDBOX_REPLAY_H_
+
+#include <stdio.h>
+
+#include <cf_vm.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief replay log file magic
+#define SANDBOX_REPLAY_MAGIC ((uint32_t)0x59504C52) // "RLPY"
+
+/// @brief replay log file version
+#define SANDBOX_REPLAY_VERSION 1
+
+/// @brief replay sandbox mode
+typedef enum SandboxReplayMode_ {
+    SANDBOX_REPLAY_MODE_RECORD, ///< callbacks are forwarded to wrapped sandbox and their results are written to log
+    SANDBOX_REPLAY_MODE_REPLAY, ///< callback results are read from log (output is still passed to wrapped sandbox)
+} SandboxReplayMode;
+
+/// @brief logged callback kind
+typedef enum SandboxReplayEventKind_ {
+    SANDBOX_REPLAY_EVENT_KIND_REFRESH_SCREEN,     ///< refreshScreen (result is status)
+    SANDBOX_REPLAY_EVENT_KIND_SET_VIDEO_MODE,     ///< setVideoMode (argument is packed storage format and update mode, result is status)
+    SANDBOX_REPLAY_EVENT_KIND_GET_EXECUTION_TIME, ///< getExecutionTime (result is status, value is float time bits)
+    SANDBOX_REPLAY_EVENT_KIND_GET_KEY_STATE,      ///< getKeyState (argument is key, result is status, value is key state)
+    SANDBOX_REPLAY_EVENT_KIND_WAIT_KEY_DOWN,      ///< waitKeyDown (result is status, value is key)
+    SANDBOX_REPLAY_EVENT_KIND_READ_FLOAT64,       ///< readFloat64 (value is double bits)
+    SANDBOX_REPLAY_EVENT_KIND_READ_ARRAY,         ///< readArray (argument is element type, result is read element count,
+                                                  ///< value is requested element count, read elements follow event)
+    SANDBOX_REPLAY_EVENT_KIND_WRITE_ARRAY,        ///< writeArray (argument is element type, result is status, value is element count)
+} SandboxReplayEventKind;
+
+/// @brief replay log event (log is file header followed by events in callback order)
+typedef struct SandboxReplayEvent_ {
+    uint64_t index;    ///< event index (callback ordinal, it's execution position of deterministic program)
+    uint32_t kind;     ///< event kind (SandboxReplayEventKind)
+    uint32_t argument; ///< callback argument (meaning depends on kind)
+    uint64_t result;   ///< callback result (meaning depends on kind)
+    uint64_t value;    ///< callback output value (meaning depends on kind)
+} SandboxReplayEvent;
+
+/// @brief replay sandbox context representation structure
+typedef struct SandboxReplayContext_ {
+    const CfSandbox * sandbox;    ///< wrapped sandbox (non-null, valid)
+    SandboxReplayMode mode;       ///< replay sandbox mode
+    FILE            * file;       ///< log file (opened for binary writing if events are recorded and for reading if replayed)
+
+    // execution state
+    uint64_t          eventCount; ///< count of logged events
+    bool              isDiverged; ///< true if log is malformed, can't be written or replayed execution differs from recorded one
+} SandboxReplayContext;
+
+/**
+ * @brief VM replay sandbox configuration function
+ *
+ * @param[out] vmSandbox VM sandbox pointer (non-null, zero-initialized)
+ * @param[in]  context   context to configure vm sandbox to be used with (non-null, sandbox and file are set)
+ *
+ * @note results of all callbacks program input depends on (time, keyboard, numbers and statuses of screen
+ * operations) are logged, so deterministic program requests the same callbacks then replayed. Replayed
+ * callback that differs from the recorded one (or callback after log end) fails. Arrays are
+ * transferred element by element if wrapped sandbox doesn't support array callbacks, so log recorded
+ * with one sandbox (e.g. SDL2-based one) may be replayed with another (e.g. headless one).
+ */
+void sandboxReplayConfigure( CfSandbox *vmSandbox, SandboxReplayContext *context );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // !defined(SANDBOX_REPLAY_H_)
+
+// sandbox_replay.h
@@ -0,0 +1,440 @@
+/**
+ * @brief sandbox input recording/replaying wrapper implementation file
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "sandbox_replay.h"
+
+/**
+ * @brief event logging function
+ *
+ * @param[in,out] context  replay sandbox context (non-null, recording)
+ * @param[in]     kind     event kind
+ * @param[in]     argument callback argument
+ * @param[in]     result   callback result
+ * @param[in]     value    callback output value
+ * @param[in]     data     event data (written after event, nullable if dataSize is 0)
+ * @param[in]     dataSize event data size
+ *
+ * @note log is marked as diverged if event can't be written.
+ */
+static void sandboxReplayWriteEvent(
+    SandboxReplayContext   *const context,
+    const SandboxReplayEventKind  kind,
+    const uint32_t                argument,
+    const uint64_t                result,
+    const uint64_t                value,
+    const void             *const data,
+    const size_t                  dataSize
+) {
+    const SandboxReplayEvent event = {
+        .index    = context->eventCount++,
+        .kind     = (uint32_t)kind,
+        .argument = argument,
+        .result   = result,
+        .value    = value,
+    };
+
+    if (false
+        || 1 != fwrite(&event, sizeof(event), 1, context->file)
+        || (dataSize != 0 && 1 != fwrite(data, dataSize, 1, context->file))
+    )
+        context->isDiverged = true;
+} // sandboxReplayWriteEvent
+
+/**
+ * @brief next logged event reading function
+ *
+ * @param[in,out] context  replay sandbox context (non-null, replaying)
+ * @param[in]     kind     expected event kind
+ * @param[in]     argument expected callback argument
+ * @param[out]    dst      event destination (non-null)
+ *
+ * @return true if event of the same callback is read, false if replayed execution diverged from recorded one
+ */
+static bool sandboxReplayReadEvent(
+    SandboxReplayContext    *const context,
+    const SandboxReplayEventKind   kind,
+    const uint32_t                 argument,
+    SandboxReplayEvent      *const dst
+) {
+    // nothing is replayed after divergence, because log position is unknown then
+    if (false
+        || context->isDiverged
+        || 1 != fread(dst, sizeof(SandboxReplayEvent), 1, context->file)
+        || dst->index != context->eventCount
+        || dst->kind != (uint32_t)kind
+        || dst->argument != argument
+    ) {
+        context->isDiverged = true;
+        return false;
+    }
+
+    context->eventCount++;
+    return true;
+} // sandboxReplayReadEvent
+
+/**
+ * @brief sandbox initialization function
+ *
+ * @param[in] userContext user context
+ * @param[in] execContext execution context
+ *
+ * @return true if log header is valid (or written) and wrapped sandbox is initialized, false otherwise
+ *
+ * @note matches prototype of 'CfSandbox::initialize' function pointer
+ */
+static bool sandboxReplayInitialize( void *userContext, const CfExecContext *execContext ) {
+    SandboxReplayContext *context = (SandboxReplayContext *)userContext;
+    uint32_t header[2] = { SANDBOX_REPLAY_MAGIC, SANDBOX_REPLAY_VERSION };
+
+    context->eventCount = 0;
+    context->isDiverged = false;
+
+    // wrapped sandbox is initialized only if log is ok, because it's not terminated otherwise
+    const bool isHeaderOk = context->mode == SANDBOX_REPLAY_MODE_RECORD
+        ? 1 == fwrite(header, sizeof(header), 1, context->file)
+        : true
+            && 1 == fread(header, sizeof(header), 1, context->file)
+            && header[0] == SANDBOX_REPLAY_MAGIC
+            && header[1] == SANDBOX_REPLAY_VERSION
+    ;
+
+    return isHeaderOk && context->sandbox->initialize(context->sandbox->userContext, execContext);
+} // sandboxReplayInitialize
+
+/**
+ * @brief sandbox termination function
+ *
+ * @param[in] userContext user context
+ * @param[in] termInfo    termination info (non-null)
+ *
+ * @note matches prototype of 'CfSandbox::terminate' function pointer
+ */
+static void sandboxReplayTerminate( void *userContext, const CfTermInfo *termInfo ) {
+    assert(termInfo != NULL);
+
+    SandboxReplayContext *context = (SandboxReplayContext *)userContext;
+
+    if (context->mode == SANDBOX_REPLAY_MODE_RECORD && 0 != fflush(context->file))
+        context->isDiverged = true;
+
+    context->sandbox->terminate(context->sandbox->userContext, termInfo);
+} // sandboxReplayTerminate
+
+/**
+ * @brief screen update function
+ *
+ * @param[in] userContext user context
+ *
+ * @return wrapped sandbox status (recorded one if replaying)
+ *
+ * @note matches prototype of 'CfSandbox::refreshScreen' function pointer
+ */
+static bool sandboxReplayRefreshScreen( void *userContext ) {
+    SandboxReplayContext *context = (SandboxReplayContext *)userContext;
+    const bool isOk = context->sandbox->refreshScreen(context->sandbox->userContext);
+
+    if (context->mode == SANDBOX_REPLAY_MODE_RECORD) {
+        sandboxReplayWriteEvent(context, SANDBOX_REPLAY_EVENT_KIND_REFRESH_SCREEN, 0, isOk, 0, NULL, 0);
+        return isOk;
+    }
+
+    // screen is still refreshed, but its status (e.g. window closing) is replayed
+    SandboxReplayEvent event;
+    return sandboxReplayReadEvent(context, SANDBOX_REPLAY_EVENT_KIND_REFRESH_SCREEN, 0, &event) && event.result != 0;
+} // sandboxReplayRefreshScreen
+
+/**
+ * @brief video mode setting function
+ *
+ * @return wrapped sandbox status (recorded one if replaying)
+ *
+ * @note matches prototype of 'CfSandbox::setVideoMode' function pointer
+ */
+static bool sandboxReplaySetVideoMode(
+    void                 *userContext,
+    CfVideoStorageFormat  storageFormat,
+    CfVideoUpdateMode     updateMode
+) {
+    SandboxReplayContext *context = (SandboxReplayContext *)userContext;
+    const uint32_t argument = (uint32_t)storageFormat | (uint32_t)updateMode << 16;
+    const bool isOk = context->sandbox->setVideoMode(context->sandbox->userContext, storageFormat, updateMode);
+
+    if (context->mode == SANDBOX_REPLAY_MODE_RECORD) {
+        sandboxReplayWriteEvent(context, SANDBOX_REPLAY_EVENT_KIND_SET_VIDEO_MODE, argument, isOk, 0, NULL, 0);
+        return isOk;
+    }
+
+    SandboxReplayEvent event;
+    return sandboxReplayReadEvent(context, SANDBOX_REPLAY_EVENT_KIND_SET_VIDEO_MODE, argument, &event) && event.result != 0;
+} // sandboxReplaySetVideoMode
+
+/**
+ * @brief program execution time (in seconds) getting function
+ *
+ * @param[in]  userContext user context
+ * @param[out] dst         time destination (non-null)
+ *
+ * @return wrapped sandbox status (recorded one if replaying)
+ *
+ * @note matches prototype of 'CfSandbox::getExecutionTime' function pointer
+ */
+static bool sandboxReplayGetExecutionTime( void *userContext, float *dst ) {
+    SandboxReplayContext *context = (SandboxReplayContext *)userContext;
+
+    if (context->mode == SANDBOX_REPLAY_MODE_RECORD) {
+        const bool isOk = context->sandbox->getExecutionTime(context->sandbox->userContext, dst);
+        uint32_t bits = 0;
+
+        memcpy(&bits, dst, sizeof(bits));
+        sandboxReplayWriteEvent(context, SANDBOX_REPLAY_EVENT_KIND_GET_EXECUTION_TIME, 0, isOk, bits, NULL, 0);
+        return isOk;
+    }
+
+    SandboxReplayEvent event;
+    if (!sandboxReplayReadEvent(context, SANDBOX_REPLAY_EVENT_KIND_GET_EXECUTION_TIME, 0, &event))
+        return false;
+
+    const uint32_t bits = (uint32_t)event.value;
+    memcpy(dst, &bits, sizeof(bits));
+    return event.result != 0;
+} // sandboxReplayGetExecutionTime
+
+/**
+ * @brief key state getting function
+ *
+ * @param[in]  userContext user context
+ * @param[in]  key         key to get state of
+ * @param[out] dst         state destination (non-null)
+ *
+ * @return wrapped sandbox status (recorded one if replaying)
+ *
+ * @note matches prototype of 'CfSandbox::getKeyState' function pointer
+ */
+static bool sandboxReplayGetKeyState( void *userContext, CfKey key, bool *dst ) {
+    assert(dst != NULL);
+
+    SandboxReplayContext *context = (SandboxReplayContext *)userContext;
+
+    if (context->mode == SANDBOX_REPLAY_MODE_RECORD) {
+        const bool isOk = context->sandbox->getKeyState(context->sandbox->userContext, key, dst);
+
+        sandboxReplayWriteEvent(context, SANDBOX_REPLAY_EVENT_KIND_GET_KEY_STATE, (uint32_t)key, isOk, *dst, NULL, 0);
+        return isOk;
+    }
+
+    SandboxReplayEvent event;
+    if (!sandboxReplayReadEvent(context, SANDBOX_REPLAY_EVENT_KIND_GET_KEY_STATE, (uint32_t)key, &event))
+        return false;
+
+    *dst = event.value != 0;
+    return event.result != 0;
+} // sandboxReplayGetKeyState
+
+/**
+ * @brief any key press waiting function
+ *
+ * @param[in]  userContext user context
+ * @param[out] dst         pressed key destination (non-null)
+ *
+ * @return wrapped sandbox status (recorded one if replaying)
+ *
+ * @note matches prototype of 'CfSandbox::waitKeyDown' function pointer
+ */
+static bool sandboxReplayWaitKeyDown( void *userContext, CfKey *dst ) {
+    assert(dst != NULL);
+
+    SandboxReplayContext *context = (SandboxReplayContext *)userContext;
+
+    if (context->mode == SANDBOX_REPLAY_MODE_RECORD) {
+        const bool isOk = context->sandbox->waitKeyDown(context->sandbox->userContext, dst);
+
+        sandboxReplayWriteEvent(context, SANDBOX_REPLAY_EVENT_KIND_WAIT_KEY_DOWN, 0, isOk, isOk ? (uint64_t)*dst : 0, NULL, 0);
+        return isOk;
+    }
+
+    // key press is not waited for
+    SandboxReplayEvent event;
+    if (!sandboxReplayReadEvent(context, SANDBOX_REPLAY_EVENT_KIND_WAIT_KEY_DOWN, 0, &event))
+        return false;
+
+    *dst = (CfKey)event.value;
+    return event.result != 0;
+} // sandboxReplayWaitKeyDown
+
+/**
+ * @brief number reading function
+ *
+ * @param[in] userContext user context
+ *
+ * @return read number (recorded one if replaying), -1 if replayed execution diverged
+ *
+ * @note matches prototype of 'CfSandbox::readFloat64' function pointer
+ */
+static double sandboxReplayReadFloat64( void *userContext ) {
+    SandboxReplayContext *context = (SandboxReplayContext *)userContext;
+    double number;
+    uint64_t bits;
+
+    if (context->mode == SANDBOX_REPLAY_MODE_RECORD) {
+        number = context->sandbox->readFloat64(context->sandbox->userContext);
+
+        memcpy(&bits, &number, sizeof(bits));
+        sandboxReplayWriteEvent(context, SANDBOX_REPLAY_EVENT_KIND_READ_FLOAT64, 0, 0, bits, NULL, 0);
+        return number;
+    }
+
+    SandboxReplayEvent event;
+    if (!sandboxReplayReadEvent(context, SANDBOX_REPLAY_EVENT_KIND_READ_FLOAT64, 0, &event))
+        return -1;
+
+    bits = event.value;
+    memcpy(&number, &bits, sizeof(number));
+    return number;
+} // sandboxReplayReadFloat64
+
+/**
+ * @brief number writing function
+ *
+ * @param[in] userContext user context
+ * @param[in] number      number to write
+ *
+ * @note numbers are written by wrapped sandbox in both modes, so there's nothing to log.
+ * @note matches prototype of 'CfSandbox::writeFloat64' function pointer
+ */
+static void sandboxReplayWriteFloat64( void *userContext, double number ) {
+    SandboxReplayContext *context = (SandboxReplayContext *)userContext;
+
+    context->sandbox->writeFloat64(context->sandbox->userContext, number);
+} // sandboxReplayWriteFloat64
+
+/**
+ * @brief number array reading function
+ *
+ * @param[in]  userContext user context
+ * @param[in]  type        array element type
+ * @param[out] dst         array destination (non-null)
+ * @param[in]  count       count of elements to read
+ *
+ * @return count of elements read (recorded one if replaying, 0 if replayed execution diverged)
+ *
+ * @note array is read by wrapped sandbox element by element (in the same way as VM does it) if it
+ * doesn't read arrays, so log doesn't depend on array support of wrapped sandbox.
+ * @note matches prototype of 'CfSandbox::readArray' function pointer
+ */
+static size_t sandboxReplayReadArray( void *userContext, CfArrayType type, void *dst, size_t count ) {
+    SandboxReplayContext *context = (SandboxReplayContext *)userContext;
+
+    if (context->mode == SANDBOX_REPLAY_MODE_RECORD) {
+        const CfSandbox *const sandbox = context->sandbox;
+        size_t readCount = count;
+
+        if (sandbox->readArray != NULL)
+            readCount = sandbox->readArray(sandbox->userContext, type, dst, count);
+        else
+            for (size_t i = 0; i < count; i++) {
+                const double number = sandbox->readFloat64(sandbox->userContext);
+                union {
+                    float   f32;
+                    int32_t i32;
+                } element;
+
+                if (type == CF_ARRAY_TYPE_F32)
+                    element.f32 = (float)number;
+                else
+                    element.i32 = (int32_t)number;
+                memcpy((uint8_t *)dst + i * 4, &element, 4);
+            }
+
+        sandboxReplayWriteEvent(context, SANDBOX_REPLAY_EVENT_KIND_READ_ARRAY, (uint32_t)type, readCount, count, dst, readCount * 4);
+        return readCount;
+    }
+
+    // read elements are stored in log as they're stored in VM memory
+    SandboxReplayEvent event;
+    if (false
+        || !sandboxReplayReadEvent(context, SANDBOX_REPLAY_EVENT_KIND_READ_ARRAY, (uint32_t)type, &event)
+        || event.value != count
+        || event.result > count
+        || (event.result != 0 && 1 != fread(dst, (size_t)event.result * 4, 1, context->file))
+    ) {
+        context->isDiverged = true;
+        return 0;
+    }
+
+    return (size_t)event.result;
+} // sandboxReplayReadArray
+
+/**
+ * @brief number array writing function
+ *
+ * @param[in] userContext user context
+ * @param[in] type        array element type
+ * @param[in] src         array to write (non-null)
+ * @param[in] count       count of elements to write
+ *
+ * @return wrapped sandbox status (recorded one if replaying)
+ *
+ * @note matches prototype of 'CfSandbox::writeArray' function pointer
+ */
+static bool sandboxReplayWriteArray( void *userContext, CfArrayType type, const void *src, size_t count ) {
+    SandboxReplayContext *context = (SandboxReplayContext *)userContext;
+    const CfSandbox *const sandbox = context->sandbox;
+    bool isOk = true;
+
+    if (sandbox->writeArray != NULL)
+        isOk = sandbox->writeArray(sandbox->userContext, type, src, count);
+    else
+        for (size_t i = 0; i < count; i++) {
+            union {
+                float   f32;
+                int32_t i32;
+            } element;
+
+            memcpy(&element, (const uint8_t *)src + i * 4, 4);
+            sandbox->writeFloat64(
+                sandbox->userContext,
+                type == CF_ARRAY_TYPE_F32 ? (double)element.f32 : (double)element.i32
+            );
+        }
+
+    if (context->mode == SANDBOX_REPLAY_MODE_RECORD) {
+        sandboxReplayWriteEvent(context, SANDBOX_REPLAY_EVENT_KIND_WRITE_ARRAY, (uint32_t)type, isOk, count, NULL, 0);
+        return isOk;
+    }
+
+    SandboxReplayEvent event;
+    return true
+        && sandboxReplayReadEvent(context, SANDBOX_REPLAY_EVENT_KIND_WRITE_ARRAY, (uint32_t)type, &event)
+        && event.value == count
+        && event.result != 0
+    ;
+} // sandboxReplayWriteArray
+
+void sandboxReplayConfigure( CfSandbox *vmSandbox, SandboxReplayContext *context ) {
+    assert(context->sandbox != NULL);
+    assert(context->file != NULL);
+
+    vmSandbox->userContext = context;
+
+    vmSandbox->initialize = sandboxReplayInitialize;
+    vmSandbox->terminate = sandboxReplayTerminate;
+
+    vmSandbox->setVideoMode = sandboxReplaySetVideoMode;
+    vmSandbox->refreshScreen = sandboxReplayRefreshScreen;
+    vmSandbox->getExecutionTime = sandboxReplayGetExecutionTime;
+
+    vmSandbox->getKeyState = sandboxReplayGetKeyState;
+    vmSandbox->waitKeyDown = sandboxReplayWaitKeyDown;
+
+    vmSandbox->readFloat64 = sandboxReplayReadFloat64;
+    vmSandbox->writeFloat64 = sandboxReplayWriteFloat64;
+
+    vmSandbox->readArray = sandboxReplayReadArray;
+    vmSandbox->writeArray = sandboxReplayWriteArray;
+} // sandboxReplayConfigure
+
+// sandbox_replay.c
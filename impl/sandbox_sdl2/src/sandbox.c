@@ -543,6 +543,18 @@ static void sandboxTerminate( void *userContext, const CfTermInfo *termInfo ) {
         printf("operand stack underflow.");
         break;
     }
+    case CF_TERM_REASON_STACK_OVERFLOW      : {
+        printf("operand stack overflow.");
+        break;
+    }
+    case CF_TERM_REASON_CALL_STACK_OVERFLOW : {
+        printf("call stack overflow.");
+        break;
+    }
+    case CF_TERM_REASON_SNAPSHOT_ERROR      : {
+        printf("snapshot writing failed.");
+        break;
+    }
     }
 } // sandboxTerminate
 
@@ -30,12 +30,23 @@ typedef enum CfAssemblyStatus_ {
     CF_ASSEMBLY_STATUS_INVALID_JUMP_ARGUMENT,    ///< invalid jump-family instructino argument
     CF_ASSEMBLY_STATUS_JUMP_ARGUMENT_MISSING,    ///< jump-family instruction argument missing
 
+    CF_ASSEMBLY_STATUS_INVALID_CONDITION,        ///< invalid condition of compare-and-set instruction family
+    CF_ASSEMBLY_STATUS_CONDITION_MISSING,        ///< compare-and-set instruction family condition missing
+
+    CF_ASSEMBLY_STATUS_INVALID_FILL_WIDTH,       ///< invalid element bit width of 'mset' instruction (8 or 32 expected)
+    CF_ASSEMBLY_STATUS_FILL_WIDTH_MISSING,       ///< 'mset' instruction element bit width missing
+
     CF_ASSEMBLY_STATUS_EMPTY_LABEL,              ///< label must not be empty
     CF_ASSEMBLY_STATUS_TOO_LONG_LABEL,           ///< label is longer than CF_LABEL_MAX
 
     CF_ASSEMBLY_STATUS_INVALID_CONSTANT_VALUE,   ///< invalid constant value
 
     CF_ASSEMBLY_STATUS_UNEXPECTED_CHARACTERS,    ///< unexpected (a.k.a. unrelated to instruction) characters occured.
+
+    CF_ASSEMBLY_STATUS_UNKNOWN_DIRECTIVE,          ///< unknown directive
+    CF_ASSEMBLY_STATUS_INVALID_DIRECTIVE_ARGUMENT, ///< invalid (or missing) directive argument
+    CF_ASSEMBLY_STATUS_DATA_OUTSIDE_SEGMENT,       ///< data directive is used outside of data segment
+    CF_ASSEMBLY_STATUS_INSTRUCTION_OUTSIDE_CODE,   ///< instruction is used inside of data segment
 } CfAssemblyStatus;
 
 /// @brief detailed info about assembling process
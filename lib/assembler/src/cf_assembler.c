@@ -22,6 +22,10 @@ typedef struct CfAssembler_ {
     CfDarr            output;       ///< assembler output data
     CfDarr            links;        ///< set of links to labels in this file
     CfDarr            labels;       ///< set of labels declared in file
+    CfDarr            segments;     ///< set of RAM segments declared in file
+    CfDarr            segmentData;  ///< contents of current segment
+    bool              isInSegment;  ///< true if lines are assembled into last segment instead of code
+    char              entry[CF_LABEL_MAX]; ///< entry point label (empty if not declared)
 
     CfAssemblyDetails details;      ///< details
     CfAssemblyStatus  status;       ///< assembling status (**must not** be accessed directly)
@@ -33,8 +37,10 @@ typedef enum CfAssemblerTokenType_ {
     CF_ASSEMBLER_TOKEN_TYPE_LEFT_SQUARE_BRACKET,  ///< '['
     CF_ASSEMBLER_TOKEN_TYPE_RIGHT_SQUARE_BRACKET, ///< ']'
     CF_ASSEMBLER_TOKEN_TYPE_PLUS,                 ///< '+'
+    CF_ASSEMBLER_TOKEN_TYPE_ASTERISK,             ///< '*'
     CF_ASSEMBLER_TOKEN_TYPE_COLON,                ///< ':'
     CF_ASSEMBLER_TOKEN_TYPE_EQUAL,                ///< '='
+    CF_ASSEMBLER_TOKEN_TYPE_DOT,                  ///< '.'
     CF_ASSEMBLER_TOKEN_TYPE_IDENTIFIER,           ///< identifier
     CF_ASSEMBLER_TOKEN_TYPE_FLOATING,             ///< floating point number
     CF_ASSEMBLER_TOKEN_TYPE_INTEGER,              ///< integer number
@@ -87,6 +93,33 @@ void cfAssemblerFinish( CfAssembler *const self, const CfAssemblyStatus status )
     longjmp(self->finishBuffer, true);
 } // cfAssemblerFinish
 
+/**
+ * @brief current segment closing function
+ *
+ * @param[in,out] self assembler pointer
+ *
+ * @note segment contents are moved from segmentData into segment, lines are assembled into code after it.
+ */
+static void cfAssemblerCloseSegment( CfAssembler *const self ) {
+    if (!self->isInSegment)
+        return;
+
+    CfSegment *const segment = (CfSegment *)cfDarrData(self->segments) + cfDarrLength(self->segments) - 1;
+    const size_t size = cfDarrLength(self->segmentData);
+
+    self->isInSegment = false;
+
+    // segment must fit into VM address space
+    if ((uint64_t)segment->address + size > ((uint64_t)1 << 32))
+        cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_DIRECTIVE_ARGUMENT);
+
+    segment->size = (uint32_t)size;
+    if (size != 0 && cfDarrIntoData(self->segmentData, (void **)&segment->data) != CF_DARR_OK)
+        cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INTERNAL_ERROR);
+
+    cfDarrClear(self->segmentData);
+} // cfAssemblerCloseSegment
+
 /**
  * @brief next line parsing function
  * 
@@ -99,8 +132,10 @@ void cfAssemblerNextLine( CfAssembler *const self ) {
     CfStr slice;
 
     do {
-        if (self->textRest.begin >= self->textRest.end)
+        if (self->textRest.begin >= self->textRest.end) {
+            cfAssemblerCloseSegment(self);
             cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_OK);
+        }
 
         // find line end
         const char *lineEnd = self->textRest.begin;
@@ -171,7 +206,9 @@ bool cfAssemblerNextToken( CfAssembler *const self, CfAssemblerToken *const dst
         case ']': tokenType = CF_ASSEMBLER_TOKEN_TYPE_RIGHT_SQUARE_BRACKET; break;
         case ':': tokenType = CF_ASSEMBLER_TOKEN_TYPE_COLON;                break;
         case '+': tokenType = CF_ASSEMBLER_TOKEN_TYPE_PLUS;                 break;
+        case '*': tokenType = CF_ASSEMBLER_TOKEN_TYPE_ASTERISK;             break;
         case '=': tokenType = CF_ASSEMBLER_TOKEN_TYPE_EQUAL;                break;
+        case '.': tokenType = CF_ASSEMBLER_TOKEN_TYPE_DOT;                  break;
         default:
             parsed = false;
         }
@@ -311,6 +348,24 @@ static bool cfAssemblerParseOpcode( CfStr identifier, CfOpcode *dst ) {
         {OPCODE_HASH("mgs"         ), CF_OPCODE_MGS         },
         {OPCODE_HASH("igks"        ), CF_OPCODE_IGKS        },
         {OPCODE_HASH("iwkd"        ), CF_OPCODE_IWKD        },
+        {OPCODE_HASH("mov"         ), CF_OPCODE_MOV         },
+        {OPCODE_HASH("ppush"       ), CF_OPCODE_PPUSH       },
+        {OPCODE_HASH("cset"        ), CF_OPCODE_CSET        },
+        {OPCODE_HASH("icset"       ), CF_OPCODE_ICSET       },
+        {OPCODE_HASH("fcset"       ), CF_OPCODE_FCSET       },
+        {OPCODE_HASH("jz\0"        ), CF_OPCODE_JZ          },
+        {OPCODE_HASH("jnz"         ), CF_OPCODE_JNZ         },
+        {OPCODE_HASH("snap"        ), CF_OPCODE_SNAP        },
+        {OPCODE_HASH("vld\0"       ), CF_OPCODE_VLD         },
+        {OPCODE_HASH("vst\0"       ), CF_OPCODE_VST         },
+        {OPCODE_HASH("vadd"        ), CF_OPCODE_VADD        },
+        {OPCODE_HASH("vsub"        ), CF_OPCODE_VSUB        },
+        {OPCODE_HASH("vmul"        ), CF_OPCODE_VMUL        },
+        {OPCODE_HASH("vdot"        ), CF_OPCODE_VDOT        },
+        {OPCODE_HASH("vbcast"      ), CF_OPCODE_VBCAST      },
+        {OPCODE_HASH("vsqrt"       ), CF_OPCODE_VSQRT       },
+        {OPCODE_HASH("mcpy"        ), CF_OPCODE_MCPY        },
+        {OPCODE_HASH("mset"        ), CF_OPCODE_MSET        },
     };
     static const size_t opcodeHashTableSize = sizeof(opcodeHashTable) / sizeof(opcodeHashTable[0]);
 
@@ -379,7 +434,8 @@ static bool cfAssemblerParseRegister( CfAssembler *const self, CfStr identifier,
 
 /// @brief pushPopInfo full description
 typedef struct CfAssemblerPushPopInfoData_ {
-    CfPushPopInfo info; ///< pushPopInfo
+    CfPushPopInfo  info;  ///< pushPopInfo
+    CfPushPopIndex index; ///< pushPopIndex (valid only if pushPopInfo.isIndexed is set to 1)
 
     ///< true if 'literal' value is valid in immediate, false if 'label'.
     ///< This field is ok to read only in case if pushPopInfo.doReadImmediate is set to 1.
@@ -440,254 +496,396 @@ static bool cfAssemblerParsePushPopInfoImmediate(
 } // cfAssemblerParsePushPopInfoImmediate
 
 /**
- * @brief push/pop info or register from token parsing function
- * 
- * @param[in]  self  assembler pointer
- * @param[in]  token token to read
- * @param[out] data  reading destination
+ * @brief memory access size prefix ('byte' or 'word') from token parsing function
+ *
+ * @param[in]  token token to parse prefix from
+ * @param[out] dst   access size destination (non-null)
+ *
+ * @return true if parsed, false if not
  */
-static void cfAssemblerParsePushPopInfoImmediateOrRegister(
-    CfAssembler                *const self,
-    const CfAssemblerToken     *const token,
-    CfAssemblerPushPopInfoData *const data
-) {
-    uint8_t registerIndex = 0;
-
-    if (true
-        && token->type == CF_ASSEMBLER_TOKEN_TYPE_IDENTIFIER
-        && cfAssemblerParseRegister(self, token->identifier, &registerIndex)
-    ) {
-        data->info.doReadImmediate = false;
-        data->info.registerIndex = registerIndex;
-    } else if (cfAssemblerParsePushPopInfoImmediate(self, token, data)) {
-        data->info.doReadImmediate = true;
-        data->info.registerIndex = 0;
-    } else {
-        cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
+static bool cfAssemblerParseAccessSize( const CfAssemblerToken *const token, CfAccessSize *const dst ) {
+    if (token->type != CF_ASSEMBLER_TOKEN_TYPE_IDENTIFIER)
+        return false;
+
+    if (cfStrIsSame(token->identifier, CF_STR("byte"))) {
+        *dst = CF_ACCESS_SIZE_8;
+        return true;
     }
-} // cfAssemblerParsePushPopInfoImmediateOrRegister
+
+    if (cfStrIsSame(token->identifier, CF_STR("word"))) {
+        *dst = CF_ACCESS_SIZE_16;
+        return true;
+    }
+
+    return false;
+} // cfAssemblerParseAccessSize
 
 /**
- * @brief push/pop info parsing function
+ * @brief push/pop info from token sequence parsing function
  *
- * @param[in] self assembler poniter
- * @param[in] data push/pop info full description pointer
+ * @param[in]  self       assembler pointer
+ * @param[in]  tokens     tokens to parse push/pop info from
+ * @param[in]  tokenCount token count
+ * @param[out] data       parsing destination
+ *
+ * @note push/pop info is optional access size prefix and sum of up to two registers (one of them may be
+ * scaled by 1, 2, 4 or 8) and immediate that is enclosed into square brackets in case of memory access,
+ * e.g. 'ax', 'bx + 4', '[ax + cx * 4 + label]' or 'byte [ax + bx]'.
  */
-static void cfAssemblerParsePushPopInfo2(
-    CfAssembler *const self,
+static void cfAssemblerParsePushPopInfoTokens(
+    CfAssembler                *const self,
+    const CfAssemblerToken     *const tokens,
+    uint32_t                          tokenCount,
     CfAssemblerPushPopInfoData *const data
 ) {
-    CfAssemblerToken tokens[5] = {};
-    uint32_t tokenCount = 0;
+    const CfAssemblerToken *token = tokens;
+    CfAccessSize accessSize = CF_ACCESS_SIZE_32;
 
-    for (uint32_t i = 0; i < 5; i++) {
-        if (!cfAssemblerNextToken(self, &tokens[tokenCount]))
-            break;
-        tokenCount++;
+    // parse access size prefix
+    if (tokenCount >= 2 && cfAssemblerParseAccessSize(&token[0], &accessSize)) {
+        if (token[1].type != CF_ASSEMBLER_TOKEN_TYPE_LEFT_SQUARE_BRACKET)
+            cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
+        token++;
+        tokenCount--;
     }
 
-    if (tokenCount == 5) {
-        // validate token types
-        if (false
-            || tokens[0].type != CF_ASSEMBLER_TOKEN_TYPE_LEFT_SQUARE_BRACKET
-            || tokens[1].type != CF_ASSEMBLER_TOKEN_TYPE_IDENTIFIER
-            || tokens[2].type != CF_ASSEMBLER_TOKEN_TYPE_PLUS
-            || !cfAssemblerParsePushPopInfoImmediate(self, &tokens[3], data)
-            || tokens[4].type != CF_ASSEMBLER_TOKEN_TYPE_RIGHT_SQUARE_BRACKET
-        ) {
-            cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
-        }
+    data->info.accessSize = accessSize;
+    data->info.isMemoryAccess = tokenCount >= 1 && token[0].type == CF_ASSEMBLER_TOKEN_TYPE_LEFT_SQUARE_BRACKET;
 
-        uint8_t regNum = 0;
-        if (!cfAssemblerParseRegister(self, tokens[1].identifier, &regNum))
-            cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_UNKNOWN_REGISTER);
+    if (data->info.isMemoryAccess) {
+        if (tokenCount < 2 || token[tokenCount - 1].type != CF_ASSEMBLER_TOKEN_TYPE_RIGHT_SQUARE_BRACKET)
+            cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
+        token++;
+        tokenCount -= 2;
+    }
 
-        data->info.isMemoryAccess = true;
-        data->info.doReadImmediate = true;
-        data->info.registerIndex = regNum;
+    uint8_t registers[2] = {0};
+    uint32_t registerCount = 0;
+    bool isScaled = false;
+    uint8_t scaledRegister = 0;
+    uint8_t scaleShift = 0;
+    bool hasImmediate = false;
+
+    // parse terms
+    for (uint32_t i = 0;;) {
+        // empty sum or trailing '+'
+        if (i >= tokenCount)
+            cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
 
-        return;
-    }
+        const CfAssemblerToken *const term = &token[i++];
+        uint8_t registerIndex = 0;
 
-    if (tokenCount == 3) {
         if (true
-            && tokens[0].type == CF_ASSEMBLER_TOKEN_TYPE_LEFT_SQUARE_BRACKET
-            && tokens[2].type == CF_ASSEMBLER_TOKEN_TYPE_RIGHT_SQUARE_BRACKET
-        ) {
-            data->info.isMemoryAccess = true;
-            cfAssemblerParsePushPopInfoImmediateOrRegister(self, &tokens[1], data);
-        } else if (true
-            && tokens[0].type == CF_ASSEMBLER_TOKEN_TYPE_IDENTIFIER
-            && tokens[1].type == CF_ASSEMBLER_TOKEN_TYPE_PLUS
-            && cfAssemblerParsePushPopInfoImmediate(self, &tokens[2], data)
+            && term->type == CF_ASSEMBLER_TOKEN_TYPE_IDENTIFIER
+            && cfAssemblerParseRegister(self, term->identifier, &registerIndex)
         ) {
-            uint8_t registerIndex = 0;
-
-            if (!cfAssemblerParseRegister(self, tokens[0].identifier, &registerIndex))
-                cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_UNKNOWN_REGISTER);
+            if (i < tokenCount && token[i].type == CF_ASSEMBLER_TOKEN_TYPE_ASTERISK) {
+                if (false
+                    || isScaled
+                    || i + 1 >= tokenCount
+                    || token[i + 1].type != CF_ASSEMBLER_TOKEN_TYPE_INTEGER
+                )
+                    cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
+
+                switch (token[i + 1].integer) {
+                case 1: scaleShift = 0; break;
+                case 2: scaleShift = 1; break;
+                case 4: scaleShift = 2; break;
+                case 8: scaleShift = 3; break;
+                default:
+                    cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
+                }
 
-            data->info.isMemoryAccess = false;
-            data->info.doReadImmediate = true;
-            data->info.registerIndex = registerIndex;
+                isScaled = true;
+                scaledRegister = registerIndex;
+                i += 2;
+            } else {
+                if (registerCount + (uint32_t)isScaled == 2)
+                    cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
+                registers[registerCount++] = registerIndex;
+            }
         } else {
-            cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
+            if (hasImmediate || !cfAssemblerParsePushPopInfoImmediate(self, term, data))
+                cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
+            hasImmediate = true;
         }
 
-        return;
+        if (i == tokenCount)
+            break;
+
+        if (token[i++].type != CF_ASSEMBLER_TOKEN_TYPE_PLUS)
+            cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
     }
 
-    if (tokenCount == 1) {
-        data->info.isMemoryAccess = false;
-        cfAssemblerParsePushPopInfoImmediateOrRegister(self, &tokens[0], data);
-        return;
+    // scaled register is added to two plain ones
+    if (registerCount + (uint32_t)isScaled > 2)
+        cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
+
+    // unscaled second register is index with scale 1, index with scale 1 and no base is base
+    if (!isScaled && registerCount == 2) {
+        isScaled = true;
+        scaledRegister = registers[--registerCount];
+        scaleShift = 0;
+    } else if (isScaled && scaleShift == 0 && registerCount == 0) {
+        isScaled = false;
+        registers[registerCount++] = scaledRegister;
     }
 
-    cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
-} // cfAssemblerParsePushPopInfo2
+    data->info.registerIndex = registerCount != 0 ? registers[0] : 0;
+    data->info.doReadImmediate = hasImmediate;
+    data->info.isIndexed = isScaled;
+    data->index.asByte = 0;
+    data->index.registerIndex = scaledRegister;
+    data->index.scaleShift = scaleShift;
+} // cfAssemblerParsePushPopInfoTokens
+
+/// @brief maximal count of tokens push/pop info consists of (e.g. 'byte [ax + bx * 4 + 8]')
+#define CF_ASSEMBLER_PUSH_POP_INFO_MAX_TOKEN_COUNT 10
 
 /**
  * @brief push/pop info parsing function
  *
- * @param[in] self    assembler poniter
- * @param[in] dstInfo push/pop info destination (non-null)
- * @param[in] dstImm  corresponding immediate value destination (non-null)
+ * @param[in] self assembler poniter
+ * @param[in] data push/pop info full description pointer
  */
 static void cfAssemblerParsePushPopInfo(
-    CfAssembler   *const self,
-    CfPushPopInfo *const dstInfo,
-    uint32_t      *const dstImm
+    CfAssembler *const self,
+    CfAssemblerPushPopInfoData *const data
 ) {
-    CfAssemblerToken tokens[5] = {};
+    CfAssemblerToken tokens[CF_ASSEMBLER_PUSH_POP_INFO_MAX_TOKEN_COUNT] = {};
     uint32_t tokenCount = 0;
 
-    for (uint32_t i = 0; i < 5; i++) {
+    for (uint32_t i = 0; i < CF_ASSEMBLER_PUSH_POP_INFO_MAX_TOKEN_COUNT; i++) {
         if (!cfAssemblerNextToken(self, &tokens[tokenCount]))
             break;
         tokenCount++;
     }
 
-    if (tokenCount == 5) {
-        // validate token types
-        if (false
-            || tokens[0].type != CF_ASSEMBLER_TOKEN_TYPE_LEFT_SQUARE_BRACKET
-            || tokens[1].type != CF_ASSEMBLER_TOKEN_TYPE_IDENTIFIER
-            || tokens[2].type != CF_ASSEMBLER_TOKEN_TYPE_PLUS
-            || tokens[3].type != CF_ASSEMBLER_TOKEN_TYPE_INTEGER
-            || tokens[4].type != CF_ASSEMBLER_TOKEN_TYPE_RIGHT_SQUARE_BRACKET
-        ) {
-            cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
-        }
-
-        uint8_t regNum = 0;
-        if (!cfAssemblerParseRegister(self, tokens[1].identifier, &regNum))
-            cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_UNKNOWN_REGISTER);
+    cfAssemblerParsePushPopInfoTokens(self, tokens, tokenCount, data);
+} // cfAssemblerParsePushPopInfo
 
-        dstInfo->isMemoryAccess = true;
-        dstInfo->doReadImmediate = true;
-        dstInfo->registerIndex = regNum;
+/**
+ * @brief count of tokens first push/pop info of token sequence consists of getting function
+ *
+ * @param[in] tokens     token sequence
+ * @param[in] tokenCount token sequence length
+ *
+ * @return push/pop info token count (may be incorrect for invalid push/pop info, so it should be checked by parser)
+ */
+static uint32_t cfAssemblerGetPushPopInfoTokenCount(
+    const CfAssemblerToken *const tokens,
+    const uint32_t                tokenCount
+) {
+    if (tokenCount == 0)
+        return 0;
+
+    CfAccessSize accessSize;
+    const uint32_t first = tokenCount >= 2 && cfAssemblerParseAccessSize(&tokens[0], &accessSize) ? 1 : 0;
+
+    // memory access lasts until closing bracket
+    if (tokens[first].type == CF_ASSEMBLER_TOKEN_TYPE_LEFT_SQUARE_BRACKET) {
+        for (uint32_t i = first + 1; i < tokenCount; i++)
+            if (tokens[i].type == CF_ASSEMBLER_TOKEN_TYPE_RIGHT_SQUARE_BRACKET)
+                return i + 1;
+        return tokenCount;
+    }
 
-        *dstImm = tokens[3].integer;
+    return tokenCount >= 3 && tokens[1].type == CF_ASSEMBLER_TOKEN_TYPE_PLUS ? 3 : 1;
+} // cfAssemblerGetPushPopInfoTokenCount
 
+/**
+ * @brief push/pop info immediate writing function
+ *
+ * @param[in,out] self       assembler pointer
+ * @param[in]     data       push/pop info full description (immediate reading flag must be set)
+ * @param[out]    dst        immediate destination (4 bytes, in instruction data)
+ * @param[in]     codeOffset immediate offset in output (used if immediate is label)
+ */
+static void cfAssemblerWritePushPopImmediate(
+    CfAssembler                      *const self,
+    const CfAssemblerPushPopInfoData *const data,
+    uint8_t                          *const dst,
+    const uint32_t                          codeOffset
+) {
+    if (data->immediateIsLiteral) {
+        memcpy(dst, &data->immediate.literal, 4);
         return;
     }
 
-    if (tokenCount == 3) {
-        if (true
-            && tokens[0].type == CF_ASSEMBLER_TOKEN_TYPE_LEFT_SQUARE_BRACKET
-            && tokens[2].type == CF_ASSEMBLER_TOKEN_TYPE_RIGHT_SQUARE_BRACKET
-        ) {
-            dstInfo->isMemoryAccess = true;
+    memset(dst, 0xFF, 4);
 
-            switch (tokens[1].type) {
-            case CF_ASSEMBLER_TOKEN_TYPE_IDENTIFIER: {
-                uint8_t registerIndex = 0;
+    CfLink link = {
+        .sourceLine = (uint32_t)self->lineIndex,
+        .codeOffset = codeOffset,
+    };
+    memcpy(link.label, data->immediate.label, CF_LABEL_MAX);
 
-                if (!cfAssemblerParseRegister(self, tokens[1].identifier, &registerIndex))
-                    cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_UNKNOWN_REGISTER);
-                
-                dstInfo->registerIndex = registerIndex;
-                dstInfo->doReadImmediate = false;
-                break;
-            }
+    if (cfDarrPush(&self->links, &link) != CF_DARR_OK)
+        cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INTERNAL_ERROR);
+} // cfAssemblerWritePushPopImmediate
 
-            case CF_ASSEMBLER_TOKEN_TYPE_INTEGER: {
-                dstInfo->registerIndex = 0;
-                dstInfo->doReadImmediate = true;
+/**
+ * @brief comparison condition from identifier parsing function
+ *
+ * @param[in]  identifier identifier to parse condition from
+ * @param[out] dst        condition destination (non-null)
+ *
+ * @return true if parsed, false if not
+ */
+static bool cfAssemblerParseCondition( CfStr identifier, CfCondition *const dst ) {
+    static const struct CfConditionTableElement_ {
+        const char  * name;      ///< condition name (same as conditional jump opcode suffix)
+        CfCondition   condition; ///< condition itself
+    } conditionTable[] = {
+        {"le", CF_CONDITION_LE},
+        {"l",  CF_CONDITION_L },
+        {"ge", CF_CONDITION_GE},
+        {"g",  CF_CONDITION_G },
+        {"e",  CF_CONDITION_E },
+        {"ne", CF_CONDITION_NE},
+    };
 
-                *dstImm = tokens[1].integer;
-                break;
-            }
+    for (size_t i = 0; i < sizeof(conditionTable) / sizeof(conditionTable[0]); i++)
+        if (cfStrIsSame(identifier, CF_STR(conditionTable[i].name))) {
+            *dst = conditionTable[i].condition;
+            return true;
+        }
 
-            default: {
-                cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
-            }
-            }
-        } else if (true
-            && tokens[0].type == CF_ASSEMBLER_TOKEN_TYPE_IDENTIFIER
-            && tokens[1].type == CF_ASSEMBLER_TOKEN_TYPE_PLUS
-            && tokens[2].type == CF_ASSEMBLER_TOKEN_TYPE_INTEGER
-        ) {
-            uint8_t registerIndex = 0;
+    return false;
+} // cfAssemblerParseCondition
 
-            if (!cfAssemblerParseRegister(self, tokens[0].identifier, &registerIndex))
-                cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_UNKNOWN_REGISTER);
+/**
+ * @brief directive integer argument parsing function
+ *
+ * @param[in,out] self     assembler pointer
+ * @param[in]     maxValue maximal argument value
+ *
+ * @return parsed argument
+ */
+static uint64_t cfAssemblerParseDirectiveInteger( CfAssembler *const self, const uint64_t maxValue ) {
+    CfAssemblerToken token = {};
 
-            dstInfo->isMemoryAccess = false;
-            dstInfo->doReadImmediate = true;
-            dstInfo->registerIndex = registerIndex;
+    if (false
+        || !cfAssemblerNextToken(self, &token)
+        || token.type != CF_ASSEMBLER_TOKEN_TYPE_INTEGER
+        || (uint64_t)token.integer > maxValue
+    )
+        cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_DIRECTIVE_ARGUMENT);
 
-            *dstImm = tokens[2].integer;
-        } else {
-            cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
-        }
+    return (uint64_t)token.integer;
+} // cfAssemblerParseDirectiveInteger
 
+/**
+ * @brief new segment starting function
+ *
+ * @param[in,out] self    assembler pointer
+ * @param[in]     kind    segment kind
+ * @param[in]     address segment address
+ * @param[in]     size    segment size (zero-initialized segments only, contents of other ones are assembled from next lines)
+ */
+static void cfAssemblerStartSegment( CfAssembler *const self, const CfSegmentKind kind, const uint32_t address, const uint32_t size ) {
+    const CfSegment segment = {
+        .kind    = kind,
+        .address = address,
+        .size    = size,
+        .data    = NULL,
+    };
+
+    cfAssemblerCloseSegment(self);
+
+    if (cfDarrPush(&self->segments, &segment) != CF_DARR_OK)
+        cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INTERNAL_ERROR);
+    self->isInSegment = kind != CF_SEGMENT_KIND_ZERO;
+} // cfAssemblerStartSegment
+
+/**
+ * @brief directive (line that starts from '.') parsing function
+ *
+ * @param[in,out] self assembler pointer
+ *
+ * @note supported directives are:
+ * '.entry label' (execution starts from label),
+ * '.data address' and '.rodata address' (next lines are assembled into segment placed at address),
+ * '.zero address size' (zero-initialized segment), '.code' (next lines are assembled into code) and
+ * '.u8', '.u16', '.i32', '.f32' (values are appended to current segment).
+ */
+static void cfAssemblerParseDirective( CfAssembler *const self ) {
+    CfAssemblerToken nameToken = {};
+
+    if (!cfAssemblerNextToken(self, &nameToken) || nameToken.type != CF_ASSEMBLER_TOKEN_TYPE_IDENTIFIER)
+        cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_UNKNOWN_DIRECTIVE);
+
+    const CfStr name = nameToken.identifier;
+
+    if (cfStrIsSame(name, CF_STR("entry"))) {
+        CfAssemblerToken labelToken = {};
+
+        if (!cfAssemblerNextToken(self, &labelToken) || labelToken.type != CF_ASSEMBLER_TOKEN_TYPE_IDENTIFIER)
+            cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_DIRECTIVE_ARGUMENT);
+        if (cfStrLength(labelToken.identifier) >= CF_LABEL_MAX)
+            cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_TOO_LONG_LABEL);
+
+        memset(self->entry, 0, CF_LABEL_MAX);
+        memcpy(self->entry, labelToken.identifier.begin, cfStrLength(labelToken.identifier));
         return;
     }
 
-    if (tokenCount == 1) {
-        dstInfo->isMemoryAccess = false;
+    if (cfStrIsSame(name, CF_STR("data")) || cfStrIsSame(name, CF_STR("rodata"))) {
+        const uint32_t address = (uint32_t)cfAssemblerParseDirectiveInteger(self, UINT32_MAX);
 
-        switch (tokens[0].type) {
-        case CF_ASSEMBLER_TOKEN_TYPE_IDENTIFIER: {
-            uint8_t registerIndex = 0;
+        cfAssemblerStartSegment(self, cfStrIsSame(name, CF_STR("data")) ? CF_SEGMENT_KIND_DATA : CF_SEGMENT_KIND_RODATA, address, 0);
+        return;
+    }
 
-            if (!cfAssemblerParseRegister(self, tokens[0].identifier, &registerIndex))
-                cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_UNKNOWN_REGISTER);
-            
-            dstInfo->registerIndex = registerIndex;
-            dstInfo->doReadImmediate = false;
-            break;
-        }
+    if (cfStrIsSame(name, CF_STR("zero"))) {
+        const uint32_t address = (uint32_t)cfAssemblerParseDirectiveInteger(self, UINT32_MAX);
+        const uint32_t size = (uint32_t)cfAssemblerParseDirectiveInteger(self, ((uint64_t)1 << 32) - address);
 
-        case CF_ASSEMBLER_TOKEN_TYPE_INTEGER: {
-            dstInfo->registerIndex = 0;
+        cfAssemblerStartSegment(self, CF_SEGMENT_KIND_ZERO, address, size);
+        return;
+    }
 
-            // now this assembler may be proudly called 'optimizing'
-            if (tokens[0].integer == 0) {
-                dstInfo->doReadImmediate = false;
-            } else {
-                dstInfo->doReadImmediate = true;
-                *dstImm = tokens[0].integer;
-            }
-           break;
-        }
+    if (cfStrIsSame(name, CF_STR("code"))) {
+        cfAssemblerCloseSegment(self);
+        return;
+    }
 
-        case CF_ASSEMBLER_TOKEN_TYPE_FLOATING: {
-            dstInfo->registerIndex = 0;
-            dstInfo->doReadImmediate = true;
-            *(float *)dstImm = tokens[0].floating;
-            break;
+    // value directives
+    uint32_t valueSize = 0;
+
+    if (cfStrIsSame(name, CF_STR("u8")))
+        valueSize = 1;
+    else if (cfStrIsSame(name, CF_STR("u16")))
+        valueSize = 2;
+    else if (cfStrIsSame(name, CF_STR("i32")) || cfStrIsSame(name, CF_STR("f32")))
+        valueSize = 4;
+    else
+        cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_UNKNOWN_DIRECTIVE);
+
+    if (!self->isInSegment)
+        cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_DATA_OUTSIDE_SEGMENT);
+
+    const bool isFloating = cfStrIsSame(name, CF_STR("f32"));
+    CfAssemblerToken valueToken = {};
+
+    while (cfAssemblerNextToken(self, &valueToken)) {
+        uint32_t value = 0;
+
+        if (isFloating && valueToken.type == CF_ASSEMBLER_TOKEN_TYPE_FLOATING) {
+            *(float *)&value = valueToken.floating;
+        } else if (isFloating && valueToken.type == CF_ASSEMBLER_TOKEN_TYPE_INTEGER) {
+            *(float *)&value = (float)valueToken.integer;
+        } else if (valueToken.type == CF_ASSEMBLER_TOKEN_TYPE_INTEGER && (uint64_t)valueToken.integer >> (valueSize * 8) == 0) {
+            value = (uint32_t)valueToken.integer;
+        } else {
+            cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_DIRECTIVE_ARGUMENT);
         }
 
-        default: {
-            cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
-        }
-        }
-        return;
+        // VM is little-endian, so value prefix is written
+        if (cfDarrPushArray(&self->segmentData, &value, valueSize) != CF_DARR_OK)
+            cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INTERNAL_ERROR);
     }
-
-    cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
-} // cfAssemblerParsePushPopInfo
+} // cfAssemblerParseDirective
 
 /**
  * @brief assembling starting function
@@ -708,7 +906,14 @@ void cfAssemblerRun( CfAssembler *const self ) {
 
         CfOpcode opcode = CF_OPCODE_UNREACHABLE;
 
-        if (cfAssemblerParseOpcode(opcodeToken.identifier, &opcode)) {
+        if (opcodeToken.type == CF_ASSEMBLER_TOKEN_TYPE_DOT) {
+            cfAssemblerParseDirective(self);
+        } else if (opcodeToken.type != CF_ASSEMBLER_TOKEN_TYPE_IDENTIFIER) {
+            cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_UNKNOWN_INSTRUCTION);
+        } else if (cfAssemblerParseOpcode(opcodeToken.identifier, &opcode)) {
+            if (self->isInSegment)
+                cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INSTRUCTION_OUTSIDE_CODE);
+
             uint8_t instructionData[32] = {0};
             uint32_t instructionSize = 0;
 
@@ -730,38 +935,151 @@ void cfAssemblerRun( CfAssembler *const self ) {
             }
 
             case CF_OPCODE_PUSH:
-            case CF_OPCODE_POP: {
+            case CF_OPCODE_POP:
+            case CF_OPCODE_VLD:
+            case CF_OPCODE_VST: {
                 CfAssemblerPushPopInfoData data = {0};
 
-                cfAssemblerParsePushPopInfo2(self, &data);
+                cfAssemblerParsePushPopInfo(self, &data);
+
+                // vectors are loaded from and stored to memory by register + immediate address only
+                if (true
+                    && (opcode == CF_OPCODE_VLD || opcode == CF_OPCODE_VST)
+                    && (!data.info.isMemoryAccess || data.info.isIndexed || data.info.accessSize != CF_ACCESS_SIZE_32)
+                )
+                    cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
 
                 instructionData[0] = opcode;
-                instructionData[1] = *(uint8_t *)&data.info;
+                instructionData[1] = data.info.asByte;
+                instructionSize = 2;
+
+                if (data.info.isIndexed)
+                    instructionData[instructionSize++] = data.index.asByte;
 
                 if (data.info.doReadImmediate) {
-                    if (data.immediateIsLiteral) {
-                        memcpy(instructionData + 2, &data.immediate.literal, 4);
-                    } else {
-                        memset(instructionData + 2, 0xFF, 4);
-
-                        CfLink link = {
-                            .sourceLine = (uint32_t)self->lineIndex,
-                            .codeOffset = (uint32_t)cfDarrLength(self->output) + 2,
-                        };
-                        memcpy(link.label, data.immediate.label, CF_LABEL_MAX);
-
-                        if (cfDarrPush(&self->links, &link) != CF_DARR_OK)
-                            cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INTERNAL_ERROR);
-                    }
+                    cfAssemblerWritePushPopImmediate(self, &data, instructionData + instructionSize,
+                        (uint32_t)cfDarrLength(self->output) + instructionSize
+                    );
+                    instructionSize += 4;
+                }
+
+                break;
+            }
+
+            case CF_OPCODE_MOV: {
+                CfAssemblerToken registerToken = {};
+                uint8_t registerIndex = 0;
+
+                // parse destination register
+                if (!cfAssemblerNextToken(self, &registerToken) || registerToken.type != CF_ASSEMBLER_TOKEN_TYPE_IDENTIFIER)
+                    cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
+                if (!cfAssemblerParseRegister(self, registerToken.identifier, &registerIndex))
+                    cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_UNKNOWN_REGISTER);
+
+                CfPushPopInfo destination = { .asByte = 0 };
+                destination.registerIndex = registerIndex;
+
+                // parse source
+                CfAssemblerPushPopInfoData data = {0};
+                cfAssemblerParsePushPopInfo(self, &data);
 
-                    instructionSize = 6;
+                if (data.info.isIndexed || data.info.accessSize != CF_ACCESS_SIZE_32)
+                    cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
+
+                instructionData[0] = opcode;
+                instructionData[1] = data.info.asByte;
+                instructionData[2] = destination.asByte;
+
+                if (data.info.doReadImmediate) {
+                    cfAssemblerWritePushPopImmediate(self, &data, instructionData + 3,
+                        (uint32_t)cfDarrLength(self->output) + 3
+                    );
+                    instructionSize = 7;
                 } else {
-                    instructionSize = 2;
+                    instructionSize = 3;
                 }
 
                 break;
             }
 
+            case CF_OPCODE_PPUSH: {
+                CfAssemblerToken tokens[10] = {};
+                uint32_t tokenCount = 0;
+
+                while (tokenCount < 10 && cfAssemblerNextToken(self, &tokens[tokenCount]))
+                    tokenCount++;
+
+                const uint32_t firstTokenCount = cfAssemblerGetPushPopInfoTokenCount(tokens, tokenCount);
+                CfAssemblerPushPopInfoData data[2] = {};
+
+                cfAssemblerParsePushPopInfoTokens(self, tokens, firstTokenCount, &data[0]);
+                cfAssemblerParsePushPopInfoTokens(self, tokens + firstTokenCount, tokenCount - firstTokenCount, &data[1]);
+
+                instructionData[0] = opcode;
+
+                for (uint32_t i = 0; i < 2; i++) {
+                    int16_t immediate = 0;
+
+                    if (data[i].info.isIndexed || data[i].info.accessSize != CF_ACCESS_SIZE_32)
+                        cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
+
+                    // pair immediates are 16-bit, so they can't be resolved by linker
+                    if (data[i].info.doReadImmediate) {
+                        if (false
+                            || !data[i].immediateIsLiteral
+                            || (int32_t)data[i].immediate.literal != (int16_t)data[i].immediate.literal
+                        )
+                            cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_PUSHPOP_ARGUMENT);
+                        immediate = (int16_t)data[i].immediate.literal;
+                    }
+
+                    instructionData[1 + i] = data[i].info.asByte;
+                    memcpy(instructionData + 3 + i * 2, &immediate, 2);
+                }
+
+                instructionSize = 7;
+                break;
+            }
+
+            case CF_OPCODE_CSET:
+            case CF_OPCODE_ICSET:
+            case CF_OPCODE_FCSET: {
+                CfAssemblerToken conditionToken = {};
+                CfCondition condition = CF_CONDITION_E;
+
+                if (!cfAssemblerNextToken(self, &conditionToken))
+                    cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_CONDITION_MISSING);
+
+                if (false
+                    || conditionToken.type != CF_ASSEMBLER_TOKEN_TYPE_IDENTIFIER
+                    || !cfAssemblerParseCondition(conditionToken.identifier, &condition)
+                )
+                    cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_CONDITION);
+
+                instructionData[0] = opcode;
+                instructionData[1] = condition;
+                instructionSize = 2;
+                break;
+            }
+
+            case CF_OPCODE_MSET: {
+                CfAssemblerToken widthToken = {};
+
+                if (!cfAssemblerNextToken(self, &widthToken))
+                    cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_FILL_WIDTH_MISSING);
+
+                if (false
+                    || widthToken.type != CF_ASSEMBLER_TOKEN_TYPE_INTEGER
+                    || (widthToken.integer != 8 && widthToken.integer != 32)
+                )
+                    cfAssemblerFinish(self, CF_ASSEMBLY_STATUS_INVALID_FILL_WIDTH);
+
+                instructionData[0] = opcode;
+                instructionData[1] = (uint8_t)widthToken.integer;
+                instructionSize = 2;
+                break;
+            }
+
             case CF_OPCODE_JMP:
             case CF_OPCODE_JLE:
             case CF_OPCODE_JL:
@@ -769,6 +1087,8 @@ void cfAssemblerRun( CfAssembler *const self ) {
             case CF_OPCODE_JG:
             case CF_OPCODE_JE:
             case CF_OPCODE_JNE:
+            case CF_OPCODE_JZ:
+            case CF_OPCODE_JNZ:
             case CF_OPCODE_CALL: {
                 CfAssemblerToken labelToken = {};
 
@@ -832,7 +1152,15 @@ void cfAssemblerRun( CfAssembler *const self ) {
             case CF_OPCODE_TIME:
             case CF_OPCODE_IGKS:
             case CF_OPCODE_IWKD:
-            case CF_OPCODE_MGS: {
+            case CF_OPCODE_MGS:
+            case CF_OPCODE_SNAP:
+            case CF_OPCODE_VADD:
+            case CF_OPCODE_VSUB:
+            case CF_OPCODE_VMUL:
+            case CF_OPCODE_VDOT:
+            case CF_OPCODE_VBCAST:
+            case CF_OPCODE_VSQRT:
+            case CF_OPCODE_MCPY: {
                 instructionSize = 1;
                 instructionData[0] = opcode;
                 break;
@@ -854,14 +1182,19 @@ void cfAssemblerRun( CfAssembler *const self ) {
 
             switch (colonToken.type) {
 
-            // jump label
+            // jump label (or segment label, it's RAM address, so it's not corrected by linker)
             case CF_ASSEMBLER_TOKEN_TYPE_COLON: {
                 CfLabel label = {
                     .sourceLine = (uint32_t)self->lineIndex,
                     .value      = (uint32_t)cfDarrLength(self->output),
-                    .isRelative = true,
+                    .isRelative = !self->isInSegment,
                 };
 
+                if (self->isInSegment) {
+                    const CfSegment *const segment = (const CfSegment *)cfDarrData(self->segments) + cfDarrLength(self->segments) - 1;
+                    label.value = segment->address + (uint32_t)cfDarrLength(self->segmentData);
+                }
+
                 memcpy(label.label, opcodeToken.identifier.begin, cfStrLength(opcodeToken.identifier));
 
                 if (cfDarrPush(&self->labels, &label) != CF_DARR_OK)
@@ -933,19 +1266,27 @@ CfAssemblyStatus cfAssemble( CfStr text, CfStr sourceName, CfObject *dst, CfAsse
         dst->codeLength = cfDarrLength(assembler.output);
         dst->linkCount = cfDarrLength(assembler.links);
         dst->labelCount = cfDarrLength(assembler.labels);
+        dst->segmentCount = cfDarrLength(assembler.segments);
+        memcpy(dst->entry, assembler.entry, CF_LABEL_MAX);
 
         if (false
             || cfDarrIntoData(assembler.output, (void **)&dst->code)   != CF_DARR_OK
             || cfDarrIntoData(assembler.links, (void **)&dst->links)   != CF_DARR_OK
             || cfDarrIntoData(assembler.labels, (void **)&dst->labels) != CF_DARR_OK
+            || cfDarrIntoData(assembler.segments, (void **)&dst->segments) != CF_DARR_OK
             || (dst->sourceName = cfStrOwnedCopy(sourceName)) == NULL // allowed by function definition
         ) {
             free(dst->code);
             free(dst->links);
             free(dst->labels);
+            free(dst->segments);
             free((char *)dst->sourceName);
+            memset(dst, 0, sizeof(CfObject));
 
             assembler.status = CF_ASSEMBLY_STATUS_INTERNAL_ERROR;
+        } else {
+            // segment contents are owned by object now
+            cfDarrClear(assembler.segments);
         }
 
         goto cfAssembler__cleanup;
@@ -956,11 +1297,15 @@ CfAssemblyStatus cfAssemble( CfStr text, CfStr sourceName, CfObject *dst, CfAsse
     assembler.output = cfDarrCtor(1);
     assembler.links = cfDarrCtor(sizeof(CfLink));
     assembler.labels = cfDarrCtor(sizeof(CfLabel));
+    assembler.segments = cfDarrCtor(sizeof(CfSegment));
+    assembler.segmentData = cfDarrCtor(1);
 
     if (false
-        || assembler.output == NULL
-        || assembler.links  == NULL
-        || assembler.labels == NULL
+        || assembler.output      == NULL
+        || assembler.links       == NULL
+        || assembler.labels      == NULL
+        || assembler.segments    == NULL
+        || assembler.segmentData == NULL
     )
         goto cfAssembler__cleanup;
 
@@ -972,9 +1317,18 @@ CfAssemblyStatus cfAssemble( CfStr text, CfStr sourceName, CfObject *dst, CfAsse
 
 cfAssembler__cleanup:
 
+    if (assembler.segments != NULL) {
+        const CfSegment *const segments = (const CfSegment *)cfDarrData(assembler.segments);
+
+        for (size_t i = 0, n = cfDarrLength(assembler.segments); i < n; i++)
+            free((void *)segments[i].data);
+    }
+
     cfDarrDtor(assembler.output);
     cfDarrDtor(assembler.links);
     cfDarrDtor(assembler.labels);
+    cfDarrDtor(assembler.segments);
+    cfDarrDtor(assembler.segmentData);
 
     if (details != NULL)
         *details = assembler.details;
@@ -995,10 +1349,18 @@ const char * cfAssemblyStatusStr( const CfAssemblyStatus status ) {
     case CF_ASSEMBLY_STATUS_SYSCALL_ARGUMENT_MISSING : return "syscall argument missing";
     case CF_ASSEMBLY_STATUS_INVALID_JUMP_ARGUMENT    : return "invalid jump argument";
     case CF_ASSEMBLY_STATUS_JUMP_ARGUMENT_MISSING    : return "jump argument missing";
+    case CF_ASSEMBLY_STATUS_INVALID_CONDITION        : return "invalid condition";
+    case CF_ASSEMBLY_STATUS_CONDITION_MISSING        : return "condition missing";
+    case CF_ASSEMBLY_STATUS_INVALID_FILL_WIDTH       : return "invalid fill width";
+    case CF_ASSEMBLY_STATUS_FILL_WIDTH_MISSING       : return "fill width missing";
     case CF_ASSEMBLY_STATUS_EMPTY_LABEL              : return "label is empty";
     case CF_ASSEMBLY_STATUS_TOO_LONG_LABEL           : return "label is too long";
     case CF_ASSEMBLY_STATUS_INVALID_CONSTANT_VALUE   : return "invalid constant value";
     case CF_ASSEMBLY_STATUS_UNEXPECTED_CHARACTERS    : return "unexpected characters";
+    case CF_ASSEMBLY_STATUS_UNKNOWN_DIRECTIVE        : return "unknown directive";
+    case CF_ASSEMBLY_STATUS_INVALID_DIRECTIVE_ARGUMENT: return "invalid directive argument";
+    case CF_ASSEMBLY_STATUS_DATA_OUTSIDE_SEGMENT     : return "data outside of segment";
+    case CF_ASSEMBLY_STATUS_INSTRUCTION_OUTSIDE_CODE : return "instruction outside of code";
     }
 
     return "<invalid>";
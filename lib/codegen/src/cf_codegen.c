@@ -13,6 +13,7 @@ typedef enum CfCodeGeneratorInstrinsict_ {
     CF_CODE_GENERATOR_INTRINSICT_F32_READ,  ///< read f32
     CF_CODE_GENERATOR_INTRINSICT_F32_WRITE, ///< write f32
     CF_CODE_GENERATOR_INTRINSICT_F32_SQRT,  ///< write f32 square root
+    CF_CODE_GENERATOR_INTRINSICT_SNAPSHOT,  ///< write VM snapshot
 } CfCodeGeneratorInstrinsict;
 
 /// @brief insintrisct info
@@ -66,6 +67,18 @@ static const CfCodeGeneratorIntrinsictInfo * cfCodeGeneratorGetIntrinsictInfo( C
             .intrinsict = CF_CODE_GENERATOR_INTRINSICT_F32_SQRT,
         };
 
+        return &info;
+    } else if (cfStrIsSame(name, CF_STR("__cfvm_snapshot"))) {
+        static CfTirFunctionPrototype prototype = {
+            .inputTypeArray = NULL,
+            .inputTypeArrayLength = 0,
+            .outputType = CF_TIR_TYPE_VOID,
+        };
+        static CfCodeGeneratorIntrinsictInfo info = {
+            .funcPrototype = &prototype,
+            .intrinsict = CF_CODE_GENERATOR_INTRINSICT_SNAPSHOT,
+        };
+
         return &info;
     } else {
         return NULL;
@@ -182,12 +195,24 @@ void cfCodeGeneratorWritePushPop(
     CfOpcode               opcode,
     CfPushPopInfo          info,
     int32_t                immediate
+) {
+    cfCodeGeneratorWritePushPopIndexed(self, opcode, info, (CfPushPopIndex) { .asByte = 0 }, immediate);
+} // cfCodeGeneratorWritePushPop
+
+void cfCodeGeneratorWritePushPopIndexed(
+    CfCodeGenerator *const self,
+    CfOpcode               opcode,
+    CfPushPopInfo          info,
+    CfPushPopIndex         index,
+    int32_t                immediate
 ) {
     cfCodeGeneratorWriteCode(self, &opcode, 1);
     cfCodeGeneratorWriteCode(self, &info, 1);
+    if (info.isIndexed)
+        cfCodeGeneratorWriteCode(self, &index, 1);
     if (info.doReadImmediate)
         cfCodeGeneratorWriteCode(self, &immediate, 4);
-} // cfCodeGeneratorWritePushPop
+} // cfCodeGeneratorWritePushPopIndexed
 
 void cfCodeGeneratorWritePushConstant( CfCodeGenerator *const self, int32_t constant ) {
     cfCodeGeneratorWritePushPop(self,
@@ -201,55 +226,292 @@ void cfCodeGeneratorWriteOpcode( CfCodeGenerator *const self, CfOpcode opcode )
     cfCodeGeneratorWriteCode(self, &opcode, 1);
 } // cfCodeGeneratorWriteOpcode
 
-void cfCodeGeneratorGenExpression( CfCodeGenerator *const self, const CfTirExpression *expression ) {
+void cfCodeGeneratorWriteMove(
+    CfCodeGenerator *const self,
+    CfRegister             destination,
+    CfPushPopInfo          source,
+    int32_t                immediate
+) {
+    const CfPushPopInfo destinationInfo = { (uint8_t)destination };
+
+    cfCodeGeneratorWriteOpcode(self, CF_OPCODE_MOV);
+    cfCodeGeneratorWriteCode(self, &source, 1);
+    cfCodeGeneratorWriteCode(self, &destinationInfo, 1);
+    if (source.doReadImmediate)
+        cfCodeGeneratorWriteCode(self, &immediate, 4);
+} // cfCodeGeneratorWriteMove
+
+void cfCodeGeneratorWritePushPair(
+    CfCodeGenerator *const self,
+    CfPushPopInfo          first,
+    int16_t                firstImmediate,
+    CfPushPopInfo          second,
+    int16_t                secondImmediate
+) {
+    cfCodeGeneratorWriteOpcode(self, CF_OPCODE_PPUSH);
+    cfCodeGeneratorWriteCode(self, &first, 1);
+    cfCodeGeneratorWriteCode(self, &second, 1);
+    cfCodeGeneratorWriteCode(self, &firstImmediate, 2);
+    cfCodeGeneratorWriteCode(self, &secondImmediate, 2);
+} // cfCodeGeneratorWritePushPair
+
+/**
+ * @brief get push/pop info of expression, that is generated as single push instruction
+ * 
+ * @param[in]  expression expression to get push/pop info of
+ * @param[out] info       push/pop info destination (non-null)
+ * @param[out] immediate  immediate destination (non-null, zero if immediate isn't required)
+ * 
+ * @return true if expression is single push, false if not
+ */
+static bool cfCodeGeneratorGetPushPopInfo(
+    const CfTirExpression *const expression,
+    CfPushPopInfo         *const info,
+    int32_t               *const immediate
+) {
+    *info = (CfPushPopInfo) { CF_REGISTER_CZ };
+    *immediate = 0;
+
     switch (expression->type) {
-    case CF_TIR_EXPRESSION_TYPE_CONST_I32: {
-        if (expression->constI32 == 0)
+    case CF_TIR_EXPRESSION_TYPE_CONST_I32:
+        info->doReadImmediate = expression->constI32 != 0;
+        *immediate = expression->constI32;
+        return true;
+
+    case CF_TIR_EXPRESSION_TYPE_CONST_F32:
+        *immediate = *(const int32_t *)&expression->constF32;
+        info->doReadImmediate = *immediate != 0;
+        return true;
+
+    case CF_TIR_EXPRESSION_TYPE_CONST_U32:
+        *immediate = *(const int32_t *)&expression->constU32;
+        info->doReadImmediate = *immediate != 0;
+        return true;
+
+    case CF_TIR_EXPRESSION_TYPE_VOID:
+        // nice solution))) (no)
+        return true;
+
+    case CF_TIR_EXPRESSION_TYPE_LOCAL:
+        info->registerIndex = CF_REGISTER_FX;
+        info->isMemoryAccess = true;
+        info->doReadImmediate = true;
+        *immediate = -(int32_t)(expression->local + 1) * 4;
+        return true;
+
+    default:
+        return false;
+    }
+} // cfCodeGeneratorGetPushPopInfo
+
+void cfCodeGeneratorGenOperands(
+    CfCodeGenerator       *const self,
+    const CfTirExpression *      lhs,
+    const CfTirExpression *      rhs
+) {
+    CfPushPopInfo lhsInfo, rhsInfo;
+    int32_t lhsImmediate, rhsImmediate;
+
+    // fuse two pushes if both immediates fit into push pair
+    if (true
+        && cfCodeGeneratorGetPushPopInfo(lhs, &lhsInfo, &lhsImmediate)
+        && cfCodeGeneratorGetPushPopInfo(rhs, &rhsInfo, &rhsImmediate)
+        && lhsImmediate == (int16_t)lhsImmediate
+        && rhsImmediate == (int16_t)rhsImmediate
+    ) {
+        cfCodeGeneratorWritePushPair(self, lhsInfo, (int16_t)lhsImmediate, rhsInfo, (int16_t)rhsImmediate);
+        return;
+    }
+
+    cfCodeGeneratorGenExpression(self, lhs);
+    cfCodeGeneratorGenExpression(self, rhs);
+} // cfCodeGeneratorGenOperands
+
+/**
+ * @brief get comparison opcode for operands of certain type
+ * 
+ * @param[in] self code generator pointer
+ * @param[in] type operand type (non-void)
+ * @param[in] cmp  opcode for unsigned integers (CMP or CSET)
+ * @param[in] icmp opcode for signed integers
+ * @param[in] fcmp opcode for floating-point numbers
+ * 
+ * @return opcode
+ */
+static CfOpcode cfCodeGeneratorSelectComparison(
+    CfCodeGenerator *const self,
+    CfTirType              type,
+    CfOpcode               cmp,
+    CfOpcode               icmp,
+    CfOpcode               fcmp
+) {
+    switch (type) {
+    case CF_TIR_TYPE_I32 : return icmp;
+    case CF_TIR_TYPE_U32 : return cmp;
+    case CF_TIR_TYPE_F32 : return fcmp;
+    case CF_TIR_TYPE_VOID: break;
+    }
+
+    // invalid TIR
+    cfCodeGeneratorAssert(self, false);
+    return cmp;
+} // cfCodeGeneratorSelectComparison
+
+void cfCodeGeneratorGenJumpIfFalse(
+    CfCodeGenerator       *const self,
+    const CfTirExpression *      condition,
+    CfStr                        label
+) {
+    // inverse conditional jump for each comparison operator (or UNREACHABLE if operator isn't comparison)
+    CfOpcode jumpOpcode = CF_OPCODE_UNREACHABLE;
+
+    if (condition->type == CF_TIR_EXPRESSION_TYPE_BINARY_OPERATOR) {
+        switch (condition->binaryOperator.op) {
+        case CF_TIR_BINARY_OPERATOR_LT: jumpOpcode = CF_OPCODE_JGE; break;
+        case CF_TIR_BINARY_OPERATOR_GT: jumpOpcode = CF_OPCODE_JLE; break;
+        case CF_TIR_BINARY_OPERATOR_LE: jumpOpcode = CF_OPCODE_JG;  break;
+        case CF_TIR_BINARY_OPERATOR_GE: jumpOpcode = CF_OPCODE_JL;  break;
+        case CF_TIR_BINARY_OPERATOR_EQ: jumpOpcode = CF_OPCODE_JNE; break;
+        case CF_TIR_BINARY_OPERATOR_NE: jumpOpcode = CF_OPCODE_JE;  break;
+
+        default:
+            break;
+        }
+    }
+
+    if (jumpOpcode != CF_OPCODE_UNREACHABLE) {
+        // compare operands and jump by flags directly, without boolean value materialization
+        cfCodeGeneratorGenOperands(self, condition->binaryOperator.lhs, condition->binaryOperator.rhs);
+        cfCodeGeneratorWriteOpcode(self, cfCodeGeneratorSelectComparison(self,
+            condition->binaryOperator.lhs->resultingType,
+            CF_OPCODE_CMP,
+            CF_OPCODE_ICMP,
+            CF_OPCODE_FCMP
+        ));
+    } else {
+        cfCodeGeneratorGenExpression(self, condition);
+        jumpOpcode = CF_OPCODE_JZ;
+    }
+
+    cfCodeGeneratorWriteOpcode(self, jumpOpcode);
+    cfCodeGeneratorAddLink(self, label);
+} // cfCodeGeneratorGenJumpIfFalse
+
+/**
+ * @brief generate assignment without pushing its result
+ * 
+ * @param[in] self       code generator pointer
+ * @param[in] expression assignment expression
+ */
+static void cfCodeGeneratorGenAssignment( CfCodeGenerator *const self, const CfTirExpression *expression ) {
+    cfCodeGeneratorGenExpression(self, expression->assignment.value);
+    cfCodeGeneratorWritePushPop(self,
+        CF_OPCODE_POP,
+        (CfPushPopInfo) {
+            .registerIndex = CF_REGISTER_FX,
+            .isMemoryAccess = true,
+            .doReadImmediate = true,
+        },
+        -(int32_t)(expression->local + 1) * 4
+    );
+} // cfCodeGeneratorGenAssignment
+
+/**
+ * @brief generate call
+ * 
+ * @param[in] self             code generator pointer
+ * @param[in] expression       call expression
+ * @param[in] isResultRequired true if call result should be pushed, false if it's not used
+ */
+static void cfCodeGeneratorGenCall(
+    CfCodeGenerator       *const self,
+    const CfTirExpression *      expression,
+    bool                         isResultRequired
+) {
+    // execute argument expressions in reverse order
+    for (int32_t i = expression->call.inputArrayLength - 1; i >= 0; i--)
+        cfCodeGeneratorGenExpression(self, expression->call.inputArray[i]);
+    // call function, actually>=
+    const CfTirFunction *function = cfTirGetFunctionById(self->tir, expression->call.functionId);
+    cfCodeGeneratorAssert(self, function != NULL);
+
+    const CfCodeGeneratorIntrinsictInfo *info = cfCodeGeneratorGetIntrinsictInfo(function->name);
+
+    if (info != NULL) {
+        switch (info->intrinsict) {
+        case CF_CODE_GENERATOR_INTRINSICT_F32_READ: {
+            // syscall 0
+            int32_t n = 0;
+            cfCodeGeneratorWriteOpcode(self, CF_OPCODE_SYSCALL);
+            cfCodeGeneratorWriteCode(self, &n, 4);
+
+            if (!isResultRequired)
+                cfCodeGeneratorWritePushPop(self, CF_OPCODE_POP, (CfPushPopInfo) { CF_REGISTER_CZ }, 0);
+            break;
+        }
+
+        case CF_CODE_GENERATOR_INTRINSICT_F32_WRITE: {
+            // syscall 1
+            int32_t n = 1;
+            cfCodeGeneratorWriteOpcode(self, CF_OPCODE_SYSCALL);
+            cfCodeGeneratorWriteCode(self, &n, 4);
+
+            if (isResultRequired)
+                cfCodeGeneratorWritePushPop(self,
+                    CF_OPCODE_PUSH,
+                    (CfPushPopInfo) { CF_REGISTER_CZ },
+                    0
+                );
+            break;
+        }
+
+        case CF_CODE_GENERATOR_INTRINSICT_F32_SQRT: {
+            cfCodeGeneratorWriteOpcode(self, CF_OPCODE_FSQRT);
+
+            if (!isResultRequired)
+                cfCodeGeneratorWritePushPop(self, CF_OPCODE_POP, (CfPushPopInfo) { CF_REGISTER_CZ }, 0);
+            break;
+        }
+
+        case CF_CODE_GENERATOR_INTRINSICT_SNAPSHOT: {
+            cfCodeGeneratorWriteOpcode(self, CF_OPCODE_SNAP);
+
+            if (isResultRequired)
+                cfCodeGeneratorWritePushPop(self,
+                    CF_OPCODE_PUSH,
+                    (CfPushPopInfo) { CF_REGISTER_CZ },
+                    0
+                );
+            break;
+        }
+        }
+    } else {
+        // call function by name
+        cfCodeGeneratorWriteOpcode(self, CF_OPCODE_CALL);
+        cfCodeGeneratorAddLink(self, function->name);
+
+        // push AX to stack
+        if (isResultRequired)
             cfCodeGeneratorWritePushPop(self,
                 CF_OPCODE_PUSH,
-                (CfPushPopInfo) { CF_REGISTER_CZ },
+                (CfPushPopInfo) { CF_REGISTER_AX },
                 0
             );
-        else
-            cfCodeGeneratorWritePushPop(self,
-                CF_OPCODE_PUSH,
-                (CfPushPopInfo) {
-                    .registerIndex   = CF_REGISTER_CZ,
-                    .doReadImmediate = true
-                },
-                expression->constI32
-            );
-        break;
-    }
-    case CF_TIR_EXPRESSION_TYPE_CONST_F32: {
-        cfCodeGeneratorWritePushPop(self,
-            CF_OPCODE_PUSH,
-            (CfPushPopInfo) {
-                .registerIndex   = CF_REGISTER_CZ,
-                .doReadImmediate = true
-            },
-            *(const int32_t *)&expression->constF32
-        );
-        break;
     }
-    case CF_TIR_EXPRESSION_TYPE_CONST_U32: {
-        cfCodeGeneratorWritePushPop(self,
-            CF_OPCODE_PUSH,
-            (CfPushPopInfo) {
-                .registerIndex   = CF_REGISTER_CZ,
-                .doReadImmediate = true
-            },
-            *(const int32_t *)&expression->constU32
-        );
-        break;
-    }
-    case CF_TIR_EXPRESSION_TYPE_VOID: {
-        // nice solution))) (no)
-        cfCodeGeneratorWritePushPop(self,
-            CF_OPCODE_PUSH,
-            (CfPushPopInfo) { CF_REGISTER_CZ },
-            0
-        );
+} // cfCodeGeneratorGenCall
+
+void cfCodeGeneratorGenExpression( CfCodeGenerator *const self, const CfTirExpression *expression ) {
+    switch (expression->type) {
+    case CF_TIR_EXPRESSION_TYPE_CONST_I32:
+    case CF_TIR_EXPRESSION_TYPE_CONST_F32:
+    case CF_TIR_EXPRESSION_TYPE_CONST_U32:
+    case CF_TIR_EXPRESSION_TYPE_VOID:
+    case CF_TIR_EXPRESSION_TYPE_LOCAL: {
+        CfPushPopInfo info;
+        int32_t immediate;
+
+        cfCodeGeneratorAssert(self, cfCodeGeneratorGetPushPopInfo(expression, &info, &immediate));
+        cfCodeGeneratorWritePushPop(self, CF_OPCODE_PUSH, info, immediate);
         break;
     }
     case CF_TIR_EXPRESSION_TYPE_BINARY_OPERATOR: {
@@ -284,45 +546,14 @@ void cfCodeGeneratorGenExpression( CfCodeGenerator *const self, const CfTirExpre
 
         if (firstIndex != ~0U) {
             // generate operands
-            cfCodeGeneratorGenExpression(self, expression->binaryOperator.lhs);
-            cfCodeGeneratorGenExpression(self, expression->binaryOperator.rhs);
+            cfCodeGeneratorGenOperands(self, expression->binaryOperator.lhs, expression->binaryOperator.rhs);
 
             // generate simple expression
             cfCodeGeneratorWriteOpcode(self, binaryOperatorOpcodes[firstIndex][secondIndex]);
             break;
         }
 
-        // generate lhs/rhs
-        if (false
-            || expression->binaryOperator.op == CF_TIR_BINARY_OPERATOR_LT
-            || expression->binaryOperator.op == CF_TIR_BINARY_OPERATOR_LE
-        ) {
-            cfCodeGeneratorGenExpression(self, expression->binaryOperator.lhs);
-            cfCodeGeneratorGenExpression(self, expression->binaryOperator.rhs);
-        } else {
-            cfCodeGeneratorGenExpression(self, expression->binaryOperator.rhs);
-            cfCodeGeneratorGenExpression(self, expression->binaryOperator.lhs);
-        }
-
-        // generate comparison opcode
-        switch (expression->binaryOperator.lhs->resultingType) {
-        case CF_TIR_TYPE_I32:
-            // generate operands
-            cfCodeGeneratorWriteOpcode(self, CF_OPCODE_ICMP);
-            break;
-        case CF_TIR_TYPE_U32:
-            // generate operands
-            cfCodeGeneratorWriteOpcode(self, CF_OPCODE_CMP );
-            break;
-        case CF_TIR_TYPE_F32:
-            // generate operands
-            cfCodeGeneratorWriteOpcode(self, CF_OPCODE_FCMP);
-            break;
-
-        case CF_TIR_TYPE_VOID:
-            assert(false && "unreachable");
-        }
-
+        uint8_t condition = CF_CONDITION_E;
         switch (expression->binaryOperator.op) {
         case CF_TIR_BINARY_OPERATOR_ADD:
         case CF_TIR_BINARY_OPERATOR_SUB:
@@ -330,114 +561,27 @@ void cfCodeGeneratorGenExpression( CfCodeGenerator *const self, const CfTirExpre
         case CF_TIR_BINARY_OPERATOR_DIV:
             assert(false && "unreachable");
 
-        case CF_TIR_BINARY_OPERATOR_LT:
-        case CF_TIR_BINARY_OPERATOR_GT:
-        case CF_TIR_BINARY_OPERATOR_LE:
-        case CF_TIR_BINARY_OPERATOR_GE:
-
-            // generate operands
-            // n
-            cfCodeGeneratorWritePushPop(self, CF_OPCODE_PUSH, (CfPushPopInfo) { CF_REGISTER_FL }, 0);
-
-            if (false
-                || expression->binaryOperator.op == CF_TIR_BINARY_OPERATOR_LE
-                || expression->binaryOperator.op == CF_TIR_BINARY_OPERATOR_LE
-            ) {
-                // | (n << 1)
-                cfCodeGeneratorWritePushPop(self, CF_OPCODE_PUSH, (CfPushPopInfo) { CF_REGISTER_FL }, 0);
-                cfCodeGeneratorWritePushConstant(self, 1);
-                cfCodeGeneratorWriteOpcode(self, CF_OPCODE_SHL);
-                cfCodeGeneratorWriteOpcode(self, CF_OPCODE_OR);
-            }
-
-            // & 1
-            cfCodeGeneratorWritePushConstant(self, 1);
-            cfCodeGeneratorWriteOpcode(self, CF_OPCODE_AND);
-            break;
-
-        case CF_TIR_BINARY_OPERATOR_EQ:
-        case CF_TIR_BINARY_OPERATOR_NE:
-            // push lhs/rhs
-            cfCodeGeneratorWritePushPop(self, CF_OPCODE_PUSH, (CfPushPopInfo) { CF_REGISTER_FL }, 0);
-            cfCodeGeneratorWritePushConstant(self, 1);
-            cfCodeGeneratorWriteOpcode(self, CF_OPCODE_SHL);
-
-            if (expression->binaryOperator.op == CF_TIR_BINARY_OPERATOR_NE) {
-                cfCodeGeneratorWritePushConstant(self, 1);
-                cfCodeGeneratorWriteOpcode(self, CF_OPCODE_XOR);
-            }
-
-            cfCodeGeneratorWritePushConstant(self, 1);
-            cfCodeGeneratorWriteOpcode(self, CF_OPCODE_AND);
-
-            break;
-        }
-        break;
-    }
-    case CF_TIR_EXPRESSION_TYPE_CALL: {
-        // execute argument expressions in reverse order
-        for (int32_t i = expression->call.inputArrayLength - 1; i >= 0; i--)
-            cfCodeGeneratorGenExpression(self, expression->call.inputArray[i]);
-        // call function, actually>=
-        const CfTirFunction *function = cfTirGetFunctionById(self->tir, expression->call.functionId);
-        cfCodeGeneratorAssert(self, function != NULL);
-
-        const CfCodeGeneratorIntrinsictInfo *info = cfCodeGeneratorGetIntrinsictInfo(function->name);
-
-        if (info != NULL) {
-            switch (info->intrinsict) {
-            case CF_CODE_GENERATOR_INTRINSICT_F32_READ: {
-                // syscall 0
-                int32_t n = 0;
-                cfCodeGeneratorWriteOpcode(self, CF_OPCODE_SYSCALL);
-                cfCodeGeneratorWriteCode(self, &n, 4);
-                break;
-            }
-
-            case CF_CODE_GENERATOR_INTRINSICT_F32_WRITE: {
-                // syscall 1
-                int32_t n = 1;
-                cfCodeGeneratorWriteOpcode(self, CF_OPCODE_SYSCALL);
-                cfCodeGeneratorWriteCode(self, &n, 4);
-                cfCodeGeneratorWritePushPop(self,
-                    CF_OPCODE_PUSH,
-                    (CfPushPopInfo) { CF_REGISTER_CZ },
-                    0
-                );
-                break;
-            }
-
-            case CF_CODE_GENERATOR_INTRINSICT_F32_SQRT: {
-                cfCodeGeneratorWriteOpcode(self, CF_OPCODE_FSQRT);
-                break;
-            }
-            }
-        } else {
-            // call function by name
-            cfCodeGeneratorWriteOpcode(self, CF_OPCODE_CALL);
-            cfCodeGeneratorAddLink(self, function->name);
-
-            // push AX to stack
-            cfCodeGeneratorWritePushPop(self,
-                CF_OPCODE_PUSH,
-                (CfPushPopInfo) { CF_REGISTER_AX },
-                0
-            );
+        case CF_TIR_BINARY_OPERATOR_LT: condition = CF_CONDITION_L;  break;
+        case CF_TIR_BINARY_OPERATOR_GT: condition = CF_CONDITION_G;  break;
+        case CF_TIR_BINARY_OPERATOR_LE: condition = CF_CONDITION_LE; break;
+        case CF_TIR_BINARY_OPERATOR_GE: condition = CF_CONDITION_GE; break;
+        case CF_TIR_BINARY_OPERATOR_EQ: condition = CF_CONDITION_E;  break;
+        case CF_TIR_BINARY_OPERATOR_NE: condition = CF_CONDITION_NE; break;
         }
 
+        // compare operands and push comparison result
+        cfCodeGeneratorGenOperands(self, expression->binaryOperator.lhs, expression->binaryOperator.rhs);
+        cfCodeGeneratorWriteOpcode(self, cfCodeGeneratorSelectComparison(self,
+            expression->binaryOperator.lhs->resultingType,
+            CF_OPCODE_CSET,
+            CF_OPCODE_ICSET,
+            CF_OPCODE_FCSET
+        ));
+        cfCodeGeneratorWriteCode(self, &condition, 1);
         break;
     }
-
-    case CF_TIR_EXPRESSION_TYPE_LOCAL: {
-        cfCodeGeneratorWritePushPop(self,
-            CF_OPCODE_PUSH,
-            (CfPushPopInfo) {
-                .registerIndex = CF_REGISTER_FX,
-                .isMemoryAccess = true,
-                .doReadImmediate = true,
-            },
-            -(int32_t)(expression->local + 1) * 4
-        );
+    case CF_TIR_EXPRESSION_TYPE_CALL: {
+        cfCodeGeneratorGenCall(self, expression, true);
         break;
     }
 
@@ -447,16 +591,7 @@ void cfCodeGeneratorGenExpression( CfCodeGenerator *const self, const CfTirExpre
     }
 
     case CF_TIR_EXPRESSION_TYPE_ASSIGNMENT: {
-        cfCodeGeneratorGenExpression(self, expression->assignment.value);
-        cfCodeGeneratorWritePushPop(self,
-            CF_OPCODE_POP,
-            (CfPushPopInfo) {
-                .registerIndex = CF_REGISTER_FX,
-                .isMemoryAccess = true,
-                .doReadImmediate = true,
-            },
-            -(int32_t)(expression->local + 1) * 4
-        );
+        cfCodeGeneratorGenAssignment(self, expression);
 
         // void has value)))
         cfCodeGeneratorWritePushPop(self,
@@ -492,16 +627,7 @@ void cfCodeGeneratorGenExpression( CfCodeGenerator *const self, const CfTirExpre
 
 void cfCodeGeneratorGenReturn( CfCodeGenerator *const self ) {
     // ex = fx
-    cfCodeGeneratorWritePushPop(self,
-        CF_OPCODE_PUSH,
-        (CfPushPopInfo) { CF_REGISTER_FX, },
-        0
-    );
-    cfCodeGeneratorWritePushPop(self,
-        CF_OPCODE_POP,
-        (CfPushPopInfo) { CF_REGISTER_EX },
-        0
-    );
+    cfCodeGeneratorWriteMove(self, CF_REGISTER_EX, (CfPushPopInfo) { CF_REGISTER_FX }, 0);
 
     // restore fx
     cfCodeGeneratorWritePushPop(self,
@@ -515,46 +641,48 @@ void cfCodeGeneratorGenReturn( CfCodeGenerator *const self ) {
 } // cfCodeGeneratorGenReturn
 
 void cfCodeGeneratorGenBlock( CfCodeGenerator *const self, const CfTirBlock *block ) {
-    // ex -= localCount * 4
-    cfCodeGeneratorWritePushPop(self,
-        CF_OPCODE_PUSH,
-        (CfPushPopInfo) {
-            .registerIndex   = CF_REGISTER_EX,
-            .isMemoryAccess  = false,
-            .doReadImmediate = true,
-        },
-        -(int32_t)block->localCount * 4
-    );
-    cfCodeGeneratorWritePushPop(self,
-        CF_OPCODE_POP,
-        (CfPushPopInfo) { CF_REGISTER_EX },
-        0
-    );
+    // ex -= localCount * 4 (stack frame isn't changed by blocks without locals)
+    if (block->localCount != 0)
+        cfCodeGeneratorWriteMove(self,
+            CF_REGISTER_EX,
+            (CfPushPopInfo) {
+                .registerIndex   = CF_REGISTER_EX,
+                .isMemoryAccess  = false,
+                .doReadImmediate = true,
+            },
+            -(int32_t)block->localCount * 4
+        );
 
     // generate block statements
     for (size_t i = 0; i < block->statementCount; i++)
         cfCodeGeneratorGenStatement(self, &block->statements[i]);
 
     // ex += localCount * 4
-    cfCodeGeneratorWritePushPop(self,
-        CF_OPCODE_PUSH,
-        (CfPushPopInfo) {
-            .registerIndex   = CF_REGISTER_EX,
-            .isMemoryAccess  = false,
-            .doReadImmediate = true,
-        },
-        +(int32_t)block->localCount * 4
-    );
-    cfCodeGeneratorWritePushPop(self,
-        CF_OPCODE_POP,
-        (CfPushPopInfo) { CF_REGISTER_EX },
-        0
-    );
+    if (block->localCount != 0)
+        cfCodeGeneratorWriteMove(self,
+            CF_REGISTER_EX,
+            (CfPushPopInfo) {
+                .registerIndex   = CF_REGISTER_EX,
+                .isMemoryAccess  = false,
+                .doReadImmediate = true,
+            },
+            +(int32_t)block->localCount * 4
+        );
 } // cfCodeGeneratorGenBlock
 
 void cfCodeGeneratorGenStatement( CfCodeGenerator *const self, const CfTirStatement *statement ) {
     switch (statement->type) {
     case CF_TIR_STATEMENT_TYPE_EXPRESSION: {
+        // assignment and call results are just not generated
+        if (statement->expression->type == CF_TIR_EXPRESSION_TYPE_ASSIGNMENT) {
+            cfCodeGeneratorGenAssignment(self, statement->expression);
+            break;
+        }
+        if (statement->expression->type == CF_TIR_EXPRESSION_TYPE_CALL) {
+            cfCodeGeneratorGenCall(self, statement->expression, false);
+            break;
+        }
+
         // generate expression (note, that ANY expression returns 32-bit value now)
         cfCodeGeneratorGenExpression(self, statement->expression);
 
@@ -572,24 +700,27 @@ void cfCodeGeneratorGenStatement( CfCodeGenerator *const self, const CfTirStatem
     }
 
     case CF_TIR_STATEMENT_TYPE_RETURN: {
-        // generate return expression
-        cfCodeGeneratorGenExpression(self, statement->return_);
+        CfPushPopInfo info;
+        int32_t immediate;
 
-        // pop ax
-        cfCodeGeneratorWritePushPop(self,
-            CF_OPCODE_POP,
-            (CfPushPopInfo) { CF_REGISTER_AX },
-            0
-        );
+        // generate return expression and pop it to ax
+        if (cfCodeGeneratorGetPushPopInfo(statement->return_, &info, &immediate)) {
+            cfCodeGeneratorWriteMove(self, CF_REGISTER_AX, info, immediate);
+        } else {
+            cfCodeGeneratorGenExpression(self, statement->return_);
+            cfCodeGeneratorWritePushPop(self,
+                CF_OPCODE_POP,
+                (CfPushPopInfo) { CF_REGISTER_AX },
+                0
+            );
+        }
         cfCodeGeneratorGenReturn(self);
         break;
     }
 
     case CF_TIR_STATEMENT_TYPE_IF: {
         /*
-            [condition]
-            push 0
-            je __fnname__else_[index]
+            [jump to __fnname__else_[index] if condition is false]
 
             [code then]
 
@@ -620,15 +751,7 @@ void cfCodeGeneratorGenStatement( CfCodeGenerator *const self, const CfTirStatem
             condIndex
         );
 
-        cfCodeGeneratorGenExpression(self, statement->if_.condition);
-        cfCodeGeneratorWritePushPop(self,
-            CF_OPCODE_PUSH,
-            (CfPushPopInfo) { CF_REGISTER_CZ },
-            0
-        );
-        cfCodeGeneratorWriteOpcode(self, CF_OPCODE_CMP);
-        cfCodeGeneratorWriteOpcode(self, CF_OPCODE_JE);
-        cfCodeGeneratorAddLink(self, CF_STR(elseLabel));
+        cfCodeGeneratorGenJumpIfFalse(self, statement->if_.condition, CF_STR(elseLabel));
 
         cfCodeGeneratorGenBlock(self, statement->if_.blockThen);
         cfCodeGeneratorWriteOpcode(self, CF_OPCODE_JMP);
@@ -672,22 +795,8 @@ void cfCodeGeneratorGenStatement( CfCodeGenerator *const self, const CfTirStatem
         cfCodeGeneratorAddLabel(self, CF_STR(loopLabel));
 
         if (statement->loop.condition != NULL) {
-            /*
-                [condition]
-                push 0
-                cmp
-                je __fnname__loop_end_[index]
-            */
-
-            cfCodeGeneratorGenExpression(self, statement->loop.condition);
-            cfCodeGeneratorWritePushPop(self,
-                CF_OPCODE_PUSH,
-                (CfPushPopInfo) { CF_REGISTER_CZ },
-                0
-            );
-            cfCodeGeneratorWriteOpcode(self, CF_OPCODE_CMP);
-            cfCodeGeneratorWriteOpcode(self, CF_OPCODE_JE);
-            cfCodeGeneratorAddLink(self, CF_STR(loopEndLabel));
+            // [jump to __fnname__loop_end_[index] if condition is false]
+            cfCodeGeneratorGenJumpIfFalse(self, statement->loop.condition, CF_STR(loopEndLabel));
         }
 
         // generate loop block
@@ -787,32 +896,19 @@ void cfCodeGeneratorGenFunction( CfCodeGenerator *const self, const CfTirFunctio
     );
 
     // fx = ex
-    cfCodeGeneratorWritePushPop(self,
-        CF_OPCODE_PUSH,
-        (CfPushPopInfo) { CF_REGISTER_EX },
-        0
-    );
-    cfCodeGeneratorWritePushPop(self,
-        CF_OPCODE_POP,
-        (CfPushPopInfo) { CF_REGISTER_FX },
-        0
-    );
+    cfCodeGeneratorWriteMove(self, CF_REGISTER_FX, (CfPushPopInfo) { CF_REGISTER_EX }, 0);
 
     // ex -= argCount * 4
-    cfCodeGeneratorWritePushPop(self,
-        CF_OPCODE_PUSH,
-        (CfPushPopInfo) {
-            .registerIndex   = CF_REGISTER_EX,
-            .isMemoryAccess  = false,
-            .doReadImmediate = true,
-        },
-        -(int32_t)function->prototype.inputTypeArrayLength * 4
-    );
-    cfCodeGeneratorWritePushPop(self,
-        CF_OPCODE_POP,
-        (CfPushPopInfo) { CF_REGISTER_EX },
-        0
-    );
+    if (function->prototype.inputTypeArrayLength != 0)
+        cfCodeGeneratorWriteMove(self,
+            CF_REGISTER_EX,
+            (CfPushPopInfo) {
+                .registerIndex   = CF_REGISTER_EX,
+                .isMemoryAccess  = false,
+                .doReadImmediate = true,
+            },
+            -(int32_t)function->prototype.inputTypeArrayLength * 4
+        );
 
     // codegenerate block
     cfCodeGeneratorGenBlock(self, function->impl);
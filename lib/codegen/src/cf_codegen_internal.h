@@ -129,6 +129,23 @@ void cfCodeGeneratorWritePushPop(
     int32_t                immediate
 );
 
+/**
+ * @brief write push/pop instruction with (possibly) scaled index and sub-word access size
+ * 
+ * @param[in] self      code generator pointer
+ * @param[in] opcode    opcode (should be push or pop)
+ * @param[in] info      push/pop info
+ * @param[in] index     push/pop index (ignored if isIndexed info field is false)
+ * @param[in] immediate immediate (ignored if doReadImmediate info field is false)
+ */
+void cfCodeGeneratorWritePushPopIndexed(
+    CfCodeGenerator *const self,
+    CfOpcode               opcode,
+    CfPushPopInfo          info,
+    CfPushPopIndex         index,
+    int32_t                immediate
+);
+
 /**
  * @brief write opcode
  * 
@@ -137,6 +154,68 @@ void cfCodeGeneratorWritePushPop(
  */
 void cfCodeGeneratorWriteOpcode( CfCodeGenerator *const self, CfOpcode opcode );
 
+/**
+ * @brief write mov instruction
+ * 
+ * @param[in] self        code generator pointer
+ * @param[in] destination destination register
+ * @param[in] source      source push/pop info
+ * @param[in] immediate   source immediate (ignored if doReadImmediate source field is false)
+ */
+void cfCodeGeneratorWriteMove(
+    CfCodeGenerator *const self,
+    CfRegister             destination,
+    CfPushPopInfo          source,
+    int32_t                immediate
+);
+
+/**
+ * @brief write ppush instruction
+ * 
+ * @param[in] self            code generator pointer
+ * @param[in] first           first pushed value push/pop info
+ * @param[in] firstImmediate  first pushed value immediate
+ * @param[in] second          second pushed value push/pop info
+ * @param[in] secondImmediate second pushed value immediate
+ */
+void cfCodeGeneratorWritePushPair(
+    CfCodeGenerator *const self,
+    CfPushPopInfo          first,
+    int16_t                firstImmediate,
+    CfPushPopInfo          second,
+    int16_t                secondImmediate
+);
+
+/**
+ * @brief generate binary operator operands (lhs is pushed first)
+ * 
+ * @param[in] self code generator
+ * @param[in] lhs  left hand side
+ * @param[in] rhs  right hand side
+ * 
+ * @note operands are pushed by single ppush instruction if it's possible
+ */
+void cfCodeGeneratorGenOperands(
+    CfCodeGenerator       *const self,
+    const CfTirExpression *      lhs,
+    const CfTirExpression *      rhs
+);
+
+/**
+ * @brief generate jump to label if condition is false (zero)
+ * 
+ * @param[in] self      code generator
+ * @param[in] condition condition expression
+ * @param[in] label     label to jump to
+ * 
+ * @note comparison results are not pushed, jump is performed by comparison flags directly
+ */
+void cfCodeGeneratorGenJumpIfFalse(
+    CfCodeGenerator       *const self,
+    const CfTirExpression *      condition,
+    CfStr                        label
+);
+
 /**
  * @brief generate expression code
  * 
@@ -34,27 +34,39 @@ static const char * cfAsmGetRegisterName( uint8_t reg ) {
  * @param[out] dst    formatting destination
  * @param[in]  dstLen destinatino buffer length
  * @param[in]  info   pushPop info
+ * @param[in]  index  pushPop index (any value acceptable if info index flag is not set)
  * @param[in]  imm    immediate value (any value acceptable if info immediate reading flag is not set)
  */
 static void cfAsmFormatPushPopInfo(
     char                *const dst,
     const size_t               dstLen,
     const CfPushPopInfo        info,
+    const CfPushPopIndex       index,
     const uint32_t             imm
 ) {
-    if (info.isMemoryAccess) {
-        if (info.doReadImmediate) {
-            snprintf(dst, dstLen, "[%s + 0x%08X]", cfAsmGetRegisterName(info.registerIndex), imm);
-            return;
-        }
-        snprintf(dst, dstLen, "[%s]", cfAsmGetRegisterName(info.registerIndex));
-        return;
-    }
-    if (info.doReadImmediate) {
-        snprintf(dst, dstLen, "%s + 0x%08X", cfAsmGetRegisterName(info.registerIndex), imm);
-        return;
+    char indexText[16] = "";
+    char immText[16] = "";
+
+    if (info.isIndexed)
+        snprintf(indexText, sizeof(indexText), " + %s * %d",
+            cfAsmGetRegisterName(index.registerIndex),
+            1 << index.scaleShift
+        );
+    if (info.doReadImmediate)
+        snprintf(immText, sizeof(immText), " + 0x%08X", imm);
+
+    const char *sizePrefix = "";
+    switch (info.accessSize) {
+    case CF_ACCESS_SIZE_8  : sizePrefix = "byte "; break;
+    case CF_ACCESS_SIZE_16 : sizePrefix = "word "; break;
     }
-    snprintf(dst, dstLen, "%s", cfAsmGetRegisterName(info.registerIndex));
+
+    snprintf(dst, dstLen, info.isMemoryAccess ? "%s[%s%s%s]" : "%s%s%s%s",
+        sizePrefix,
+        cfAsmGetRegisterName(info.registerIndex),
+        indexText,
+        immText
+    );
 } // cfAsmFormatPushPopInfo
 
 CfDisassemblyStatus cfDisassemble( const CfExecutable *exec, char **dest, CfDisassemblyDetails *details ) {
@@ -219,6 +231,49 @@ CfDisassemblyStatus cfDisassemble( const CfExecutable *exec, char **dest, CfDisa
             strcpy(line, "iwkd");
             break;
         }
+        case CF_OPCODE_SNAP: {
+            strcpy(line, "snap");
+            break;
+        }
+        case CF_OPCODE_VADD: {
+            strcpy(line, "vadd");
+            break;
+        }
+        case CF_OPCODE_VSUB: {
+            strcpy(line, "vsub");
+            break;
+        }
+        case CF_OPCODE_VMUL: {
+            strcpy(line, "vmul");
+            break;
+        }
+        case CF_OPCODE_VDOT: {
+            strcpy(line, "vdot");
+            break;
+        }
+        case CF_OPCODE_VBCAST: {
+            strcpy(line, "vbcast");
+            break;
+        }
+        case CF_OPCODE_VSQRT: {
+            strcpy(line, "vsqrt");
+            break;
+        }
+        case CF_OPCODE_MCPY: {
+            strcpy(line, "mcpy");
+            break;
+        }
+
+        case CF_OPCODE_MSET: {
+            if (bytecodeEnd - bytecode < 1) {
+                cfDarrDtor(outStack);
+                return CF_DISASSEMBLY_STATUS_UNEXPECTED_CODE_END;
+            }
+            uint8_t width = *bytecode++;
+
+            snprintf(line, lineLengthMax, "mset %u", (unsigned int)width);
+            break;
+        }
 
         case CF_OPCODE_JL:
         case CF_OPCODE_JLE:
@@ -226,6 +281,8 @@ CfDisassemblyStatus cfDisassemble( const CfExecutable *exec, char **dest, CfDisa
         case CF_OPCODE_JGE:
         case CF_OPCODE_JE:
         case CF_OPCODE_JNE:
+        case CF_OPCODE_JZ:
+        case CF_OPCODE_JNZ:
         case CF_OPCODE_JMP:
         case CF_OPCODE_CALL: {
             if (bytecodeEnd - bytecode < 4) {
@@ -244,6 +301,8 @@ CfDisassemblyStatus cfDisassemble( const CfExecutable *exec, char **dest, CfDisa
             case CF_OPCODE_JGE : name = "jge "; break;
             case CF_OPCODE_JE  : name = "je  "; break;
             case CF_OPCODE_JNE : name = "jne "; break;
+            case CF_OPCODE_JZ  : name = "jz  "; break;
+            case CF_OPCODE_JNZ : name = "jnz "; break;
             case CF_OPCODE_JMP : name = "jmp "; break;
             case CF_OPCODE_CALL: name = "call"; break;
             }
@@ -273,15 +332,27 @@ CfDisassemblyStatus cfDisassemble( const CfExecutable *exec, char **dest, CfDisa
         }
 
         case CF_OPCODE_POP:
-        case CF_OPCODE_PUSH: {
+        case CF_OPCODE_PUSH:
+        case CF_OPCODE_VLD:
+        case CF_OPCODE_VST: {
             if (bytecodeEnd - bytecode < 1) {
                 cfDarrDtor(outStack);
                 return CF_DISASSEMBLY_STATUS_UNEXPECTED_CODE_END;
             }
             CfPushPopInfo info = *(const CfPushPopInfo *)bytecode;
             bytecode += sizeof(CfPushPopInfo);
+            CfPushPopIndex index = { .asByte = 0 };
             uint32_t imm = 0;
 
+            if (info.isIndexed) {
+                if (bytecodeEnd - bytecode < 1) {
+                    cfDarrDtor(outStack);
+                    return CF_DISASSEMBLY_STATUS_UNEXPECTED_CODE_END;
+                }
+                index = *(const CfPushPopIndex *)bytecode;
+                bytecode += sizeof(CfPushPopIndex);
+            }
+
             if (info.doReadImmediate) {
                 // read immediate, actually
                 if (bytecodeEnd - bytecode < 4) {
@@ -292,18 +363,101 @@ CfDisassemblyStatus cfDisassemble( const CfExecutable *exec, char **dest, CfDisa
                 bytecode += sizeof(uint32_t);
             }
 
-            const char *name = opcode == CF_OPCODE_PUSH ? "push  " : "pop   ";
+            const char *name = "???   ";
+            switch (opcode) {
+            case CF_OPCODE_PUSH: name = "push  "; break;
+            case CF_OPCODE_POP : name = "pop   "; break;
+            case CF_OPCODE_VLD : name = "vld   "; break;
+            case CF_OPCODE_VST : name = "vst   "; break;
+            }
 
             strncpy(line, name, lineLengthMax);
             cfAsmFormatPushPopInfo(
                 line + strlen(name),
                 lineLengthMax - strlen(name),
                 info,
+                index,
                 imm
             );
             break;
         }
 
+        case CF_OPCODE_MOV: {
+            if (bytecodeEnd - bytecode < 2) {
+                cfDarrDtor(outStack);
+                return CF_DISASSEMBLY_STATUS_UNEXPECTED_CODE_END;
+            }
+            CfPushPopInfo source = *(const CfPushPopInfo *)bytecode;
+            CfPushPopInfo destination = *(const CfPushPopInfo *)(bytecode + 1);
+            bytecode += 2 * sizeof(CfPushPopInfo);
+            uint32_t imm = 0;
+
+            if (source.doReadImmediate) {
+                if (bytecodeEnd - bytecode < 4) {
+                    cfDarrDtor(outStack);
+                    return CF_DISASSEMBLY_STATUS_UNEXPECTED_CODE_END;
+                }
+                imm = *(const uint32_t *)bytecode;
+                bytecode += sizeof(uint32_t);
+            }
+
+            // destination is formatted as pop argument (so invalid ones are visible)
+            strcpy(line, "mov   ");
+            cfAsmFormatPushPopInfo(line + strlen(line), lineLengthMax - strlen(line), destination, (CfPushPopIndex){}, 0);
+            strcat(line, " ");
+            cfAsmFormatPushPopInfo(line + strlen(line), lineLengthMax - strlen(line), source, (CfPushPopIndex){}, imm);
+            break;
+        }
+
+        case CF_OPCODE_PPUSH: {
+            if (bytecodeEnd - bytecode < 6) {
+                cfDarrDtor(outStack);
+                return CF_DISASSEMBLY_STATUS_UNEXPECTED_CODE_END;
+            }
+            CfPushPopInfo first = *(const CfPushPopInfo *)bytecode;
+            CfPushPopInfo second = *(const CfPushPopInfo *)(bytecode + 1);
+            int16_t firstImm, secondImm;
+            memcpy(&firstImm, bytecode + 2, 2);
+            memcpy(&secondImm, bytecode + 4, 2);
+            bytecode += 6;
+
+            strcpy(line, "ppush ");
+            cfAsmFormatPushPopInfo(line + strlen(line), lineLengthMax - strlen(line), first, (CfPushPopIndex){}, (uint32_t)(int32_t)firstImm);
+            strcat(line, " ");
+            cfAsmFormatPushPopInfo(line + strlen(line), lineLengthMax - strlen(line), second, (CfPushPopIndex){}, (uint32_t)(int32_t)secondImm);
+            break;
+        }
+
+        case CF_OPCODE_CSET:
+        case CF_OPCODE_ICSET:
+        case CF_OPCODE_FCSET: {
+            if (bytecodeEnd - bytecode < 1) {
+                cfDarrDtor(outStack);
+                return CF_DISASSEMBLY_STATUS_UNEXPECTED_CODE_END;
+            }
+            uint8_t condition = *bytecode++;
+
+            const char *name = "???  ";
+            switch (opcode) {
+            case CF_OPCODE_CSET : name = "cset "; break;
+            case CF_OPCODE_ICSET: name = "icset"; break;
+            case CF_OPCODE_FCSET: name = "fcset"; break;
+            }
+
+            const char *conditionName = "???";
+            switch (condition) {
+            case CF_CONDITION_LE: conditionName = "le"; break;
+            case CF_CONDITION_L : conditionName = "l";  break;
+            case CF_CONDITION_GE: conditionName = "ge"; break;
+            case CF_CONDITION_G : conditionName = "g";  break;
+            case CF_CONDITION_E : conditionName = "e";  break;
+            case CF_CONDITION_NE: conditionName = "ne"; break;
+            }
+
+            snprintf(line, lineLengthMax, "%s %s", name, conditionName);
+            break;
+        }
+
         default: {
             if (details != NULL)
                 details->unknownOpcode.opcode = opcode;
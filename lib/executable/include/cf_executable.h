@@ -2,6 +2,15 @@
  * @brief CF executable basic functions declaration file
  * 
  * @note actually, this file contains full 'specification' of CF binary executable format.
+ *
+ * @note executable without segments, symbols and with zero entry point is written in original format
+ * (header and code). Other ones are written in sectioned format: header, section table and section
+ * contents (code, RAM segments and symbols), so RAM is initialized by copying segments instead of
+ * executing initialization code.
+ *
+ * @note executable of any format may be written compressed: compressed header (magic and file image size)
+ * is followed by LZ-compressed file image (see cf_lz.h), so it's decompressed into the final image buffer
+ * (instead of separate file and image buffers) during reading.
  */
 
 #ifndef CF_EXECUTABLE_H_
@@ -223,8 +232,8 @@ typedef enum CfOpcode_ {
     CF_OPCODE_FSQRT,  ///< Square RooT calculation
 
     // push-pop instructions
-    CF_OPCODE_PUSH,   ///< 32-bit literal pushing opcode
-    CF_OPCODE_POP,    ///< 32-bit value removing opcode
+    CF_OPCODE_PUSH,   ///< 32-bit literal pushing opcode. Followed by push/pop info, push/pop index (if required) and immediate (if required).
+    CF_OPCODE_POP,    ///< 32-bit value removing opcode. Followed by push/pop info, push/pop index (if required) and immediate (if required).
 
     // comparison instruction family
     CF_OPCODE_CMP,  ///< unsigned integer comparison instruction
@@ -256,8 +265,55 @@ typedef enum CfOpcode_ {
 
     CF_OPCODE_IWKD, ///< (Input Wait Key Down) waits any key press, returns pressed key opcode.
     CF_OPCODE_IGKS, ///< (Input Get Key State) pushes current key state (1 if pressed 0 if not). In case if popped value does not correspond any key value, pushes 0.
+
+    // fused instructions (superinstructions for common instruction sequences)
+    CF_OPCODE_MOV,   ///< (MOVe) 'push src; pop dst' equivalent. Followed by source push/pop info, destination push/pop info (register only) and source immediate (if required).
+    CF_OPCODE_PPUSH, ///< (Pair PUSH) 'push first; push second' equivalent. Followed by two push/pop infos and two 16-bit signed immediates (always present).
+    CF_OPCODE_CSET,  ///< (Compare and SET) unsigned comparison, that also pushes 1 if condition (followed CfCondition byte) holds and 0 if not
+    CF_OPCODE_ICSET, ///< signed integer comparison, that also pushes 1 if condition holds and 0 if not
+    CF_OPCODE_FCSET, ///< floating-point comparison, that also pushes 1 if condition holds and 0 if not
+    CF_OPCODE_JZ,    ///< (Jump if Zero) pops value and jumps if it's zero
+    CF_OPCODE_JNZ,   ///< (Jump if Not Zero) pops value and jumps if it's not zero
+
+    CF_OPCODE_SNAP,  ///< (SNAPshot) writes VM state snapshot, execution may be started from it later (no-op if snapshot isn't requested by VM user)
+
+    // packed f32x4 instructions (vector occupies 4 operand stack elements, lane 0 is the deepest one)
+    CF_OPCODE_VLD,    ///< (Vector LoaD) pushes 4 f32 lanes from [register + immediate]. Followed by push/pop info (memory access only) and immediate (if required).
+    CF_OPCODE_VST,    ///< (Vector STore) pops 4 f32 lanes into [register + immediate]. Followed by push/pop info (memory access only) and immediate (if required).
+    CF_OPCODE_VADD,   ///< f32x4 lane-wise addition
+    CF_OPCODE_VSUB,   ///< f32x4 lane-wise substraction
+    CF_OPCODE_VMUL,   ///< f32x4 lane-wise multiplication
+    CF_OPCODE_VDOT,   ///< f32x4 dot product (pops two vectors, pushes single f32)
+    CF_OPCODE_VBCAST, ///< (Vector BroadCAST) pops f32 and pushes vector with it in all lanes
+    CF_OPCODE_VSQRT,  ///< f32x4 lane-wise square root
+
+    // bulk memory instructions (whole range is checked before access)
+    CF_OPCODE_MCPY,   ///< (Memory CoPY) pops size, source and destination address and copies size bytes (ranges may overlap)
+    CF_OPCODE_MSET,   ///< (Memory SET) pops count, value and destination address and fills count elements by value. Followed by element bit width byte (8 or 32).
 } CfOpcode;
 
+/// @brief system call (SYSCALL instruction immediate) enumeration
+typedef enum CfSystemCall_ {
+    CF_SYSTEM_CALL_READ_FLOAT64,    ///< reads number and pushes it as f32
+    CF_SYSTEM_CALL_WRITE_FLOAT64,   ///< pops f32 and writes it
+    CF_SYSTEM_CALL_READ_F32_ARRAY,  ///< pops element count and array address, reads f32 numbers into array and pushes count of read ones
+    CF_SYSTEM_CALL_WRITE_F32_ARRAY, ///< pops element count and array address, writes f32 numbers from array
+    CF_SYSTEM_CALL_READ_I32_ARRAY,  ///< pops element count and array address, reads i32 numbers into array and pushes count of read ones
+    CF_SYSTEM_CALL_WRITE_I32_ARRAY, ///< pops element count and array address, writes i32 numbers from array
+
+    _CF_SYSTEM_CALL_MAX,            ///< count of system calls
+} CfSystemCall;
+
+/// @brief comparison condition (operand of compare-and-set instruction family, same order as in conditional jumps)
+typedef enum CfCondition_ {
+    CF_CONDITION_LE, ///< <=
+    CF_CONDITION_L,  ///< <
+    CF_CONDITION_GE, ///< >=
+    CF_CONDITION_G,  ///< >
+    CF_CONDITION_E,  ///< ==
+    CF_CONDITION_NE, ///< !=
+} CfCondition;
+
 /// @brief colored character representation structure (used in coloredText video mode)
 typedef struct CfColoredCharacter_ {
     uint8_t character;               ///< character itself
@@ -284,10 +340,44 @@ typedef union CfVideoMemory_ {
     } colorPalette;
 } CfVideoMemory;
 
+/// @brief maximal length of symbol name (including null terminator)
+#define CF_SYMBOL_MAX 64
+
+/// @brief RAM segment kind
+typedef enum CfSegmentKind_ {
+    CF_SEGMENT_KIND_DATA   = 0, ///< initialized data
+    CF_SEGMENT_KIND_RODATA = 1, ///< initialized read-only data (RAM isn't protected by VM, so it's read-only by convention)
+    CF_SEGMENT_KIND_ZERO   = 2, ///< zero-initialized data (has no contents)
+} CfSegmentKind;
+
+/// @brief RAM segment (contents are placed into VM RAM before execution starts)
+typedef struct CfSegment_ {
+    uint32_t     kind;    ///< segment kind (CfSegmentKind)
+    uint32_t     address; ///< RAM address segment starts at
+    uint32_t     size;    ///< segment size (in bytes)
+    const void * data;    ///< segment contents (null for zero-initialized segments)
+} CfSegment;
+
+/// @brief executable symbol (label executable is linked with)
+typedef struct CfSymbol_ {
+    uint32_t value;               ///< symbol value (code offset, RAM address or constant)
+    uint32_t isCode;              ///< true if value is code offset
+    char     name[CF_SYMBOL_MAX]; ///< symbol name (null-terminated)
+} CfSymbol;
+
 /// @brief bytecode executable represetnation structure
 typedef struct CfExecutable_ {
-    void    *code;       ///< executable bytecode
-    size_t   codeLength; ///< executable bytecode length
+    void      * code;          ///< executable bytecode
+    size_t      codeLength;    ///< executable bytecode length
+    uint32_t    entryPoint;    ///< offset of instruction execution starts from
+    CfSegment * segments;      ///< RAM segments (null if executable has no segments)
+    size_t      segmentCount;  ///< RAM segment count
+    CfSymbol  * symbols;       ///< symbols (null if executable has no symbols)
+    size_t      symbolCount;   ///< symbol count
+
+    void      * image;         ///< file image code and segment contents are placed in (null if they're allocated separately)
+    size_t      imageSize;     ///< file image size
+    bool        isImageMapped; ///< true if image is read-only file mapping, false if it's allocated by malloc
 } CfExecutable;
 
 /// @brief executable reading status
@@ -297,8 +387,18 @@ typedef enum CfExecutableReadStatus_ {
     CF_EXECUTABLE_READ_STATUS_UNEXPECTED_FILE_END,      ///< unexpected end of file
     CF_EXECUTABLE_READ_STATUS_INVALID_EXECUTABLE_MAGIC, ///< invalid executable magic number
     CF_EXECUTABLE_READ_STATUS_CODE_INVALID_HASH,        ///< invalid executable code hash
+    CF_EXECUTABLE_READ_STATUS_FILE_ERROR,               ///< executable file opening (or mapping) error
+    CF_EXECUTABLE_READ_STATUS_INVALID_SECTION_TABLE,    ///< invalid section table (sections are out of file, segments are out of address space etc.)
+    CF_EXECUTABLE_READ_STATUS_INVALID_COMPRESSED_DATA,  ///< compressed executable can't be decompressed
 } CfExecutableReadStatus;
 
+/// @brief push/pop memory access size
+typedef enum CfAccessSize_ {
+    CF_ACCESS_SIZE_32 = 0, ///< 32-bit access (default one)
+    CF_ACCESS_SIZE_8  = 1, ///< 8-bit access (value is zero-extended by push)
+    CF_ACCESS_SIZE_16 = 2, ///< 16-bit access (value is zero-extended by push)
+} CfAccessSize;
+
 /// @brief push and pop instruction additional data
 typedef struct CfPushPopInfo_ {
     union {
@@ -307,10 +407,23 @@ typedef struct CfPushPopInfo_ {
             uint8_t registerIndex   : 3; ///< index of register to get value from
             uint8_t isMemoryAccess  : 1; ///< true if destination is placed in memory
             uint8_t doReadImmediate : 1; ///< is this instruction followed by 4-byte immediate
+            uint8_t accessSize      : 2; ///< memory access size (CfAccessSize, memory accesses only)
+            uint8_t isIndexed       : 1; ///< is this info followed by CfPushPopIndex byte (push/pop instructions only)
         };
     };
 } CfPushPopInfo;
 
+/// @brief push and pop instruction scaled index (value is register + index register * scale + immediate)
+typedef struct CfPushPopIndex_ {
+    union {
+        uint8_t asByte; ///< pushPopIndex asByte
+        struct {
+            uint8_t registerIndex : 3; ///< index of register to get index from
+            uint8_t scaleShift    : 2; ///< index scale logarithm (so scale is 1, 2, 4 or 8)
+        };
+    };
+} CfPushPopIndex;
+
 /**
  * @brief executable from file reading function
  * 
@@ -321,6 +434,27 @@ typedef struct CfPushPopInfo_ {
  */
 CfExecutableReadStatus cfExecutableRead( FILE *file, CfExecutable *dst );
 
+/**
+ * @brief executable from file mapping function
+ *
+ * @param[in]  path          executable file path (non-null)
+ * @param[in]  hashCachePath trusted hash cache file path (null if cache isn't used)
+ * @param[in]  verifyHash    true if code hash should be verified even if it's trusted by cache
+ * @param[out] dst           executable destination (non-null)
+ *
+ * @return operation status
+ *
+ * @note code and segment contents are not copied, they're kept in read-only shared file mapping (so its
+ * pages are shared by all processes that execute the same file), so file must not be modified while
+ * executable is used.
+ * @note hash is verified if verifyHash is set or if file identity (device, inode, size and
+ * modification time) isn't found in hash cache, verified identities are appended to the cache.
+ * Hash is not verified at all if verifyHash isn't set and cache isn't used.
+ * @note executable is read by cfExecutableRead if files can't be mapped by host.
+ * @note compressed executable is decompressed into private buffer (so mapping is released immediately).
+ */
+CfExecutableReadStatus cfExecutableMap( const char *path, const char *hashCachePath, bool verifyHash, CfExecutable *dst );
+
 /**
  * @brief executable to file writing function
  * 
@@ -331,10 +465,20 @@ CfExecutableReadStatus cfExecutableRead( FILE *file, CfExecutable *dst );
  */
 bool cfExecutableWrite( FILE *file, const CfExecutable *executable );
 
+/**
+ * @brief executable to file in compressed format writing function
+ *
+ * @param[out] file       destination file, should allow "wb" access
+ * @param[in]  executable executable to dump to file (non-null)
+ *
+ * @return true if succeeded, false otherwise
+ */
+bool cfExecutableWriteCompressed( FILE *file, const CfExecutable *executable );
+
 /**
  * @brief executable destructor
  * 
- * @param[in] executable executable to destroy
+ * @param[in] executable executable to destroy (read, mapped or linked one)
  */
 void cfExecutableDtor( CfExecutable *executable );
 
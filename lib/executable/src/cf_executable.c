@@ -1,12 +1,30 @@
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
+
+#ifdef CF_EXECUTABLE_MMAP
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
 
 #include "cf_executable.h"
 #include "cf_hash.h"
+#include "cf_lz.h"
 
 /// @brief executable file magic
 const uint64_t CF_EXECUTABLE_MAGIC = 0x0045434146544143; // "CATFACE\0" as char
 
+/// @brief sectioned executable file magic
+const uint64_t CF_EXECUTABLE_SECTIONED_MAGIC = 0x3245434146544143; // "CATFACE2" as char
+
+/// @brief compressed executable file magic
+const uint64_t CF_EXECUTABLE_COMPRESSED_MAGIC = 0x5A45434146544143; // "CATFACEZ" as char
+
+/// @brief section contents alignment (in bytes)
+#define CF_EXECUTABLE_SECTION_ALIGNMENT 8
+
 /// @brief executable file header representation structure
 typedef struct CfExecutableHeader_ {
     uint64_t magic;      ///< executable magic number
@@ -14,59 +32,725 @@ typedef struct CfExecutableHeader_ {
     CfHash   codeHash;   ///< executable bytecode hash
 } CfExecutableHeader;
 
+/// @brief sectioned executable file header representation structure
+typedef struct CfExecutableSectionedHeader_ {
+    uint64_t magic;        ///< sectioned executable magic number
+    uint32_t sectionCount; ///< count of sections in section table
+    uint32_t entryPoint;   ///< offset of instruction execution starts from
+    uint64_t contentSize;  ///< size of section table and section contents
+    CfHash   contentHash;  ///< section table and section contents hash
+} CfExecutableSectionedHeader;
+
+/// @brief compressed executable file header (it's followed by LZ-compressed image of original or sectioned executable file)
+typedef struct CfExecutableCompressedHeader_ {
+    uint64_t magic;     ///< compressed executable magic number
+    uint64_t imageSize; ///< decompressed file image size
+} CfExecutableCompressedHeader;
+
+/// @brief section kind
+typedef enum CfExecutableSectionKind_ {
+    CF_EXECUTABLE_SECTION_KIND_CODE,    ///< bytecode (exactly one section)
+    CF_EXECUTABLE_SECTION_KIND_SYMBOLS, ///< symbol array (at most one section)
+    CF_EXECUTABLE_SECTION_KIND_SEGMENT, ///< RAM segment
+} CfExecutableSectionKind;
+
+/// @brief section table entry (table is placed right after sectioned executable header)
+typedef struct CfExecutableSection_ {
+    uint32_t kind;        ///< section kind (CfExecutableSectionKind)
+    uint32_t segmentKind; ///< RAM segment kind (CfSegmentKind, segment sections only)
+    uint32_t address;     ///< RAM segment address (segment sections only)
+    uint32_t size;        ///< section contents size (zero-initialized segments have no contents, so it's segment size)
+    uint64_t offset;      ///< section contents offset (from section table start)
+} CfExecutableSection;
+
+/// @brief executable file layout (common for both formats)
+typedef struct CfExecutableLayout_ {
+    size_t   headerSize;   ///< file header size
+    uint64_t contentSize;  ///< size of file part that follows header
+    CfHash   contentHash;  ///< hash of file part that follows header
+    bool     isSectioned;  ///< true if file is in sectioned format (so content is section table and sections)
+    uint32_t sectionCount; ///< section count (sectioned format only)
+    uint32_t entryPoint;   ///< entry point (sectioned format only)
+} CfExecutableLayout;
+
+/**
+ * @brief executable header parsing function
+ *
+ * @param[in]  header header bytes
+ * @param[in]  size   count of available header bytes
+ * @param[out] dst    layout destination (non-null)
+ *
+ * @return operation status
+ */
+static CfExecutableReadStatus cfExecutableParseHeader(
+    const uint8_t      *const header,
+    const size_t              size,
+    CfExecutableLayout *const dst
+) {
+    uint64_t magic;
+
+    if (size < sizeof(magic))
+        return CF_EXECUTABLE_READ_STATUS_UNEXPECTED_FILE_END;
+    memcpy(&magic, header, sizeof(magic));
+
+    if (magic == CF_EXECUTABLE_MAGIC) {
+        CfExecutableHeader original;
+
+        if (size < sizeof(original))
+            return CF_EXECUTABLE_READ_STATUS_UNEXPECTED_FILE_END;
+        memcpy(&original, header, sizeof(original));
+
+        *dst = (CfExecutableLayout) {
+            .headerSize  = sizeof(original),
+            .contentSize = original.codeLength,
+            .contentHash = original.codeHash,
+            .isSectioned = false,
+        };
+        return CF_EXECUTABLE_READ_STATUS_OK;
+    }
+
+    if (magic == CF_EXECUTABLE_SECTIONED_MAGIC) {
+        CfExecutableSectionedHeader sectioned;
+
+        if (size < sizeof(sectioned))
+            return CF_EXECUTABLE_READ_STATUS_UNEXPECTED_FILE_END;
+        memcpy(&sectioned, header, sizeof(sectioned));
+
+        *dst = (CfExecutableLayout) {
+            .headerSize   = sizeof(sectioned),
+            .contentSize  = sectioned.contentSize,
+            .contentHash  = sectioned.contentHash,
+            .isSectioned  = true,
+            .sectionCount = sectioned.sectionCount,
+            .entryPoint   = sectioned.entryPoint,
+        };
+        return CF_EXECUTABLE_READ_STATUS_OK;
+    }
+
+    return CF_EXECUTABLE_READ_STATUS_INVALID_EXECUTABLE_MAGIC;
+} // cfExecutableParseHeader
+
+/**
+ * @brief executable header from file reading function
+ *
+ * @param[in]  file  file to read header from
+ * @param[in]  magic file magic (it's already read)
+ * @param[out] dst   layout destination (non-null)
+ *
+ * @return operation status
+ */
+static CfExecutableReadStatus cfExecutableReadHeader( FILE *const file, const uint64_t magic, CfExecutableLayout *const dst ) {
+    uint8_t header[sizeof(CfExecutableSectionedHeader)];
+
+    memcpy(header, &magic, sizeof(magic));
+
+    // header size depends on format
+    const size_t headerSize = magic == CF_EXECUTABLE_SECTIONED_MAGIC
+        ? sizeof(CfExecutableSectionedHeader)
+        : sizeof(CfExecutableHeader);
+
+    if (magic != CF_EXECUTABLE_MAGIC && magic != CF_EXECUTABLE_SECTIONED_MAGIC)
+        return CF_EXECUTABLE_READ_STATUS_INVALID_EXECUTABLE_MAGIC;
+    if (1 != fread(header + sizeof(magic), headerSize - sizeof(magic), 1, file))
+        return CF_EXECUTABLE_READ_STATUS_UNEXPECTED_FILE_END;
+
+    return cfExecutableParseHeader(header, headerSize, dst);
+} // cfExecutableReadHeader
+
+/**
+ * @brief executable content (part of file that follows header) parsing function
+ *
+ * @param[in]  layout  executable layout
+ * @param[in]  content content bytes (layout.contentSize bytes, hash is already verified)
+ * @param[out] dst     executable destination (non-null, code, segments and their contents point to content)
+ *
+ * @return operation status
+ */
+static CfExecutableReadStatus cfExecutableParseContent(
+    const CfExecutableLayout *const layout,
+    uint8_t                  *const content,
+    CfExecutable             *const dst
+) {
+    memset(dst, 0, sizeof(CfExecutable));
+
+    if (!layout->isSectioned) {
+        dst->code = content;
+        dst->codeLength = layout->contentSize;
+        return CF_EXECUTABLE_READ_STATUS_OK;
+    }
+
+    if (layout->sectionCount > layout->contentSize / sizeof(CfExecutableSection))
+        return CF_EXECUTABLE_READ_STATUS_INVALID_SECTION_TABLE;
+
+    CfExecutableReadStatus status = CF_EXECUTABLE_READ_STATUS_OK;
+    size_t codeSectionCount = 0;
+    size_t symbolSectionCount = 0;
+
+    dst->segments = (CfSegment *)calloc(layout->sectionCount, sizeof(CfSegment));
+    if (dst->segments == NULL)
+        return CF_EXECUTABLE_READ_STATUS_INTERNAL_ERROR;
+
+    for (uint32_t i = 0; i < layout->sectionCount; i++) {
+        CfExecutableSection section;
+        memcpy(&section, content + i * sizeof(CfExecutableSection), sizeof(section));
+
+        const bool hasContents = false
+            || section.kind != CF_EXECUTABLE_SECTION_KIND_SEGMENT
+            || section.segmentKind != CF_SEGMENT_KIND_ZERO
+        ;
+
+        if (hasContents && (section.offset > layout->contentSize || section.size > layout->contentSize - section.offset)) {
+            status = CF_EXECUTABLE_READ_STATUS_INVALID_SECTION_TABLE;
+            break;
+        }
+
+        switch (section.kind) {
+        case CF_EXECUTABLE_SECTION_KIND_CODE:
+            codeSectionCount++;
+            dst->code = content + section.offset;
+            dst->codeLength = section.size;
+            break;
+
+        case CF_EXECUTABLE_SECTION_KIND_SYMBOLS:
+            symbolSectionCount++;
+            if (section.size % sizeof(CfSymbol) != 0 || symbolSectionCount > 1) {
+                status = CF_EXECUTABLE_READ_STATUS_INVALID_SECTION_TABLE;
+                break;
+            }
+
+            // symbols are copied, so their names may be terminated
+            dst->symbolCount = section.size / sizeof(CfSymbol);
+            dst->symbols = (CfSymbol *)calloc(dst->symbolCount, sizeof(CfSymbol));
+            if (dst->symbols == NULL) {
+                status = CF_EXECUTABLE_READ_STATUS_INTERNAL_ERROR;
+                break;
+            }
+
+            memcpy(dst->symbols, content + section.offset, section.size);
+            for (size_t s = 0; s < dst->symbolCount; s++)
+                dst->symbols[s].name[CF_SYMBOL_MAX - 1] = '\0';
+            break;
+
+        case CF_EXECUTABLE_SECTION_KIND_SEGMENT:
+            // segment must fit into 32-bit address space
+            if (section.segmentKind > CF_SEGMENT_KIND_ZERO || (uint64_t)section.address + section.size > ((uint64_t)1 << 32)) {
+                status = CF_EXECUTABLE_READ_STATUS_INVALID_SECTION_TABLE;
+                break;
+            }
+
+            dst->segments[dst->segmentCount++] = (CfSegment) {
+                .kind    = section.segmentKind,
+                .address = section.address,
+                .size    = section.size,
+                .data    = hasContents ? content + section.offset : NULL,
+            };
+            break;
+
+        default:
+            status = CF_EXECUTABLE_READ_STATUS_INVALID_SECTION_TABLE;
+        }
+
+        if (status != CF_EXECUTABLE_READ_STATUS_OK)
+            break;
+    }
+
+    dst->entryPoint = layout->entryPoint;
+
+    if (status == CF_EXECUTABLE_READ_STATUS_OK && (codeSectionCount != 1 || dst->entryPoint > dst->codeLength))
+        status = CF_EXECUTABLE_READ_STATUS_INVALID_SECTION_TABLE;
+
+    if (status != CF_EXECUTABLE_READ_STATUS_OK) {
+        free(dst->segments);
+        free(dst->symbols);
+        memset(dst, 0, sizeof(CfExecutable));
+        return status;
+    }
+
+    if (dst->segmentCount == 0) {
+        free(dst->segments);
+        dst->segments = NULL;
+    }
+
+    return CF_EXECUTABLE_READ_STATUS_OK;
+} // cfExecutableParseContent
+
+/**
+ * @brief executable from file image parsing function
+ *
+ * @param[in]  image     file image (allocated by malloc, it's owned by executable if succeeded)
+ * @param[in]  imageSize file image size
+ * @param[out] dst       executable destination (non-null)
+ *
+ * @return operation status
+ */
+static CfExecutableReadStatus cfExecutableParseImage( uint8_t *const image, const size_t imageSize, CfExecutable *const dst ) {
+    CfExecutableLayout layout;
+    CfExecutableReadStatus status = cfExecutableParseHeader(image, imageSize, &layout);
+
+    if (status == CF_EXECUTABLE_READ_STATUS_OK && layout.contentSize > imageSize - layout.headerSize)
+        status = CF_EXECUTABLE_READ_STATUS_UNEXPECTED_FILE_END;
+
+    if (status == CF_EXECUTABLE_READ_STATUS_OK) {
+        const CfHash hash = cfHash(image + layout.headerSize, layout.contentSize);
+
+        if (!cfHashCompare(&hash, &layout.contentHash))
+            status = CF_EXECUTABLE_READ_STATUS_CODE_INVALID_HASH;
+    }
+
+    if (status == CF_EXECUTABLE_READ_STATUS_OK)
+        status = cfExecutableParseContent(&layout, image + layout.headerSize, dst);
+
+    if (status != CF_EXECUTABLE_READ_STATUS_OK)
+        return status;
+
+    dst->image = image;
+    dst->imageSize = imageSize;
+    return CF_EXECUTABLE_READ_STATUS_OK;
+} // cfExecutableParseImage
+
+/**
+ * @brief compressed executable from file reading function
+ *
+ * @param[in]  file file to read executable from (its magic is already read)
+ * @param[out] dst  executable destination (non-null)
+ *
+ * @return operation status
+ */
+static CfExecutableReadStatus cfExecutableReadCompressed( FILE *const file, CfExecutable *const dst ) {
+    uint64_t imageSize;
+
+    if (1 != fread(&imageSize, sizeof(imageSize), 1, file))
+        return CF_EXECUTABLE_READ_STATUS_UNEXPECTED_FILE_END;
+    if (imageSize > SIZE_MAX)
+        return CF_EXECUTABLE_READ_STATUS_INTERNAL_ERROR;
+
+    // image is decompressed into its final buffer block by block
+    uint8_t *const image = (uint8_t *)malloc(imageSize == 0 ? 1 : (size_t)imageSize);
+    if (image == NULL)
+        return CF_EXECUTABLE_READ_STATUS_INTERNAL_ERROR;
+
+    CfExecutableReadStatus status = cfLzDecompressFile(file, image, (size_t)imageSize)
+        ? cfExecutableParseImage(image, (size_t)imageSize, dst)
+        : CF_EXECUTABLE_READ_STATUS_INVALID_COMPRESSED_DATA;
+
+    if (status != CF_EXECUTABLE_READ_STATUS_OK)
+        free(image);
+    return status;
+} // cfExecutableReadCompressed
+
 CfExecutableReadStatus cfExecutableRead( FILE *file, CfExecutable *dst ) {
     assert(file != NULL);
     assert(dst != NULL);
 
-    CfExecutableHeader header;
-
-    if (!fread(&header, sizeof(CfExecutableHeader), 1, file))
+    uint64_t magic;
+    if (1 != fread(&magic, sizeof(magic), 1, file))
         return CF_EXECUTABLE_READ_STATUS_UNEXPECTED_FILE_END;
 
-    if (header.magic != CF_EXECUTABLE_MAGIC)
-        return CF_EXECUTABLE_READ_STATUS_INVALID_EXECUTABLE_MAGIC;
+    if (magic == CF_EXECUTABLE_COMPRESSED_MAGIC)
+        return cfExecutableReadCompressed(file, dst);
+
+    CfExecutableLayout layout;
+    CfExecutableReadStatus status = cfExecutableReadHeader(file, magic, &layout);
+
+    if (status != CF_EXECUTABLE_READ_STATUS_OK)
+        return status;
 
-    void *code = calloc(header.codeLength, 1);
-    if (code == NULL)
+    // content is read as a whole, so its hash is calculated in the same way as by writer
+    uint8_t *content = (uint8_t *)calloc(layout.contentSize, 1);
+    if (content == NULL)
         return CF_EXECUTABLE_READ_STATUS_INTERNAL_ERROR;
-    size_t readCount = fread(code, 1, header.codeLength, file);
-    if (readCount != header.codeLength) {
-        free(code);
+    size_t readCount = fread(content, 1, layout.contentSize, file);
+    if (readCount != layout.contentSize) {
+        free(content);
         return CF_EXECUTABLE_READ_STATUS_UNEXPECTED_FILE_END;
     }
 
-    CfHash hash = cfHash(code, readCount);
-    if (!cfHashCompare(&hash, &header.codeHash)) {
-        free(code);
+    CfHash hash = cfHash(content, readCount);
+    if (!cfHashCompare(&hash, &layout.contentHash)) {
+        free(content);
         return CF_EXECUTABLE_READ_STATUS_CODE_INVALID_HASH;
     }
 
-    dst->code = code;
-    dst->codeLength = header.codeLength;
+    status = cfExecutableParseContent(&layout, content, dst);
+    if (status != CF_EXECUTABLE_READ_STATUS_OK) {
+        free(content);
+        return status;
+    }
+
+    // code of original format executable is the content itself
+    if (layout.isSectioned) {
+        dst->image = content;
+        dst->imageSize = layout.contentSize;
+    }
 
     return CF_EXECUTABLE_READ_STATUS_OK;
 } // cfExecutableRead
 
-bool cfExecutableWrite( FILE *const dst, const CfExecutable *const executable ) {
-    assert(executable != NULL);
+#ifdef CF_EXECUTABLE_MMAP
+
+/// @brief trusted hash cache entry (cache file is array of them)
+typedef struct CfExecutableHashCacheEntry_ {
+    uint64_t device;    ///< executable file device
+    uint64_t inode;     ///< executable file inode
+    uint64_t size;      ///< executable file size
+    int64_t  mtimeSec;  ///< executable file modification time (seconds)
+    int64_t  mtimeNsec; ///< executable file modification time (nanoseconds)
+    CfHash   hash;      ///< verified code hash
+} CfExecutableHashCacheEntry;
+
+/**
+ * @brief trusted hash cache entry of executable file building function
+ *
+ * @param[in] status executable file status
+ * @param[in] hash   executable code hash (from its header)
+ *
+ * @return cache entry
+ */
+static CfExecutableHashCacheEntry cfExecutableGetHashCacheEntry( const struct stat *const status, const CfHash *const hash ) {
+    CfExecutableHashCacheEntry entry;
+
+    // entry is compared by memcmp, so padding is zeroed
+    memset(&entry, 0, sizeof(entry));
+    entry.device = (uint64_t)status->st_dev;
+    entry.inode = (uint64_t)status->st_ino;
+    entry.size = (uint64_t)status->st_size;
+#ifdef __APPLE__
+    entry.mtimeSec = (int64_t)status->st_mtimespec.tv_sec;
+    entry.mtimeNsec = (int64_t)status->st_mtimespec.tv_nsec;
+#else
+    entry.mtimeSec = (int64_t)status->st_mtim.tv_sec;
+    entry.mtimeNsec = (int64_t)status->st_mtim.tv_nsec;
+#endif
+    entry.hash = *hash;
+
+    return entry;
+} // cfExecutableGetHashCacheEntry
+
+/**
+ * @brief trusted hash cache lookup function
+ *
+ * @param[in] path  cache file path (non-null)
+ * @param[in] entry entry to find
+ *
+ * @return true if entry is present in cache (so hash of the same file was verified before), false otherwise
+ */
+static bool cfExecutableHashCacheContains( const char *const path, const CfExecutableHashCacheEntry *const entry ) {
+    FILE *file = fopen(path, "rb");
+    CfExecutableHashCacheEntry cacheEntry;
+    bool isFound = false;
+
+    if (file == NULL)
+        return false;
+
+    while (!isFound && 1 == fread(&cacheEntry, sizeof(cacheEntry), 1, file))
+        isFound = 0 == memcmp(&cacheEntry, entry, sizeof(cacheEntry));
+
+    fclose(file);
+    return isFound;
+} // cfExecutableHashCacheContains
+
+#endif
+
+CfExecutableReadStatus cfExecutableMap(
+    const char   *const path,
+    const char   *const hashCachePath,
+    const bool          verifyHash,
+    CfExecutable *const dst
+) {
+    assert(path != NULL);
     assert(dst != NULL);
 
+#ifdef CF_EXECUTABLE_MMAP
+    const int fd = open(path, O_RDONLY);
+    struct stat status;
+
+    if (fd == -1)
+        return CF_EXECUTABLE_READ_STATUS_FILE_ERROR;
+
+    if (0 != fstat(fd, &status) || status.st_size == 0) {
+        close(fd);
+        return status.st_size == 0
+            ? CF_EXECUTABLE_READ_STATUS_UNEXPECTED_FILE_END
+            : CF_EXECUTABLE_READ_STATUS_FILE_ERROR;
+    }
+
+    // mapping stays valid after file is closed
+    const size_t mappingSize = (size_t)status.st_size;
+    void *const mapping = mmap(NULL, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED)
+        return CF_EXECUTABLE_READ_STATUS_FILE_ERROR;
+
+    uint8_t *image = (uint8_t *)mapping;
+    size_t imageSize = mappingSize;
+    bool isImageMapped = true;
+    CfExecutableCompressedHeader compressedHeader;
+    CfExecutableReadStatus readStatus = CF_EXECUTABLE_READ_STATUS_OK;
+
+    // compressed image can't be shared, so it's decompressed into private buffer and mapping is released
+    if (mappingSize >= sizeof(compressedHeader) && 0 == memcmp(mapping, &CF_EXECUTABLE_COMPRESSED_MAGIC, sizeof(uint64_t))) {
+        memcpy(&compressedHeader, mapping, sizeof(compressedHeader));
+
+        image = compressedHeader.imageSize <= SIZE_MAX
+            ? (uint8_t *)malloc(compressedHeader.imageSize == 0 ? 1 : (size_t)compressedHeader.imageSize)
+            : NULL;
+        imageSize = (size_t)compressedHeader.imageSize;
+        isImageMapped = false;
+
+        if (image == NULL)
+            readStatus = CF_EXECUTABLE_READ_STATUS_INTERNAL_ERROR;
+        else if (!cfLzDecompress((const uint8_t *)mapping + sizeof(compressedHeader), mappingSize - sizeof(compressedHeader), image, imageSize))
+            readStatus = CF_EXECUTABLE_READ_STATUS_INVALID_COMPRESSED_DATA;
+
+        munmap(mapping, mappingSize);
+    }
+
+    CfExecutableLayout layout = {0};
+
+    if (readStatus == CF_EXECUTABLE_READ_STATUS_OK)
+        readStatus = cfExecutableParseHeader(image, imageSize, &layout);
+
+    if (readStatus == CF_EXECUTABLE_READ_STATUS_OK && layout.contentSize > imageSize - layout.headerSize)
+        readStatus = CF_EXECUTABLE_READ_STATUS_UNEXPECTED_FILE_END;
+
+    uint8_t *const content = image + layout.headerSize;
+
+    if (readStatus == CF_EXECUTABLE_READ_STATUS_OK && (verifyHash || hashCachePath != NULL)) {
+        const CfExecutableHashCacheEntry entry = cfExecutableGetHashCacheEntry(&status, &layout.contentHash);
+
+        if (verifyHash || !cfExecutableHashCacheContains(hashCachePath, &entry)) {
+            const CfHash hash = cfHash(content, layout.contentSize);
+
+            if (!cfHashCompare(&hash, &layout.contentHash)) {
+                readStatus = CF_EXECUTABLE_READ_STATUS_CODE_INVALID_HASH;
+            } else if (hashCachePath != NULL && (!verifyHash || !cfExecutableHashCacheContains(hashCachePath, &entry))) {
+                // cache is just not extended if it can't be written
+                FILE *cache = fopen(hashCachePath, "ab");
+
+                if (cache != NULL) {
+                    fwrite(&entry, sizeof(entry), 1, cache);
+                    fclose(cache);
+                }
+            }
+        }
+    }
+
+    // mapping is read-only, so contents are never modified through non-const pointers
+    if (readStatus == CF_EXECUTABLE_READ_STATUS_OK)
+        readStatus = cfExecutableParseContent(&layout, content, dst);
+
+    if (readStatus != CF_EXECUTABLE_READ_STATUS_OK) {
+        if (isImageMapped)
+            munmap(image, imageSize);
+        else
+            free(image);
+        return readStatus;
+    }
+
+    dst->image = image;
+    dst->imageSize = imageSize;
+    dst->isImageMapped = isImageMapped;
+
+    return CF_EXECUTABLE_READ_STATUS_OK;
+#else
+    // hash is always verified by reading function
+    (void)hashCachePath;
+    (void)verifyHash;
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+        return CF_EXECUTABLE_READ_STATUS_FILE_ERROR;
+
+    const CfExecutableReadStatus readStatus = cfExecutableRead(file, dst);
+    fclose(file);
+    return readStatus;
+#endif
+} // cfExecutableMap
+
+/**
+ * @brief section contents size alignment function
+ *
+ * @param[in] size size to align
+ *
+ * @return size aligned up to CF_EXECUTABLE_SECTION_ALIGNMENT
+ */
+static uint64_t cfExecutableAlignSection( const uint64_t size ) {
+    return (size + CF_EXECUTABLE_SECTION_ALIGNMENT - 1) / CF_EXECUTABLE_SECTION_ALIGNMENT * CF_EXECUTABLE_SECTION_ALIGNMENT;
+} // cfExecutableAlignSection
+
+/**
+ * @brief sectioned executable file image building function
+ *
+ * @param[in]  executable executable to build image of (non-null)
+ * @param[out] dstSize    image size destination (non-null)
+ *
+ * @return file image (allocated by malloc, null if allocation failed)
+ */
+static uint8_t * cfExecutableBuildSectioned( const CfExecutable *const executable, size_t *const dstSize ) {
+    const uint32_t sectionCount = (uint32_t)(1 + executable->segmentCount + (executable->symbolCount != 0));
+    uint64_t contentSize = cfExecutableAlignSection(sectionCount * sizeof(CfExecutableSection));
+
+    // calculate content size
+    contentSize += cfExecutableAlignSection(executable->codeLength);
+    for (size_t i = 0; i < executable->segmentCount; i++)
+        if (executable->segments[i].kind != CF_SEGMENT_KIND_ZERO)
+            contentSize += cfExecutableAlignSection(executable->segments[i].size);
+    contentSize += executable->symbolCount * sizeof(CfSymbol);
+
+    // content is built in memory, so it's hashed at once
+    uint8_t *const image = (uint8_t *)calloc(sizeof(CfExecutableSectionedHeader) + contentSize, 1);
+    if (image == NULL)
+        return NULL;
+
+    uint8_t *const content = image + sizeof(CfExecutableSectionedHeader);
+    CfExecutableSection *const sections = (CfExecutableSection *)content;
+    uint64_t offset = cfExecutableAlignSection(sectionCount * sizeof(CfExecutableSection));
+    uint32_t sectionIndex = 0;
+
+    sections[sectionIndex++] = (CfExecutableSection) {
+        .kind   = CF_EXECUTABLE_SECTION_KIND_CODE,
+        .size   = (uint32_t)executable->codeLength,
+        .offset = offset,
+    };
+    memcpy(content + offset, executable->code, executable->codeLength);
+    offset += cfExecutableAlignSection(executable->codeLength);
+
+    for (size_t i = 0; i < executable->segmentCount; i++) {
+        const CfSegment *const segment = &executable->segments[i];
+
+        sections[sectionIndex++] = (CfExecutableSection) {
+            .kind        = CF_EXECUTABLE_SECTION_KIND_SEGMENT,
+            .segmentKind = segment->kind,
+            .address     = segment->address,
+            .size        = segment->size,
+            .offset      = segment->kind != CF_SEGMENT_KIND_ZERO ? offset : 0,
+        };
+
+        if (segment->kind != CF_SEGMENT_KIND_ZERO) {
+            memcpy(content + offset, segment->data, segment->size);
+            offset += cfExecutableAlignSection(segment->size);
+        }
+    }
+
+    if (executable->symbolCount != 0) {
+        sections[sectionIndex++] = (CfExecutableSection) {
+            .kind   = CF_EXECUTABLE_SECTION_KIND_SYMBOLS,
+            .size   = (uint32_t)(executable->symbolCount * sizeof(CfSymbol)),
+            .offset = offset,
+        };
+        memcpy(content + offset, executable->symbols, executable->symbolCount * sizeof(CfSymbol));
+    }
+
+    const CfExecutableSectionedHeader header = {
+        .magic        = CF_EXECUTABLE_SECTIONED_MAGIC,
+        .sectionCount = sectionCount,
+        .entryPoint   = executable->entryPoint,
+        .contentSize  = contentSize,
+        .contentHash  = cfHash(content, contentSize),
+    };
+    memcpy(image, &header, sizeof(header));
+
+    *dstSize = sizeof(header) + contentSize;
+    return image;
+} // cfExecutableBuildSectioned
+
+/**
+ * @brief executable file image building function
+ *
+ * @param[in]  executable executable to build image of (non-null)
+ * @param[out] dstSize    image size destination (non-null)
+ *
+ * @return file image (allocated by malloc, null if allocation failed)
+ */
+static uint8_t * cfExecutableBuildImage( const CfExecutable *const executable, size_t *const dstSize ) {
+    // executables that don't require sections are written in original format, so older tools may read them
+    if (executable->segmentCount != 0 || executable->symbolCount != 0 || executable->entryPoint != 0)
+        return cfExecutableBuildSectioned(executable, dstSize);
+
     const CfExecutableHeader executableHeader = {
         .magic = CF_EXECUTABLE_MAGIC,
         .codeLength = executable->codeLength,
         .codeHash = cfHash(executable->code, executable->codeLength),
     };
 
-    return true
-        && sizeof(executableHeader) == fwrite(&executableHeader, 1, sizeof(executableHeader), dst)
-        && executable->codeLength == fwrite(executable->code, 1, executable->codeLength, dst)
-    ;
+    uint8_t *const image = (uint8_t *)malloc(sizeof(executableHeader) + executable->codeLength);
+    if (image == NULL)
+        return NULL;
+
+    memcpy(image, &executableHeader, sizeof(executableHeader));
+    memcpy(image + sizeof(executableHeader), executable->code, executable->codeLength);
+
+    *dstSize = sizeof(executableHeader) + executable->codeLength;
+    return image;
+} // cfExecutableBuildImage
+
+bool cfExecutableWrite( FILE *const dst, const CfExecutable *const executable ) {
+    assert(executable != NULL);
+    assert(dst != NULL);
+
+    size_t imageSize = 0;
+    uint8_t *const image = cfExecutableBuildImage(executable, &imageSize);
+
+    if (image == NULL)
+        return false;
+
+    const bool isOk = imageSize == fwrite(image, 1, imageSize, dst);
+
+    free(image);
+    return isOk;
 } // cfExecutableWrite
 
+bool cfExecutableWriteCompressed( FILE *const dst, const CfExecutable *const executable ) {
+    assert(executable != NULL);
+    assert(dst != NULL);
+
+    size_t imageSize = 0;
+    uint8_t *const image = cfExecutableBuildImage(executable, &imageSize);
+
+    if (image == NULL)
+        return false;
+
+    uint8_t *const compressed = (uint8_t *)malloc(cfLzCompressBound(imageSize));
+    if (compressed == NULL) {
+        free(image);
+        return false;
+    }
+
+    const size_t compressedSize = cfLzCompress(image, imageSize, compressed);
+    const CfExecutableCompressedHeader header = {
+        .magic     = CF_EXECUTABLE_COMPRESSED_MAGIC,
+        .imageSize = imageSize,
+    };
+
+    const bool isOk = true
+        && sizeof(header) == fwrite(&header, 1, sizeof(header), dst)
+        && compressedSize == fwrite(compressed, 1, compressedSize, dst)
+    ;
+
+    free(compressed);
+    free(image);
+    return isOk;
+} // cfExecutableWriteCompressed
+
 void cfExecutableDtor( CfExecutable *executable ) {
     assert(executable != NULL);
 
-    free(executable->code);
+    if (executable->image == NULL) {
+        // code and segment contents are allocated separately
+        free(executable->code);
+        for (size_t i = 0; i < executable->segmentCount; i++)
+            free((void *)executable->segments[i].data);
+    } else if (executable->isImageMapped) {
+#ifdef CF_EXECUTABLE_MMAP
+        munmap(executable->image, executable->imageSize);
+#endif
+    } else {
+        free(executable->image);
+    }
+
+    free(executable->segments);
+    free(executable->symbols);
 } // cfExecutableDtor
 
 
@@ -77,6 +761,9 @@ const char * cfExecutableReadStatusStr( CfExecutableReadStatus status ) {
     case CF_EXECUTABLE_READ_STATUS_UNEXPECTED_FILE_END  : return "unexpected file end";
     case CF_EXECUTABLE_READ_STATUS_INVALID_EXECUTABLE_MAGIC : return "invalid executable magic";
     case CF_EXECUTABLE_READ_STATUS_CODE_INVALID_HASH    : return "invalid hash";
+    case CF_EXECUTABLE_READ_STATUS_FILE_ERROR           : return "file opening error";
+    case CF_EXECUTABLE_READ_STATUS_INVALID_SECTION_TABLE: return "invalid section table";
+    case CF_EXECUTABLE_READ_STATUS_INVALID_COMPRESSED_DATA: return "invalid compressed data";
 
     default                                         : return "<invalid>";
     }
@@ -19,6 +19,9 @@ typedef enum CfLinkStatus_ {
     CF_LINK_STATUS_INTERNAL_ERROR,  ///< internal error
     CF_LINK_STATUS_UNKNOWN_LABEL,   ///< unknown label
     CF_LINK_STATUS_DUPLICATE_LABEL, ///< duplicated label declaration
+    CF_LINK_STATUS_OVERLAPPING_SEGMENTS, ///< RAM segments overlap
+    CF_LINK_STATUS_DUPLICATE_ENTRY,      ///< entry point is declared by several objects
+    CF_LINK_STATUS_INVALID_ENTRY,        ///< entry point label isn't code label
 } CfLinkStatus;
 
 /// @brief linking process details
@@ -36,6 +39,22 @@ typedef struct CfLinkDetails_ {
         uint32_t secondLine; ///< line where second label is declared
         CfStr    label;      ///< label itself
     } duplicateLabel;
+
+    struct {
+        CfStr    firstFile;     ///< file first segment is declared in
+        uint32_t firstAddress;  ///< first segment address
+        CfStr    secondFile;    ///< file second segment is declared in
+        uint32_t secondAddress; ///< second segment address
+    } overlappingSegments;
+
+    struct {
+        CfStr firstFile;  ///< file entry point is declared in first
+        CfStr secondFile; ///< file entry point is declared in second
+    } duplicateEntry;
+
+    struct {
+        CfStr label; ///< entry point label
+    } invalidEntry;
 } CfLinkDetails;
 
 /**
@@ -47,6 +66,9 @@ typedef struct CfLinkDetails_ {
  * @param[out] details     more detailed info about linking process (nullable)
  * 
  * @return operation status
+ *
+ * @note segments of all objects are placed into executable (they must not overlap). Symbols are
+ * written only if executable is sectioned anyway (e.g. if it has segments or entry point).
  */
 CfLinkStatus cfLink(
     const CfObject * objects,
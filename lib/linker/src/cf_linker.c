@@ -4,6 +4,7 @@
 
 #include <assert.h>
 #include <setjmp.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <cf_darr.h>
@@ -15,9 +16,16 @@ typedef struct CfLinkerLabel_ {
     CfStr    sourceName; ///< file label declared at
     uint32_t sourceLine; ///< line label declared at
     uint32_t value;      ///< label underlying value
+    bool     isCode;     ///< true if value is code offset
     CfStr    label;      ///< label name
 } CfLinkerLabel;
 
+/// @brief linker internal segment representation
+typedef struct CfLinkerSegment_ {
+    CfStr             sourceName; ///< file segment declared in
+    const CfSegment * segment;    ///< segment itself (owned by object)
+} CfLinkerSegment;
+
 /// @brief linker internal label and link representations
 typedef struct CfLinkerLabelAndLink_ {
     CfStr    sourceName; ///< file label declared in
@@ -31,6 +39,9 @@ typedef struct CfLinker_ {
     CfDarr          code;            ///< code array
     CfDarr          links;           ///< links
     CfDarr          labels;          ///< labels
+    CfDarr          segments;        ///< RAM segments
+    CfStr           entry;           ///< entry point label (empty if not declared)
+    CfStr           entrySourceName; ///< file entry point is declared in
 
     CfLinkStatus    linkStatus;      ///< linking status
     CfLinkDetails * details;         ///< linking details (non-null)
@@ -101,6 +112,36 @@ void cfLinkerAddLink( CfLinker *const self, const CfLinkerLink *const link ) {
         cfLinkerThrow(self, CF_LINK_STATUS_INTERNAL_ERROR);
 } // cfLinkerAddLink
 
+/**
+ * @brief segment to linker adding function
+ *
+ * @param[in,out] self    linker pointer
+ * @param[in]     segment segment to add
+ */
+void cfLinkerAddSegment( CfLinker *const self, const CfLinkerSegment *const segment ) {
+    const CfLinkerSegment *segments = (const CfLinkerSegment *)cfDarrData(self->segments);
+    const uint64_t begin = segment->segment->address;
+    const uint64_t end = begin + segment->segment->size;
+
+    // search for overlapping segment
+    for (size_t i = 0, n = cfDarrLength(self->segments); i < n; i++) {
+        const uint64_t otherBegin = segments[i].segment->address;
+        const uint64_t otherEnd = otherBegin + segments[i].segment->size;
+
+        if (begin < otherEnd && otherBegin < end) {
+            self->details->overlappingSegments.firstFile = segments[i].sourceName;
+            self->details->overlappingSegments.firstAddress = segments[i].segment->address;
+            self->details->overlappingSegments.secondFile = segment->sourceName;
+            self->details->overlappingSegments.secondAddress = segment->segment->address;
+
+            cfLinkerThrow(self, CF_LINK_STATUS_OVERLAPPING_SEGMENTS);
+        }
+    }
+
+    if (CF_DARR_OK != cfDarrPush(&self->segments, segment))
+        cfLinkerThrow(self, CF_LINK_STATUS_INTERNAL_ERROR);
+} // cfLinkerAddSegment
+
 /**
  * @brief object to linker adding function
  * 
@@ -122,12 +163,36 @@ void cfLinkerAddObject( CfLinker *const self, const CfObject *const object ) {
                 ? object->labels[i].value + codeSize
                 : object->labels[i].value
             ,
+            .isCode     = object->labels[i].isRelative != 0,
             .label      = CF_STR(object->labels[i].label),
         };
 
         cfLinkerAddLabel(self, &label);
     }
 
+    // append segments
+    for (size_t i = 0; i < object->segmentCount; i++) {
+        CfLinkerSegment segment = {
+            .sourceName = sourceName,
+            .segment    = object->segments + i,
+        };
+
+        cfLinkerAddSegment(self, &segment);
+    }
+
+    // set entry point
+    if (object->entry[0] != '\0') {
+        if (self->entrySourceName.begin != NULL) {
+            self->details->duplicateEntry.firstFile = self->entrySourceName;
+            self->details->duplicateEntry.secondFile = sourceName;
+
+            cfLinkerThrow(self, CF_LINK_STATUS_DUPLICATE_ENTRY);
+        }
+
+        self->entry = CF_STR(object->entry);
+        self->entrySourceName = sourceName;
+    }
+
     // append links
     for (size_t i = 0; i < object->linkCount; i++) {
         CfLinkerLink link = {
@@ -171,9 +236,84 @@ void cfLinkerBuildExecutable( CfLinker *const self, CfExecutable *const dst ) {
         memcpy(code + link->codeOffset, &label->value, sizeof(link->codeOffset));
     }
 
-    dst->codeLength = cfDarrLength(self->code);
-    if (CF_DARR_OK != cfDarrIntoData(self->code, &dst->code))
+    CfExecutable executable = {0};
+
+    // resolve entry point
+    if (self->entry.begin != NULL) {
+        CfLinkerLabel *label = cfLinkerFindLabel(self, self->entry);
+
+        if (label == NULL) {
+            self->details->unknownLabel.file  = self->entrySourceName;
+            self->details->unknownLabel.line  = 0;
+            self->details->unknownLabel.label = self->entry;
+
+            cfLinkerThrow(self, CF_LINK_STATUS_UNKNOWN_LABEL);
+        }
+
+        if (!label->isCode) {
+            self->details->invalidEntry.label = self->entry;
+
+            cfLinkerThrow(self, CF_LINK_STATUS_INVALID_ENTRY);
+        }
+
+        executable.entryPoint = label->value;
+    }
+
+    const CfLinkerSegment *segments = (const CfLinkerSegment *)cfDarrData(self->segments);
+    const size_t segmentCount = cfDarrLength(self->segments);
+    const bool isSectioned = segmentCount != 0 || self->entry.begin != NULL;
+
+    // segment contents are copied, because objects own them
+    executable.segments = (CfSegment *)calloc(segmentCount, sizeof(CfSegment));
+    bool isOk = segmentCount == 0 || executable.segments != NULL;
+
+    for (size_t i = 0; isOk && i < segmentCount; i++) {
+        const CfSegment *const segment = segments[i].segment;
+        void *data = NULL;
+
+        if (segment->data != NULL) {
+            data = malloc(segment->size);
+            isOk = data != NULL;
+            if (isOk)
+                memcpy(data, segment->data, segment->size);
+        }
+
+        executable.segments[executable.segmentCount++] = (CfSegment) {
+            .kind    = segment->kind,
+            .address = segment->address,
+            .size    = segment->size,
+            .data    = data,
+        };
+    }
+
+    // symbols are written to sectioned executables only
+    if (isOk && isSectioned) {
+        const CfLinkerLabel *labels = (const CfLinkerLabel *)cfDarrData(self->labels);
+        const size_t labelCount = cfDarrLength(self->labels);
+
+        executable.symbols = (CfSymbol *)calloc(labelCount, sizeof(CfSymbol));
+        isOk = labelCount == 0 || executable.symbols != NULL;
+
+        for (size_t i = 0; isOk && i < labelCount; i++) {
+            CfSymbol *const symbol = &executable.symbols[executable.symbolCount++];
+            const size_t nameLength = cfStrLength(labels[i].label) < CF_SYMBOL_MAX - 1
+                ? cfStrLength(labels[i].label)
+                : CF_SYMBOL_MAX - 1
+            ;
+
+            symbol->value = labels[i].value;
+            symbol->isCode = labels[i].isCode;
+            memcpy(symbol->name, labels[i].label.begin, nameLength);
+        }
+    }
+
+    executable.codeLength = cfDarrLength(self->code);
+    if (!isOk || CF_DARR_OK != cfDarrIntoData(self->code, &executable.code)) {
+        cfExecutableDtor(&executable);
         cfLinkerThrow(self, CF_LINK_STATUS_INTERNAL_ERROR);
+    }
+
+    *dst = executable;
 } // cfLinkerBuildExecutable
 
 CfLinkStatus cfLink(
@@ -197,11 +337,12 @@ CfLinkStatus cfLink(
     linker.code = cfDarrCtor(1);
     linker.links = cfDarrCtor(sizeof(CfLinkerLink));
     linker.labels = cfDarrCtor(sizeof(CfLinkerLabel));
+    linker.segments = cfDarrCtor(sizeof(CfLinkerSegment));
     linker.details = details == NULL ? &dummyDetails : details;
     linker.linkStatus = CF_LINK_STATUS_OK;
 
     // construct
-    if (linker.code == NULL || linker.links == NULL || linker.labels == NULL) {
+    if (linker.code == NULL || linker.links == NULL || linker.labels == NULL || linker.segments == NULL) {
         linker.linkStatus = CF_LINK_STATUS_INTERNAL_ERROR;
         goto cfLink__end;
     }
@@ -214,6 +355,7 @@ cfLink__end:
     cfDarrDtor(linker.code);
     cfDarrDtor(linker.links);
     cfDarrDtor(linker.labels);
+    cfDarrDtor(linker.segments);
     return linker.linkStatus;
 } // cfLink
 
@@ -248,6 +390,29 @@ void cfLinkDetailsWrite( FILE *output, CfLinkStatus status, const CfLinkDetails
         cfStrWrite(output, details->unknownLabel.file);
         fprintf(output, ":%d", details->unknownLabel.line);
         break;
+
+    case CF_LINK_STATUS_OVERLAPPING_SEGMENTS:
+        fprintf(output, "overlapping segments (first: ");
+        cfStrWrite(output, details->overlappingSegments.firstFile);
+        fprintf(output, ":0x%X", details->overlappingSegments.firstAddress);
+        fprintf(output, ", second: ");
+        cfStrWrite(output, details->overlappingSegments.secondFile);
+        fprintf(output, ":0x%X)", details->overlappingSegments.secondAddress);
+        break;
+
+    case CF_LINK_STATUS_DUPLICATE_ENTRY:
+        fprintf(output, "duplicate entry point declaration (first: ");
+        cfStrWrite(output, details->duplicateEntry.firstFile);
+        fprintf(output, ", second: ");
+        cfStrWrite(output, details->duplicateEntry.secondFile);
+        fprintf(output, ")");
+        break;
+
+    case CF_LINK_STATUS_INVALID_ENTRY:
+        fprintf(output, "entry point label \"");
+        cfStrWrite(output, details->invalidEntry.label);
+        fprintf(output, "\" is not code label");
+        break;
     }
 } // cfLinkDetailsWrite
 
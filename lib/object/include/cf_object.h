@@ -9,6 +9,8 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include <cf_executable.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -33,13 +35,16 @@ typedef struct CfLink_ {
 
 /// @brief object (single .cfasm compilation result) represetnation structure
 typedef struct CfObject_ {
-    const char * sourceName; ///< name of object source name
-    size_t       codeLength; ///< length of bytecode
-    uint8_t    * code;       ///< bytecode itself
-    size_t       linkCount;  ///< count of links in bytecode
-    CfLink     * links;      ///< links itself
-    size_t       labelCount; ///< count of labels in bytecode
-    CfLabel    * labels;     ///< labels itself
+    const char * sourceName;          ///< name of object source name
+    size_t       codeLength;          ///< length of bytecode
+    uint8_t    * code;                ///< bytecode itself
+    size_t       linkCount;           ///< count of links in bytecode
+    CfLink     * links;               ///< links itself
+    size_t       labelCount;          ///< count of labels in bytecode
+    CfLabel    * labels;              ///< labels itself
+    size_t       segmentCount;        ///< count of RAM segments
+    CfSegment  * segments;            ///< RAM segments (contents of every segment are allocated separately)
+    char         entry[CF_LABEL_MAX]; ///< entry point label (empty if object doesn't declare entry point)
 } CfObject;
 
 /// @brief object from file reading status representation enumeration
@@ -49,6 +54,7 @@ typedef enum CfObjectReadStatus_ {
     CF_OBJECT_READ_STATUS_UNEXPECTED_FILE_END,  ///< reading from file failed
     CF_OBJECT_READ_STATUS_INVALID_OBJECT_MAGIC, ///< invalid object magic
     CF_OBJECT_READ_STATUS_INVALID_HASH,         ///< object file hash
+    CF_OBJECT_READ_STATUS_INVALID_COMPRESSED_DATA, ///< compressed object can't be decompressed
 } CfObjectReadStatus;
 
 /**
@@ -58,6 +64,8 @@ typedef enum CfObjectReadStatus_ {
  * @param[out] dst  reading destination
  * 
  * @return operation status
+ *
+ * @note both original and compressed (by cfObjectWriteCompressed) objects are read.
  */
 CfObjectReadStatus cfObjectRead( FILE *file, CfObject *dst );
 
@@ -77,6 +85,19 @@ typedef enum CfObjectWriteStatus_ {
  */
 bool cfObjectWrite( FILE *file, const CfObject *src );
 
+/**
+ * @brief object to file in compressed format writing function
+ *
+ * @param[in] file file to write object to (opened for binary writing)
+ * @param[in] src  object to write
+ *
+ * @return true if succeeded, false otherwise
+ *
+ * @note compressed object file is header (magic and object file size) followed by LZ-compressed
+ * object file (see cf_lz.h).
+ */
+bool cfObjectWriteCompressed( FILE *file, const CfObject *src );
+
 /**
  * @brief object data destructor
  * 
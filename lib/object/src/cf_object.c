@@ -3,12 +3,19 @@
 #include <string.h>
 
 #include <cf_hash.h>
+#include <cf_lz.h>
 
 #include "cf_object.h"
 
 /// @brief object file magic
 const uint64_t CF_OBJECT_MAGIC = 0x00004A424F544143;
 
+/// @brief object with RAM segments or entry point file magic
+const uint64_t CF_OBJECT_SEGMENTED_MAGIC = 0x00324A424F544143;
+
+/// @brief compressed object file magic
+const uint64_t CF_OBJECT_COMPRESSED_MAGIC = 0x5A4A424F544143;
+
 /// @brief object file representation structure
 typedef struct CfObjectFileHeader_ {
     uint64_t magic;            ///< magic value
@@ -19,19 +26,166 @@ typedef struct CfObjectFileHeader_ {
     CfHash   dataHash;         ///< sourceName - code - link - label hash
 } CfObjectFileHeader;
 
-CfObjectReadStatus cfObjectRead( FILE *file, CfObject *dst ) {
-    assert(file != NULL);
-    assert(dst != NULL);
+/// @brief segmented object file header extension (placed right after header)
+typedef struct CfObjectFileSegmentHeader_ {
+    uint32_t segmentCount;        ///< segment section length
+    uint32_t segmentDataSize;     ///< total size of segment contents
+    char     entry[CF_LABEL_MAX]; ///< entry point label
+} CfObjectFileSegmentHeader;
+
+/// @brief object file segment descriptor (contents of all segments follow descriptors)
+typedef struct CfObjectFileSegment_ {
+    uint32_t kind;    ///< segment kind
+    uint32_t address; ///< segment address
+    uint32_t size;    ///< segment size
+} CfObjectFileSegment;
+
+/// @brief compressed object file header (it's followed by LZ-compressed image of object file)
+typedef struct CfObjectFileCompressedHeader_ {
+    uint64_t magic;     ///< compressed object magic
+    uint64_t imageSize; ///< decompressed object file image size
+} CfObjectFileCompressedHeader;
+
+/// @brief object file reading source (file or decompressed file image)
+typedef struct CfObjectSource_ {
+    FILE          * file; ///< file to read from (null if data is read from image)
+    const uint8_t * data; ///< image rest
+    size_t          size; ///< image rest size
+} CfObjectSource;
+
+/**
+ * @brief fread-like object source reading function
+ *
+ * @param[out] dst         read elements destination
+ * @param[in]  elementSize element size
+ * @param[in]  count       count of elements to read
+ * @param[in]  source      source to read from (non-null)
+ *
+ * @return count of read elements
+ */
+static size_t cfObjectSourceRead( void *const dst, const size_t elementSize, size_t count, CfObjectSource *const source ) {
+    if (source->file != NULL)
+        return fread(dst, elementSize, count, source->file);
+
+    if (elementSize == 0)
+        return 0;
+    if (count > source->size / elementSize)
+        count = source->size / elementSize;
+
+    if (count != 0)
+        memcpy(dst, source->data, count * elementSize);
+    source->data += count * elementSize;
+    source->size -= count * elementSize;
+    return count;
+} // cfObjectSourceRead
+
+/**
+ * @brief object segment section from file reading function
+ *
+ * @param[in]  source          file to read segments from (positioned after header extension)
+ * @param[in]  segmentHeader header extension
+ * @param[in]  hasher        object hasher to extend by segment section (non-null)
+ * @param[out] dst           object to read segments to (non-null)
+ *
+ * @return operation status
+ */
+static CfObjectReadStatus cfObjectReadSegments(
+    CfObjectSource                  *const source,
+    const CfObjectFileSegmentHeader *const segmentHeader,
+    CfHasher                        *const hasher,
+    CfObject                        *const dst
+) {
+    CfObjectFileSegment *fileSegments = (CfObjectFileSegment *)calloc(segmentHeader->segmentCount, sizeof(CfObjectFileSegment));
+    uint8_t *segmentData = (uint8_t *)calloc(segmentHeader->segmentDataSize, sizeof(uint8_t));
+    CfObjectReadStatus status = CF_OBJECT_READ_STATUS_OK;
+    uint32_t dataOffset = 0;
+
+    dst->segments = (CfSegment *)calloc(segmentHeader->segmentCount, sizeof(CfSegment));
+    dst->segmentCount = 0;
+
+    if (fileSegments == NULL || segmentData == NULL || dst->segments == NULL) {
+        status = CF_OBJECT_READ_STATUS_INTERNAL_ERROR;
+        goto cfObjectReadSegments__end;
+    }
+
+    if (false
+        || segmentHeader->segmentCount    != cfObjectSourceRead(fileSegments, sizeof(CfObjectFileSegment), segmentHeader->segmentCount,    source)
+        || segmentHeader->segmentDataSize != cfObjectSourceRead(segmentData,  sizeof(uint8_t),             segmentHeader->segmentDataSize, source)
+    ) {
+        status = CF_OBJECT_READ_STATUS_UNEXPECTED_FILE_END;
+        goto cfObjectReadSegments__end;
+    }
+
+    cfHasherStep(hasher, fileSegments, segmentHeader->segmentCount * sizeof(CfObjectFileSegment));
+    cfHasherStep(hasher, segmentData,  segmentHeader->segmentDataSize);
+
+    // segment contents are copied, so every segment owns its data
+    for (uint32_t i = 0; i < segmentHeader->segmentCount; i++) {
+        CfSegment segment = {
+            .kind    = fileSegments[i].kind,
+            .address = fileSegments[i].address,
+            .size    = fileSegments[i].size,
+            .data    = NULL,
+        };
+
+        if (segment.kind != CF_SEGMENT_KIND_ZERO) {
+            if (segment.size > segmentHeader->segmentDataSize - dataOffset) {
+                status = CF_OBJECT_READ_STATUS_UNEXPECTED_FILE_END;
+                goto cfObjectReadSegments__end;
+            }
+
+            void *data = malloc(segment.size);
+            if (data == NULL && segment.size != 0) {
+                status = CF_OBJECT_READ_STATUS_INTERNAL_ERROR;
+                goto cfObjectReadSegments__end;
+            }
+
+            memcpy(data, segmentData + dataOffset, segment.size);
+            dataOffset += segment.size;
+            segment.data = data;
+        }
 
+        dst->segments[dst->segmentCount++] = segment;
+    }
+
+    memcpy(dst->entry, segmentHeader->entry, CF_LABEL_MAX);
+    dst->entry[CF_LABEL_MAX - 1] = '\0';
+
+cfObjectReadSegments__end:
+    free(fileSegments);
+    free(segmentData);
+    return status;
+} // cfObjectReadSegments
+
+/**
+ * @brief object from source reading function
+ *
+ * @param[in]  source source to read object from (positioned after magic, non-null)
+ * @param[in]  magic  object file magic
+ * @param[out] dst    reading destination (non-null)
+ *
+ * @return operation status
+ */
+static CfObjectReadStatus cfObjectReadSource( CfObjectSource *const source, const uint64_t magic, CfObject *const dst ) {
     CfObjectFileHeader header = {0};
 
-    if (1 != fread(&header, sizeof(header), 1, file))
-        return CF_OBJECT_READ_STATUS_UNEXPECTED_FILE_END;
-    if (header.magic != CF_OBJECT_MAGIC)
+    if (magic != CF_OBJECT_MAGIC && magic != CF_OBJECT_SEGMENTED_MAGIC)
         return CF_OBJECT_READ_STATUS_INVALID_OBJECT_MAGIC;
 
-    // just for simplicity
-    char *sourceName = (char *)calloc(header.sourceNameLength, sizeof(char));
+    // magic is already read
+    header.magic = magic;
+    if (1 != cfObjectSourceRead((uint8_t *)&header + sizeof(magic), sizeof(header) - sizeof(magic), 1, source))
+        return CF_OBJECT_READ_STATUS_UNEXPECTED_FILE_END;
+
+    CfObjectFileSegmentHeader segmentHeader = {0};
+
+    if (header.magic == CF_OBJECT_SEGMENTED_MAGIC && 1 != cfObjectSourceRead(&segmentHeader, sizeof(segmentHeader), 1, source))
+        return CF_OBJECT_READ_STATUS_UNEXPECTED_FILE_END;
+
+    memset(dst, 0, sizeof(CfObject));
+
+    // just for simplicity (source name is written without terminator)
+    char *sourceName = (char *)calloc(header.sourceNameLength + 1, sizeof(char));
     uint8_t *code = (uint8_t *)calloc(header.codeLength, sizeof(uint8_t));
     CfLink *links = (CfLink *)calloc(header.linkCount, sizeof(CfLink));
     CfLabel *labels = (CfLabel *)calloc(header.labelCount, sizeof(CfLabel));
@@ -47,10 +201,10 @@ CfObjectReadStatus cfObjectRead( FILE *file, CfObject *dst ) {
 
     // read code/links/labels
     if (false
-        || header.sourceNameLength != fread(sourceName,     sizeof(char),    header.sourceNameLength, file)
-        || header.codeLength       != fread(code,           sizeof(uint8_t), header.codeLength,       file)
-        || header.linkCount        != fread(links,          sizeof(CfLink),  header.linkCount,        file)
-        || header.labelCount       != fread(labels,         sizeof(CfLabel), header.labelCount,       file)
+        || header.sourceNameLength != cfObjectSourceRead(sourceName, sizeof(char),    header.sourceNameLength, source)
+        || header.codeLength       != cfObjectSourceRead(code,       sizeof(uint8_t), header.codeLength,       source)
+        || header.linkCount        != cfObjectSourceRead(links,      sizeof(CfLink),  header.linkCount,        source)
+        || header.labelCount       != cfObjectSourceRead(labels,     sizeof(CfLabel), header.labelCount,       source)
     ) {
         status = CF_OBJECT_READ_STATUS_UNEXPECTED_FILE_END;
         goto cfObjectRead__error;
@@ -62,6 +216,15 @@ CfObjectReadStatus cfObjectRead( FILE *file, CfObject *dst ) {
     cfHasherStep(&hasher, code,       header.codeLength);
     cfHasherStep(&hasher, links,      header.linkCount * sizeof(CfLink));
     cfHasherStep(&hasher, labels,     header.labelCount * sizeof(CfLabel));
+
+    if (header.magic == CF_OBJECT_SEGMENTED_MAGIC) {
+        cfHasherStep(&hasher, &segmentHeader, sizeof(segmentHeader));
+
+        status = cfObjectReadSegments(source, &segmentHeader, &hasher, dst);
+        if (status != CF_OBJECT_READ_STATUS_OK)
+            goto cfObjectRead__error;
+    }
+
     dataHash = cfHasherTerminate(&hasher);
 
     // compare hashes
@@ -81,18 +244,116 @@ CfObjectReadStatus cfObjectRead( FILE *file, CfObject *dst ) {
     return CF_OBJECT_READ_STATUS_OK;
 
 cfObjectRead__error:
+    for (size_t i = 0; i < dst->segmentCount; i++)
+        free((void *)dst->segments[i].data);
+    free(dst->segments);
+    dst->segments = NULL;
+    dst->segmentCount = 0;
+
+    free(sourceName);
     free(code);
     free(links);
     free(labels);
     return status;
-} // cfObjectRead
+} // cfObjectReadSource
 
-bool cfObjectWrite( FILE *file, const CfObject *src ) {
+CfObjectReadStatus cfObjectRead( FILE *file, CfObject *dst ) {
     assert(file != NULL);
-    assert(src != NULL);
+    assert(dst != NULL);
+
+    uint64_t magic = 0;
+
+    if (1 != fread(&magic, sizeof(magic), 1, file))
+        return CF_OBJECT_READ_STATUS_UNEXPECTED_FILE_END;
+
+    if (magic != CF_OBJECT_COMPRESSED_MAGIC) {
+        CfObjectSource source = { .file = file };
+
+        return cfObjectReadSource(&source, magic, dst);
+    }
+
+    uint64_t imageSize = 0;
+
+    if (1 != fread(&imageSize, sizeof(imageSize), 1, file))
+        return CF_OBJECT_READ_STATUS_UNEXPECTED_FILE_END;
+    if (imageSize < sizeof(magic) || imageSize > SIZE_MAX)
+        return CF_OBJECT_READ_STATUS_INVALID_COMPRESSED_DATA;
+
+    // object is parsed from decompressed image (its sections are copied, so they're owned by object as usual)
+    uint8_t *image = (uint8_t *)malloc((size_t)imageSize);
+    CfObjectReadStatus status = CF_OBJECT_READ_STATUS_OK;
+
+    if (image == NULL)
+        return CF_OBJECT_READ_STATUS_INTERNAL_ERROR;
+
+    if (!cfLzDecompressFile(file, image, (size_t)imageSize)) {
+        status = CF_OBJECT_READ_STATUS_INVALID_COMPRESSED_DATA;
+    } else {
+        CfObjectSource source = {
+            .file = NULL,
+            .data = image + sizeof(magic),
+            .size = (size_t)imageSize - sizeof(magic),
+        };
+
+        memcpy(&magic, image, sizeof(magic));
+        status = cfObjectReadSource(&source, magic, dst);
+    }
+
+    free(image);
+    return status;
+} // cfObjectRead
+
+/**
+ * @brief data to object file image appending function
+ *
+ * @param[in,out] dst  image write pointer (non-null)
+ * @param[in]     data data to append (may be null if size is zero)
+ * @param[in]     size data size
+ */
+static void cfObjectImagePut( uint8_t **const dst, const void *const data, const size_t size ) {
+    if (size != 0)
+        memcpy(*dst, data, size);
+    *dst += size;
+} // cfObjectImagePut
+
+/**
+ * @brief object file image building function
+ *
+ * @param[in]  src     object to build image of (non-null)
+ * @param[out] dstSize image size destination (non-null)
+ *
+ * @return object file image (allocated by malloc, null if allocation failed)
+ */
+static uint8_t * cfObjectBuildImage( const CfObject *const src, size_t *const dstSize ) {
+
+    // objects without segments and entry point are written in original format
+    const bool isSegmented = src->segmentCount != 0 || src->entry[0] != '\0';
+    CfObjectFileSegmentHeader segmentHeader = {
+        .segmentCount = (uint32_t)src->segmentCount,
+    };
+    CfObjectFileSegment *fileSegments = NULL;
+
+    if (isSegmented) {
+        fileSegments = (CfObjectFileSegment *)calloc(src->segmentCount, sizeof(CfObjectFileSegment));
+        if (fileSegments == NULL && src->segmentCount != 0)
+            return NULL;
+
+        for (size_t i = 0; i < src->segmentCount; i++) {
+            fileSegments[i] = (CfObjectFileSegment) {
+                .kind    = src->segments[i].kind,
+                .address = src->segments[i].address,
+                .size    = src->segments[i].size,
+            };
+
+            if (src->segments[i].kind != CF_SEGMENT_KIND_ZERO)
+                segmentHeader.segmentDataSize += src->segments[i].size;
+        }
+
+        memcpy(segmentHeader.entry, src->entry, CF_LABEL_MAX);
+    }
 
     CfObjectFileHeader header = {
-        .magic = CF_OBJECT_MAGIC,
+        .magic = isSegmented ? CF_OBJECT_SEGMENTED_MAGIC : CF_OBJECT_MAGIC,
         .sourceNameLength = (uint32_t)strlen(src->sourceName),
         .codeLength = (uint32_t)src->codeLength,
         .linkCount = (uint32_t)src->linkCount,
@@ -107,18 +368,109 @@ bool cfObjectWrite( FILE *file, const CfObject *src ) {
     cfHasherStep(&hasher, src->code,       header.codeLength);
     cfHasherStep(&hasher, src->links,      header.linkCount * sizeof(CfLink));
     cfHasherStep(&hasher, src->labels,     header.labelCount * sizeof(CfLabel));
+
+    // segment contents are hashed as a whole, so they're concatenated
+    uint8_t *segmentData = (uint8_t *)malloc(segmentHeader.segmentDataSize);
+    if (segmentData == NULL && segmentHeader.segmentDataSize != 0) {
+        free(fileSegments);
+        return NULL;
+    }
+
+    for (size_t i = 0, offset = 0; i < src->segmentCount; i++)
+        if (src->segments[i].kind != CF_SEGMENT_KIND_ZERO) {
+            memcpy(segmentData + offset, src->segments[i].data, src->segments[i].size);
+            offset += src->segments[i].size;
+        }
+
+    if (isSegmented) {
+        cfHasherStep(&hasher, &segmentHeader, sizeof(segmentHeader));
+        cfHasherStep(&hasher, fileSegments,   segmentHeader.segmentCount * sizeof(CfObjectFileSegment));
+        cfHasherStep(&hasher, segmentData,    segmentHeader.segmentDataSize);
+    }
+
     header.dataHash = cfHasherTerminate(&hasher);
 
-    // yeah functional style
-    return true
-        && 1 == fwrite(&header, sizeof(CfObjectFileHeader), 1, file)
-        && header.sourceNameLength == fwrite(src->sourceName, sizeof(char), header.sourceNameLength, file)
-        && header.codeLength == fwrite(src->code, sizeof(uint8_t), header.codeLength, file)
-        && header.linkCount == fwrite(src->links, sizeof(CfLink), header.linkCount, file)
-        && header.labelCount == fwrite(src->labels, sizeof(CfLabel), header.labelCount, file)
+    const size_t imageSize = 0
+        + sizeof(CfObjectFileHeader)
+        + (isSegmented ? sizeof(CfObjectFileSegmentHeader) : 0)
+        + header.sourceNameLength
+        + header.codeLength
+        + header.linkCount * sizeof(CfLink)
+        + header.labelCount * sizeof(CfLabel)
+        + segmentHeader.segmentCount * sizeof(CfObjectFileSegment)
+        + segmentHeader.segmentDataSize
     ;
+    uint8_t *const image = (uint8_t *)malloc(imageSize);
+
+    if (image != NULL) {
+        uint8_t *dst = image;
+
+        cfObjectImagePut(&dst, &header, sizeof(CfObjectFileHeader));
+        if (isSegmented)
+            cfObjectImagePut(&dst, &segmentHeader, sizeof(CfObjectFileSegmentHeader));
+        cfObjectImagePut(&dst, src->sourceName, header.sourceNameLength);
+        cfObjectImagePut(&dst, src->code,       header.codeLength);
+        cfObjectImagePut(&dst, src->links,      header.linkCount * sizeof(CfLink));
+        cfObjectImagePut(&dst, src->labels,     header.labelCount * sizeof(CfLabel));
+        cfObjectImagePut(&dst, fileSegments,    segmentHeader.segmentCount * sizeof(CfObjectFileSegment));
+        cfObjectImagePut(&dst, segmentData,     segmentHeader.segmentDataSize);
+
+        *dstSize = imageSize;
+    }
+
+    free(fileSegments);
+    free(segmentData);
+    return image;
+} // cfObjectBuildImage
+
+bool cfObjectWrite( FILE *file, const CfObject *src ) {
+    assert(file != NULL);
+    assert(src != NULL);
+
+    size_t imageSize = 0;
+    uint8_t *const image = cfObjectBuildImage(src, &imageSize);
+
+    if (image == NULL)
+        return false;
+
+    const bool isOk = imageSize == fwrite(image, sizeof(uint8_t), imageSize, file);
+
+    free(image);
+    return isOk;
 } // cfObjectWrite
 
+bool cfObjectWriteCompressed( FILE *file, const CfObject *src ) {
+    assert(file != NULL);
+    assert(src != NULL);
+
+    size_t imageSize = 0;
+    uint8_t *const image = cfObjectBuildImage(src, &imageSize);
+
+    if (image == NULL)
+        return false;
+
+    uint8_t *const compressed = (uint8_t *)malloc(cfLzCompressBound(imageSize));
+    if (compressed == NULL) {
+        free(image);
+        return false;
+    }
+
+    const size_t compressedSize = cfLzCompress(image, imageSize, compressed);
+    const CfObjectFileCompressedHeader header = {
+        .magic     = CF_OBJECT_COMPRESSED_MAGIC,
+        .imageSize = imageSize,
+    };
+
+    const bool isOk = true
+        && 1 == fwrite(&header, sizeof(CfObjectFileCompressedHeader), 1, file)
+        && compressedSize == fwrite(compressed, sizeof(uint8_t), compressedSize, file)
+    ;
+
+    free(compressed);
+    free(image);
+    return isOk;
+} // cfObjectWriteCompressed
+
 void cfObjectDtor( CfObject *object ) {
     // write NULLs or not?
 
@@ -127,6 +479,10 @@ void cfObjectDtor( CfObject *object ) {
         free(object->code);
         free(object->labels);
         free(object->links);
+
+        for (size_t i = 0; i < object->segmentCount; i++)
+            free((void *)object->segments[i].data);
+        free(object->segments);
     }
 } // cfObjectDtor
 
@@ -137,6 +493,7 @@ const char * cfObjectReadStatusStr( CfObjectReadStatus status ) {
     case CF_OBJECT_READ_STATUS_UNEXPECTED_FILE_END  : return "unexpected file end";
     case CF_OBJECT_READ_STATUS_INVALID_OBJECT_MAGIC : return "invalid object magic";
     case CF_OBJECT_READ_STATUS_INVALID_HASH         : return "invalid hash";
+    case CF_OBJECT_READ_STATUS_INVALID_COMPRESSED_DATA: return "invalid compressed data";
     }
 
     return "<invalid>";
@@ -87,6 +87,15 @@ void * cfDarrData( CfDarr darr );
  */
 size_t cfDarrLength( CfDarr darr );
 
+/**
+ * @brief dynamic array clearing function
+ * 
+ * @param[in,out] darr dynamic array to remove all elements of (non-null)
+ * 
+ * @note array capacity is kept, so array may be refilled without reallocations.
+ */
+void cfDarrClear( CfDarr darr );
+
 /**
  * @brief non-dynamic-sized array with exactly same data allocation function
  * 
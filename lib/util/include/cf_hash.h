@@ -46,7 +46,7 @@ CfHash cfHasherTerminate( CfHasher *hasher );
  * @brief iterative hasher step preferring function
  * 
  * @param[in,out] hasher hasher to perform step in (non-null)
- * @param[in]     data   data block to hash (non-null)
+ * @param[in]     data   data block to hash (non-null if size isn't zero)
  * @param[in]     size   data block size (in bytes)
  */
 void cfHasherStep( CfHasher *hasher, const void *data, size_t size );
@@ -61,6 +61,19 @@ void cfHasherStep( CfHasher *hasher, const void *data, size_t size );
  */
 CfHash cfHash( const void *data, const size_t size );
 
+/**
+ * @brief multiple data block hash calculation function
+ *
+ * @param[in]  data  data blocks to calculate hashes of (count non-null pointers)
+ * @param[in]  sizes data block sizes (in bytes)
+ * @param[in]  count count of data blocks
+ * @param[out] dst   hashes destination (count elements, non-null)
+ *
+ * @note up to 8 blocks are hashed at once by AVX2 CPUs without SHA extensions, so hashes of several blocks of similar
+ * sizes (e.g. object files) are calculated faster than by separate cfHash calls.
+ */
+void cfHashMany( const void *const *data, const size_t *sizes, size_t count, CfHash *dst );
+
 /**
  * @brief hash comparison function
  * 
@@ -0,0 +1,79 @@
+/**
+ * @brief LZ compression declaration file
+ *
+ * @note compressed stream is sequence of independently compressed blocks of CF_LZ_BLOCK_SIZE bytes (last
+ * one may be shorter). Block starts from 32-bit little-endian header: lower 31 bits are size of block
+ * contents and higher one is set if block is stored uncompressed. Compressed block is sequence of
+ * LZ4-like commands: token (higher half is literal count, lower half is match length - 4), literal count
+ * extension (255-valued bytes and terminating byte), literals, 16-bit match distance and match length
+ * extension. Last command of block has literals only.
+ */
+
+#ifndef CF_LZ_H_
+#define CF_LZ_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief size of data block compressed independently (so decompressor requires buffer of this size at most)
+#define CF_LZ_BLOCK_SIZE ((size_t)1 << 16)
+
+/**
+ * @brief compressed data size upper bound getting function
+ *
+ * @param[in] size size of data to compress
+ *
+ * @return maximal size of compressed data
+ */
+size_t cfLzCompressBound( size_t size );
+
+/**
+ * @brief data compression function
+ *
+ * @param[in]  src  data to compress (non-null if size isn't zero)
+ * @param[in]  size size of data to compress
+ * @param[out] dst  compressed data destination (at least cfLzCompressBound(size) bytes)
+ *
+ * @return compressed data size
+ */
+size_t cfLzCompress( const void *src, size_t size, void *dst );
+
+/**
+ * @brief data decompression function
+ *
+ * @param[in]  src     compressed data
+ * @param[in]  srcSize compressed data size
+ * @param[out] dst     decompressed data destination
+ * @param[in]  dstSize decompressed data size
+ *
+ * @return true if succeeded, false if compressed data is invalid (or its decompressed size isn't dstSize)
+ */
+bool cfLzDecompress( const void *src, size_t srcSize, void *dst, size_t dstSize );
+
+/**
+ * @brief data from file decompression function
+ *
+ * @param[in]  file    file to read compressed data from (opened for binary reading)
+ * @param[out] dst     decompressed data destination
+ * @param[in]  dstSize decompressed data size
+ *
+ * @return true if succeeded, false if compressed data is invalid or can't be read
+ *
+ * @note data is decompressed block by block, so only single compressed block is buffered
+ * (and uncompressed blocks are read into destination directly).
+ */
+bool cfLzDecompressFile( FILE *file, void *dst, size_t dstSize );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // !defined(CF_LZ_H_)
+
+// cf_lz.h
@@ -88,6 +88,11 @@ size_t cfDarrLength( CfDarr darr ) {
     return darr->size;
 } // cfDarrLength
 
+void cfDarrClear( CfDarr darr ) {
+    assert(darr != NULL);
+    darr->size = 0;
+} // cfDarrClear
+
 CfDarrStatus cfDarrIntoData( CfDarr darr, void **dst ) {
     assert(darr != NULL);
     void *data = calloc(darr->elementSize, darr->size);
@@ -5,10 +5,10 @@
 #include <assert.h>
 #include <string.h>
 
-#include "cf_hash.h"
+#include "cf_hash_internal.h"
 
-/// @brief SHA256 constant table
-const static uint32_t CF_constTable[64] = {
+/// @brief SHA256 constant table (shared with hardware-accelerated implementations)
+const uint32_t CF_constTable[64] = {
     0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
     0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
     0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
@@ -51,7 +51,7 @@ static inline uint32_t cfRotr32( const uint32_t n, const uint32_t at ) {
  * @param[in,out] hash  hash calculation destination
  * @param[in]     batch chunk of data to perform step on
  */
-static void cfHashStep( CfHash *const hash, const uint32_t *const batch ) {
+static void cfHashStep( CfHash *const hash, const uint8_t *const batch ) {
     uint32_t words[64] = {0};
 
     memcpy(words, batch, sizeof(uint32_t) * 16);
@@ -112,6 +112,25 @@ static void cfHashStep( CfHash *const hash, const uint32_t *const batch ) {
     hash->hash[7] += h;
 } // cfHashStep function end
 
+/**
+ * @brief hash calculation steps performing function (fastest implementation supported by CPU is used)
+ *
+ * @param[in,out] hash       hash calculation destination
+ * @param[in]     blocks     blocks to perform steps on
+ * @param[in]     blockCount count of blocks
+ */
+static void cfHashStepBlocks( CfHash *const hash, const uint8_t *const blocks, const size_t blockCount ) {
+#ifdef CF_HASH_X86
+    if (cfHashX86HasSha()) {
+        cfHashX86StepSha(hash, blocks, blockCount);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < blockCount; i++)
+        cfHashStep(hash, blocks + i * CF_HASH_BLOCK_SIZE);
+} // cfHashStepBlocks
+
 void cfHasherInitialize( CfHasher *const hasher ) {
     assert(hasher != NULL);
 
@@ -141,7 +160,7 @@ CfHash cfHasherTerminate( CfHasher *const hasher ) {
     // check for case where size isn't fitting in last batch
     if (64 - hasher->batchSize < 9) {
         // handle 1st batch
-        cfHashStep(&hasher->hash, (const uint32_t *)&hasher->batch);
+        cfHashStepBlocks(&hasher->hash, hasher->batch, 1);
 
         // start 2nd batch
         memset(hasher->batch, 0, 56);
@@ -156,7 +175,7 @@ CfHash cfHasherTerminate( CfHasher *const hasher ) {
     lastBatchRev = ((lastBatchRev >>  8) & 0x00FF00FF00FF00FF) | ((lastBatchRev <<  8) & 0xFF00FF00FF00FF00);
 
     ((uint64_t *)hasher->batch)[7] = lastBatchRev;
-    cfHashStep(&hasher->hash, (const uint32_t *)&hasher->batch);
+    cfHashStepBlocks(&hasher->hash, hasher->batch, 1);
 
     return hasher->hash;
 } // cfHasherTerminate
@@ -167,7 +186,7 @@ void cfHasherStep(
     const size_t             size
 ) {
     assert(hasher != NULL);
-    assert(data != NULL);
+    assert(data != NULL || size == 0);
 
     size_t sizeRest = size;
     uint8_t *dataRest = (uint8_t *)data;
@@ -175,15 +194,25 @@ void cfHasherStep(
     // increment total hashed data sizeo
     hasher->totalSize += size;
 
-    do {
+    while (sizeRest > 0) {
+        // whole blocks are hashed right from data while batch is empty
+        if (hasher->batchSize == 0 && sizeRest >= CF_HASH_BLOCK_SIZE) {
+            const size_t blockCount = sizeRest / CF_HASH_BLOCK_SIZE;
+
+            cfHashStepBlocks(&hasher->hash, dataRest, blockCount);
+            dataRest += blockCount * CF_HASH_BLOCK_SIZE;
+            sizeRest -= blockCount * CF_HASH_BLOCK_SIZE;
+            continue;
+        }
+
         // count of bytes to write to batch
         size_t writeCount = sizeRest < 64 - hasher->batchSize
             ? sizeRest
             : 64 - hasher->batchSize;
 
-        // write data to batch
+        // append data to batch
         memcpy(
-            hasher->batch,
+            hasher->batch + hasher->batchSize,
             dataRest,
             writeCount
         );
@@ -196,11 +225,11 @@ void cfHasherStep(
 
         // append to hash if hasher batch is full
         if (hasher->batchSize == 64) {
-            cfHashStep(&hasher->hash, (const uint32_t *)hasher->batch);
+            cfHashStepBlocks(&hasher->hash, hasher->batch, 1);
             memset(hasher->batch, 0, 64);
             hasher->batchSize = 0;
         }
-    } while (sizeRest > 0);
+    }
 } // cfHasherStep
 
 CfHash cfHash( const void *data, const size_t size ) {
@@ -212,6 +241,65 @@ CfHash cfHash( const void *data, const size_t size ) {
     return cfHasherTerminate(&hasher);
 } // cfHash
 
+void cfHashMany(
+    const void   *const *const data,
+    const size_t        *const sizes,
+    const size_t               count,
+    CfHash              *const dst
+) {
+    assert(data != NULL || count == 0);
+    assert(sizes != NULL || count == 0);
+    assert(dst != NULL || count == 0);
+
+    size_t first = 0;
+
+#ifdef CF_HASH_X86
+    // SHA-NI hashes single message faster than AVX2 hashes 8 ones, so lanes are used only without it.
+    // Group of messages is hashed in parallel while all of them have whole blocks left.
+    while (!cfHashX86HasSha() && cfHashX86HasAvx2() && count - first >= 2) {
+        const size_t laneCount = count - first < CF_HASH_LANE_COUNT
+            ? count - first
+            : CF_HASH_LANE_COUNT;
+        const uint8_t *blocks[CF_HASH_LANE_COUNT];
+        CfHasher hashers[CF_HASH_LANE_COUNT];
+        CfHash hashes[CF_HASH_LANE_COUNT];
+        size_t blockCount = sizes[first] / CF_HASH_BLOCK_SIZE;
+
+        for (size_t lane = 0; lane < laneCount; lane++) {
+            if (blockCount > sizes[first + lane] / CF_HASH_BLOCK_SIZE)
+                blockCount = sizes[first + lane] / CF_HASH_BLOCK_SIZE;
+
+            cfHasherInitialize(&hashers[lane]);
+            hashes[lane] = hashers[lane].hash;
+            blocks[lane] = (const uint8_t *)data[first + lane];
+        }
+
+        // unused lanes repeat the first one, their results are dropped
+        for (size_t lane = laneCount; lane < CF_HASH_LANE_COUNT; lane++) {
+            hashes[lane] = hashes[0];
+            blocks[lane] = blocks[0];
+        }
+
+        cfHashX86StepAvx2(hashes, blocks, blockCount);
+
+        // tails of different length are hashed one by one
+        for (size_t lane = 0; lane < laneCount; lane++) {
+            const size_t hashedSize = blockCount * CF_HASH_BLOCK_SIZE;
+
+            hashers[lane].hash = hashes[lane];
+            hashers[lane].totalSize = hashedSize;
+            cfHasherStep(&hashers[lane], blocks[lane] + hashedSize, sizes[first + lane] - hashedSize);
+            dst[first + lane] = cfHasherTerminate(&hashers[lane]);
+        }
+
+        first += laneCount;
+    }
+#endif
+
+    for (size_t i = first; i < count; i++)
+        dst[i] = cfHash(data[i], sizes[i]);
+} // cfHashMany
+
 bool cfHashCompare( const CfHash *lhs, const CfHash *rhs ) {
     return 0 == memcmp(lhs, rhs, sizeof(CfHash));
 } // cfHashCompare
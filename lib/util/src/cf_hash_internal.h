@@ -0,0 +1,65 @@
+/**
+ * @brief hash internal declaration file
+ */
+
+#ifndef CF_HASH_INTERNAL_H_
+#define CF_HASH_INTERNAL_H_
+
+#include "cf_hash.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief SHA256 block size (in bytes)
+#define CF_HASH_BLOCK_SIZE 64
+
+/// @brief count of messages hashed by multi-buffer step function at once
+#define CF_HASH_LANE_COUNT 8
+
+/// @brief SHA256 constant table
+extern const uint32_t CF_constTable[64];
+
+#ifdef CF_HASH_X86
+
+/**
+ * @brief SHA extension (SHA-NI) support checking function
+ *
+ * @return true if SHA-NI step function may be used
+ */
+bool cfHashX86HasSha( void );
+
+/**
+ * @brief AVX2 support checking function
+ *
+ * @return true if AVX2 multi-buffer step function may be used
+ */
+bool cfHashX86HasAvx2( void );
+
+/**
+ * @brief SHA-NI hash calculation step performing function
+ *
+ * @param[in,out] hash       hash calculation destination (non-null)
+ * @param[in]     blocks     blocks to perform steps on (non-null)
+ * @param[in]     blockCount count of blocks
+ */
+void cfHashX86StepSha( CfHash *hash, const uint8_t *blocks, size_t blockCount );
+
+/**
+ * @brief AVX2 multi-buffer hash calculation step performing function
+ *
+ * @param[in,out] hashes     hash calculation destinations (one per lane, non-null)
+ * @param[in]     blocks     block sequences of lanes (CF_HASH_LANE_COUNT non-null pointers)
+ * @param[in]     blockCount count of blocks in each sequence
+ */
+void cfHashX86StepAvx2( CfHash *hashes, const uint8_t *const *blocks, size_t blockCount );
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // !defined(CF_HASH_INTERNAL_H_)
+
+// cf_hash_internal.h
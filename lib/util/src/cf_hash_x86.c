@@ -0,0 +1,250 @@
+/**
+ * @brief x86 hardware-accelerated hash implementation file
+ *
+ * @note functions are compiled for instruction set extensions they use by target attribute,
+ * so the rest of library runs on any x86-64 CPU and these ones are called only if CPU supports them.
+ */
+
+#ifdef CF_HASH_X86
+
+#include <cpuid.h>
+#include <immintrin.h>
+
+#include "cf_hash_internal.h"
+
+/// @brief x86 CPU features required by hash implementations
+typedef enum CfHashX86Feature_ {
+    CF_HASH_X86_FEATURE_DETECTED = 0x1, ///< features are already detected
+    CF_HASH_X86_FEATURE_SHA      = 0x2, ///< SHA extensions (with SSE4.1 they require)
+    CF_HASH_X86_FEATURE_AVX2     = 0x4, ///< AVX2 (including OS support of YMM registers)
+} CfHashX86Feature;
+
+/**
+ * @brief CPU feature set getting function
+ *
+ * @return CfHashX86Feature mask
+ */
+static uint32_t cfHashX86GetFeatures( void ) {
+    // hash may be calculated by several threads, and they detect the same features, so relaxed order is enough
+    static uint32_t features = 0;
+    uint32_t result = __atomic_load_n(&features, __ATOMIC_RELAXED);
+
+    if (result & CF_HASH_X86_FEATURE_DETECTED)
+        return result;
+
+    result = CF_HASH_X86_FEATURE_DETECTED;
+
+    uint32_t eax, ebx, ecx, edx;
+    uint32_t eax7, ebx7, ecx7, edx7;
+
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && __get_cpuid_count(7, 0, &eax7, &ebx7, &ecx7, &edx7)) {
+        const bool hasSse41 = (ecx >> 19) & 1;
+        const bool hasOsxsave = (ecx >> 27) & 1;
+        const bool hasAvx = (ecx >> 28) & 1;
+
+        if (hasSse41 && ((ebx7 >> 29) & 1))
+            result |= CF_HASH_X86_FEATURE_SHA;
+
+        // OS must save YMM register state on context switch
+        if (hasOsxsave && hasAvx && ((ebx7 >> 5) & 1)) {
+            uint32_t xcr0Low, xcr0High;
+
+            __asm__ ("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+            if ((xcr0Low & 0x6) == 0x6)
+                result |= CF_HASH_X86_FEATURE_AVX2;
+        }
+    }
+
+    __atomic_store_n(&features, result, __ATOMIC_RELAXED);
+    return result;
+} // cfHashX86GetFeatures
+
+bool cfHashX86HasSha( void ) {
+    return cfHashX86GetFeatures() & CF_HASH_X86_FEATURE_SHA;
+} // cfHashX86HasSha
+
+bool cfHashX86HasAvx2( void ) {
+    return cfHashX86GetFeatures() & CF_HASH_X86_FEATURE_AVX2;
+} // cfHashX86HasAvx2
+
+__attribute__((target("sha,sse4.1")))
+void cfHashX86StepSha( CfHash *const hash, const uint8_t *blocks, size_t blockCount ) {
+    const __m128i byteSwapMask = _mm_set_epi64x(0x0C0D0E0F08090A0BULL, 0x0405060700010203ULL);
+
+    // SHA instructions keep state as ABEF/CDGH pairs
+    const __m128i dcba = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&hash->hash[0]), 0xB1);
+    const __m128i efgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&hash->hash[4]), 0x1B);
+    __m128i abef = _mm_alignr_epi8(dcba, efgh, 8);
+    __m128i cdgh = _mm_blend_epi16(efgh, dcba, 0xF0);
+
+    for (; blockCount > 0; blockCount--, blocks += CF_HASH_BLOCK_SIZE) {
+        const __m128i abefStart = abef;
+        const __m128i cdghStart = cdgh;
+        __m128i words[4];
+
+        // each iteration performs 4 rounds, words[i % 4] holds words i * 4 .. i * 4 + 3
+#pragma GCC unroll 16
+        for (int i = 0; i < 16; i++) {
+            if (i < 4) {
+                words[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(blocks + i * 16)), byteSwapMask);
+            } else {
+                __m128i next = _mm_sha256msg1_epu32(words[i % 4], words[(i + 1) % 4]);
+                next = _mm_add_epi32(next, _mm_alignr_epi8(words[(i + 3) % 4], words[(i + 2) % 4], 4));
+                words[i % 4] = _mm_sha256msg2_epu32(next, words[(i + 3) % 4]);
+            }
+
+            __m128i roundInput = _mm_add_epi32(words[i % 4], _mm_loadu_si128((const __m128i *)&CF_constTable[i * 4]));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, roundInput);
+            roundInput = _mm_shuffle_epi32(roundInput, 0x0E);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, roundInput);
+        }
+
+        abef = _mm_add_epi32(abef, abefStart);
+        cdgh = _mm_add_epi32(cdgh, cdghStart);
+    }
+
+    // convert state back to ABCD/EFGH
+    const __m128i feba = _mm_shuffle_epi32(abef, 0x1B);
+    const __m128i dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128((__m128i *)&hash->hash[0], _mm_blend_epi16(feba, dchg, 0xF0));
+    _mm_storeu_si128((__m128i *)&hash->hash[4], _mm_alignr_epi8(dchg, feba, 8));
+} // cfHashX86StepSha
+
+/**
+ * @brief 8-lane right bit rotation function
+ *
+ * @param[in] n  numbers to rotate
+ * @param[in] at count of bits to rotate at (0 < at < 32)
+ *
+ * @return rotated numbers
+ */
+__attribute__((target("avx2")))
+static inline __m256i cfHashX86Rotr( const __m256i n, const int at ) {
+    return _mm256_or_si256(_mm256_srli_epi32(n, at), _mm256_slli_epi32(n, 32 - at));
+} // cfHashX86Rotr
+
+/**
+ * @brief 8x8 32-bit word matrix transposition function
+ *
+ * @param[in,out] rows matrix rows (columns after transposition)
+ */
+__attribute__((target("avx2")))
+static inline void cfHashX86Transpose( __m256i *const rows ) {
+    __m256i t[8], u[8];
+
+    for (int i = 0; i < 4; i++) {
+        t[i * 2 + 0] = _mm256_unpacklo_epi32(rows[i * 2], rows[i * 2 + 1]);
+        t[i * 2 + 1] = _mm256_unpackhi_epi32(rows[i * 2], rows[i * 2 + 1]);
+    }
+
+    for (int i = 0; i < 2; i++) {
+        u[i * 4 + 0] = _mm256_unpacklo_epi64(t[i * 4 + 0], t[i * 4 + 2]);
+        u[i * 4 + 1] = _mm256_unpackhi_epi64(t[i * 4 + 0], t[i * 4 + 2]);
+        u[i * 4 + 2] = _mm256_unpacklo_epi64(t[i * 4 + 1], t[i * 4 + 3]);
+        u[i * 4 + 3] = _mm256_unpackhi_epi64(t[i * 4 + 1], t[i * 4 + 3]);
+    }
+
+    for (int i = 0; i < 4; i++) {
+        rows[i + 0] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+        rows[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+    }
+} // cfHashX86Transpose
+
+__attribute__((target("avx2")))
+void cfHashX86StepAvx2( CfHash *const hashes, const uint8_t *const *const blocks, const size_t blockCount ) {
+    const __m256i byteSwapMask = _mm256_set_epi64x(
+        0x0C0D0E0F08090A0BULL, 0x0405060700010203ULL,
+        0x0C0D0E0F08090A0BULL, 0x0405060700010203ULL
+    );
+
+    // state[i] holds i-th state word of every lane
+    __m256i state[8];
+    for (int i = 0; i < 8; i++)
+        state[i] = _mm256_set_epi32(
+            hashes[7].hash[i], hashes[6].hash[i], hashes[5].hash[i], hashes[4].hash[i],
+            hashes[3].hash[i], hashes[2].hash[i], hashes[1].hash[i], hashes[0].hash[i]
+        );
+
+    for (size_t blockIndex = 0; blockIndex < blockCount; blockIndex++) {
+        __m256i words[16];
+
+        // load block halves lane by lane and transpose them into word vectors
+        for (int half = 0; half < 2; half++) {
+            for (int lane = 0; lane < CF_HASH_LANE_COUNT; lane++)
+                words[half * 8 + lane] = _mm256_shuffle_epi8(
+                    _mm256_loadu_si256((const __m256i *)(blocks[lane] + blockIndex * CF_HASH_BLOCK_SIZE + half * 32)),
+                    byteSwapMask
+                );
+            cfHashX86Transpose(words + half * 8);
+        }
+
+        __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+        __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+
+#pragma GCC unroll 64
+        for (int i = 0; i < 64; i++) {
+            // message schedule is extended in place (words[i % 16] is no longer required by i-th round)
+            if (i >= 16) {
+                const __m256i w0 = words[(i - 15) % 16];
+                const __m256i w1 = words[(i - 2) % 16];
+                const __m256i s0 = _mm256_xor_si256(
+                    _mm256_xor_si256(cfHashX86Rotr(w0, 7), cfHashX86Rotr(w0, 18)),
+                    _mm256_srli_epi32(w0, 3)
+                );
+                const __m256i s1 = _mm256_xor_si256(
+                    _mm256_xor_si256(cfHashX86Rotr(w1, 17), cfHashX86Rotr(w1, 19)),
+                    _mm256_srli_epi32(w1, 10)
+                );
+
+                words[i % 16] = _mm256_add_epi32(
+                    _mm256_add_epi32(words[i % 16], s0),
+                    _mm256_add_epi32(words[(i - 7) % 16], s1)
+                );
+            }
+
+            const __m256i sum0 = _mm256_xor_si256(
+                _mm256_xor_si256(cfHashX86Rotr(a, 2), cfHashX86Rotr(a, 13)),
+                cfHashX86Rotr(a, 22)
+            );
+            const __m256i majority = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+            const __m256i sum1 = _mm256_xor_si256(
+                _mm256_xor_si256(cfHashX86Rotr(e, 6), cfHashX86Rotr(e, 11)),
+                cfHashX86Rotr(e, 25)
+            );
+            const __m256i choice = _mm256_xor_si256(g, _mm256_and_si256(e, _mm256_xor_si256(f, g)));
+
+            const __m256i temp1 = _mm256_add_epi32(
+                _mm256_add_epi32(_mm256_add_epi32(h, sum1), _mm256_add_epi32(choice, words[i % 16])),
+                _mm256_set1_epi32((int)CF_constTable[i])
+            );
+            const __m256i temp2 = _mm256_add_epi32(sum0, majority);
+
+            h = g;
+            g = f;
+            f = e;
+            e = _mm256_add_epi32(d, temp1);
+            d = c;
+            c = b;
+            b = a;
+            a = _mm256_add_epi32(temp1, temp2);
+        }
+
+        state[0] = _mm256_add_epi32(state[0], a);
+        state[1] = _mm256_add_epi32(state[1], b);
+        state[2] = _mm256_add_epi32(state[2], c);
+        state[3] = _mm256_add_epi32(state[3], d);
+        state[4] = _mm256_add_epi32(state[4], e);
+        state[5] = _mm256_add_epi32(state[5], f);
+        state[6] = _mm256_add_epi32(state[6], g);
+        state[7] = _mm256_add_epi32(state[7], h);
+    }
+
+    // transpose state back into per-lane hashes
+    cfHashX86Transpose(state);
+    for (int lane = 0; lane < CF_HASH_LANE_COUNT; lane++)
+        _mm256_storeu_si256((__m256i *)hashes[lane].hash, state[lane]);
+} // cfHashX86StepAvx2
+
+#endif
+
+// cf_hash_x86.c
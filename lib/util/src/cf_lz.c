@@ -0,0 +1,385 @@
+/**
+ * @brief LZ compression implementation file
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cf_lz.h"
+
+/// @brief minimal match length
+#define CF_LZ_MIN_MATCH 4
+
+/// @brief maximal match distance
+#define CF_LZ_MAX_DISTANCE 0xFFFF
+
+/// @brief match finder hash table size logarithm
+#define CF_LZ_HASH_BITS 13
+
+/// @brief block header flag of uncompressed block
+#define CF_LZ_STORED_FLAG ((uint32_t)1 << 31)
+
+/// @brief block header size
+#define CF_LZ_HEADER_SIZE 4
+
+/**
+ * @brief 32-bit unaligned number reading function
+ *
+ * @param[in] data data to read number from
+ *
+ * @return number
+ */
+static uint32_t cfLzRead32( const uint8_t *const data ) {
+    uint32_t value;
+
+    memcpy(&value, data, sizeof(value));
+    return value;
+} // cfLzRead32
+
+/**
+ * @brief match finder hash function
+ *
+ * @param[in] value first bytes of match candidate
+ *
+ * @return hash table index
+ */
+static uint32_t cfLzHash( const uint32_t value ) {
+    return (value * 2654435761U) >> (32 - CF_LZ_HASH_BITS);
+} // cfLzHash
+
+/**
+ * @brief length extension writing function
+ *
+ * @param[out] dst    extension destination
+ * @param[in]  length length rest (length without value stored in token)
+ *
+ * @return pointer to byte after extension
+ */
+static uint8_t * cfLzWriteLength( uint8_t *dst, size_t length ) {
+    for (; length >= 255; length -= 255)
+        *dst++ = 255;
+    *dst++ = (uint8_t)length;
+    return dst;
+} // cfLzWriteLength
+
+/**
+ * @brief single command writing function
+ *
+ * @param[out] dst           command destination
+ * @param[in]  dstEnd        destination end
+ * @param[in]  literals      literals
+ * @param[in]  literalCount  count of literals
+ * @param[in]  distance      match distance (command has no match if it's zero)
+ * @param[in]  matchLength   match length
+ *
+ * @return pointer to byte after command (null if command doesn't fit into destination)
+ */
+static uint8_t * cfLzWriteCommand(
+    uint8_t       *      dst,
+    const uint8_t *const dstEnd,
+    const uint8_t *const literals,
+    const size_t         literalCount,
+    const size_t         distance,
+    const size_t         matchLength
+) {
+    // command size upper bound
+    const size_t size = 1 + (literalCount / 255 + 1) + literalCount + 2 + (matchLength / 255 + 1);
+
+    if (size > (size_t)(dstEnd - dst))
+        return NULL;
+
+    uint8_t *const token = dst++;
+
+    *token = (uint8_t)((literalCount < 15 ? literalCount : 15) << 4);
+    if (literalCount >= 15)
+        dst = cfLzWriteLength(dst, literalCount - 15);
+
+    memcpy(dst, literals, literalCount);
+    dst += literalCount;
+
+    if (distance == 0)
+        return dst;
+
+    const size_t matchRest = matchLength - CF_LZ_MIN_MATCH;
+
+    *dst++ = (uint8_t)(distance & 0xFF);
+    *dst++ = (uint8_t)(distance >> 8);
+    *token |= (uint8_t)(matchRest < 15 ? matchRest : 15);
+    if (matchRest >= 15)
+        dst = cfLzWriteLength(dst, matchRest - 15);
+
+    return dst;
+} // cfLzWriteCommand
+
+/**
+ * @brief single block compression function
+ *
+ * @param[in]  src  block to compress
+ * @param[in]  size block size (CF_LZ_BLOCK_SIZE at most)
+ * @param[out] dst  compressed block destination (size bytes at least)
+ *
+ * @return compressed block size (zero if compressed block isn't smaller than source one)
+ */
+static size_t cfLzCompressBlock( const uint8_t *const src, const size_t size, uint8_t *const dst ) {
+    // block positions fit into 16 bits, stale entries are rejected by match comparison
+    uint16_t table[1 << CF_LZ_HASH_BITS];
+    const uint8_t *const srcEnd = src + size;
+    const uint8_t *const dstEnd = dst + size - 1;
+    const uint8_t *anchor = src;
+    const uint8_t *current = src;
+    uint8_t *output = dst;
+
+    memset(table, 0, sizeof(table));
+
+    while (srcEnd - current >= CF_LZ_MIN_MATCH) {
+        const uint32_t hash = cfLzHash(cfLzRead32(current));
+        const uint8_t *const candidate = src + table[hash];
+
+        table[hash] = (uint16_t)(current - src);
+
+        if (false
+            || candidate >= current
+            || current - candidate > CF_LZ_MAX_DISTANCE
+            || cfLzRead32(candidate) != cfLzRead32(current)
+        ) {
+            // incompressible data is skipped faster
+            current += 1 + ((current - anchor) >> 6);
+            continue;
+        }
+
+        size_t matchLength = CF_LZ_MIN_MATCH;
+        while (current + matchLength < srcEnd && candidate[matchLength] == current[matchLength])
+            matchLength++;
+
+        output = cfLzWriteCommand(output, dstEnd, anchor, (size_t)(current - anchor), (size_t)(current - candidate), matchLength);
+        if (output == NULL)
+            return 0;
+
+        current += matchLength;
+        anchor = current;
+
+        // match end is used as candidate for the next match
+        if (srcEnd - current >= CF_LZ_MIN_MATCH)
+            table[cfLzHash(cfLzRead32(current - 2))] = (uint16_t)(current - 2 - src);
+    }
+
+    output = cfLzWriteCommand(output, dstEnd, anchor, (size_t)(srcEnd - anchor), 0, 0);
+    return output == NULL ? 0 : (size_t)(output - dst);
+} // cfLzCompressBlock
+
+/**
+ * @brief length extension reading function
+ *
+ * @param[in,out] src    extension pointer
+ * @param[in]     srcEnd compressed block end
+ * @param[in,out] length length to extend
+ *
+ * @return true if succeeded, false if extension is out of block
+ */
+static bool cfLzReadLength( const uint8_t **const src, const uint8_t *const srcEnd, size_t *const length ) {
+    uint8_t byte;
+
+    do {
+        if (*src >= srcEnd)
+            return false;
+        byte = *(*src)++;
+        *length += byte;
+    } while (byte == 255);
+
+    return true;
+} // cfLzReadLength
+
+/**
+ * @brief single block decompression function
+ *
+ * @param[in]  src     compressed block
+ * @param[in]  srcSize compressed block size
+ * @param[out] dst     decompressed block destination
+ * @param[in]  dstSize decompressed block size
+ *
+ * @return true if succeeded, false if block is invalid
+ */
+static bool cfLzDecompressBlock( const uint8_t *src, const size_t srcSize, uint8_t *const dst, const size_t dstSize ) {
+    const uint8_t *const srcEnd = src + srcSize;
+    const uint8_t *const dstEnd = dst + dstSize;
+    uint8_t *output = dst;
+
+    for (;;) {
+        if (src >= srcEnd)
+            return false;
+
+        const uint8_t token = *src++;
+        size_t literalCount = token >> 4;
+
+        if (literalCount == 15 && !cfLzReadLength(&src, srcEnd, &literalCount))
+            return false;
+        if (literalCount > (size_t)(srcEnd - src) || literalCount > (size_t)(dstEnd - output))
+            return false;
+
+        memcpy(output, src, literalCount);
+        output += literalCount;
+        src += literalCount;
+
+        // last command has no match
+        if (src == srcEnd)
+            return output == dstEnd;
+
+        if (srcEnd - src < 2)
+            return false;
+
+        const size_t distance = (size_t)src[0] | (size_t)src[1] << 8;
+        size_t matchLength = token & 15;
+
+        src += 2;
+        if (matchLength == 15 && !cfLzReadLength(&src, srcEnd, &matchLength))
+            return false;
+        matchLength += CF_LZ_MIN_MATCH;
+
+        if (distance == 0 || distance > (size_t)(output - dst) || matchLength > (size_t)(dstEnd - output))
+            return false;
+
+        const uint8_t *const match = output - distance;
+
+        // overlapping match repeats its first distance bytes
+        if (distance >= matchLength) {
+            memcpy(output, match, matchLength);
+        } else {
+            for (size_t i = 0; i < matchLength; i++)
+                output[i] = match[i];
+        }
+        output += matchLength;
+    }
+} // cfLzDecompressBlock
+
+/**
+ * @brief block header parsing function
+ *
+ * @param[in]  header       block header bytes
+ * @param[in]  expectedSize decompressed block size
+ * @param[out] isStored     true if block is stored uncompressed
+ *
+ * @return block contents size (zero if header is invalid)
+ */
+static size_t cfLzParseHeader( const uint8_t *const header, const size_t expectedSize, bool *const isStored ) {
+    const uint32_t value = 0
+        | (uint32_t)header[0] <<  0
+        | (uint32_t)header[1] <<  8
+        | (uint32_t)header[2] << 16
+        | (uint32_t)header[3] << 24
+    ;
+    const size_t size = value & ~CF_LZ_STORED_FLAG;
+
+    *isStored = (value & CF_LZ_STORED_FLAG) != 0;
+
+    // compressed blocks are smaller than decompressed ones (they're stored otherwise)
+    if (*isStored ? size != expectedSize : size == 0 || size >= expectedSize)
+        return 0;
+    return size;
+} // cfLzParseHeader
+
+size_t cfLzCompressBound( const size_t size ) {
+    return size + (size + CF_LZ_BLOCK_SIZE - 1) / CF_LZ_BLOCK_SIZE * CF_LZ_HEADER_SIZE;
+} // cfLzCompressBound
+
+size_t cfLzCompress( const void *const src, const size_t size, void *const dst ) {
+    assert(src != NULL || size == 0);
+    assert(dst != NULL || size == 0);
+
+    const uint8_t *input = (const uint8_t *)src;
+    uint8_t *output = (uint8_t *)dst;
+
+    for (size_t rest = size; rest > 0; ) {
+        const size_t blockSize = rest < CF_LZ_BLOCK_SIZE ? rest : CF_LZ_BLOCK_SIZE;
+        size_t contentSize = cfLzCompressBlock(input, blockSize, output + CF_LZ_HEADER_SIZE);
+        uint32_t header = (uint32_t)contentSize;
+
+        // incompressible block is stored as is
+        if (contentSize == 0) {
+            memcpy(output + CF_LZ_HEADER_SIZE, input, blockSize);
+            contentSize = blockSize;
+            header = (uint32_t)blockSize | CF_LZ_STORED_FLAG;
+        }
+
+        output[0] = (uint8_t)(header >>  0);
+        output[1] = (uint8_t)(header >>  8);
+        output[2] = (uint8_t)(header >> 16);
+        output[3] = (uint8_t)(header >> 24);
+
+        output += CF_LZ_HEADER_SIZE + contentSize;
+        input += blockSize;
+        rest -= blockSize;
+    }
+
+    return (size_t)(output - (uint8_t *)dst);
+} // cfLzCompress
+
+bool cfLzDecompress( const void *const src, const size_t srcSize, void *const dst, const size_t dstSize ) {
+    const uint8_t *input = (const uint8_t *)src;
+    const uint8_t *const inputEnd = input + srcSize;
+    uint8_t *output = (uint8_t *)dst;
+
+    for (size_t rest = dstSize; rest > 0; ) {
+        const size_t blockSize = rest < CF_LZ_BLOCK_SIZE ? rest : CF_LZ_BLOCK_SIZE;
+        bool isStored = false;
+
+        if (inputEnd - input < CF_LZ_HEADER_SIZE)
+            return false;
+
+        const size_t contentSize = cfLzParseHeader(input, blockSize, &isStored);
+        input += CF_LZ_HEADER_SIZE;
+
+        if (contentSize == 0 || contentSize > (size_t)(inputEnd - input))
+            return false;
+
+        if (isStored)
+            memcpy(output, input, blockSize);
+        else if (!cfLzDecompressBlock(input, contentSize, output, blockSize))
+            return false;
+
+        input += contentSize;
+        output += blockSize;
+        rest -= blockSize;
+    }
+
+    return input == inputEnd;
+} // cfLzDecompress
+
+bool cfLzDecompressFile( FILE *const file, void *const dst, const size_t dstSize ) {
+    assert(file != NULL);
+
+    // compressed blocks are smaller than decompressed ones
+    uint8_t *const buffer = (uint8_t *)malloc(CF_LZ_BLOCK_SIZE);
+    uint8_t *output = (uint8_t *)dst;
+    bool isOk = buffer != NULL;
+
+    for (size_t rest = dstSize; isOk && rest > 0; ) {
+        const size_t blockSize = rest < CF_LZ_BLOCK_SIZE ? rest : CF_LZ_BLOCK_SIZE;
+        uint8_t header[CF_LZ_HEADER_SIZE];
+        bool isStored = false;
+
+        if (1 != fread(header, CF_LZ_HEADER_SIZE, 1, file)) {
+            isOk = false;
+            break;
+        }
+
+        const size_t contentSize = cfLzParseHeader(header, blockSize, &isStored);
+
+        // uncompressed blocks are read into destination directly
+        isOk = isStored
+            ? contentSize != 0 && 1 == fread(output, contentSize, 1, file)
+            : true
+                && contentSize != 0
+                && 1 == fread(buffer, contentSize, 1, file)
+                && cfLzDecompressBlock(buffer, contentSize, output, blockSize)
+        ;
+
+        output += blockSize;
+        rest -= blockSize;
+    }
+
+    free(buffer);
+    return isOk;
+} // cfLzDecompressFile
+
+// cf_lz.c
@@ -37,6 +37,9 @@ typedef enum CfTermReason_ {
     CF_TERM_REASON_INVALID_VIDEO_MODE,   ///< invalid video mode
     CF_TERM_REASON_SEGMENTATION_FAULT,   ///< good old segfault
     CF_TERM_REASON_INVALID_POP_INFO,     ///< invalid push/pop info for pop instruction
+    CF_TERM_REASON_STACK_OVERFLOW,       ///< operand stack overflow
+    CF_TERM_REASON_CALL_STACK_OVERFLOW,  ///< call stack overflow
+    CF_TERM_REASON_SNAPSHOT_ERROR,       ///< snapshot writing by snap instruction failed
 } CfTermReason;
 
 /// @brief description of program termination reason
@@ -68,6 +71,12 @@ typedef struct CfExecContext_ {
     size_t   memorySize; ///< memory size (usually 1 MB)
 } CfExecContext;
 
+/// @brief element type of arrays transferred by bulk input/output system calls
+typedef enum CfArrayType_ {
+    CF_ARRAY_TYPE_F32, ///< 32-bit floating-point numbers
+    CF_ARRAY_TYPE_I32, ///< 32-bit signed integers
+} CfArrayType;
+
 /// @brief sandbox description structure.
 typedef struct CfSandbox_ {
     void *userContext; ///< some pointer user may pass into this structure
@@ -161,24 +170,197 @@ typedef struct CfSandbox_ {
      * @param number      number to write to output
      */
     void (*writeFloat64)( void *userContext, double number );
+
+    /**
+     * @brief number array reading function (optional, numbers are read by readFloat64 one by one if null)
+     *
+     * @param[in,out] userContext user-provided context
+     * @param[in]     type        array element type
+     * @param[out]    dst         array destination (VM memory, elements are stored in host byte order and may be unaligned)
+     * @param[in]     count       count of elements to read
+     *
+     * @return count of elements read (less than count if input is exhausted)
+     */
+    size_t (*readArray)( void *userContext, CfArrayType type, void *dst, size_t count );
+
+    /**
+     * @brief number array writing function (optional, numbers are written by writeFloat64 one by one if null)
+     *
+     * @param[in,out] userContext user-provided context
+     * @param[in]     type        array element type
+     * @param[in]     src         array to write (VM memory, elements are stored in host byte order and may be unaligned)
+     * @param[in]     count       count of elements to write
+     *
+     * @return true if succeeded, false if something went wrong.
+     */
+    bool (*writeArray)( void *userContext, CfArrayType type, const void *src, size_t count );
 } CfSandbox;
 
+/// @brief default operand stack capacity (in operands)
+#define CF_VM_DEFAULT_OPERAND_STACK_SIZE ((size_t)1 << 20)
+
+/// @brief default call stack capacity (in nested calls)
+#define CF_VM_DEFAULT_CALL_STACK_SIZE ((size_t)1 << 16)
+
+/// @brief pre-decoded executable code (may be shared by any count of concurrently executed VMs)
+typedef struct CfVmCode_ CfVmCode;
+
+/**
+ * @brief pre-decoded code constructor
+ *
+ * @param[in] executable executable to decode (non-null, may be destroyed after constructor call)
+ *
+ * @return newly created code (null if allocation failed)
+ */
+CfVmCode * cfVmCodeCtor( const CfExecutable *executable );
+
+/**
+ * @brief pre-decoded code destructor
+ *
+ * @param[in] code code to destroy (nullable, no VMs may use it)
+ */
+void cfVmCodeDtor( CfVmCode *code );
+
 /// @brief execution info
 typedef struct CfExecuteInfo_ {
-    const CfExecutable * executable; ///< executable
-    const CfSandbox    * sandbox;    ///< sandbox pointer
-    size_t               ramSize;    ///< required RAM size
+    const CfExecutable * executable;       ///< executable
+    const CfSandbox    * sandbox;          ///< sandbox pointer
+    size_t               ramSize;          ///< required RAM size
+    size_t               operandStackSize; ///< operand stack capacity (in operands, CF_VM_DEFAULT_OPERAND_STACK_SIZE if 0)
+    size_t               callStackSize;    ///< call stack capacity (in nested calls, CF_VM_DEFAULT_CALL_STACK_SIZE if 0)
+    bool                 useJit;           ///< compile code into native code before execution (ignored if JIT isn't
+                                           ///< supported by VM build, interpreter is used if compilation fails)
+    bool                 useTranslation;   ///< execute verified code translated into register-based form (ignored if code
+                                           ///< is JIT-compiled or can't be verified, interpreter is used then)
+    bool                 useTraces;        ///< record and execute straight-line traces of hot loops (ignored if code is
+                                           ///< JIT-compiled, translated, profiled or can't be verified)
+    const char         * profilePath;      ///< execution profile file path (null if profiling isn't required, code is
+                                           ///< executed by profiling interpreter and useJit/useTranslation are ignored otherwise)
+    const CfVmCode     * code;             ///< pre-decoded code of executable (nullable, executable is decoded by VM if null, if operand
+                                           ///< stack is too small for top-level code of verified one or if execution starts from snapshot)
+    const char         * snapshotPath;     ///< file snap instruction writes VM snapshot to (null if snapshots aren't required,
+                                           ///< snap is no-op then, code is interpreted and useJit/useTranslation are ignored otherwise)
+    const char         * imagePath;        ///< snapshot to start execution from (null if execution is started from scratch,
+                                           ///< RAM and stack sizes are taken from snapshot, code is executed by checked interpreter
+                                           ///< and useJit/useTranslation/useTraces are ignored otherwise)
 } CfExecuteInfo;
 
+/**
+ * @brief execution profile file format description
+ *
+ * Profile is text file written on program termination. It starts from header line
+ * ("cfprofile <version> <clock>", where clock is "tsc" if time is measured in CPU cycles
+ * and "ns" if in nanoseconds), followed by lines of executed instructions
+ * ("i <code offset> <opcode> <execution count> <time>", sorted by offset) and then
+ * by per-opcode total lines ("o <opcode> <execution count> <time>").
+ *
+ * @note instruction time includes time of its dispatch and of sandbox functions it calls.
+ */
+#define CF_VM_PROFILE_VERSION 1
+
+/**
+ * @brief VM snapshot file format description
+ *
+ * Snapshot is binary file that starts from header (magic, version, hash of executable code,
+ * RAM and stack sizes, stack depths, code offset of next instruction and register values),
+ * followed by operand stack contents and call stack contents (return addresses as code offsets).
+ * RAM is placed at the end of file so that its end offset is aligned by CF_VM_SNAPSHOT_RAM_ALIGNMENT,
+ * so it's mapped into VM started from snapshot directly (pages are copied on first write only, so
+ * snapshot file is never modified and may be used by any count of VMs). All-zero RAM pages
+ * aren't written, so snapshots are sparse files on file systems that support them.
+ *
+ * @note snapshot may be used with the executable it's written by only.
+ */
+#define CF_VM_SNAPSHOT_VERSION 1
+
+/// @brief alignment of RAM end offset in snapshot file (maximal page size of supported hosts)
+#define CF_VM_SNAPSHOT_RAM_ALIGNMENT ((size_t)1 << 16)
+
 /**
  * @brief executable execution function
  * 
  * @param[in] execInfo info about execution process
  * 
- * @return true if execution started, false if not
+ * @return true if execution started (and profile is written, if required), false if not
+ *
+ * @note executable segments are copied into RAM before execution (if it isn't started from snapshot),
+ * so execution doesn't start if some segment is out of RAM.
  */
 bool cfExecute( const CfExecuteInfo *execInfo );
 
+/// @brief resumable execution VM handle
+typedef struct CfVm_ CfVm;
+
+/// @brief resumable execution status
+typedef enum CfVmResumeStatus_ {
+    CF_VM_RESUME_STATUS_YIELDED,    ///< budget is exhausted, execution may be resumed later
+    CF_VM_RESUME_STATUS_TERMINATED, ///< program terminated (sandbox termination callback is already called)
+} CfVmResumeStatus;
+
+/**
+ * @brief resumable execution VM constructor
+ *
+ * @param[in] execInfo info about execution process (useJit and useTranslation are ignored,
+ *                     because execution may be suspended only by interpreter)
+ *
+ * @return newly created VM (null if creation or sandbox initialization failed)
+ *
+ * @note execInfo is not required to live after constructor call, but executable and sandbox are.
+ */
+CfVm * cfVmCtor( const CfExecuteInfo *execInfo );
+
+/**
+ * @brief execution resuming function
+ *
+ * @param[in,out] vm                VM to resume execution in (non-null)
+ * @param[in]     instructionBudget count of instructions to execute before yield (0 if unlimited)
+ * @param[in]     timeBudget        time to execute before yield (in microseconds, 0 if unlimited)
+ *
+ * @return execution status
+ *
+ * @note budget is checked at control transfer instructions (jumps, calls and returns), so it may be
+ * exceeded by instructions of single basic block; time is checked once per several thousands of instructions.
+ * @note VM state (registers, stacks and instruction counter) is kept between calls, so execution
+ * is continued from the point it has been suspended at. Calling this function after termination
+ * has no effect (CF_VM_RESUME_STATUS_TERMINATED is returned).
+ */
+CfVmResumeStatus cfVmResume( CfVm *vm, uint64_t instructionBudget, uint64_t timeBudget );
+
+/**
+ * @brief resumable execution VM forking function
+ *
+ * @param[in,out] vm      VM to fork (non-null)
+ * @param[in]     sandbox sandbox of forked VM (non-null, valid, is required to live while forked VM exists)
+ *
+ * @return forked VM (null if vm execution is terminated or creation or sandbox initialization failed)
+ *
+ * @note forked VM continues execution from the point vm is suspended at (sandbox state, e.g. video mode, isn't forked).
+ * @note RAM of forked VM is copy-on-write mapping of vm RAM copy, so only pages forked VM writes are duplicated.
+ * VMs forked without vm resuming in between share single copy (it's made again after vm is resumed).
+ * @note shared code of vm (CfExecuteInfo::code) is used by forked VM too.
+ */
+CfVm * cfVmFork( CfVm *vm, const CfSandbox *sandbox );
+
+/**
+ * @brief VM snapshot writing function
+ *
+ * @param[in] vm   VM to write snapshot of (non-null)
+ * @param[in] path snapshot file path (non-null)
+ *
+ * @return true if succeeded, false if vm execution is terminated or file writing failed
+ *
+ * @note snapshot may be written between cfVmResume calls only, so execution is
+ * started from the point it's suspended at by VM that is created from snapshot.
+ */
+bool cfVmWriteSnapshot( const CfVm *vm, const char *path );
+
+/**
+ * @brief resumable execution VM destructor
+ *
+ * @param[in] vm VM to destroy (nullable, execution may be not finished, sandbox termination callback isn't called then)
+ */
+void cfVmDtor( CfVm *vm );
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,8 +3,15 @@
  */
 
 #include <assert.h>
+#include <math.h>
 #include <string.h>
 
+#if defined(__SSE__)
+    #include <xmmintrin.h>
+#elif defined(__aarch64__)
+    #include <arm_neon.h>
+#endif
+
 #include "cf_vm_internal.h"
 
 void cfVmTerminate( CfVm *self, const CfTermReason reason ) {
@@ -12,69 +19,42 @@ void cfVmTerminate( CfVm *self, const CfTermReason reason ) {
 
     // fill standard termInfo fields
     self->termInfo.reason = reason;
-    self->termInfo.offset = self->instructionCounter - (const uint8_t *)self->executable->code;
+    self->termInfo.offset = self->instructionCounter[-1].offset;
+
+#ifdef CF_VM_GUARD_PAGES
+    cfVmRamSetCurrent(NULL);
+#endif
 
     // jump to termination handler
     longjmp(self->panicJumpBuffer, 1);
 } // cfVmTerminate
 
-void cfVmRead( CfVm *const self, void *const dst, const size_t count ) {
-    if (self->instructionCounterEnd - self->instructionCounter < count)
-        cfVmTerminate(self, CF_TERM_REASON_UNEXPECTED_CODE_END);
-    memcpy(dst, self->instructionCounter, count);
-    self->instructionCounter += count;
-} // cfVmRead
-
-void cfVmPushOperand( CfVm *const self, const void *const src ) {
-    if (CF_DARR_OK != cfDarrPush(&self->operandStack, src))
-        cfVmTerminate(self, CF_TERM_REASON_INTERNAL_ERROR);
-} // cfVmPushOperand
-
-void cfVmPopOperand( CfVm *const self, void *const dst ) {
-    switch (cfDarrPop(&self->operandStack, dst)) {
-    case CF_DARR_INTERNAL_ERROR : cfVmTerminate(self, CF_TERM_REASON_INTERNAL_ERROR);
-    case CF_DARR_NO_VALUES      : cfVmTerminate(self, CF_TERM_REASON_NO_OPERANDS);
-    case CF_DARR_OK             : break;
-    }
-} // cfVmPopOperand
-
-void cfVmJump( CfVm *const self, const uint32_t point ) {
-    self->instructionCounter = self->instructionCounterBegin + point;
-
-    // perform instructionCuonter bound check
-    if (self->instructionCounter >= self->instructionCounterEnd)
+void cfVmJump( CfVm *const self, const uint32_t target ) {
+    // perform jump target check
+    if (target >= self->codeLength)
         cfVmTerminate(self, CF_TERM_REASON_INVALID_IC);
+
+    self->instructionCounter = self->code + target;
 } // cfVmJump
 
-void cfVmGenericConditionalJump( CfVm *const self, const bool condition ) {
-    uint32_t point;
-    cfVmRead(self, &point, sizeof(point));
-    if (condition)
-        cfVmJump(self, point);
-} // cfVmGenericConditionalJump
-
-void cfVmPushIC( CfVm *const self ) {
-    if (CF_DARR_OK != cfDarrPush(&self->callStack, &self->instructionCounter))
-        cfVmTerminate(self, CF_TERM_REASON_INTERNAL_ERROR);
-} // cfVmPushCall
-
-void cfVmPopIC( CfVm *const self ) {
-    switch (cfDarrPop(&self->callStack, &self->instructionCounter)) {
-    case CF_DARR_INTERNAL_ERROR : cfVmTerminate(self, CF_TERM_REASON_INTERNAL_ERROR);
-    case CF_DARR_NO_VALUES      : cfVmTerminate(self, CF_TERM_REASON_CALL_STACK_UNDERFLOW);
-    case CF_DARR_OK             : break;
-    }
-} // cfVmPopIC
+const CfVmInstruction * cfVmFindInstruction( const CfVm *const self, const uint32_t offset ) {
+    size_t left = 0;
+    size_t right = self->codeLength;
+
+    // decoded instructions are ordered by offset
+    while (left < right) {
+        const size_t middle = left + (right - left) / 2;
 
-void cfVmWriteRegister( CfVm *const self, const uint32_t reg, const uint32_t value ) {
-    if (reg >= CF_REGISTER_COUNT) {
-        self->termInfo.unknownRegister = reg;
-        cfVmTerminate(self, CF_TERM_REASON_UNKNOWN_REGISTER);
+        if (self->code[middle].offset < offset)
+            left = middle + 1;
+        else
+            right = middle;
     }
 
-    if (reg >= 2)
-        self->registers.indexed[reg] = value;
-} // cfVmWriteRegister
+    return left < self->codeLength && self->code[left].offset == offset
+        ? &self->code[left]
+        : NULL;
+} // cfVmFindInstruction
 
 void cfVmSetVideoMode(
     CfVm *const self,
@@ -90,17 +70,41 @@ void cfVmSetVideoMode(
         cfVmTerminate(self, CF_TERM_REASON_SANDBOX_ERROR);
 } // cfVmSetVideoMode
 
-uint32_t cfVmReadRegister( CfVm *const self, const uint32_t reg ) {
-    if (reg >= CF_REGISTER_COUNT) {
-        self->termInfo.unknownRegister = reg;
-        cfVmTerminate(self, CF_TERM_REASON_UNKNOWN_REGISTER);
+void cfVmSetPackedVideoMode( CfVm *const self, const uint32_t videoMode ) {
+    // validate video mode flag bit combination
+    self->termInfo.invalidVideoMode.storageFormatBits = videoMode;
+    self->termInfo.invalidVideoMode.updateModeBits = videoMode >> 1;
+
+    // validate video mode
+    switch ((CfVideoStorageFormat)(videoMode & 0x7)) {
+    case CF_VIDEO_STORAGE_FORMAT_TEXT:
+    case CF_VIDEO_STORAGE_FORMAT_COLORED_TEXT:
+    case CF_VIDEO_STORAGE_FORMAT_COLOR_PALETTE:
+    case CF_VIDEO_STORAGE_FORMAT_TRUE_COLOR:
+        break;
+    default:
+        cfVmTerminate(self, CF_TERM_REASON_INVALID_VIDEO_MODE);
     }
-    return self->registers.indexed[reg];
-} // cfVmReadRegister
+
+    switch ((CfVideoUpdateMode)((videoMode >> 3) & 0x1)) {
+    case CF_VIDEO_UPDATE_MODE_IMMEDIATE:
+    case CF_VIDEO_UPDATE_MODE_MANUAL:
+        break;
+    default:
+        cfVmTerminate(self, CF_TERM_REASON_INVALID_VIDEO_MODE);
+    }
+
+    // actually, set video mode
+    cfVmSetVideoMode(
+        self,
+        (CfVideoStorageFormat)(videoMode & 0x7),
+        (CfVideoUpdateMode)((videoMode >> 3) & 0x1)
+    );
+} // cfVmSetPackedVideoMode
 
 void * cfVmGetMemoryPointer( CfVm *const self, const uint32_t addr ) {
-    // perform address bound check
-    if (addr + 4 > self->ramSize) {
+    // perform address bound check (in size_t, because addr + 4 may overflow uint32_t)
+    if ((size_t)addr + 4 > self->ramSize) {
         self->termInfo.segmentationFault.memorySize = self->ramSize;
         self->termInfo.segmentationFault.addr = addr;
         cfVmTerminate(self, CF_TERM_REASON_SEGMENTATION_FAULT);
@@ -109,4 +113,108 @@ void * cfVmGetMemoryPointer( CfVm *const self, const uint32_t addr ) {
     return self->ram + addr;
 } // cfVmGetMemoryPointer
 
+uint8_t * cfVmGetMemoryRangePointer( CfVm *const self, const uint32_t addr, const size_t size ) {
+    // ranges are accessed by sandbox (or are too long to rely on guard pages), so they're always checked
+    if ((size_t)addr + size > self->ramSize) {
+        self->termInfo.segmentationFault.memorySize = self->ramSize;
+        self->termInfo.segmentationFault.addr = addr;
+        cfVmTerminate(self, CF_TERM_REASON_SEGMENTATION_FAULT);
+    }
+
+    return self->ram + addr;
+} // cfVmGetMemoryRangePointer
+
+void cfVmMemoryCopy( CfVm *const self, const uint32_t dst, const uint32_t src, const uint32_t size ) {
+    uint8_t *const source = cfVmGetMemoryRangePointer(self, src, size);
+    uint8_t *const destination = cfVmGetMemoryRangePointer(self, dst, size);
+
+    memmove(destination, source, size);
+} // cfVmMemoryCopy
+
+void cfVmMemoryFill(
+    CfVm     *const self,
+    const uint32_t  dst,
+    const uint32_t  value,
+    const uint32_t  count,
+    const uint32_t  elementSize
+) {
+    uint8_t *const destination = cfVmGetMemoryRangePointer(self, dst, (size_t)count * elementSize);
+
+    // 32-bit values of same bytes (e.g. 0 or ~0) are filled bytewise too
+    if (elementSize == 1 || value == (value & 0xFF) * 0x01010101u) {
+        memset(destination, value & 0xFF, (size_t)count * elementSize);
+        return;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+        memcpy(destination + (size_t)i * 4, &value, 4);
+} // cfVmMemoryFill
+
+CfVmF32x4 cfVmF32x4Sqrt( const CfVmF32x4 value ) {
+#if defined(__SSE__)
+    return (CfVmF32x4)_mm_sqrt_ps((__m128)value);
+#elif defined(__aarch64__)
+    return (CfVmF32x4)vsqrtq_f32((float32x4_t)value);
+#else
+    CfVmF32x4 result;
+    for (int i = 0; i < 4; i++)
+        result[i] = sqrtf(value[i]);
+    return result;
+#endif
+} // cfVmF32x4Sqrt
+
+uint32_t cfVmReadArray( CfVm *const self, const CfSystemCall systemCall, const uint32_t addr, const uint32_t count ) {
+    uint8_t *const array = cfVmGetMemoryRangePointer(self, addr, (size_t)count * sizeof(uint32_t));
+    const CfArrayType type = systemCall == CF_SYSTEM_CALL_READ_F32_ARRAY
+        ? CF_ARRAY_TYPE_F32
+        : CF_ARRAY_TYPE_I32;
+
+    if (self->sandbox->readArray != NULL) {
+        const size_t readCount = self->sandbox->readArray(self->sandbox->userContext, type, array, count);
+        return readCount < count ? (uint32_t)readCount : count;
+    }
+
+    // number reading failure can't be detected, so all numbers are considered read
+    for (uint32_t i = 0; i < count; i++) {
+        const double number = self->sandbox->readFloat64(self->sandbox->userContext);
+        union {
+            float   f32;
+            int32_t i32;
+        } element;
+
+        if (type == CF_ARRAY_TYPE_F32)
+            element.f32 = (float)number;
+        else
+            element.i32 = (int32_t)number;
+        memcpy(array + i * sizeof(uint32_t), &element, sizeof(uint32_t));
+    }
+    return count;
+} // cfVmReadArray
+
+void cfVmWriteArray( CfVm *const self, const CfSystemCall systemCall, const uint32_t addr, const uint32_t count ) {
+    const uint8_t *const array = cfVmGetMemoryRangePointer(self, addr, (size_t)count * sizeof(uint32_t));
+    const CfArrayType type = systemCall == CF_SYSTEM_CALL_WRITE_F32_ARRAY
+        ? CF_ARRAY_TYPE_F32
+        : CF_ARRAY_TYPE_I32;
+
+    if (self->sandbox->writeArray != NULL) {
+        if (!self->sandbox->writeArray(self->sandbox->userContext, type, array, count))
+            cfVmTerminate(self, CF_TERM_REASON_SANDBOX_ERROR);
+        return;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        union {
+            float   f32;
+            int32_t i32;
+        } element;
+
+        memcpy(&element, array + i * sizeof(uint32_t), sizeof(uint32_t));
+        self->sandbox->writeFloat64(
+            self->sandbox->userContext,
+            type == CF_ARRAY_TYPE_F32 ? (double)element.f32 : (double)element.i32
+        );
+    }
+} // cfVmWriteArray
+
 // cf_vm.c
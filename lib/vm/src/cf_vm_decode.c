@@ -0,0 +1,446 @@
+/**
+ * @brief executable bytecode into pre-decoded instruction stream translator implementation file
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cf_vm_internal.h"
+
+/**
+ * @brief push/pop instruction operand (info, index and immediate) decoding function
+ *
+ * @param[in]  bytecode instruction start pointer
+ * @param[in]  rest     count of bytes from instruction start to bytecode end
+ * @param[out] dst      decoded instruction destination (non-null, opcode is set only if operand is truncated)
+ *
+ * @return decoded instruction length in bytes, 0 if instruction is truncated
+ */
+static size_t cfVmDecodePushPopOperand(
+    const uint8_t   *const bytecode,
+    const size_t           rest,
+    CfVmInstruction *const dst
+) {
+    if (rest < 2) {
+        dst->opcode = CF_VM_OPCODE_CODE_END;
+        return 0;
+    }
+
+    CfPushPopInfo info;
+    memcpy(&info, bytecode + 1, sizeof(info));
+
+    size_t length = 2;
+    CfPushPopIndex index = { .asByte = 0 };
+    uint32_t immediate = 0;
+
+    if (info.isIndexed) {
+        if (rest < length + 1) {
+            dst->opcode = CF_VM_OPCODE_CODE_END;
+            return 0;
+        }
+        memcpy(&index, bytecode + length, sizeof(index));
+        length += 1;
+    }
+
+    if (info.doReadImmediate) {
+        if (rest < length + 4) {
+            dst->opcode = CF_VM_OPCODE_CODE_END;
+            return 0;
+        }
+        memcpy(&immediate, bytecode + length, 4);
+        length += 4;
+    }
+
+    dst->info = info;
+    dst->registerIndex = info.registerIndex;
+    dst->index = index;
+    dst->immediate = immediate;
+
+    return length;
+} // cfVmDecodePushPopOperand
+
+/**
+ * @brief single instruction decoding function
+ *
+ * @param[in]  bytecode    instruction start pointer
+ * @param[in]  bytecodeEnd bytecode end pointer
+ * @param[out] dst         decoded instruction destination (non-null, offset field is ignored)
+ *
+ * @return decoded instruction length in bytes, 0 if instruction can't be decoded
+ * (corresponding trap is written to dst in this case)
+ */
+static size_t cfVmDecodeInstruction(
+    const uint8_t   *const bytecode,
+    const uint8_t   *const bytecodeEnd,
+    CfVmInstruction *const dst
+) {
+    const size_t rest = bytecodeEnd - bytecode;
+    const uint8_t opcode = bytecode[0];
+
+    dst->opcode = opcode;
+
+    switch ((CfOpcode)opcode) {
+    case CF_OPCODE_SYSCALL:
+    case CF_OPCODE_JMP:
+    case CF_OPCODE_JLE:
+    case CF_OPCODE_JL:
+    case CF_OPCODE_JGE:
+    case CF_OPCODE_JG:
+    case CF_OPCODE_JE:
+    case CF_OPCODE_JNE:
+    case CF_OPCODE_JZ:
+    case CF_OPCODE_JNZ:
+    case CF_OPCODE_CALL: {
+        if (rest < 5) {
+            dst->opcode = CF_VM_OPCODE_CODE_END;
+            return 0;
+        }
+
+        memcpy(&dst->immediate, bytecode + 1, 4);
+        return 5;
+    }
+
+    case CF_OPCODE_PUSH:
+    case CF_OPCODE_POP: {
+        const size_t length = cfVmDecodePushPopOperand(bytecode, rest, dst);
+        const CfPushPopInfo info = dst->info;
+
+        if (length == 0)
+            return 0;
+
+        if (false
+            || info.accessSize > CF_ACCESS_SIZE_16
+            || (info.accessSize != CF_ACCESS_SIZE_32 && !info.isMemoryAccess)
+        ) {
+            dst->opcode = CF_VM_OPCODE_INVALID_POP_INFO;
+        } else if (info.accessSize != CF_ACCESS_SIZE_32) {
+            static const uint8_t subWordOpcodes[2][2] = {
+                {CF_VM_OPCODE_PUSH_MEMORY_U8, CF_VM_OPCODE_PUSH_MEMORY_U16},
+                {CF_VM_OPCODE_POP_MEMORY_U8,  CF_VM_OPCODE_POP_MEMORY_U16 },
+            };
+            dst->opcode = subWordOpcodes[opcode == CF_OPCODE_POP][info.accessSize - CF_ACCESS_SIZE_8];
+        } else if (opcode == CF_OPCODE_PUSH) {
+            if (info.isMemoryAccess)
+                dst->opcode = info.isIndexed
+                    ? CF_VM_OPCODE_PUSH_MEMORY_INDEXED
+                    : CF_VM_OPCODE_PUSH_MEMORY;
+            else
+                dst->opcode = info.isIndexed
+                    ? CF_VM_OPCODE_PUSH_VALUE_INDEXED
+                    : CF_VM_OPCODE_PUSH_VALUE;
+        } else if (info.isMemoryAccess)
+            dst->opcode = info.isIndexed
+                ? CF_VM_OPCODE_POP_MEMORY_INDEXED
+                : CF_VM_OPCODE_POP_MEMORY;
+        else if (info.doReadImmediate || info.isIndexed)
+            dst->opcode = CF_VM_OPCODE_INVALID_POP_INFO;
+        else
+            // writes to cz and fl registers are ignored
+            dst->opcode = info.registerIndex >= 2
+                ? CF_VM_OPCODE_POP_REGISTER
+                : CF_VM_OPCODE_POP_DISCARD;
+
+        return length;
+    }
+
+    case CF_OPCODE_VLD:
+    case CF_OPCODE_VST: {
+        const size_t length = cfVmDecodePushPopOperand(bytecode, rest, dst);
+        const CfPushPopInfo info = dst->info;
+
+        if (length == 0)
+            return 0;
+
+        // vectors are loaded from and stored to [register + immediate] memory only
+        if (!info.isMemoryAccess || info.isIndexed || info.accessSize != CF_ACCESS_SIZE_32)
+            dst->opcode = CF_VM_OPCODE_INVALID_POP_INFO;
+
+        return length;
+    }
+
+    case CF_OPCODE_MOV: {
+        if (rest < 3) {
+            dst->opcode = CF_VM_OPCODE_CODE_END;
+            return 0;
+        }
+
+        CfPushPopInfo source, destination;
+        memcpy(&source, bytecode + 1, sizeof(source));
+        memcpy(&destination, bytecode + 2, sizeof(destination));
+
+        size_t length = 3;
+        uint32_t immediate = 0;
+
+        if (source.doReadImmediate) {
+            if (rest < 7) {
+                dst->opcode = CF_VM_OPCODE_CODE_END;
+                return 0;
+            }
+            memcpy(&immediate, bytecode + 3, 4);
+            length = 7;
+        }
+
+        dst->info = source;
+        dst->registerIndex = source.registerIndex;
+        dst->destinationRegister = destination.registerIndex;
+        dst->immediate = immediate;
+
+        if (false
+            || destination.isMemoryAccess
+            || destination.doReadImmediate
+            || destination.isIndexed
+            || destination.accessSize != CF_ACCESS_SIZE_32
+        ) {
+            // destination is checked in the same way as pop instruction push/pop info
+            dst->opcode = CF_VM_OPCODE_INVALID_POP_INFO;
+            dst->info = destination;
+        } else if (source.isIndexed || source.accessSize != CF_ACCESS_SIZE_32) {
+            // moves are encoded without index, so they read 32-bit (register + immediate) values only
+            dst->opcode = CF_VM_OPCODE_INVALID_POP_INFO;
+        } else if (source.isMemoryAccess)
+            dst->opcode = CF_VM_OPCODE_MOVE_MEMORY;
+        else
+            // writes to cz and fl registers are ignored
+            dst->opcode = destination.registerIndex >= 2
+                ? CF_VM_OPCODE_MOVE_VALUE
+                : CF_VM_OPCODE_NOP;
+
+        return length;
+    }
+
+    case CF_OPCODE_PPUSH: {
+        if (rest < 7) {
+            dst->opcode = CF_VM_OPCODE_CODE_END;
+            return 0;
+        }
+
+        CfPushPopInfo first, second;
+        memcpy(&first, bytecode + 1, sizeof(first));
+        memcpy(&second, bytecode + 2, sizeof(second));
+
+        uint16_t immediates[2] = {0, 0};
+        if (first.doReadImmediate)
+            memcpy(&immediates[0], bytecode + 3, 2);
+        if (second.doReadImmediate)
+            memcpy(&immediates[1], bytecode + 5, 2);
+
+        dst->info = first;
+        dst->registerIndex = first.registerIndex;
+        dst->secondInfo = second;
+        dst->immediate = (uint32_t)immediates[0] | ((uint32_t)immediates[1] << 16);
+
+        static const uint8_t pairOpcodes[2][2] = {
+            {CF_VM_OPCODE_PUSH_PAIR_VALUE_VALUE,  CF_VM_OPCODE_PUSH_PAIR_VALUE_MEMORY },
+            {CF_VM_OPCODE_PUSH_PAIR_MEMORY_VALUE, CF_VM_OPCODE_PUSH_PAIR_MEMORY_MEMORY},
+        };
+        dst->opcode = pairOpcodes[first.isMemoryAccess][second.isMemoryAccess];
+
+        // pairs are encoded without indices, so they read 32-bit (register + immediate) values only
+        for (uint32_t i = 0; i < 2; i++) {
+            const CfPushPopInfo info = i == 0 ? first : second;
+
+            if (info.isIndexed || info.accessSize != CF_ACCESS_SIZE_32) {
+                dst->opcode = CF_VM_OPCODE_INVALID_POP_INFO;
+                dst->info = info;
+                break;
+            }
+        }
+
+        return 7;
+    }
+
+    case CF_OPCODE_CSET:
+    case CF_OPCODE_ICSET:
+    case CF_OPCODE_FCSET: {
+        if (rest < 2) {
+            dst->opcode = CF_VM_OPCODE_CODE_END;
+            return 0;
+        }
+
+        // condition mask bit index is (isLt * 2 + isEq), so 0 bit means >, 1 means ==, 2 means <
+        switch ((CfCondition)bytecode[1]) {
+        case CF_CONDITION_LE: dst->immediate = 0x6; break;
+        case CF_CONDITION_L : dst->immediate = 0x4; break;
+        case CF_CONDITION_GE: dst->immediate = 0x3; break;
+        case CF_CONDITION_G : dst->immediate = 0x1; break;
+        case CF_CONDITION_E : dst->immediate = 0x2; break;
+        case CF_CONDITION_NE: dst->immediate = 0x5; break;
+
+        default:
+            // instruction with unknown condition is unknown instruction
+            dst->opcode = CF_VM_OPCODE_UNKNOWN_OPCODE;
+            dst->immediate = opcode;
+        }
+
+        return 2;
+    }
+
+    case CF_OPCODE_MSET: {
+        if (rest < 2) {
+            dst->opcode = CF_VM_OPCODE_CODE_END;
+            return 0;
+        }
+
+        switch (bytecode[1]) {
+        case 8 : dst->immediate = 1; break;
+        case 32: dst->immediate = 4; break;
+
+        default:
+            // instruction with unknown element width is unknown instruction
+            dst->opcode = CF_VM_OPCODE_UNKNOWN_OPCODE;
+            dst->immediate = opcode;
+        }
+
+        return 2;
+    }
+
+    case CF_OPCODE_UNREACHABLE:
+    case CF_OPCODE_HALT:
+    case CF_OPCODE_ADD:
+    case CF_OPCODE_SUB:
+    case CF_OPCODE_SHL:
+    case CF_OPCODE_SHR:
+    case CF_OPCODE_SAR:
+    case CF_OPCODE_OR:
+    case CF_OPCODE_XOR:
+    case CF_OPCODE_AND:
+    case CF_OPCODE_IMUL:
+    case CF_OPCODE_MUL:
+    case CF_OPCODE_IDIV:
+    case CF_OPCODE_DIV:
+    case CF_OPCODE_FADD:
+    case CF_OPCODE_FSUB:
+    case CF_OPCODE_FMUL:
+    case CF_OPCODE_FDIV:
+    case CF_OPCODE_FTOI:
+    case CF_OPCODE_ITOF:
+    case CF_OPCODE_FSIN:
+    case CF_OPCODE_FCOS:
+    case CF_OPCODE_FNEG:
+    case CF_OPCODE_FSQRT:
+    case CF_OPCODE_CMP:
+    case CF_OPCODE_ICMP:
+    case CF_OPCODE_FCMP:
+    case CF_OPCODE_RET:
+    case CF_OPCODE_VSM:
+    case CF_OPCODE_VRS:
+    case CF_OPCODE_MEOW:
+    case CF_OPCODE_TIME:
+    case CF_OPCODE_MGS:
+    case CF_OPCODE_IWKD:
+    case CF_OPCODE_IGKS:
+    case CF_OPCODE_SNAP:
+    case CF_OPCODE_VADD:
+    case CF_OPCODE_VSUB:
+    case CF_OPCODE_VMUL:
+    case CF_OPCODE_VDOT:
+    case CF_OPCODE_VBCAST:
+    case CF_OPCODE_VSQRT:
+    case CF_OPCODE_MCPY:
+        return 1;
+    }
+
+    // instruction length is unknown, so decoding can't be continued
+    dst->opcode = CF_VM_OPCODE_UNKNOWN_OPCODE;
+    dst->immediate = opcode;
+    return 0;
+} // cfVmDecodeInstruction
+
+bool cfVmOpcodeHasJumpTarget( const uint8_t opcode ) {
+    switch (opcode) {
+    case CF_OPCODE_JMP:
+    case CF_OPCODE_JLE:
+    case CF_OPCODE_JL:
+    case CF_OPCODE_JGE:
+    case CF_OPCODE_JG:
+    case CF_OPCODE_JE:
+    case CF_OPCODE_JNE:
+    case CF_OPCODE_JZ:
+    case CF_OPCODE_JNZ:
+    case CF_OPCODE_CALL:
+        return true;
+    default:
+        return false;
+    }
+} // cfVmOpcodeHasJumpTarget
+
+bool cfVmDecode( const CfExecutable *executable, CfVmInstruction **dst, size_t *dstLength, uint32_t *dstEntry ) {
+    assert(executable != NULL);
+    assert(dst != NULL);
+    assert(dstLength != NULL);
+    assert(dstEntry != NULL);
+
+    const uint8_t *const bytecodeBegin = (const uint8_t *)executable->code;
+    const uint8_t *const bytecodeEnd = bytecodeBegin + executable->codeLength;
+
+    // bytecode offset -> instruction index table
+    uint32_t *indexTable = (uint32_t *)malloc(sizeof(uint32_t) * (executable->codeLength + 1));
+    CfDarr instructions = cfDarrCtor(sizeof(CfVmInstruction));
+
+    if (indexTable == NULL || instructions == NULL) {
+        free(indexTable);
+        cfDarrDtor(instructions);
+        return false;
+    }
+
+    memset(indexTable, 0xFF, sizeof(uint32_t) * (executable->codeLength + 1));
+
+    const uint8_t *bytecode = bytecodeBegin;
+    bool decodingFinished = false;
+
+    while (!decodingFinished) {
+        CfVmInstruction instruction = {
+            .opcode = CF_VM_OPCODE_CODE_END,
+            .offset = (uint32_t)(bytecode - bytecodeBegin),
+        };
+        size_t length = 0;
+
+        if (bytecode < bytecodeEnd) {
+            length = cfVmDecodeInstruction(bytecode, bytecodeEnd, &instruction);
+            indexTable[instruction.offset] = (uint32_t)cfDarrLength(instructions);
+        }
+
+        // stop after trap written, because rest of bytecode can't be interpreted
+        decodingFinished = (length == 0);
+        bytecode += length;
+
+        if (CF_DARR_OK != cfDarrPush(&instructions, &instruction)) {
+            free(indexTable);
+            cfDarrDtor(instructions);
+            return false;
+        }
+    }
+
+    // resolve jump targets into instruction indices
+    CfVmInstruction *const code = (CfVmInstruction *)cfDarrData(instructions);
+    const size_t codeLength = cfDarrLength(instructions);
+
+    for (size_t i = 0; i < codeLength; i++) {
+        if (!cfVmOpcodeHasJumpTarget(code[i].opcode))
+            continue;
+
+        code[i].immediate = code[i].immediate < executable->codeLength
+            ? indexTable[code[i].immediate]
+            : CF_VM_INVALID_TARGET;
+        code[i].isBackwardJump = code[i].opcode != CF_OPCODE_CALL && code[i].immediate <= i;
+    }
+
+    // execution of invalid entry point starts from trap
+    *dstEntry = executable->entryPoint < executable->codeLength && indexTable[executable->entryPoint] != CF_VM_INVALID_TARGET
+        ? indexTable[executable->entryPoint]
+        : (uint32_t)(codeLength - 1);
+
+    free(indexTable);
+
+    *dstLength = codeLength;
+    if (CF_DARR_OK != cfDarrIntoData(instructions, (void **)dst)) {
+        cfDarrDtor(instructions);
+        return false;
+    }
+    cfDarrDtor(instructions);
+
+    return true;
+} // cfVmDecode
+
+// cf_vm_decode.c
@@ -0,0 +1,101 @@
+/**
+ * @brief VM forking implementation file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+    #include <sys/mman.h>
+    #include <unistd.h>
+
+    /// @brief forked VM RAM is private mapping of anonymous file with parent RAM copy (copied otherwise)
+    #define CF_VM_FORK_MEMFD
+#endif
+
+#include "cf_vm_internal.h"
+
+#ifdef CF_VM_FORK_MEMFD
+/// @brief size of RAM page checked for zeroness during RAM copy creation
+#define CF_VM_FORK_PAGE_SIZE ((size_t)4096)
+
+/**
+ * @brief RAM offset in RAM copy file getting function
+ *
+ * @param[in] ramSize RAM size
+ *
+ * @return offset (RAM end is aligned by CF_VM_SNAPSHOT_RAM_ALIGNMENT, as in snapshots, so RAM copy may be mapped with guard pages)
+ */
+static uint64_t cfVmGetRamImageOffset( const size_t ramSize ) {
+    return (ramSize + CF_VM_SNAPSHOT_RAM_ALIGNMENT - 1) / CF_VM_SNAPSHOT_RAM_ALIGNMENT * CF_VM_SNAPSHOT_RAM_ALIGNMENT - ramSize;
+} // cfVmGetRamImageOffset
+
+/**
+ * @brief RAM copy creating function
+ *
+ * @param[in,out] self VM to create RAM copy of (has no RAM copy)
+ *
+ * @return true if succeeded, false otherwise
+ */
+static bool cfVmCreateRamImage( CfVm *const self ) {
+    const int image = memfd_create("cf_vm_ram", MFD_CLOEXEC);
+    const uint64_t ramOffset = cfVmGetRamImageOffset(self->ramSize);
+
+    if (image == -1)
+        return false;
+
+    // file is zero-filled, so zero pages aren't written (and don't occupy memory)
+    if (0 != ftruncate(image, (off_t)(ramOffset + self->ramSize))) {
+        close(image);
+        return false;
+    }
+
+    for (size_t pageOffset = 0; pageOffset < self->ramSize; pageOffset += CF_VM_FORK_PAGE_SIZE) {
+        const uint8_t *const page = self->ram + pageOffset;
+        const size_t pageSize = self->ramSize - pageOffset < CF_VM_FORK_PAGE_SIZE
+            ? self->ramSize - pageOffset
+            : CF_VM_FORK_PAGE_SIZE;
+
+        bool isZero = true;
+        for (size_t i = 0; isZero && i < pageSize; i++)
+            isZero = page[i] == 0;
+
+        if (!isZero && (ssize_t)pageSize != pwrite(image, page, pageSize, (off_t)(ramOffset + pageOffset))) {
+            close(image);
+            return false;
+        }
+    }
+
+    self->ramImage = image;
+    self->hasRamImage = true;
+    return true;
+} // cfVmCreateRamImage
+#endif
+
+bool cfVmForkRam( CfVm *const parent, CfVm *const child ) {
+#ifdef CF_VM_FORK_MEMFD
+    // RAM is copied if copy-on-write mapping can't be created (e.g. memfd isn't supported by kernel)
+    if (true
+        && parent->ramSize != 0
+        && (parent->hasRamImage || cfVmCreateRamImage(parent))
+        && cfVmMapRam(child, parent->ramSize, parent->ramImage, cfVmGetRamImageOffset(parent->ramSize))
+    )
+        return true;
+#endif
+
+    if (!cfVmAllocateRam(child, parent->ramSize))
+        return false;
+    memcpy(child->ram, parent->ram, child->ramSize);
+    return true;
+} // cfVmForkRam
+
+void cfVmReleaseRamImage( CfVm *const self ) {
+#ifdef CF_VM_FORK_MEMFD
+    if (self->hasRamImage)
+        close(self->ramImage);
+#endif
+
+    self->hasRamImage = false;
+} // cfVmReleaseRamImage
+
+// cf_vm_fork.c
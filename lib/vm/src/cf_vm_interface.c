@@ -4,7 +4,9 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <time.h>
 
 #include "cf_vm_internal.h"
 
@@ -30,6 +32,268 @@ static bool cfSandboxIsValid( const CfSandbox *sandbox ) {
     ;
 } // cfSandboxIsValid
 
+/**
+ * @brief pre-decoded code initialization function
+ *
+ * @param[out] self             code to initialize (non-null)
+ * @param[in]  executable       executable to decode (non-null)
+ * @param[in]  operandStackSize operand stack capacity of VM code is executed in (SIZE_MAX if unknown)
+ * @param[in]  doVerify         true if code should be verified (so it may be executed by check-free interpreter)
+ *
+ * @return true if succeeded, false if allocation failed
+ */
+static bool cfVmCodeInitialize(
+    CfVmCode           *const self,
+    const CfExecutable *const executable,
+    const size_t              operandStackSize,
+    const bool                doVerify
+) {
+    // translate bytecode into pre-decoded instruction stream
+    if (!cfVmDecode(executable, &self->code, &self->codeLength, &self->entry))
+        return false;
+
+    // verified code is executed by check-free interpreter
+    self->isCodeVerified = doVerify && cfVmVerify(self->code, self->codeLength, self->entry);
+
+    // check-free interpreter checks operand stack overflow on function calls only, so
+    // top-level code overflow is reported by checked interpreter at exact instruction
+    if (self->isCodeVerified && (size_t)self->code[self->entry].maxStackDepth > operandStackSize)
+        self->isCodeVerified = false;
+
+#ifdef CF_VM_THREADED_DISPATCH
+    cfVmThreadCode(self->code, self->codeLength, self->isCodeVerified);
+#endif
+
+    return true;
+} // cfVmCodeInitialize
+
+CfVmCode * cfVmCodeCtor( const CfExecutable *executable ) {
+    assert(executable != NULL);
+
+    CfVmCode *self = (CfVmCode *)calloc(1, sizeof(CfVmCode));
+
+    if (self == NULL)
+        return NULL;
+
+    // VMs with smaller operand stacks decode their own code
+    if (!cfVmCodeInitialize(self, executable, SIZE_MAX, true)) {
+        free(self);
+        return NULL;
+    }
+
+    return self;
+} // cfVmCodeCtor
+
+void cfVmCodeDtor( CfVmCode *self ) {
+    if (self == NULL)
+        return;
+
+    free(self->code);
+    free(self);
+} // cfVmCodeDtor
+
+/**
+ * @brief VM initialization function
+ *
+ * @param[out] self          VM to initialize (zeroed, executable and sandbox are set)
+ * @param[in]  execInfo      execution info (valid)
+ * @param[in]  image         snapshot to start execution from (null if execution is started from scratch)
+ * @param[in]  imageHeader   snapshot header (null if image is null)
+ * @param[in]  isResumable   true if VM is used for resumable execution (so only interpreters are set up)
+ *
+ * @return true if VM is ready to run code, false otherwise (VM still should be released by cfVmRelease then)
+ *
+ * @note sandbox is initialized here, so its termination callback should be called after VM start.
+ */
+static bool cfVmInitializeState(
+    CfVm                     *const self,
+    const CfExecuteInfo      *const execInfo,
+    FILE                     *const image,
+    const CfVmSnapshotHeader *const imageHeader,
+    const bool                      isResumable
+) {
+    // allocate memory (RAM and stack sizes of VM started from snapshot are the same as of VM snapshot is written by)
+    if (image != NULL) {
+        self->operandStackSize = imageHeader->operandStackSize;
+        self->callStackSize = imageHeader->callStackSize;
+
+        if (!cfVmSnapshotLoadRam(self, image, imageHeader))
+            return false;
+    } else {
+        // snapshot RAM contains segments already, so they are loaded only if execution starts from scratch
+        if (!cfVmAllocateRam(self, execInfo->ramSize) || !cfVmLoadSegments(self))
+            return false;
+        self->operandStackSize = execInfo->operandStackSize != 0
+            ? execInfo->operandStackSize
+            : CF_VM_DEFAULT_OPERAND_STACK_SIZE;
+        self->callStackSize = execInfo->callStackSize != 0
+            ? execInfo->callStackSize
+            : CF_VM_DEFAULT_CALL_STACK_SIZE;
+    }
+    self->operandStack = (uint32_t *)malloc(sizeof(uint32_t) * self->operandStackSize);
+    self->callStack = (uint32_t *)malloc(sizeof(uint32_t) * self->callStackSize);
+
+    // here VM is not even initialized
+    if (self->ram == NULL || self->callStack == NULL || self->operandStack == NULL)
+        return false;
+
+    self->operandStackTop = self->operandStack;
+    self->callStackTop = self->callStack;
+
+    // stack depths of snapshot aren't known to match ones computed by verifier (snapshot file
+    // may be damaged or modified), so execution from snapshot is performed by checked interpreter
+    const bool doVerify = image == NULL;
+
+    // shared code is threaded for check-free interpreter if it's verified, so it can't be used by VM
+    // which operand stack is too small for top-level code or which is started from snapshot (it's decoded again then)
+    const CfVmCode *const sharedCode = execInfo->code;
+    if (true
+        && sharedCode != NULL
+        && !(sharedCode->isCodeVerified && (false
+            || !doVerify
+            || (size_t)sharedCode->code[sharedCode->entry].maxStackDepth > self->operandStackSize
+        ))
+    ) {
+        self->code = sharedCode->code;
+        self->codeLength = sharedCode->codeLength;
+        self->entry = sharedCode->entry;
+        self->isCodeVerified = sharedCode->isCodeVerified;
+    } else {
+        CfVmCode code = {};
+
+        if (!cfVmCodeInitialize(&code, self->executable, self->operandStackSize, doVerify))
+            return false;
+
+        self->ownedCode = code.code;
+        self->code = code.code;
+        self->codeLength = code.codeLength;
+        self->entry = code.entry;
+        self->isCodeVerified = code.isCodeVerified;
+    }
+
+    // profile is collected by interpreter, so no other execution engines are set up
+    if (execInfo->profilePath != NULL) {
+        self->profilePath = execInfo->profilePath;
+        self->profile = (CfVmProfileEntry *)calloc(self->codeLength, sizeof(CfVmProfileEntry));
+
+        if (self->profile == NULL)
+            return false;
+    }
+
+    // JIT-compiled and translated code can't yield, so they are never used by resumable execution
+    // (and by execution from snapshot or with snapshot writing, because they don't keep interpreter's state)
+    self->snapshotPath = execInfo->snapshotPath;
+    if (!isResumable && self->profile == NULL && self->snapshotPath == NULL && image == NULL) {
+#ifdef CF_VM_JIT
+        // interpreter is used if code can't be compiled
+        if (execInfo->useJit)
+            cfVmJitCompile(self);
+#endif
+
+        // translation requires operand stack depth of each instruction to be known
+        if (true
+            && execInfo->useTranslation
+            && self->isCodeVerified
+#ifdef CF_VM_JIT
+            && self->nativeCode == NULL
+#endif
+        )
+            cfVmTranslationCreate(self);
+    }
+
+    // traces are executed by check-free interpreter, which keeps its state in VM, so they're allowed
+    // for resumable execution and snapshots (code is interpreted if trace cache allocation fails)
+    if (true
+        && execInfo->useTraces
+        && self->isCodeVerified
+        && self->profile == NULL
+        && self->translation == NULL
+#ifdef CF_VM_JIT
+        && self->nativeCode == NULL
+#endif
+    )
+        cfVmTraceCreate(self);
+
+    self->instructionCounter = self->code + self->entry;
+
+    if (image != NULL && !cfVmSnapshotRestore(self, image, imageHeader))
+        return false;
+
+    // try to initialize sandbox
+    CfExecContext execContext = {
+        .memory = self->ram,
+        .memorySize = self->ramSize,
+    };
+
+    // standard termination mechanism is not used, because (by specification?)
+    // ANY sandbox function (terminate() too) MUST NOT be called if sandbox initialization failed.
+    return execInfo->sandbox->initialize(execInfo->sandbox->userContext, &execContext);
+} // cfVmInitializeState
+
+/**
+ * @brief VM initialization function
+ *
+ * @param[out] self          VM to initialize (zeroed, executable and sandbox are set)
+ * @param[in]  execInfo      execution info (valid)
+ * @param[in]  isResumable   true if VM is used for resumable execution (so only interpreters are set up)
+ *
+ * @return true if VM is ready to run code, false otherwise (VM still should be released by cfVmRelease then)
+ *
+ * @note sandbox is initialized here, so its termination callback should be called after VM start.
+ */
+static bool cfVmInitialize( CfVm *const self, const CfExecuteInfo *const execInfo, const bool isResumable ) {
+    if (execInfo->imagePath == NULL)
+        return cfVmInitializeState(self, execInfo, NULL, NULL, isResumable);
+
+    // mapping stays valid after file is closed
+    FILE *image = fopen(execInfo->imagePath, "rb");
+    CfVmSnapshotHeader imageHeader;
+
+    if (image == NULL)
+        return false;
+
+    const bool isOk = true
+        && cfVmSnapshotReadHeader(image, self->executable, &imageHeader)
+        && cfVmInitializeState(self, execInfo, image, &imageHeader, isResumable)
+    ;
+
+    fclose(image);
+    return isOk;
+} // cfVmInitialize
+
+/**
+ * @brief VM resources releasing function
+ *
+ * @param[in,out] self VM to release resources of (may be partially initialized)
+ */
+static void cfVmRelease( CfVm *const self ) {
+#ifdef CF_VM_JIT
+    cfVmJitRelease(self);
+#endif
+    cfVmTranslationRelease(self);
+    cfVmTraceRelease(self);
+    free(self->profile);
+    cfVmReleaseRamImage(self);
+    cfVmReleaseRam(self);
+    free(self->ownedCode);
+    free(self->callStack);
+    free(self->operandStack);
+} // cfVmRelease
+
+/**
+ * @brief VM termination handling function (called after longjmp to panicJumpBuffer)
+ *
+ * @param[in,out] self terminated VM
+ *
+ * @return true if succeeded, false if profile writing failed
+ */
+static bool cfVmHandleTermination( CfVm *const self ) {
+    self->isTerminated = true;
+    self->sandbox->terminate(self->sandbox->userContext, &self->termInfo);
+
+    return self->profile == NULL || cfVmProfileWrite(self, self->profilePath);
+} // cfVmHandleTermination
+
 bool cfExecute( const CfExecuteInfo *execInfo ) {
     assert(execInfo != NULL);
 
@@ -50,55 +314,207 @@ bool cfExecute( const CfExecuteInfo *execInfo ) {
     // note: after jumpBuffer setup it's ok to do cleanup and call panic.
     int jmp = setjmp(vm.panicJumpBuffer);
     if (jmp) {
-        execInfo->sandbox->terminate(execInfo->sandbox->userContext, &vm.termInfo);
+        isOk = cfVmHandleTermination(&vm);
         // then go to cleanup
         goto cfExecute__cleanup;
     }
 
-    // allocate memory
-    vm.ramSize = execInfo->ramSize;
-    vm.ram = (uint8_t *)calloc(vm.ramSize, 1);
-    vm.callStack = cfDarrCtor(sizeof(uint8_t *));
-    vm.operandStack = cfDarrCtor(sizeof(uint32_t));
-
-    // here VM is not even initialized
-    if (vm.ram == NULL || vm.callStack == NULL || vm.operandStack == NULL) {
+    if (!cfVmInitialize(&vm, execInfo, false)) {
         isOk = false;
         goto cfExecute__cleanup;
     }
 
-    vm.instructionCounterBegin = (const uint8_t *)vm.executable->code;
-    vm.instructionCounterEnd   = (const uint8_t *)vm.executable->code + vm.executable->codeLength;
-
-    vm.instructionCounter = vm.instructionCounterBegin;
-
-    // try to initialize sandbox
-    {
-        CfExecContext execContext = {
-            .memory = vm.ram,
-            .memorySize = vm.ramSize,
-        };
-
-        // finish if initialization failed
-        // standard termination mechanism is not used, because (by specification?)
-        // ANY sandbox function (terminate() too) MUST NOT be called if sandbox initialization failed.
-        if (!execInfo->sandbox->initialize(execInfo->sandbox->userContext, &execContext)) {
-            isOk = false;
-            goto cfExecute__cleanup;
-        }
+    // start execution (interpreter returns only if budget is exhausted, so it's just restarted then)
+    for (;;) {
+        vm.instructionBudget = INT64_MAX;
+        cfVmRun(&vm);
     }
 
-    // start execution
-    cfVmRun(&vm);
-
-    assert(false && "vm fatal internal error occured");
-
     // perform cleanup
 cfExecute__cleanup:
-    free(vm.ram);
-    cfDarrDtor(vm.callStack);
-    cfDarrDtor(vm.operandStack);
+    cfVmRelease(&vm);
     return isOk;
 } // cfExecute
 
-// cf_vm.c
+CfVm * cfVmCtor( const CfExecuteInfo *execInfo ) {
+    assert(execInfo != NULL);
+
+    assert(execInfo->executable != NULL);
+    assert(execInfo->sandbox != NULL);
+    assert(cfSandboxIsValid(execInfo->sandbox));
+
+    CfVm *self = (CfVm *)calloc(1, sizeof(CfVm));
+
+    if (self == NULL)
+        return NULL;
+
+    self->executable = execInfo->executable;
+    self->sandbox = execInfo->sandbox;
+
+    if (!cfVmInitialize(self, execInfo, true)) {
+        cfVmRelease(self);
+        free(self);
+        return NULL;
+    }
+
+    return self;
+} // cfVmCtor
+
+/**
+ * @brief monotonic time (in microseconds) getting function
+ *
+ * @return current time
+ */
+static uint64_t cfVmGetTimeMicroseconds( void ) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000 + (uint64_t)time.tv_nsec / 1000;
+} // cfVmGetTimeMicroseconds
+
+CfVmResumeStatus cfVmResume( CfVm *const self, const uint64_t instructionBudget, const uint64_t timeBudget ) {
+    assert(self != NULL);
+
+    if (self->isTerminated)
+        return CF_VM_RESUME_STATUS_TERMINATED;
+
+    // RAM is going to be modified, so RAM copy of forked VMs becomes outdated
+    cfVmReleaseRamImage(self);
+
+    if (setjmp(self->panicJumpBuffer)) {
+        // profile writing error can't be reported here, so it's ignored
+        cfVmHandleTermination(self);
+        return CF_VM_RESUME_STATUS_TERMINATED;
+    }
+
+    const uint64_t startTime = timeBudget != 0 ? cfVmGetTimeMicroseconds() : 0;
+    uint64_t remainingBudget = instructionBudget != 0 && instructionBudget < INT64_MAX
+        ? instructionBudget
+        : INT64_MAX;
+
+    for (;;) {
+        // time is checked between slices of CF_VM_TIME_CHECK_INSTRUCTION_COUNT instructions
+        const uint64_t sliceBudget = timeBudget != 0 && remainingBudget > CF_VM_TIME_CHECK_INSTRUCTION_COUNT
+            ? CF_VM_TIME_CHECK_INSTRUCTION_COUNT
+            : remainingBudget;
+
+        self->instructionBudget = (int64_t)sliceBudget;
+        cfVmRun(self);
+
+        // interpreter returns after budget is exhausted (so it's zero or negative)
+        const uint64_t executed = sliceBudget - self->instructionBudget;
+
+        if (remainingBudget <= executed)
+            return CF_VM_RESUME_STATUS_YIELDED;
+        if (instructionBudget != 0)
+            remainingBudget -= executed;
+
+        if (timeBudget != 0 && cfVmGetTimeMicroseconds() - startTime >= timeBudget)
+            return CF_VM_RESUME_STATUS_YIELDED;
+    }
+} // cfVmResume
+
+/**
+ * @brief forked VM state initialization function
+ *
+ * @param[in,out] parent VM to fork
+ * @param[out]    child  VM to initialize (zeroed, executable and sandbox are set)
+ *
+ * @return true if forked VM is ready to run code, false otherwise (VM still should be released by cfVmRelease then)
+ *
+ * @note sandbox is initialized here, so its termination callback should be called after VM start.
+ */
+static bool cfVmInitializeFork( CfVm *const parent, CfVm *const child ) {
+    const size_t operandStackDepth = parent->operandStackTop - parent->operandStack;
+    const size_t callStackDepth = parent->callStackTop - parent->callStack;
+
+    child->operandStackSize = parent->operandStackSize;
+    child->callStackSize = parent->callStackSize;
+    child->operandStack = (uint32_t *)malloc(sizeof(uint32_t) * child->operandStackSize);
+    child->callStack = (uint32_t *)malloc(sizeof(uint32_t) * child->callStackSize);
+
+    if (child->callStack == NULL || child->operandStack == NULL || !cfVmForkRam(parent, child))
+        return false;
+
+    // code decoded by parent itself may be destroyed with it, so it's copied (threaded handlers remain valid)
+    child->codeLength = parent->codeLength;
+    child->entry = parent->entry;
+    child->isCodeVerified = parent->isCodeVerified;
+    if (parent->ownedCode != NULL) {
+        child->ownedCode = (CfVmInstruction *)malloc(sizeof(CfVmInstruction) * child->codeLength);
+
+        if (child->ownedCode == NULL)
+            return false;
+        memcpy(child->ownedCode, parent->ownedCode, sizeof(CfVmInstruction) * child->codeLength);
+        child->code = child->ownedCode;
+    } else {
+        child->code = parent->code;
+    }
+
+    // child records its own traces, so parent instruction counter is mapped from trace to code
+    if (parent->traces != NULL && !cfVmTraceCreate(child))
+        return false;
+
+    // instruction counter points to parent code (call stack holds instruction indices, so it's copied as is)
+    memcpy(child->operandStack, parent->operandStack, sizeof(uint32_t) * operandStackDepth);
+    memcpy(child->callStack, parent->callStack, sizeof(uint32_t) * callStackDepth);
+
+    child->operandStackTop = child->operandStack + operandStackDepth;
+    child->callStackTop = child->callStack + callStackDepth;
+    child->instructionCounter = child->code + (cfVmTraceGetSource(parent, parent->instructionCounter) - parent->code);
+    child->registers = parent->registers;
+    child->snapshotPath = parent->snapshotPath;
+
+    CfExecContext execContext = {
+        .memory = child->ram,
+        .memorySize = child->ramSize,
+    };
+
+    return child->sandbox->initialize(child->sandbox->userContext, &execContext);
+} // cfVmInitializeFork
+
+CfVm * cfVmFork( CfVm *vm, const CfSandbox *sandbox ) {
+    assert(vm != NULL);
+    assert(sandbox != NULL);
+    assert(cfSandboxIsValid(sandbox));
+
+    // state of terminated VM isn't saved, so there's nothing to continue execution from
+    if (vm->isTerminated)
+        return NULL;
+
+    CfVm *child = (CfVm *)calloc(1, sizeof(CfVm));
+
+    if (child == NULL)
+        return NULL;
+
+    child->executable = vm->executable;
+    child->sandbox = sandbox;
+
+    if (!cfVmInitializeFork(vm, child)) {
+        cfVmRelease(child);
+        free(child);
+        return NULL;
+    }
+
+    return child;
+} // cfVmFork
+
+bool cfVmWriteSnapshot( const CfVm *vm, const char *path ) {
+    assert(vm != NULL);
+    assert(path != NULL);
+
+    if (vm->isTerminated)
+        return false;
+
+    // stack tops are saved by interpreter on yield, so VM state is actual here
+    return cfVmSnapshotWrite(vm, path);
+} // cfVmWriteSnapshot
+
+void cfVmDtor( CfVm *self ) {
+    if (self == NULL)
+        return;
+
+    cfVmRelease(self);
+    free(self);
+} // cfVmDtor
+
+// cf_vm_interface.c
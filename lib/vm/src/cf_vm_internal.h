@@ -10,27 +10,241 @@ extern "C" {
 #endif
 
 #include <cf_darr.h>
+#include <cf_hash.h>
 #include <setjmp.h>
+#include <stdio.h>
 
 #include "cf_vm.h"
 
+/// @brief VM-internal opcodes (used in pre-decoded instruction stream only, never occur in CfExecutable bytecode)
+typedef enum CfVmOpcode_ {
+    CF_VM_OPCODE_PUSH_VALUE = 0x80,       ///< push (register + immediate)
+    CF_VM_OPCODE_PUSH_MEMORY,             ///< push [register + immediate]
+    CF_VM_OPCODE_POP_REGISTER,            ///< pop register (register index is always >= 2)
+    CF_VM_OPCODE_POP_DISCARD,             ///< pop value to read-only register (e.g. just drop it)
+    CF_VM_OPCODE_POP_MEMORY,              ///< pop [register + immediate]
+
+    CF_VM_OPCODE_PUSH_VALUE_INDEXED,      ///< push (register + index * scale + immediate)
+    CF_VM_OPCODE_PUSH_MEMORY_INDEXED,     ///< push [register + index * scale + immediate]
+    CF_VM_OPCODE_POP_MEMORY_INDEXED,      ///< pop [register + index * scale + immediate]
+    CF_VM_OPCODE_PUSH_MEMORY_U8,          ///< push byte [register + index * scale + immediate] (cz index if not indexed)
+    CF_VM_OPCODE_PUSH_MEMORY_U16,         ///< push word [register + index * scale + immediate] (cz index if not indexed)
+    CF_VM_OPCODE_POP_MEMORY_U8,           ///< pop byte [register + index * scale + immediate] (cz index if not indexed)
+    CF_VM_OPCODE_POP_MEMORY_U16,          ///< pop word [register + index * scale + immediate] (cz index if not indexed)
+
+    CF_VM_OPCODE_MOVE_VALUE,              ///< mov destinationRegister, register + immediate (destination register is always >= 2)
+    CF_VM_OPCODE_MOVE_MEMORY,             ///< mov destinationRegister, [register + immediate]
+    CF_VM_OPCODE_NOP,                     ///< no operation (e.g. move of value to read-only register)
+
+    CF_VM_OPCODE_PUSH_PAIR_VALUE_VALUE,   ///< ppush (register + imm16), (register + imm16)
+    CF_VM_OPCODE_PUSH_PAIR_VALUE_MEMORY,  ///< ppush (register + imm16), [register + imm16]
+    CF_VM_OPCODE_PUSH_PAIR_MEMORY_VALUE,  ///< ppush [register + imm16], (register + imm16)
+    CF_VM_OPCODE_PUSH_PAIR_MEMORY_MEMORY, ///< ppush [register + imm16], [register + imm16]
+
+    CF_VM_OPCODE_TRACE_LOOP,              ///< hot loop trace back edge (immediate is its index in trace, never occurs in code)
+
+    CF_VM_OPCODE_INVALID_POP_INFO,        ///< trap: pop instruction with invalid push/pop info
+    CF_VM_OPCODE_UNKNOWN_OPCODE,          ///< trap: unknown opcode (opcode byte is stored in immediate)
+    CF_VM_OPCODE_CODE_END,                ///< trap: unexpected code end (truncated instruction or end of code reached)
+} CfVmOpcode;
+
+/// @brief all opcodes handled by interpreter enumeration macro (X-macro, used to build dispatch tables)
+#define CF_VM_FOR_EACH_OPCODE(x)            \
+    x(CF_OPCODE_UNREACHABLE)                \
+    x(CF_OPCODE_SYSCALL)                    \
+    x(CF_OPCODE_HALT)                       \
+    x(CF_OPCODE_ADD)                        \
+    x(CF_OPCODE_SUB)                        \
+    x(CF_OPCODE_SHL)                        \
+    x(CF_OPCODE_SHR)                        \
+    x(CF_OPCODE_SAR)                        \
+    x(CF_OPCODE_OR)                         \
+    x(CF_OPCODE_XOR)                        \
+    x(CF_OPCODE_AND)                        \
+    x(CF_OPCODE_IMUL)                       \
+    x(CF_OPCODE_MUL)                        \
+    x(CF_OPCODE_IDIV)                       \
+    x(CF_OPCODE_DIV)                        \
+    x(CF_OPCODE_FADD)                       \
+    x(CF_OPCODE_FSUB)                       \
+    x(CF_OPCODE_FMUL)                       \
+    x(CF_OPCODE_FDIV)                       \
+    x(CF_OPCODE_FTOI)                       \
+    x(CF_OPCODE_ITOF)                       \
+    x(CF_OPCODE_FSIN)                       \
+    x(CF_OPCODE_FCOS)                       \
+    x(CF_OPCODE_FNEG)                       \
+    x(CF_OPCODE_FSQRT)                      \
+    x(CF_OPCODE_CMP)                        \
+    x(CF_OPCODE_ICMP)                       \
+    x(CF_OPCODE_FCMP)                       \
+    x(CF_OPCODE_JMP)                        \
+    x(CF_OPCODE_JLE)                        \
+    x(CF_OPCODE_JL)                         \
+    x(CF_OPCODE_JGE)                        \
+    x(CF_OPCODE_JG)                         \
+    x(CF_OPCODE_JE)                         \
+    x(CF_OPCODE_JNE)                        \
+    x(CF_OPCODE_CALL)                       \
+    x(CF_OPCODE_RET)                        \
+    x(CF_OPCODE_VSM)                        \
+    x(CF_OPCODE_VRS)                        \
+    x(CF_OPCODE_MEOW)                       \
+    x(CF_OPCODE_TIME)                       \
+    x(CF_OPCODE_MGS)                        \
+    x(CF_OPCODE_IGKS)                       \
+    x(CF_OPCODE_IWKD)                       \
+    x(CF_OPCODE_CSET)                       \
+    x(CF_OPCODE_ICSET)                      \
+    x(CF_OPCODE_FCSET)                      \
+    x(CF_OPCODE_JZ)                         \
+    x(CF_OPCODE_JNZ)                        \
+    x(CF_OPCODE_SNAP)                       \
+    x(CF_OPCODE_VLD)                        \
+    x(CF_OPCODE_VST)                        \
+    x(CF_OPCODE_VADD)                       \
+    x(CF_OPCODE_VSUB)                       \
+    x(CF_OPCODE_VMUL)                       \
+    x(CF_OPCODE_VDOT)                       \
+    x(CF_OPCODE_VBCAST)                     \
+    x(CF_OPCODE_VSQRT)                      \
+    x(CF_OPCODE_MCPY)                       \
+    x(CF_OPCODE_MSET)                       \
+    x(CF_VM_OPCODE_PUSH_VALUE)              \
+    x(CF_VM_OPCODE_PUSH_MEMORY)             \
+    x(CF_VM_OPCODE_POP_REGISTER)            \
+    x(CF_VM_OPCODE_POP_DISCARD)             \
+    x(CF_VM_OPCODE_POP_MEMORY)              \
+    x(CF_VM_OPCODE_PUSH_VALUE_INDEXED)      \
+    x(CF_VM_OPCODE_PUSH_MEMORY_INDEXED)     \
+    x(CF_VM_OPCODE_POP_MEMORY_INDEXED)      \
+    x(CF_VM_OPCODE_PUSH_MEMORY_U8)          \
+    x(CF_VM_OPCODE_PUSH_MEMORY_U16)         \
+    x(CF_VM_OPCODE_POP_MEMORY_U8)           \
+    x(CF_VM_OPCODE_POP_MEMORY_U16)          \
+    x(CF_VM_OPCODE_MOVE_VALUE)              \
+    x(CF_VM_OPCODE_MOVE_MEMORY)             \
+    x(CF_VM_OPCODE_NOP)                     \
+    x(CF_VM_OPCODE_PUSH_PAIR_VALUE_VALUE)   \
+    x(CF_VM_OPCODE_PUSH_PAIR_VALUE_MEMORY)  \
+    x(CF_VM_OPCODE_PUSH_PAIR_MEMORY_VALUE)  \
+    x(CF_VM_OPCODE_PUSH_PAIR_MEMORY_MEMORY) \
+    x(CF_VM_OPCODE_TRACE_LOOP)              \
+    x(CF_VM_OPCODE_INVALID_POP_INFO)        \
+    x(CF_VM_OPCODE_UNKNOWN_OPCODE)          \
+    x(CF_VM_OPCODE_CODE_END)
+
+/// @brief packed f32x4 vector (GCC/Clang vector extension, so host SIMD registers are used for it)
+typedef float CfVmF32x4 __attribute__((vector_size(16)));
+
+/// @brief (register + index * scale + immediate) value of indexed or sub-word push/pop instruction computing macro
+#define CF_VM_INDEXED_VALUE(self, instruction) ((uint32_t)(0                                             \
+    + (self)->registers.indexed[(instruction)->registerIndex]                                            \
+    + ((self)->registers.indexed[(instruction)->index.registerIndex] << (instruction)->index.scaleShift) \
+    + (instruction)->immediate                                                                           \
+))
+
+/// @brief invalid jump target instruction index
+#define CF_VM_INVALID_TARGET (~(uint32_t)0)
+
+/// @brief pre-decoded instruction representation structure
+typedef struct CfVmInstruction_ {
+    uint8_t       opcode;        ///< instruction opcode (CfOpcode or CfVmOpcode)
+    uint8_t       registerIndex; ///< push/pop register index (always < CF_REGISTER_COUNT)
+    CfPushPopInfo info;          ///< original push/pop info (for diagnostics)
+    union {
+        uint8_t        destinationRegister; ///< mov destination register index
+        CfPushPopInfo  secondInfo;          ///< ppush second push/pop info
+        CfPushPopIndex index;               ///< push/pop scaled index (indexed and sub-word accesses only)
+        bool           isBackwardJump;      ///< jump target doesn't follow jump, so it's loop header candidate (jumps only)
+    };
+    uint32_t      immediate;     ///< immediate value, system call index, jump target (instruction index),
+                                 ///< ppush immediate pair (first in low half), compare-and-set condition mask
+                                 ///< or memory fill element size (in bytes)
+    uint32_t      offset;        ///< offset of instruction in executable bytecode
+    int32_t       maxStackDepth; ///< maximal operand stack depth (relative to function entry, not including
+                                 ///< operands of called functions) in basic block started by instruction (verified code only),
+                                 ///< for function entries (and code entry) in the whole function
+#ifdef CF_VM_THREADED_DISPATCH
+    const void *  handler;       ///< interpreter handler address (set by cfVmThreadCode)
+#endif
+} CfVmInstruction;
+
+/// @brief single instruction execution profile
+typedef struct CfVmProfileEntry_ {
+    uint64_t count; ///< instruction execution count
+    uint64_t time;  ///< total instruction execution time (in profile clock units)
+} CfVmProfileEntry;
+
+/// @brief pre-decoded code representation structure (immutable after construction, so it may be shared by VMs)
+struct CfVmCode_ {
+    CfVmInstruction * code;           ///< pre-decoded instructions (terminated by CODE_END trap)
+    size_t            codeLength;     ///< pre-decoded instruction count (including trap)
+    uint32_t          entry;          ///< index of instruction execution starts from
+    bool              isCodeVerified; ///< true if code is verified by cfVmVerify
+};
+
+/// @brief count of instructions resumable execution is performed between time budget checks
+#define CF_VM_TIME_CHECK_INSTRUCTION_COUNT ((uint64_t)1 << 14)
+
 /// @brief VM context representation structure
 typedef struct CfVm_ {
     uint8_t *         ram;                     ///< RAM bytes
     size_t            ramSize;                 ///< RAM size
+    void            * ramMapping;              ///< mapping RAM is placed in (null if RAM is allocated by calloc)
+    size_t            ramMappingSize;          ///< RAM mapping size
+    bool              hasRamImage;             ///< true if ramImage contains actual RAM copy forked VMs map
+    int               ramImage;                ///< RAM copy file descriptor (valid only if hasRamImage is true)
 
     const CfExecutable * executable;           ///< executed executable
     const CfSandbox    * sandbox;              ///< execution environment (sandbox, actually)
 
+    // pre-decoded code
+    const CfVmInstruction * code;              ///< pre-decoded instructions (terminated by CODE_END trap)
+    CfVmInstruction * ownedCode;               ///< code decoded by VM itself (null if shared code is used)
+    size_t            codeLength;              ///< pre-decoded instruction count (including trap)
+    uint32_t          entry;                   ///< index of instruction execution starts from
+    bool              isCodeVerified;          ///< true if code is verified by cfVmVerify, so checks may be omitted
+
     // registers
     CfRegisters       registers;               ///< user visible register
-    const uint8_t   * instructionCounter;      ///< next instruction to execute pointer
-    const uint8_t   * instructionCounterBegin; ///< pointer to first instruction
-    const uint8_t   * instructionCounterEnd;   ///< pointer to first byte AFTER last instruciton
+    const CfVmInstruction * instructionCounter; ///< next instruction to execute pointer
+
+    // stacks (stack tops are kept in interpreter local variables and are saved here on yield only)
+    uint32_t        * operandStack;            ///< operand stack
+    size_t            operandStackSize;        ///< operand stack capacity
+    uint32_t        * operandStackTop;         ///< operand stack top
+    uint32_t        * callStack;               ///< call stack (contains indices of instructions to return to in all
+                                               ///< execution modes, so each frame is single 32-bit store)
+    size_t            callStackSize;           ///< call stack capacity
+    uint32_t        * callStackTop;            ///< call stack top
+
+    // resumable execution
+    int64_t           instructionBudget;       ///< count of instructions interpreter executes before yield (remaining
+                                               ///< count is written back on yield, so it's zero or negative then)
+    bool              isTerminated;            ///< true if execution is terminated
 
-    // stascks
-    CfDarr           operandStack;             ///< function operand stack
-    CfDarr           callStack;                ///< call stack (contains previous instructionCounter's)
+#ifdef CF_VM_JIT
+    // native code
+    void            * nativeCode;              ///< JIT-compiled code (null if code is interpreted)
+    size_t            nativeCodeSize;          ///< JIT-compiled code mapping size
+#endif
+
+    // register-based code
+    struct CfVmTranslation_ * translation;     ///< translated code block cache (null if code isn't translated)
+
+    // hot loop traces
+    struct CfVmTraceCache_ * traces;           ///< hot loop trace cache (null if traces aren't recorded)
+    int32_t                * loopCounters;     ///< taken back edge counters of loop headers (negative if loop isn't
+                                               ///< traced, so interpreter doesn't enter it, owned by trace cache)
+
+    // profiling
+    CfVmProfileEntry * profile;                ///< per-instruction execution profile (indexed as code, null if
+                                               ///< profiling isn't required)
+    const char       * profilePath;            ///< profile file path
+
+    // snapshots
+    const char       * snapshotPath;           ///< file snap instruction writes snapshot to (null if snap is no-op)
 
     /// panic-related fields
     CfTermInfo        termInfo;                ///< info to give to user if panic occured
@@ -38,76 +252,356 @@ typedef struct CfVm_ {
 } CfVm;
 
 /**
- * @brief execution termination function
+ * @brief executable into pre-decoded instruction stream translation function
  * 
- * @param[in,out] self   VM pointer
- * @param[in]     reason termination reason
+ * @param[in]  executable executable to decode (non-null)
+ * @param[out] dst        decoded instruction array destination (non-null, allocated with calloc)
+ * @param[out] dstLength  decoded instruction count destination (non-null)
+ * @param[out] dstEntry   entry instruction index destination (non-null)
+ * 
+ * @return true if succeeded, false if allocation failed
+ * 
+ * @note decoding never fails because of executable invalidness: corresponding
+ * traps are written into instruction stream instead, so errors are reported only
+ * in case if they are actually reached during execution (entry point that isn't
+ * instruction start is decoded as trap index too).
  */
-void cfVmTerminate( CfVm *self, const CfTermReason reason );
+bool cfVmDecode( const CfExecutable *executable, CfVmInstruction **dst, size_t *dstLength, uint32_t *dstEntry );
 
 /**
- * @brief value by instruction counter popping function
+ * @brief decoded instruction jump target presence checking function
+ * 
+ * @param[in] opcode decoded instruction opcode
  * 
- * @param[in,out] self  virtual machine to perform operation in
- * @param[out]    dst   operation destination
- * @param[in]     count count of bytes to read from instruction stream
+ * @return true if immediate of instruction is jump target, false otherwise
  */
-void cfVmRead( CfVm *const self, void *const dst, const size_t count );
+bool cfVmOpcodeHasJumpTarget( const uint8_t opcode );
 
 /**
- * @brief value to operand stack pushing function
+ * @brief instruction operand stack effect getting function
+ *
+ * @param[in]  instruction instruction to get stack effect of (non-null)
+ * @param[out] popCount    count of operands popped by instruction (non-null)
+ * @param[out] pushCount   count of operands pushed by instruction (non-null)
+ *
+ * @note control flow instructions (and traps) have zero stack effect, except
+ * of zero-test jumps, which pop tested value.
+ */
+void cfVmGetStackEffect(
+    const CfVmInstruction *const instruction,
+    int32_t               *const popCount,
+    int32_t               *const pushCount
+);
+
+/**
+ * @brief pre-decoded code verification function
+ * 
+ * @param[in,out] code       code to verify (non-null, maxStackDepth fields are written)
+ * @param[in]     codeLength code length
+ * @param[in]     entry      top-level code entry instruction index
+ * 
+ * @return true if code is verified, false if it can't be verified (or allocation failed)
  * 
- * @param[in,out] self virtual machine to perform action in
- * @param[out]    src  operand source (non-null, 4 bytes readable)
+ * @note code is verified if all reachable jump and call targets are valid, no traps are
+ * reachable, ret is never executed by top-level code and operand stack depth of each
+ * instruction is statically known (so operand stack underflow is impossible).
  */
-void cfVmPushOperand( CfVm *const self, const void *const src );
+bool cfVmVerify( CfVmInstruction *code, size_t codeLength, uint32_t entry );
 
+#ifdef CF_VM_THREADED_DISPATCH
 /**
- * @brief value from operand stack popping function
+ * @brief decoded instructions threading function (writes interpreter handler addresses to instructions)
  * 
- * @param[in,out] self virtual machine to perform action in
- * @param[out]    dst  popping destination destination (non-null, 4 bytes writable)
+ * @param[in,out] code           instructions to thread (non-null)
+ * @param[in]     codeLength     instruction count
+ * @param[in]     isCodeVerified true if code is verified (so handlers of check-free interpreter are used)
  */
-void cfVmPopOperand( CfVm *const self, void *const dst );
+void cfVmThreadCode( CfVmInstruction *const code, const size_t codeLength, const bool isCodeVerified );
+#endif
 
+#ifdef CF_VM_JIT
 /**
- * @brief jumping to certain point function
+ * @brief VM code into native x86-64 code compilation function
+ * 
+ * @param[in,out] self VM to compile code of (code is already decoded, verified and ram/stacks are allocated)
  * 
- * @param[in,out] self  virtual machine perform operation in
- * @param[in]     point point to jump to
+ * @return true if compiled (nativeCode is set then), false if compilation failed (interpreter should be used)
+ * 
+ * @note verified code is compiled check-free (in the same way as it's interpreted), other code
+ * is compiled with runtime operand/call stack checks, so behavior of compiled code is the same as
+ * behavior of interpreter in any case.
  */
-void cfVmJump( CfVm *const self, const uint32_t point );
+bool cfVmJitCompile( CfVm *const self );
 
 /**
- * @brief generic conditional jump instruction implementation
+ * @brief JIT-compiled code execution starting function
+ * 
+ * @param[in,out] self VM with compiled code (nativeCode is non-null)
  * 
- * @param[in,out] self      vm to perform action in
- * @param[in]     condition condition to 
+ * @note this function never returns, execution is finished by cfVmTerminate call (as interpreter's one)
  */
-void cfVmGenericConditionalJump( CfVm *const self, const bool condition );
+void cfVmJitRun( CfVm *const self );
 
 /**
- * @brief instruction counter to call stack pushing function
+ * @brief JIT-compiled code releasing function
  * 
- * @param[in,out] self virtual machine to perform operation in
+ * @param[in,out] self VM to release native code of (nativeCode may be null)
+ */
+void cfVmJitRelease( CfVm *const self );
+#endif
+
+/**
+ * @brief verified code into register-based code translation starting function
+ *
+ * @param[in,out] self VM to translate code of (code is already decoded and verified)
+ *
+ * @return true if translation is set up (translation is set then), false if allocation failed
+ *
+ * @note only entry block is translated here, other blocks are translated on their first entry
+ * and cached by index of their first instruction.
+ */
+bool cfVmTranslationCreate( CfVm *const self );
+
+/**
+ * @brief translated code execution starting function
+ *
+ * @param[in,out] self VM with translated code (translation is non-null)
+ *
+ * @note this function never returns, execution is finished by cfVmTerminate call (as interpreter's one)
+ */
+void cfVmTranslationRun( CfVm *const self );
+
+/**
+ * @brief translated code releasing function
+ *
+ * @param[in,out] self VM to release translated code of (translation may be null)
+ */
+void cfVmTranslationRelease( CfVm *const self );
+
+/**
+ * @brief hot loop trace recording setup function
+ *
+ * @param[in,out] self VM to record traces of (code is already decoded and verified)
+ *
+ * @return true if trace cache is allocated (traces is set then), false otherwise
+ *
+ * @note traces are executed by check-free interpreter, so they're useless for other execution engines.
  */
-void cfVmPushIC( CfVm *const self );
+bool cfVmTraceCreate( CfVm *const self );
+
+/**
+ * @brief loop header entering function (called by check-free interpreter on taken backward jumps)
+ *
+ * @param[in,out] self   VM with trace cache (stack tops and instruction budget are saved in VM)
+ * @param[in]     header index of jump target
+ *
+ * @return instruction to continue execution from (trace start if loop trace is recorded)
+ *
+ * @note trace is recorded by execution of single loop iteration, so VM state (including
+ * stack tops and instruction budget) may be changed by this function.
+ */
+const CfVmInstruction * cfVmTraceEnter( CfVm *const self, const uint32_t header );
+
+/**
+ * @brief code instruction equivalent to (possibly trace) instruction getting function
+ *
+ * @param[in] self        VM to get instruction of
+ * @param[in] instruction code or trace instruction (instruction counter, actually)
+ *
+ * @return instruction of VM code execution may be continued from instead of the instruction
+ */
+const CfVmInstruction * cfVmTraceGetSource( const CfVm *const self, const CfVmInstruction *const instruction );
+
+/**
+ * @brief trace cache releasing function
+ *
+ * @param[in,out] self VM to release traces of (traces may be null)
+ */
+void cfVmTraceRelease( CfVm *const self );
+
+/**
+ * @brief profile clock reading function
+ *
+ * @return current time in profile clock units (CPU timestamp counter cycles if available, nanoseconds otherwise)
+ */
+uint64_t cfVmProfileClock( void );
+
+/**
+ * @brief execution profile into file writing function
+ *
+ * @param[in] self VM to write profile of (profile is non-null)
+ * @param[in] path profile file path (non-null)
+ *
+ * @return true if succeeded, false if file writing failed
+ *
+ * @note profile file format is described in cf_vm.h (near CF_VM_PROFILE_VERSION)
+ */
+bool cfVmProfileWrite( const CfVm *const self, const char *const path );
+
+/// @brief VM snapshot file header (file format is described in cf_vm.h near CF_VM_SNAPSHOT_VERSION)
+typedef struct CfVmSnapshotHeader_ {
+    char        magic[8];          ///< snapshot file magic (CF_VM_SNAPSHOT_MAGIC)
+    uint32_t    version;           ///< snapshot format version (CF_VM_SNAPSHOT_VERSION)
+    uint32_t    instructionOffset; ///< code offset of instruction to execute next
+    CfHash      codeHash;          ///< hash of executable code
+    uint64_t    ramOffset;         ///< RAM offset in snapshot file (RAM end offset is multiple of CF_VM_SNAPSHOT_RAM_ALIGNMENT)
+    uint64_t    ramSize;           ///< RAM size
+    uint64_t    operandStackSize;  ///< operand stack capacity
+    uint64_t    operandStackDepth; ///< count of operands on operand stack
+    uint64_t    callStackSize;     ///< call stack capacity
+    uint64_t    callStackDepth;    ///< count of return addresses on call stack
+    CfRegisters registers;         ///< register values
+} CfVmSnapshotHeader;
+
+/// @brief snapshot file magic
+#define CF_VM_SNAPSHOT_MAGIC "CFSNAP\0\0"
 
 /**
- * @brief instruction counter from call stack popping function
+ * @brief VM snapshot into file writing function
+ *
+ * @param[in] self VM to write snapshot of (stack tops and instruction counter are actual)
+ * @param[in] path snapshot file path (non-null)
+ *
+ * @return true if succeeded, false if file writing failed
+ */
+bool cfVmSnapshotWrite( const CfVm *const self, const char *const path );
+
+/**
+ * @brief VM snapshot header reading function
+ *
+ * @param[in]  file       snapshot file (non-null)
+ * @param[in]  executable executable VM is started with (non-null)
+ * @param[out] dst        header destination (non-null)
+ *
+ * @return true if header is read and snapshot is written by executable, false otherwise
+ */
+bool cfVmSnapshotReadHeader( FILE *const file, const CfExecutable *const executable, CfVmSnapshotHeader *const dst );
+
+/**
+ * @brief VM RAM from snapshot loading function
+ *
+ * @param[in,out] self   VM to load RAM of (ramSize is set by header)
+ * @param[in]     file   snapshot file (non-null)
+ * @param[in]     header snapshot header (non-null)
+ *
+ * @return true if succeeded, false otherwise
+ *
+ * @note RAM is privately mapped if host supports it, read into allocated memory otherwise.
+ */
+bool cfVmSnapshotLoadRam( CfVm *const self, FILE *const file, const CfVmSnapshotHeader *const header );
+
+/**
+ * @brief VM stacks and registers from snapshot restoring function
+ *
+ * @param[in,out] self   VM to restore state of (code is set up, stacks are allocated by header sizes)
+ * @param[in]     file   snapshot file (non-null)
+ * @param[in]     header snapshot header (non-null)
+ *
+ * @return true if succeeded, false if snapshot is invalid
+ */
+bool cfVmSnapshotRestore( CfVm *const self, FILE *const file, const CfVmSnapshotHeader *const header );
+
+/**
+ * @brief zero-filled VM RAM allocation function
+ *
+ * @param[in,out] self    VM to allocate RAM of (ram, ramSize and mapping fields are set)
+ * @param[in]     ramSize RAM size
+ *
+ * @return true if succeeded, false otherwise
+ *
+ * @note if VM is built with guard pages, RAM is placed right before 4 GiB of inaccessible
+ * pages, so out-of-range accesses fault (and terminate VM) instead of being checked.
+ */
+bool cfVmAllocateRam( CfVm *const self, const size_t ramSize );
+
+/**
+ * @brief VM RAM from file region private mapping function
+ *
+ * @param[in,out] self    VM to map RAM of (ram, ramSize and mapping fields are set)
+ * @param[in]     ramSize RAM size
+ * @param[in]     file    file descriptor to map RAM from
+ * @param[in]     offset  RAM offset in file (file should contain ramSize bytes from it)
+ *
+ * @return true if succeeded, false if RAM can't be mapped (it should be allocated and read then)
+ *
+ * @note RAM end offset is required to be page aligned if VM is built with guard pages.
+ */
+bool cfVmMapRam( CfVm *const self, const size_t ramSize, const int file, const uint64_t offset );
+
+/**
+ * @brief executable RAM segments loading function
+ *
+ * @param[in,out] self VM to load segments of executable into RAM of (RAM is allocated and zero-filled)
+ *
+ * @return true if succeeded, false if some segment is out of RAM
+ */
+bool cfVmLoadSegments( CfVm *const self );
+
+/**
+ * @brief VM RAM releasing function
+ *
+ * @param[in,out] self VM to release RAM of (ram may be null)
+ */
+void cfVmReleaseRam( CfVm *const self );
+
+#ifdef CF_VM_GUARD_PAGES
+/**
+ * @brief current thread executed VM setting function
+ *
+ * @param[in] self VM code of which is executed by current thread (null if no code is executed)
+ *
+ * @note faults in RAM guard pages of this VM are turned into its termination.
+ */
+void cfVmRamSetCurrent( CfVm *const self );
+#endif
+
+/**
+ * @brief forked VM RAM setting up function
+ *
+ * @param[in,out] parent VM to fork RAM of (RAM copy is created if it's not actual)
+ * @param[in,out] child  forked VM (ramSize and ram are set)
+ *
+ * @return true if succeeded, false otherwise
+ *
+ * @note RAM copy is mapped privately by child if host supports it, just copied otherwise.
+ */
+bool cfVmForkRam( CfVm *const parent, CfVm *const child );
+
+/**
+ * @brief VM RAM copy releasing function (RAM copy becomes not actual after parent VM is resumed)
+ *
+ * @param[in,out] self VM to release RAM copy of (may have no RAM copy)
+ */
+void cfVmReleaseRamImage( CfVm *const self );
+
+/**
+ * @brief execution termination function
  * 
- * @param[in,out] self virtual machine to perform operation in
+ * @param[in,out] self   VM pointer
+ * @param[in]     reason termination reason
+ * 
+ * @note termination offset is taken from instruction before instructionCounter,
+ * so instructionCounter **must not** be modified by instruction before all its checks are performed.
  */
-void cfVmPopIC( CfVm *const self );
+void cfVmTerminate( CfVm *self, const CfTermReason reason );
 
 /**
- * @brief value to register writing function
+ * @brief jumping to certain point function
  * 
- * @param[in,out] self  virtual machine to perform operation in pointer
- * @param[in]     reg   register to write index
- * @param[in]     value value intended to write to register
+ * @param[in,out] self   virtual machine perform operation in
+ * @param[in]     target index of instruction to jump to (may be CF_VM_INVALID_TARGET)
  */
-void cfVmWriteRegister( CfVm *const self, const uint32_t reg, const uint32_t value );
+void cfVmJump( CfVm *const self, const uint32_t target );
+
+/**
+ * @brief instruction by code offset finding function
+ *
+ * @param[in] self   VM to find instruction in
+ * @param[in] offset code offset of instruction
+ *
+ * @return pointer to instruction (null if there's no instruction with such offset)
+ */
+const CfVmInstruction * cfVmFindInstruction( const CfVm *const self, const uint32_t offset );
 
 /**
  * @brief VM video mode setting function
@@ -124,14 +618,14 @@ void cfVmSetVideoMode(
 );
 
 /**
- * @brief value to register writing function
+ * @brief VM video mode from VSM instruction operand setting function
  * 
- * @param[in,out] self virtual machine to perform operation in
- * @param[in]     reg  index of register to read
+ * @param[in,out] self      VM pointer
+ * @param[in]     videoMode packed video mode (storage format in bits 0-2, update mode in bit 3)
  * 
- * @return value from register by **reg** index
+ * @note execution is terminated if video mode is invalid
  */
-uint32_t cfVmReadRegister( CfVm *const self, const uint32_t reg );
+void cfVmSetPackedVideoMode( CfVm *const self, const uint32_t videoMode );
 
 /**
  * @brief memory pointer getting function
@@ -143,13 +637,126 @@ uint32_t cfVmReadRegister( CfVm *const self, const uint32_t reg );
  */
 void * cfVmGetMemoryPointer( CfVm *const self, const uint32_t addr );
 
+/**
+ * @brief memory range pointer getting function
+ *
+ * @param[in,out] self VM pointer
+ * @param[in]     addr range start address
+ * @param[in]     size range size (in bytes)
+ *
+ * @return pointer to range start, always valid to read/write size bytes and non-null
+ * (execution is terminated if range doesn't fit into RAM)
+ *
+ * @note range is checked even if RAM is followed by guard pages.
+ */
+uint8_t * cfVmGetMemoryRangePointer( CfVm *const self, const uint32_t addr, const size_t size );
+
+/**
+ * @brief memory range copying function (MCPY instruction implementation)
+ *
+ * @param[in,out] self VM pointer
+ * @param[in]     dst  destination address
+ * @param[in]     src  source address
+ * @param[in]     size copied byte count
+ *
+ * @note ranges may overlap. execution is terminated if any of them doesn't fit into RAM.
+ */
+void cfVmMemoryCopy( CfVm *const self, const uint32_t dst, const uint32_t src, const uint32_t size );
+
+/**
+ * @brief memory range filling function (MSET instruction implementation)
+ *
+ * @param[in,out] self        VM pointer
+ * @param[in]     dst         destination address
+ * @param[in]     value       fill value (only low elementSize bytes are used)
+ * @param[in]     count       filled element count
+ * @param[in]     elementSize element size (1 or 4 bytes)
+ *
+ * @note execution is terminated if range doesn't fit into RAM.
+ */
+void cfVmMemoryFill(
+    CfVm     *const self,
+    const uint32_t  dst,
+    const uint32_t  value,
+    const uint32_t  count,
+    const uint32_t  elementSize
+);
+
+/**
+ * @brief lane-wise f32x4 square root calculation function
+ *
+ * @param[in] value vector to calculate square root of
+ *
+ * @return square roots of value lanes
+ */
+CfVmF32x4 cfVmF32x4Sqrt( const CfVmF32x4 value );
+
+/**
+ * @brief bulk number array reading function (implements CF_SYSTEM_CALL_READ_*_ARRAY system calls)
+ *
+ * @param[in,out] self       VM pointer
+ * @param[in]     systemCall system call (CF_SYSTEM_CALL_READ_F32_ARRAY or CF_SYSTEM_CALL_READ_I32_ARRAY)
+ * @param[in]     addr       array address
+ * @param[in]     count      array element count
+ *
+ * @return count of elements read
+ *
+ * @note execution is terminated if array doesn't fit into RAM.
+ */
+uint32_t cfVmReadArray( CfVm *const self, const CfSystemCall systemCall, const uint32_t addr, const uint32_t count );
+
+/**
+ * @brief bulk number array writing function (implements CF_SYSTEM_CALL_WRITE_*_ARRAY system calls)
+ *
+ * @param[in,out] self       VM pointer
+ * @param[in]     systemCall system call (CF_SYSTEM_CALL_WRITE_F32_ARRAY or CF_SYSTEM_CALL_WRITE_I32_ARRAY)
+ * @param[in]     addr       array address
+ * @param[in]     count      array element count
+ *
+ * @note execution is terminated if array doesn't fit into RAM or sandbox fails to write it.
+ */
+void cfVmWriteArray( CfVm *const self, const CfSystemCall systemCall, const uint32_t addr, const uint32_t count );
+
+/**
+ * @brief single rare instruction interpreting function (used by execution engines for instructions they don't implement)
+ *
+ * @param[in,out] self            VM pointer
+ * @param[in]     instruction     instruction to execute (any one except control transfers)
+ * @param[in]     operandStackTop operand stack top
+ *
+ * @return new operand stack top
+ *
+ * @note function is generated from the same interpreter body as cfVmInterpretChecked (see cf_vm_run.c),
+ * so operand stack is checked in the same way, instruction counter is set to instruction after executed one.
+ */
+uint32_t * cfVmInterpretInstruction(
+    CfVm                  *const self,
+    const CfVmInstruction *const instruction,
+    uint32_t                    *operandStackTop
+);
+
 /**
  * @brief VM execution starting function
  * 
  * @param[in] vm reference of VM to start execution in
+ * 
+ * @note profiling interpreter is used if profile is required, then JIT-compiled code is executed
+ * if it's present, then translated code, then check-free interpreter is used if VM code is verified
+ * @note interpreters return after instructionBudget instructions are executed (stack tops are saved
+ * then), JIT-compiled and translated code never returns.
  */
 void cfVmRun( CfVm *const self );
 
+/**
+ * @brief single straight-line block executing function (used by trace recorder)
+ *
+ * @param[in,out] self VM to execute block in (code is verified)
+ *
+ * @note instructions are executed by check-free interpreter until the first control transfer
+ * (which is executed too), instruction budget is decreased by count of executed instructions.
+ */
+void cfVmRunBlock( CfVm *const self );
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,1439 @@
+/**
+ * @brief VM x86-64 template JIT compiler implementation file
+ *
+ * @note each pre-decoded instruction is translated into fixed native code template.
+ * VM registers are pinned to host registers, operand stack top offset is tracked at
+ * compilation time (and written to host register at basic block boundaries only), jumps are
+ * resolved to native code labels. Rare instructions (sandbox calls, traps, sin/cos) are
+ * executed by single instruction interpreter function called from native code.
+ */
+
+#ifdef CF_VM_JIT
+
+#include <assert.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "cf_vm_internal.h"
+
+/// @brief x86-64 general-purpose register
+typedef enum CfVmJitRegister_ {
+    CF_VM_JIT_RAX = 0,
+    CF_VM_JIT_RCX = 1,
+    CF_VM_JIT_RDX = 2,
+    CF_VM_JIT_RBX = 3,
+    CF_VM_JIT_RSP = 4,
+    CF_VM_JIT_RBP = 5,
+    CF_VM_JIT_RSI = 6,
+    CF_VM_JIT_RDI = 7,
+    CF_VM_JIT_R8  = 8,
+    CF_VM_JIT_R9  = 9,
+    CF_VM_JIT_R10 = 10,
+    CF_VM_JIT_R11 = 11,
+    CF_VM_JIT_R12 = 12,
+    CF_VM_JIT_R13 = 13,
+    CF_VM_JIT_R14 = 14,
+    CF_VM_JIT_R15 = 15,
+
+    CF_VM_JIT_NO_INDEX = 0xFF, ///< memory operand index register absence marker
+} CfVmJitRegister;
+
+// host registers with fixed role in compiled code (all of them are callee-saved)
+#define CF_VM_JIT_SELF              CF_VM_JIT_RBX ///< VM pointer
+#define CF_VM_JIT_RAM               CF_VM_JIT_R12 ///< VM RAM pointer
+#define CF_VM_JIT_OPERAND_STACK_TOP CF_VM_JIT_R13 ///< operand stack top (up to pending offset)
+#define CF_VM_JIT_CALL_STACK_TOP    CF_VM_JIT_R14 ///< call stack top
+
+/// @brief VM register index -> host register table (cz and fl registers aren't pinned)
+static const uint8_t cfVmJitRegisterMap[CF_REGISTER_COUNT] = {
+    CF_VM_JIT_NO_INDEX, CF_VM_JIT_NO_INDEX,
+    CF_VM_JIT_R15, CF_VM_JIT_RBP, CF_VM_JIT_R8, CF_VM_JIT_R9, CF_VM_JIT_R10, CF_VM_JIT_R11,
+};
+
+/// @brief index of first VM register pinned to caller-saved host register (they're saved around calls)
+#define CF_VM_JIT_FIRST_CALLER_SAVED_REGISTER 4
+
+/// @brief x86-64 condition code
+typedef enum CfVmJitCondition_ {
+    CF_VM_JIT_CONDITION_B      = 0x2, ///< below
+    CF_VM_JIT_CONDITION_AE     = 0x3, ///< above or equal
+    CF_VM_JIT_CONDITION_E      = 0x4, ///< equal (zero)
+    CF_VM_JIT_CONDITION_NE     = 0x5, ///< not equal (not zero)
+    CF_VM_JIT_CONDITION_A      = 0x7, ///< above
+    CF_VM_JIT_CONDITION_NP     = 0xB, ///< not parity (ordered)
+    CF_VM_JIT_CONDITION_L      = 0xC, ///< less
+
+    CF_VM_JIT_CONDITION_ALWAYS = 0x10, ///< unconditional jump (pseudo-condition)
+} CfVmJitCondition;
+
+/// @brief flag register comparison bits (checked against CfRegisterFlags layout before compilation)
+#define CF_VM_JIT_FLAG_LT ((uint8_t)0x1)
+#define CF_VM_JIT_FLAG_EQ ((uint8_t)0x2)
+
+/// @brief operand stack element size
+#define CF_VM_JIT_OPERAND_SIZE ((int32_t)sizeof(uint32_t))
+
+/// @brief upper bound of native code size of single instruction (including its stubs)
+#define CF_VM_JIT_MAX_INSTRUCTION_SIZE ((size_t)256)
+
+/// @brief x86-64 instruction r/m operand
+typedef struct CfVmJitOperand_ {
+    bool    isMemory;     ///< true if operand is memory location, false if it's register
+    uint8_t base;         ///< register (or base register for memory operand)
+    uint8_t index;        ///< index register (CF_VM_JIT_NO_INDEX if there's no index)
+    uint8_t scale;        ///< index scale logarithm
+    int32_t displacement; ///< displacement
+} CfVmJitOperand;
+
+/// @brief out-of-line code kind
+typedef enum CfVmJitStubKind_ {
+    CF_VM_JIT_STUB_KIND_TERMINATE,          ///< execution termination with certain reason
+    CF_VM_JIT_STUB_KIND_SEGMENTATION_FAULT, ///< segmentation fault (address is stored in eax)
+} CfVmJitStubKind;
+
+/// @brief out-of-line (failed runtime check handling) code description
+typedef struct CfVmJitStub_ {
+    uint32_t                position;    ///< position of jump to stub displacement
+    CfVmJitStubKind         kind;        ///< stub kind
+    CfTermReason            reason;      ///< termination reason (for TERMINATE stubs)
+    const CfVmInstruction * instruction; ///< instruction check is performed by
+} CfVmJitStub;
+
+/// @brief jump to instruction label displacement patch
+typedef struct CfVmJitPatch_ {
+    uint32_t position; ///< displacement position
+    uint32_t target;   ///< target instruction index
+} CfVmJitPatch;
+
+/// @brief compiler state representation structure
+typedef struct CfVmJitCompiler_ {
+    CfVm     * vm;           ///< VM code is compiled for
+    bool       isChecked;    ///< true if runtime operand stack and call stack checks are required
+
+    uint8_t  * buffer;       ///< native code buffer
+    size_t     capacity;     ///< native code buffer capacity
+    size_t     length;       ///< native code length
+    bool       isOverflowed; ///< true if native code didn't fit into buffer
+
+    uint32_t * labels;       ///< instruction index -> native code offset
+    void    ** returnTable;  ///< instruction index -> native code address table (placed after code, used by ret)
+    bool     * isTarget;     ///< instruction index -> is jump/call/return target flag
+    CfDarr     patches;      ///< jump displacement patches
+    CfDarr     stubs;        ///< out-of-line code descriptions
+
+    int32_t    stackOffset;  ///< pending operand stack top offset (in bytes, relative to host register)
+    int32_t    checkedLow;   ///< lowest operand stack offset known to be valid
+    int32_t    checkedHigh;  ///< highest operand stack offset known to be valid
+} CfVmJitCompiler;
+
+/**
+ * @brief failed runtime check handling function (called from native code, never returns)
+ *
+ * @param[in,out] self        VM pointer
+ * @param[in]     reason      termination reason
+ * @param[in]     instruction instruction check failed in
+ */
+static void cfVmJitTerminate( CfVm *const self, const uint32_t reason, const CfVmInstruction *const instruction ) {
+    self->instructionCounter = instruction + 1;
+    cfVmTerminate(self, (CfTermReason)reason);
+} // cfVmJitTerminate
+
+/**
+ * @brief failed memory access check handling function (called from native code, never returns)
+ *
+ * @param[in,out] self        VM pointer
+ * @param[in]     addr        accessed address (out of RAM bounds)
+ * @param[in]     instruction instruction check failed in
+ */
+static void cfVmJitSegmentationFault( CfVm *const self, const uint32_t addr, const CfVmInstruction *const instruction ) {
+    self->instructionCounter = instruction + 1;
+
+    // address is out of bounds for all (1 to 16 byte) accesses, so execution is terminated here
+    cfVmGetMemoryRangePointer(self, addr, sizeof(CfVmF32x4));
+    cfVmTerminate(self, CF_TERM_REASON_INTERNAL_ERROR);
+} // cfVmJitSegmentationFault
+
+/**
+ * @brief byte emitting function
+ *
+ * @param[in,out] self compiler pointer
+ * @param[in]     byte byte to emit
+ */
+static void cfVmJitEmitByte( CfVmJitCompiler *const self, const uint8_t byte ) {
+    if (self->length == self->capacity) {
+        self->isOverflowed = true;
+        return;
+    }
+    self->buffer[self->length++] = byte;
+} // cfVmJitEmitByte
+
+/**
+ * @brief 32-bit integer emitting function
+ *
+ * @param[in,out] self  compiler pointer
+ * @param[in]     value value to emit
+ */
+static void cfVmJitEmitUint32( CfVmJitCompiler *const self, const uint32_t value ) {
+    for (uint32_t i = 0; i < 4; i++)
+        cfVmJitEmitByte(self, (uint8_t)(value >> (i * 8)));
+} // cfVmJitEmitUint32
+
+/**
+ * @brief 64-bit integer emitting function
+ *
+ * @param[in,out] self  compiler pointer
+ * @param[in]     value value to emit
+ */
+static void cfVmJitEmitUint64( CfVmJitCompiler *const self, const uint64_t value ) {
+    cfVmJitEmitUint32(self, (uint32_t)value);
+    cfVmJitEmitUint32(self, (uint32_t)(value >> 32));
+} // cfVmJitEmitUint64
+
+/**
+ * @brief register operand constructor
+ *
+ * @param[in] reg register
+ *
+ * @return operand
+ */
+static CfVmJitOperand cfVmJitRegisterOperand( const uint8_t reg ) {
+    return (CfVmJitOperand) {
+        .isMemory = false,
+        .base     = reg,
+        .index    = CF_VM_JIT_NO_INDEX,
+    };
+} // cfVmJitRegisterOperand
+
+/**
+ * @brief [base + displacement] memory operand constructor
+ *
+ * @param[in] base         base register
+ * @param[in] displacement displacement
+ *
+ * @return operand
+ */
+static CfVmJitOperand cfVmJitMemoryOperand( const uint8_t base, const int32_t displacement ) {
+    return (CfVmJitOperand) {
+        .isMemory     = true,
+        .base         = base,
+        .index        = CF_VM_JIT_NO_INDEX,
+        .scale        = 0,
+        .displacement = displacement,
+    };
+} // cfVmJitMemoryOperand
+
+/**
+ * @brief [base + index * (1 << scale)] memory operand constructor
+ *
+ * @param[in] base  base register
+ * @param[in] index index register (not rsp)
+ * @param[in] scale index scale logarithm
+ *
+ * @return operand
+ */
+static CfVmJitOperand cfVmJitIndexedOperand( const uint8_t base, const uint8_t index, const uint8_t scale ) {
+    return (CfVmJitOperand) {
+        .isMemory     = true,
+        .base         = base,
+        .index        = index,
+        .scale        = scale,
+        .displacement = 0,
+    };
+} // cfVmJitIndexedOperand
+
+/**
+ * @brief VM register memory location operand getting function
+ *
+ * @param[in] index VM register index
+ *
+ * @return operand
+ */
+static CfVmJitOperand cfVmJitVmRegisterOperand( const uint32_t index ) {
+    return cfVmJitMemoryOperand(
+        CF_VM_JIT_SELF,
+        (int32_t)(offsetof(CfVm, registers) + sizeof(uint32_t) * index)
+    );
+} // cfVmJitVmRegisterOperand
+
+/**
+ * @brief operand stack element operand getting function
+ *
+ * @param[in] self  compiler pointer
+ * @param[in] depth element depth (1 for stack top element, 0 for first free slot)
+ *
+ * @return operand
+ */
+static CfVmJitOperand cfVmJitStackOperand( const CfVmJitCompiler *const self, const int32_t depth ) {
+    return cfVmJitMemoryOperand(CF_VM_JIT_OPERAND_STACK_TOP, self->stackOffset - depth * CF_VM_JIT_OPERAND_SIZE);
+} // cfVmJitStackOperand
+
+/**
+ * @brief generic instruction (with ModRM operand) emitting function
+ *
+ * @param[in,out] self    compiler pointer
+ * @param[in]     prefix  mandatory prefix (0 if there's no prefix)
+ * @param[in]     isWide  true if instruction operates on 64-bit operands (REX.W is required)
+ * @param[in]     opcode  opcode (0x0Fxx for two-byte opcodes)
+ * @param[in]     reg     ModRM reg field (register or opcode extension)
+ * @param[in]     rm      ModRM r/m operand
+ */
+static void cfVmJitEmitInstruction(
+    CfVmJitCompiler *const self,
+    const uint8_t          prefix,
+    const bool             isWide,
+    const uint16_t         opcode,
+    const uint8_t          reg,
+    const CfVmJitOperand   rm
+) {
+    if (prefix != 0)
+        cfVmJitEmitByte(self, prefix);
+
+    const uint8_t index = rm.isMemory && rm.index != CF_VM_JIT_NO_INDEX ? rm.index : 0;
+    const uint8_t rex = 0x40
+        | ((uint8_t)isWide << 3)
+        | (((reg >> 3) & 1) << 2)
+        | (((index >> 3) & 1) << 1)
+        | ((rm.base >> 3) & 1);
+
+    if (rex != 0x40)
+        cfVmJitEmitByte(self, rex);
+
+    if (opcode > 0xFF)
+        cfVmJitEmitByte(self, (uint8_t)(opcode >> 8));
+    cfVmJitEmitByte(self, (uint8_t)opcode);
+
+    if (!rm.isMemory) {
+        cfVmJitEmitByte(self, 0xC0 | ((reg & 7) << 3) | (rm.base & 7));
+        return;
+    }
+
+    // rbp and r13 bases can't be encoded without displacement
+    const uint8_t mod = rm.displacement == 0 && (rm.base & 7) != 5
+        ? 0
+        : rm.displacement == (int8_t)rm.displacement ? 1 : 2;
+
+    if (rm.index == CF_VM_JIT_NO_INDEX && (rm.base & 7) != 4) {
+        cfVmJitEmitByte(self, (mod << 6) | ((reg & 7) << 3) | (rm.base & 7));
+    } else {
+        // rsp and r12 bases (and all indexed operands) require SIB byte
+        const uint8_t sibIndex = rm.index == CF_VM_JIT_NO_INDEX ? 4 : (rm.index & 7);
+
+        cfVmJitEmitByte(self, (mod << 6) | ((reg & 7) << 3) | 4);
+        cfVmJitEmitByte(self, (rm.scale << 6) | (sibIndex << 3) | (rm.base & 7));
+    }
+
+    if (mod == 1)
+        cfVmJitEmitByte(self, (uint8_t)rm.displacement);
+    else if (mod == 2)
+        cfVmJitEmitUint32(self, (uint32_t)rm.displacement);
+} // cfVmJitEmitInstruction
+
+/**
+ * @brief generic ALU instruction with immediate operand emitting function
+ *
+ * @param[in,out] self      compiler pointer
+ * @param[in]     isWide    true if instruction operates on 64-bit operand
+ * @param[in]     extension ALU operation (ModRM opcode extension: 0 - add, 4 - and, 5 - sub, 6 - xor, 7 - cmp)
+ * @param[in]     rm        destination operand
+ * @param[in]     immediate immediate value
+ */
+static void cfVmJitEmitAluImmediate(
+    CfVmJitCompiler *const self,
+    const bool             isWide,
+    const uint8_t          extension,
+    const CfVmJitOperand   rm,
+    const int32_t          immediate
+) {
+    if (immediate == (int8_t)immediate) {
+        cfVmJitEmitInstruction(self, 0, isWide, 0x83, extension, rm);
+        cfVmJitEmitByte(self, (uint8_t)immediate);
+    } else {
+        cfVmJitEmitInstruction(self, 0, isWide, 0x81, extension, rm);
+        cfVmJitEmitUint32(self, (uint32_t)immediate);
+    }
+} // cfVmJitEmitAluImmediate
+
+/**
+ * @brief 32-bit immediate into register moving instruction emitting function
+ *
+ * @param[in,out] self      compiler pointer
+ * @param[in]     reg       destination register
+ * @param[in]     immediate value to move
+ */
+static void cfVmJitEmitMoveImmediate32( CfVmJitCompiler *const self, const uint8_t reg, const uint32_t immediate ) {
+    if (reg >= 8)
+        cfVmJitEmitByte(self, 0x41);
+    cfVmJitEmitByte(self, 0xB8 + (reg & 7));
+    cfVmJitEmitUint32(self, immediate);
+} // cfVmJitEmitMoveImmediate32
+
+/**
+ * @brief 64-bit immediate into register moving instruction emitting function
+ *
+ * @param[in,out] self      compiler pointer
+ * @param[in]     reg       destination register
+ * @param[in]     immediate value to move
+ */
+static void cfVmJitEmitMoveImmediate64( CfVmJitCompiler *const self, const uint8_t reg, const uint64_t immediate ) {
+    cfVmJitEmitByte(self, 0x48 | (reg >= 8));
+    cfVmJitEmitByte(self, 0xB8 + (reg & 7));
+    cfVmJitEmitUint64(self, immediate);
+} // cfVmJitEmitMoveImmediate64
+
+/**
+ * @brief jump with 32-bit displacement emitting function
+ *
+ * @param[in,out] self      compiler pointer
+ * @param[in]     condition jump condition
+ *
+ * @return displacement position (displacement should be patched later)
+ */
+static uint32_t cfVmJitEmitJump( CfVmJitCompiler *const self, const CfVmJitCondition condition ) {
+    if (condition == CF_VM_JIT_CONDITION_ALWAYS) {
+        cfVmJitEmitByte(self, 0xE9);
+    } else {
+        cfVmJitEmitByte(self, 0x0F);
+        cfVmJitEmitByte(self, 0x80 | condition);
+    }
+
+    const uint32_t position = (uint32_t)self->length;
+    cfVmJitEmitUint32(self, 0);
+    return position;
+} // cfVmJitEmitJump
+
+/**
+ * @brief 32-bit displacement patching function
+ *
+ * @param[in,out] self     compiler pointer
+ * @param[in]     position displacement position
+ * @param[in]     target   target native code offset
+ */
+static void cfVmJitPatch( CfVmJitCompiler *const self, const uint32_t position, const size_t target ) {
+    const int32_t displacement = (int32_t)((int64_t)target - (int64_t)(position + 4));
+
+    if (!self->isOverflowed)
+        memcpy(self->buffer + position, &displacement, sizeof(displacement));
+} // cfVmJitPatch
+
+/**
+ * @brief jump to out-of-line code (that terminates execution) emitting function
+ *
+ * @param[in,out] self        compiler pointer
+ * @param[in]     condition   jump condition
+ * @param[in]     kind        stub kind
+ * @param[in]     reason      termination reason (for TERMINATE stubs)
+ * @param[in]     instruction instruction check is performed by
+ */
+static void cfVmJitEmitStubJump(
+    CfVmJitCompiler       *const self,
+    const CfVmJitCondition       condition,
+    const CfVmJitStubKind        kind,
+    const CfTermReason           reason,
+    const CfVmInstruction *const instruction
+) {
+    const CfVmJitStub stub = {
+        .position    = cfVmJitEmitJump(self, condition),
+        .kind        = kind,
+        .reason      = reason,
+        .instruction = instruction,
+    };
+
+    if (CF_DARR_OK != cfDarrPush(&self->stubs, &stub))
+        self->isOverflowed = true;
+} // cfVmJitEmitStubJump
+
+/**
+ * @brief jump to instruction emitting function
+ *
+ * @param[in,out] self        compiler pointer
+ * @param[in]     condition   jump condition
+ * @param[in]     instruction jump instruction (immediate is jump target)
+ */
+static void cfVmJitEmitJumpToInstruction(
+    CfVmJitCompiler       *const self,
+    const CfVmJitCondition       condition,
+    const CfVmInstruction *const instruction
+) {
+    // jump to invalid target terminates execution (as cfVmJump does)
+    if (instruction->immediate >= self->vm->codeLength) {
+        cfVmJitEmitStubJump(self, condition, CF_VM_JIT_STUB_KIND_TERMINATE, CF_TERM_REASON_INVALID_IC, instruction);
+        return;
+    }
+
+    const CfVmJitPatch patch = {
+        .position = cfVmJitEmitJump(self, condition),
+        .target   = instruction->immediate,
+    };
+
+    if (CF_DARR_OK != cfDarrPush(&self->patches, &patch))
+        self->isOverflowed = true;
+} // cfVmJitEmitJumpToInstruction
+
+/**
+ * @brief pending operand stack top offset writing function
+ *
+ * @param[in,out] self compiler pointer
+ */
+static void cfVmJitEmitFlush( CfVmJitCompiler *const self ) {
+    if (self->stackOffset == 0)
+        return;
+
+    // lea is used, because it doesn't modify flags
+    cfVmJitEmitInstruction(self, 0, true, 0x8D, CF_VM_JIT_OPERAND_STACK_TOP,
+        cfVmJitMemoryOperand(CF_VM_JIT_OPERAND_STACK_TOP, self->stackOffset));
+
+    self->checkedLow -= self->stackOffset;
+    self->checkedHigh -= self->stackOffset;
+    self->stackOffset = 0;
+} // cfVmJitEmitFlush
+
+/**
+ * @brief operand stack underflow check emitting function
+ *
+ * @param[in,out] self        compiler pointer
+ * @param[in]     count       count of operands instruction pops
+ * @param[in]     instruction checked instruction
+ */
+static void cfVmJitEmitCheckPop(
+    CfVmJitCompiler       *const self,
+    const int32_t                count,
+    const CfVmInstruction *const instruction
+) {
+    const int32_t offset = self->stackOffset - count * CF_VM_JIT_OPERAND_SIZE;
+
+    if (!self->isChecked || offset >= self->checkedLow)
+        return;
+
+    cfVmJitEmitInstruction(self, 0, true, 0x8D, CF_VM_JIT_RDI, cfVmJitMemoryOperand(CF_VM_JIT_OPERAND_STACK_TOP, offset));
+    cfVmJitEmitInstruction(self, 0, true, 0x3B, CF_VM_JIT_RDI,
+        cfVmJitMemoryOperand(CF_VM_JIT_SELF, (int32_t)offsetof(CfVm, operandStack)));
+    cfVmJitEmitStubJump(self, CF_VM_JIT_CONDITION_B, CF_VM_JIT_STUB_KIND_TERMINATE, CF_TERM_REASON_NO_OPERANDS, instruction);
+
+    self->checkedLow = offset;
+} // cfVmJitEmitCheckPop
+
+/**
+ * @brief operand stack overflow check emitting function
+ *
+ * @param[in,out] self        compiler pointer
+ * @param[in]     count       count of operands instruction pushes (after pops)
+ * @param[in]     instruction checked instruction
+ */
+static void cfVmJitEmitCheckPush(
+    CfVmJitCompiler       *const self,
+    const int32_t                count,
+    const CfVmInstruction *const instruction
+) {
+    const int32_t offset = self->stackOffset + count * CF_VM_JIT_OPERAND_SIZE;
+
+    if (!self->isChecked || offset <= self->checkedHigh)
+        return;
+
+    cfVmJitEmitInstruction(self, 0, true, 0x8D, CF_VM_JIT_RDI, cfVmJitMemoryOperand(CF_VM_JIT_OPERAND_STACK_TOP, offset));
+    cfVmJitEmitMoveImmediate64(self, CF_VM_JIT_RSI, (uint64_t)(uintptr_t)(self->vm->operandStack + self->vm->operandStackSize));
+    cfVmJitEmitInstruction(self, 0, true, 0x3B, CF_VM_JIT_RDI, cfVmJitRegisterOperand(CF_VM_JIT_RSI));
+    cfVmJitEmitStubJump(self, CF_VM_JIT_CONDITION_A, CF_VM_JIT_STUB_KIND_TERMINATE, CF_TERM_REASON_STACK_OVERFLOW, instruction);
+
+    self->checkedHigh = offset;
+} // cfVmJitEmitCheckPush
+
+/**
+ * @brief (VM register + immediate) value computing code emitting function
+ *
+ * @param[in,out] self      compiler pointer
+ * @param[in]     dst       destination host register
+ * @param[in]     index     VM register index
+ * @param[in]     immediate immediate to add
+ */
+static void cfVmJitEmitRegisterValue(
+    CfVmJitCompiler *const self,
+    const uint8_t          dst,
+    const uint8_t          index,
+    const uint32_t         immediate
+) {
+    if (index == 0) {
+        cfVmJitEmitMoveImmediate32(self, dst, immediate);
+    } else if (cfVmJitRegisterMap[index] == CF_VM_JIT_NO_INDEX) {
+        cfVmJitEmitInstruction(self, 0, false, 0x8B, dst, cfVmJitVmRegisterOperand(index));
+        if (immediate != 0)
+            cfVmJitEmitAluImmediate(self, false, 0, cfVmJitRegisterOperand(dst), (int32_t)immediate);
+    } else {
+        // 32-bit lea truncates sum, so it's computed in the same way as in interpreter
+        cfVmJitEmitInstruction(self, 0, false, 0x8D, dst,
+            cfVmJitMemoryOperand(cfVmJitRegisterMap[index], (int32_t)immediate));
+    }
+} // cfVmJitEmitRegisterValue
+
+/**
+ * @brief (base VM register + (index VM register << scale) + immediate) value computing code emitting function
+ *
+ * @param[in,out] self        compiler pointer
+ * @param[in]     instruction indexed push/pop instruction to compute value of
+ *
+ * @note value is stored in rax, rsi is clobbered.
+ */
+static void cfVmJitEmitIndexedValue( CfVmJitCompiler *const self, const CfVmInstruction *const instruction ) {
+    uint8_t index = cfVmJitRegisterMap[instruction->index.registerIndex];
+
+    cfVmJitEmitRegisterValue(self, CF_VM_JIT_RAX, instruction->registerIndex, instruction->immediate);
+
+    if (instruction->index.registerIndex == 0 || index == CF_VM_JIT_NO_INDEX) {
+        cfVmJitEmitRegisterValue(self, CF_VM_JIT_RSI, instruction->index.registerIndex, 0);
+        index = CF_VM_JIT_RSI;
+    }
+
+    cfVmJitEmitInstruction(self, 0, false, 0x8D, CF_VM_JIT_RAX,
+        cfVmJitIndexedOperand(CF_VM_JIT_RAX, index, instruction->index.scaleShift));
+} // cfVmJitEmitIndexedValue
+
+/**
+ * @brief RAM access address (stored in rax) checking code emitting function
+ *
+ * @param[in,out] self        compiler pointer
+ * @param[in]     size        accessed memory size (in bytes)
+ * @param[in]     instruction instruction memory is accessed by
+ *
+ * @return accessed memory location operand
+ */
+static CfVmJitOperand cfVmJitEmitAddressCheck(
+    CfVmJitCompiler       *const self,
+    const size_t                 size,
+    const CfVmInstruction *const instruction
+) {
+    const size_t ramSize = self->vm->ramSize;
+
+    // 32-bit operations zero upper half of rax, so whole rax is compared
+    if (ramSize < size) {
+        cfVmJitEmitStubJump(self, CF_VM_JIT_CONDITION_ALWAYS, CF_VM_JIT_STUB_KIND_SEGMENTATION_FAULT,
+            CF_TERM_REASON_SEGMENTATION_FAULT, instruction);
+    } else {
+        const uint64_t lastAddress = ramSize - size;
+
+        if (lastAddress <= INT32_MAX) {
+            cfVmJitEmitAluImmediate(self, true, 7, cfVmJitRegisterOperand(CF_VM_JIT_RAX), (int32_t)lastAddress);
+        } else {
+            cfVmJitEmitMoveImmediate64(self, CF_VM_JIT_RDI, lastAddress);
+            cfVmJitEmitInstruction(self, 0, true, 0x3B, CF_VM_JIT_RAX, cfVmJitRegisterOperand(CF_VM_JIT_RDI));
+        }
+        cfVmJitEmitStubJump(self, CF_VM_JIT_CONDITION_A, CF_VM_JIT_STUB_KIND_SEGMENTATION_FAULT,
+            CF_TERM_REASON_SEGMENTATION_FAULT, instruction);
+    }
+
+    return cfVmJitIndexedOperand(CF_VM_JIT_RAM, CF_VM_JIT_RAX, 0);
+} // cfVmJitEmitAddressCheck
+
+/**
+ * @brief checked RAM access address computing code emitting function
+ *
+ * @param[in,out] self        compiler pointer
+ * @param[in]     index       address VM register index
+ * @param[in]     immediate   address immediate
+ * @param[in]     size        accessed memory size (in bytes)
+ * @param[in]     instruction instruction memory is accessed by
+ *
+ * @return accessed memory location operand (address is stored in rax)
+ */
+static CfVmJitOperand cfVmJitEmitAddress(
+    CfVmJitCompiler       *const self,
+    const uint8_t                index,
+    const uint32_t               immediate,
+    const size_t                 size,
+    const CfVmInstruction *const instruction
+) {
+    cfVmJitEmitRegisterValue(self, CF_VM_JIT_RAX, index, immediate);
+    return cfVmJitEmitAddressCheck(self, size, instruction);
+} // cfVmJitEmitAddress
+
+/**
+ * @brief comparison of two top operands emitting function (operands aren't popped)
+ *
+ * @param[in,out] self    compiler pointer
+ * @param[in]     isFloat true if operands are floating-point numbers
+ * @param[in]     isLt    condition code used to get integer less-than result
+ *
+ * @note flag register comparison bits are updated, (lhs < rhs) is stored in ecx and (lhs == rhs) in edx.
+ */
+static void cfVmJitEmitComparison(
+    CfVmJitCompiler *const self,
+    const bool             isFloat,
+    const CfVmJitCondition isLt
+) {
+    if (isFloat) {
+        // rhs is compared with lhs, so unordered comparison gives false for both less and equal
+        cfVmJitEmitInstruction(self, 0xF3, false, 0x0F10, 0, cfVmJitStackOperand(self, 1));
+        cfVmJitEmitInstruction(self, 0, false, 0x0F2E, 0, cfVmJitStackOperand(self, 2));
+        cfVmJitEmitInstruction(self, 0, false, 0x0F90 | CF_VM_JIT_CONDITION_A, 0, cfVmJitRegisterOperand(CF_VM_JIT_RCX));
+        cfVmJitEmitInstruction(self, 0, false, 0x0F90 | CF_VM_JIT_CONDITION_E, 0, cfVmJitRegisterOperand(CF_VM_JIT_RDX));
+        cfVmJitEmitInstruction(self, 0, false, 0x0F90 | CF_VM_JIT_CONDITION_NP, 0, cfVmJitRegisterOperand(CF_VM_JIT_RAX));
+        cfVmJitEmitInstruction(self, 0, false, 0x20, CF_VM_JIT_RAX, cfVmJitRegisterOperand(CF_VM_JIT_RDX));
+    } else {
+        cfVmJitEmitInstruction(self, 0, false, 0x8B, CF_VM_JIT_RAX, cfVmJitStackOperand(self, 2));
+        cfVmJitEmitInstruction(self, 0, false, 0x3B, CF_VM_JIT_RAX, cfVmJitStackOperand(self, 1));
+        cfVmJitEmitInstruction(self, 0, false, 0x0F90 | isLt, 0, cfVmJitRegisterOperand(CF_VM_JIT_RCX));
+        cfVmJitEmitInstruction(self, 0, false, 0x0F90 | CF_VM_JIT_CONDITION_E, 0, cfVmJitRegisterOperand(CF_VM_JIT_RDX));
+    }
+
+    cfVmJitEmitInstruction(self, 0, false, 0x0FB6, CF_VM_JIT_RCX, cfVmJitRegisterOperand(CF_VM_JIT_RCX));
+    cfVmJitEmitInstruction(self, 0, false, 0x0FB6, CF_VM_JIT_RDX, cfVmJitRegisterOperand(CF_VM_JIT_RDX));
+
+    // fl = (fl & ~(LT | EQ)) | isLt | isEq << 1
+    cfVmJitEmitInstruction(self, 0, false, 0x8D, CF_VM_JIT_RAX, (CfVmJitOperand) {
+        .isMemory     = true,
+        .base         = CF_VM_JIT_RCX,
+        .index        = CF_VM_JIT_RDX,
+        .scale        = 1,
+        .displacement = 0,
+    });
+    cfVmJitEmitInstruction(self, 0, false, 0x80, 4, cfVmJitVmRegisterOperand(1));
+    cfVmJitEmitByte(self, (uint8_t)~(CF_VM_JIT_FLAG_LT | CF_VM_JIT_FLAG_EQ));
+    cfVmJitEmitInstruction(self, 0, false, 0x08, CF_VM_JIT_RAX, cfVmJitVmRegisterOperand(1));
+} // cfVmJitEmitComparison
+
+/**
+ * @brief single instruction interpreter call emitting function
+ *
+ * @param[in,out] self        compiler pointer
+ * @param[in]     instruction instruction to interpret
+ */
+static void cfVmJitEmitInterpreterCall( CfVmJitCompiler *const self, const CfVmInstruction *const instruction ) {
+    cfVmJitEmitFlush(self);
+
+    for (uint32_t i = CF_VM_JIT_FIRST_CALLER_SAVED_REGISTER; i < CF_REGISTER_COUNT; i++)
+        cfVmJitEmitInstruction(self, 0, false, 0x89, cfVmJitRegisterMap[i], cfVmJitVmRegisterOperand(i));
+
+    cfVmJitEmitInstruction(self, 0, true, 0x89, CF_VM_JIT_SELF, cfVmJitRegisterOperand(CF_VM_JIT_RDI));
+    cfVmJitEmitMoveImmediate64(self, CF_VM_JIT_RSI, (uint64_t)(uintptr_t)instruction);
+    cfVmJitEmitInstruction(self, 0, true, 0x89, CF_VM_JIT_OPERAND_STACK_TOP, cfVmJitRegisterOperand(CF_VM_JIT_RDX));
+    cfVmJitEmitMoveImmediate64(self, CF_VM_JIT_RAX, (uint64_t)(uintptr_t)&cfVmInterpretInstruction);
+    cfVmJitEmitInstruction(self, 0, false, 0xFF, 2, cfVmJitRegisterOperand(CF_VM_JIT_RAX));
+    cfVmJitEmitInstruction(self, 0, true, 0x89, CF_VM_JIT_RAX, cfVmJitRegisterOperand(CF_VM_JIT_OPERAND_STACK_TOP));
+
+    for (uint32_t i = CF_VM_JIT_FIRST_CALLER_SAVED_REGISTER; i < CF_REGISTER_COUNT; i++)
+        cfVmJitEmitInstruction(self, 0, false, 0x8B, cfVmJitRegisterMap[i], cfVmJitVmRegisterOperand(i));
+
+    // interpreter checks stack bounds by itself
+    self->checkedLow = 0;
+    self->checkedHigh = 0;
+} // cfVmJitEmitInterpreterCall
+
+/**
+ * @brief single instruction compilation function
+ *
+ * @param[in,out] self  compiler pointer
+ * @param[in]     index index of instruction to compile
+ */
+static void cfVmJitCompileInstruction( CfVmJitCompiler *const self, const uint32_t index ) {
+    const CfVmInstruction *const instruction = &self->vm->code[index];
+
+    switch (instruction->opcode) {
+    case CF_OPCODE_ADD:
+    case CF_OPCODE_SUB:
+    case CF_OPCODE_AND:
+    case CF_OPCODE_OR:
+    case CF_OPCODE_XOR: {
+        uint16_t opcode = 0;
+
+        switch (instruction->opcode) {
+        case CF_OPCODE_ADD : opcode = 0x01; break;
+        case CF_OPCODE_SUB : opcode = 0x29; break;
+        case CF_OPCODE_AND : opcode = 0x21; break;
+        case CF_OPCODE_OR  : opcode = 0x09; break;
+        case CF_OPCODE_XOR : opcode = 0x31; break;
+        }
+
+        cfVmJitEmitCheckPop(self, 2, instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0x8B, CF_VM_JIT_RAX, cfVmJitStackOperand(self, 1));
+        cfVmJitEmitInstruction(self, 0, false, opcode, CF_VM_JIT_RAX, cfVmJitStackOperand(self, 2));
+        self->stackOffset -= CF_VM_JIT_OPERAND_SIZE;
+        break;
+    }
+
+    case CF_OPCODE_SHL:
+    case CF_OPCODE_SHR:
+    case CF_OPCODE_SAR: {
+        const uint8_t extension = instruction->opcode == CF_OPCODE_SHL ? 4
+            : instruction->opcode == CF_OPCODE_SHR ? 5
+            : 7;
+
+        cfVmJitEmitCheckPop(self, 2, instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0x8B, CF_VM_JIT_RCX, cfVmJitStackOperand(self, 1));
+        cfVmJitEmitInstruction(self, 0, false, 0xD3, extension, cfVmJitStackOperand(self, 2));
+        self->stackOffset -= CF_VM_JIT_OPERAND_SIZE;
+        break;
+    }
+
+    case CF_OPCODE_IMUL:
+    case CF_OPCODE_MUL: {
+        // lower half of product doesn't depend on signedness
+        cfVmJitEmitCheckPop(self, 2, instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0x8B, CF_VM_JIT_RAX, cfVmJitStackOperand(self, 2));
+        cfVmJitEmitInstruction(self, 0, false, 0x0FAF, CF_VM_JIT_RAX, cfVmJitStackOperand(self, 1));
+        cfVmJitEmitInstruction(self, 0, false, 0x89, CF_VM_JIT_RAX, cfVmJitStackOperand(self, 2));
+        self->stackOffset -= CF_VM_JIT_OPERAND_SIZE;
+        break;
+    }
+
+    case CF_OPCODE_IDIV:
+    case CF_OPCODE_DIV: {
+        cfVmJitEmitCheckPop(self, 2, instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0x8B, CF_VM_JIT_RAX, cfVmJitStackOperand(self, 2));
+        if (instruction->opcode == CF_OPCODE_IDIV) {
+            // cdq
+            cfVmJitEmitByte(self, 0x99);
+            cfVmJitEmitInstruction(self, 0, false, 0xF7, 7, cfVmJitStackOperand(self, 1));
+        } else {
+            cfVmJitEmitInstruction(self, 0, false, 0x31, CF_VM_JIT_RDX, cfVmJitRegisterOperand(CF_VM_JIT_RDX));
+            cfVmJitEmitInstruction(self, 0, false, 0xF7, 6, cfVmJitStackOperand(self, 1));
+        }
+        cfVmJitEmitInstruction(self, 0, false, 0x89, CF_VM_JIT_RAX, cfVmJitStackOperand(self, 2));
+        self->stackOffset -= CF_VM_JIT_OPERAND_SIZE;
+        break;
+    }
+
+    case CF_OPCODE_FADD:
+    case CF_OPCODE_FSUB:
+    case CF_OPCODE_FMUL:
+    case CF_OPCODE_FDIV: {
+        uint16_t opcode = 0;
+
+        switch (instruction->opcode) {
+        case CF_OPCODE_FADD : opcode = 0x0F58; break;
+        case CF_OPCODE_FSUB : opcode = 0x0F5C; break;
+        case CF_OPCODE_FMUL : opcode = 0x0F59; break;
+        case CF_OPCODE_FDIV : opcode = 0x0F5E; break;
+        }
+
+        cfVmJitEmitCheckPop(self, 2, instruction);
+        cfVmJitEmitInstruction(self, 0xF3, false, 0x0F10, 0, cfVmJitStackOperand(self, 2));
+        cfVmJitEmitInstruction(self, 0xF3, false, opcode, 0, cfVmJitStackOperand(self, 1));
+        cfVmJitEmitInstruction(self, 0xF3, false, 0x0F11, 0, cfVmJitStackOperand(self, 2));
+        self->stackOffset -= CF_VM_JIT_OPERAND_SIZE;
+        break;
+    }
+
+    case CF_OPCODE_CMP:
+    case CF_OPCODE_ICMP:
+    case CF_OPCODE_FCMP: {
+        cfVmJitEmitCheckPop(self, 2, instruction);
+        cfVmJitEmitComparison(
+            self,
+            instruction->opcode == CF_OPCODE_FCMP,
+            instruction->opcode == CF_OPCODE_ICMP ? CF_VM_JIT_CONDITION_L : CF_VM_JIT_CONDITION_B
+        );
+        self->stackOffset -= 2 * CF_VM_JIT_OPERAND_SIZE;
+        break;
+    }
+
+    case CF_OPCODE_CSET:
+    case CF_OPCODE_ICSET:
+    case CF_OPCODE_FCSET: {
+        cfVmJitEmitCheckPop(self, 2, instruction);
+        cfVmJitEmitComparison(
+            self,
+            instruction->opcode == CF_OPCODE_FCSET,
+            instruction->opcode == CF_OPCODE_ICSET ? CF_VM_JIT_CONDITION_L : CF_VM_JIT_CONDITION_B
+        );
+
+        // result = (mask >> (isLt * 2 + isEq)) & 1
+        cfVmJitEmitInstruction(self, 0, false, 0x8D, CF_VM_JIT_RCX, (CfVmJitOperand) {
+            .isMemory     = true,
+            .base         = CF_VM_JIT_RDX,
+            .index        = CF_VM_JIT_RCX,
+            .scale        = 1,
+            .displacement = 0,
+        });
+        cfVmJitEmitMoveImmediate32(self, CF_VM_JIT_RAX, instruction->immediate);
+        cfVmJitEmitInstruction(self, 0, false, 0xD3, 5, cfVmJitRegisterOperand(CF_VM_JIT_RAX));
+        cfVmJitEmitAluImmediate(self, false, 4, cfVmJitRegisterOperand(CF_VM_JIT_RAX), 1);
+        cfVmJitEmitInstruction(self, 0, false, 0x89, CF_VM_JIT_RAX, cfVmJitStackOperand(self, 2));
+        self->stackOffset -= CF_VM_JIT_OPERAND_SIZE;
+        break;
+    }
+
+    case CF_OPCODE_FTOI: {
+        cfVmJitEmitCheckPop(self, 1, instruction);
+        cfVmJitEmitInstruction(self, 0xF3, false, 0x0F2C, CF_VM_JIT_RAX, cfVmJitStackOperand(self, 1));
+        cfVmJitEmitInstruction(self, 0, false, 0x89, CF_VM_JIT_RAX, cfVmJitStackOperand(self, 1));
+        break;
+    }
+
+    case CF_OPCODE_ITOF: {
+        // xorps breaks dependency on previous xmm0 value
+        cfVmJitEmitCheckPop(self, 1, instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0x0F57, 0, cfVmJitRegisterOperand(0));
+        cfVmJitEmitInstruction(self, 0xF3, false, 0x0F2A, 0, cfVmJitStackOperand(self, 1));
+        cfVmJitEmitInstruction(self, 0xF3, false, 0x0F11, 0, cfVmJitStackOperand(self, 1));
+        break;
+    }
+
+    case CF_OPCODE_FNEG: {
+        cfVmJitEmitCheckPop(self, 1, instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0x81, 6, cfVmJitStackOperand(self, 1));
+        cfVmJitEmitUint32(self, 0x80000000);
+        break;
+    }
+
+    case CF_OPCODE_FSQRT: {
+        cfVmJitEmitCheckPop(self, 1, instruction);
+        cfVmJitEmitInstruction(self, 0xF3, false, 0x0F51, 0, cfVmJitStackOperand(self, 1));
+        cfVmJitEmitInstruction(self, 0xF3, false, 0x0F11, 0, cfVmJitStackOperand(self, 1));
+        break;
+    }
+
+    case CF_OPCODE_MGS: {
+        cfVmJitEmitCheckPush(self, 1, instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0xC7, 0, cfVmJitStackOperand(self, 0));
+        cfVmJitEmitUint32(self, (uint32_t)self->vm->ramSize);
+        self->stackOffset += CF_VM_JIT_OPERAND_SIZE;
+        break;
+    }
+
+    case CF_OPCODE_JMP: {
+        cfVmJitEmitFlush(self);
+        cfVmJitEmitJumpToInstruction(self, CF_VM_JIT_CONDITION_ALWAYS, instruction);
+        break;
+    }
+
+    case CF_OPCODE_JLE:
+    case CF_OPCODE_JL:
+    case CF_OPCODE_JGE:
+    case CF_OPCODE_JG:
+    case CF_OPCODE_JE:
+    case CF_OPCODE_JNE: {
+        uint8_t mask = 0;
+        CfVmJitCondition condition = CF_VM_JIT_CONDITION_NE;
+
+        switch (instruction->opcode) {
+        case CF_OPCODE_JLE : mask = CF_VM_JIT_FLAG_LT | CF_VM_JIT_FLAG_EQ; condition = CF_VM_JIT_CONDITION_NE; break;
+        case CF_OPCODE_JL  : mask = CF_VM_JIT_FLAG_LT;                     condition = CF_VM_JIT_CONDITION_NE; break;
+        case CF_OPCODE_JGE : mask = CF_VM_JIT_FLAG_LT;                     condition = CF_VM_JIT_CONDITION_E;  break;
+        case CF_OPCODE_JG  : mask = CF_VM_JIT_FLAG_LT | CF_VM_JIT_FLAG_EQ; condition = CF_VM_JIT_CONDITION_E;  break;
+        case CF_OPCODE_JE  : mask = CF_VM_JIT_FLAG_EQ;                     condition = CF_VM_JIT_CONDITION_NE; break;
+        case CF_OPCODE_JNE : mask = CF_VM_JIT_FLAG_EQ;                     condition = CF_VM_JIT_CONDITION_E;  break;
+        }
+
+        cfVmJitEmitFlush(self);
+        cfVmJitEmitInstruction(self, 0, false, 0xF6, 0, cfVmJitVmRegisterOperand(1));
+        cfVmJitEmitByte(self, mask);
+        cfVmJitEmitJumpToInstruction(self, condition, instruction);
+        break;
+    }
+
+    case CF_OPCODE_JZ:
+    case CF_OPCODE_JNZ: {
+        cfVmJitEmitCheckPop(self, 1, instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0x8B, CF_VM_JIT_RAX, cfVmJitStackOperand(self, 1));
+        self->stackOffset -= CF_VM_JIT_OPERAND_SIZE;
+        cfVmJitEmitFlush(self);
+        cfVmJitEmitInstruction(self, 0, false, 0x85, CF_VM_JIT_RAX, cfVmJitRegisterOperand(CF_VM_JIT_RAX));
+        cfVmJitEmitJumpToInstruction(
+            self,
+            instruction->opcode == CF_OPCODE_JZ ? CF_VM_JIT_CONDITION_E : CF_VM_JIT_CONDITION_NE,
+            instruction
+        );
+        break;
+    }
+
+    case CF_OPCODE_CALL: {
+        const CfVm *const vm = self->vm;
+
+        cfVmJitEmitFlush(self);
+
+        cfVmJitEmitMoveImmediate64(self, CF_VM_JIT_RAX, (uint64_t)(uintptr_t)(vm->callStack + vm->callStackSize));
+        cfVmJitEmitInstruction(self, 0, true, 0x3B, CF_VM_JIT_CALL_STACK_TOP, cfVmJitRegisterOperand(CF_VM_JIT_RAX));
+        cfVmJitEmitStubJump(self, CF_VM_JIT_CONDITION_AE, CF_VM_JIT_STUB_KIND_TERMINATE,
+            CF_TERM_REASON_CALL_STACK_OVERFLOW, instruction);
+
+        if (instruction->immediate >= vm->codeLength) {
+            cfVmJitEmitJumpToInstruction(self, CF_VM_JIT_CONDITION_ALWAYS, instruction);
+            break;
+        }
+
+        // function entry holds maximal operand stack depth of whole function
+        if (!self->isChecked) {
+            cfVmJitEmitInstruction(self, 0, true, 0x8D, CF_VM_JIT_RAX, cfVmJitMemoryOperand(
+                CF_VM_JIT_OPERAND_STACK_TOP,
+                vm->code[instruction->immediate].maxStackDepth * CF_VM_JIT_OPERAND_SIZE
+            ));
+            cfVmJitEmitMoveImmediate64(self, CF_VM_JIT_RDX, (uint64_t)(uintptr_t)(vm->operandStack + vm->operandStackSize));
+            cfVmJitEmitInstruction(self, 0, true, 0x3B, CF_VM_JIT_RAX, cfVmJitRegisterOperand(CF_VM_JIT_RDX));
+            cfVmJitEmitStubJump(self, CF_VM_JIT_CONDITION_A, CF_VM_JIT_STUB_KIND_TERMINATE,
+                CF_TERM_REASON_STACK_OVERFLOW, instruction);
+        }
+
+        // return instruction index is stored (as interpreter does), it's mapped to native code by return table
+        cfVmJitEmitInstruction(self, 0, false, 0xC7, 0, cfVmJitMemoryOperand(CF_VM_JIT_CALL_STACK_TOP, 0));
+        cfVmJitEmitUint32(self, index + 1);
+        cfVmJitEmitAluImmediate(self, true, 0, cfVmJitRegisterOperand(CF_VM_JIT_CALL_STACK_TOP), sizeof(uint32_t));
+        cfVmJitEmitJumpToInstruction(self, CF_VM_JIT_CONDITION_ALWAYS, instruction);
+        break;
+    }
+
+    case CF_OPCODE_RET: {
+        if (self->isChecked) {
+            cfVmJitEmitInstruction(self, 0, true, 0x3B, CF_VM_JIT_CALL_STACK_TOP,
+                cfVmJitMemoryOperand(CF_VM_JIT_SELF, (int32_t)offsetof(CfVm, callStack)));
+            cfVmJitEmitStubJump(self, CF_VM_JIT_CONDITION_E, CF_VM_JIT_STUB_KIND_TERMINATE,
+                CF_TERM_REASON_CALL_STACK_UNDERFLOW, instruction);
+        }
+
+        cfVmJitEmitFlush(self);
+        cfVmJitEmitAluImmediate(self, true, 5, cfVmJitRegisterOperand(CF_VM_JIT_CALL_STACK_TOP), sizeof(uint32_t));
+        cfVmJitEmitInstruction(self, 0, false, 0x8B, CF_VM_JIT_RAX, cfVmJitMemoryOperand(CF_VM_JIT_CALL_STACK_TOP, 0));
+        cfVmJitEmitMoveImmediate64(self, CF_VM_JIT_RDX, (uint64_t)(uintptr_t)self->returnTable);
+        cfVmJitEmitInstruction(self, 0, false, 0xFF, 4, cfVmJitIndexedOperand(CF_VM_JIT_RDX, CF_VM_JIT_RAX, 3));
+        break;
+    }
+
+    case CF_VM_OPCODE_PUSH_VALUE: {
+        cfVmJitEmitCheckPush(self, 1, instruction);
+
+        if (instruction->registerIndex == 0) {
+            cfVmJitEmitInstruction(self, 0, false, 0xC7, 0, cfVmJitStackOperand(self, 0));
+            cfVmJitEmitUint32(self, instruction->immediate);
+        } else {
+            cfVmJitEmitRegisterValue(self, CF_VM_JIT_RAX, instruction->registerIndex, instruction->immediate);
+            cfVmJitEmitInstruction(self, 0, false, 0x89, CF_VM_JIT_RAX, cfVmJitStackOperand(self, 0));
+        }
+        self->stackOffset += CF_VM_JIT_OPERAND_SIZE;
+        break;
+    }
+
+    case CF_VM_OPCODE_PUSH_MEMORY: {
+        const CfVmJitOperand memory = cfVmJitEmitAddress(self, instruction->registerIndex, instruction->immediate,
+            sizeof(uint32_t), instruction);
+
+        cfVmJitEmitInstruction(self, 0, false, 0x8B, CF_VM_JIT_RCX, memory);
+        cfVmJitEmitCheckPush(self, 1, instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0x89, CF_VM_JIT_RCX, cfVmJitStackOperand(self, 0));
+        self->stackOffset += CF_VM_JIT_OPERAND_SIZE;
+        break;
+    }
+
+    case CF_VM_OPCODE_POP_REGISTER: {
+        cfVmJitEmitCheckPop(self, 1, instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0x8B, cfVmJitRegisterMap[instruction->registerIndex],
+            cfVmJitStackOperand(self, 1));
+        self->stackOffset -= CF_VM_JIT_OPERAND_SIZE;
+        break;
+    }
+
+    case CF_VM_OPCODE_POP_DISCARD: {
+        cfVmJitEmitCheckPop(self, 1, instruction);
+        self->stackOffset -= CF_VM_JIT_OPERAND_SIZE;
+        break;
+    }
+
+    case CF_VM_OPCODE_POP_MEMORY: {
+        cfVmJitEmitCheckPop(self, 1, instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0x8B, CF_VM_JIT_RCX, cfVmJitStackOperand(self, 1));
+        self->stackOffset -= CF_VM_JIT_OPERAND_SIZE;
+
+        const CfVmJitOperand memory = cfVmJitEmitAddress(self, instruction->registerIndex, instruction->immediate,
+            sizeof(uint32_t), instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0x89, CF_VM_JIT_RCX, memory);
+        break;
+    }
+
+    case CF_VM_OPCODE_PUSH_VALUE_INDEXED: {
+        cfVmJitEmitCheckPush(self, 1, instruction);
+        cfVmJitEmitIndexedValue(self, instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0x89, CF_VM_JIT_RAX, cfVmJitStackOperand(self, 0));
+        self->stackOffset += CF_VM_JIT_OPERAND_SIZE;
+        break;
+    }
+
+    // sub-word values are zero-extended by movzx
+    case CF_VM_OPCODE_PUSH_MEMORY_INDEXED:
+    case CF_VM_OPCODE_PUSH_MEMORY_U8:
+    case CF_VM_OPCODE_PUSH_MEMORY_U16: {
+        size_t size = sizeof(uint32_t);
+        uint16_t opcode = 0x8B;
+
+        if (instruction->opcode == CF_VM_OPCODE_PUSH_MEMORY_U8) {
+            size = sizeof(uint8_t);
+            opcode = 0x0FB6;
+        } else if (instruction->opcode == CF_VM_OPCODE_PUSH_MEMORY_U16) {
+            size = sizeof(uint16_t);
+            opcode = 0x0FB7;
+        }
+
+        cfVmJitEmitIndexedValue(self, instruction);
+        cfVmJitEmitInstruction(self, 0, false, opcode, CF_VM_JIT_RCX, cfVmJitEmitAddressCheck(self, size, instruction));
+        cfVmJitEmitCheckPush(self, 1, instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0x89, CF_VM_JIT_RCX, cfVmJitStackOperand(self, 0));
+        self->stackOffset += CF_VM_JIT_OPERAND_SIZE;
+        break;
+    }
+
+    // sub-word values are truncated by cl/cx stores
+    case CF_VM_OPCODE_POP_MEMORY_INDEXED:
+    case CF_VM_OPCODE_POP_MEMORY_U8:
+    case CF_VM_OPCODE_POP_MEMORY_U16: {
+        size_t size = sizeof(uint32_t);
+        uint8_t prefix = 0;
+        uint16_t opcode = 0x89;
+
+        if (instruction->opcode == CF_VM_OPCODE_POP_MEMORY_U8) {
+            size = sizeof(uint8_t);
+            opcode = 0x88;
+        } else if (instruction->opcode == CF_VM_OPCODE_POP_MEMORY_U16) {
+            size = sizeof(uint16_t);
+            prefix = 0x66;
+        }
+
+        cfVmJitEmitCheckPop(self, 1, instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0x8B, CF_VM_JIT_RCX, cfVmJitStackOperand(self, 1));
+        self->stackOffset -= CF_VM_JIT_OPERAND_SIZE;
+
+        cfVmJitEmitIndexedValue(self, instruction);
+        cfVmJitEmitInstruction(self, prefix, false, opcode, CF_VM_JIT_RCX, cfVmJitEmitAddressCheck(self, size, instruction));
+        break;
+    }
+
+    case CF_VM_OPCODE_MOVE_VALUE: {
+        cfVmJitEmitRegisterValue(self, cfVmJitRegisterMap[instruction->destinationRegister],
+            instruction->registerIndex, instruction->immediate);
+        break;
+    }
+
+    case CF_VM_OPCODE_MOVE_MEMORY: {
+        const CfVmJitOperand memory = cfVmJitEmitAddress(self, instruction->registerIndex, instruction->immediate,
+            sizeof(uint32_t), instruction);
+
+        // writes to cz and fl registers are ignored (but memory access is still checked)
+        if (instruction->destinationRegister >= 2)
+            cfVmJitEmitInstruction(self, 0, false, 0x8B, cfVmJitRegisterMap[instruction->destinationRegister], memory);
+        break;
+    }
+
+    case CF_VM_OPCODE_NOP:
+        break;
+
+    case CF_VM_OPCODE_PUSH_PAIR_VALUE_VALUE:
+    case CF_VM_OPCODE_PUSH_PAIR_VALUE_MEMORY:
+    case CF_VM_OPCODE_PUSH_PAIR_MEMORY_VALUE:
+    case CF_VM_OPCODE_PUSH_PAIR_MEMORY_MEMORY: {
+        const CfPushPopInfo infos[2] = { instruction->info, instruction->secondInfo };
+        const uint8_t values[2] = { CF_VM_JIT_RCX, CF_VM_JIT_RDX };
+
+        for (uint32_t i = 0; i < 2; i++) {
+            // pair immediates are 16-bit signed integers
+            const uint32_t immediate = (uint32_t)(int32_t)(int16_t)(instruction->immediate >> (16 * i));
+
+            if (infos[i].isMemoryAccess)
+                cfVmJitEmitInstruction(self, 0, false, 0x8B, values[i],
+                    cfVmJitEmitAddress(self, infos[i].registerIndex, immediate, sizeof(uint32_t), instruction));
+            else
+                cfVmJitEmitRegisterValue(self, values[i], infos[i].registerIndex, immediate);
+        }
+
+        cfVmJitEmitCheckPush(self, 2, instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0x89, values[0], cfVmJitStackOperand(self, 0));
+        cfVmJitEmitInstruction(self, 0, false, 0x89, values[1], cfVmJitStackOperand(self, -1));
+        self->stackOffset += 2 * CF_VM_JIT_OPERAND_SIZE;
+        break;
+    }
+
+    // vectors are processed by packed SSE instructions (movups is used, because stack and memory are unaligned)
+    case CF_OPCODE_VLD: {
+        const CfVmJitOperand memory = cfVmJitEmitAddress(self, instruction->registerIndex, instruction->immediate,
+            sizeof(CfVmF32x4), instruction);
+
+        cfVmJitEmitInstruction(self, 0, false, 0x0F10, 0, memory);
+        cfVmJitEmitCheckPush(self, 4, instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0x0F11, 0, cfVmJitStackOperand(self, 0));
+        self->stackOffset += 4 * CF_VM_JIT_OPERAND_SIZE;
+        break;
+    }
+
+    case CF_OPCODE_VST: {
+        cfVmJitEmitCheckPop(self, 4, instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0x0F10, 0, cfVmJitStackOperand(self, 4));
+        self->stackOffset -= 4 * CF_VM_JIT_OPERAND_SIZE;
+
+        const CfVmJitOperand memory = cfVmJitEmitAddress(self, instruction->registerIndex, instruction->immediate,
+            sizeof(CfVmF32x4), instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0x0F11, 0, memory);
+        break;
+    }
+
+    case CF_OPCODE_VADD:
+    case CF_OPCODE_VSUB:
+    case CF_OPCODE_VMUL: {
+        uint16_t opcode = 0;
+
+        // packed instructions are scalar ones without F3 prefix
+        switch (instruction->opcode) {
+        case CF_OPCODE_VADD : opcode = 0x0F58; break;
+        case CF_OPCODE_VSUB : opcode = 0x0F5C; break;
+        case CF_OPCODE_VMUL : opcode = 0x0F59; break;
+        }
+
+        cfVmJitEmitCheckPop(self, 8, instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0x0F10, 0, cfVmJitStackOperand(self, 8));
+        cfVmJitEmitInstruction(self, 0, false, 0x0F10, 1, cfVmJitStackOperand(self, 4));
+        cfVmJitEmitInstruction(self, 0, false, opcode, 0, cfVmJitRegisterOperand(1));
+        cfVmJitEmitInstruction(self, 0, false, 0x0F11, 0, cfVmJitStackOperand(self, 8));
+        self->stackOffset -= 4 * CF_VM_JIT_OPERAND_SIZE;
+        break;
+    }
+
+    case CF_OPCODE_VDOT: {
+        cfVmJitEmitCheckPop(self, 8, instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0x0F10, 0, cfVmJitStackOperand(self, 8));
+        cfVmJitEmitInstruction(self, 0, false, 0x0F10, 1, cfVmJitStackOperand(self, 4));
+        cfVmJitEmitInstruction(self, 0, false, 0x0F59, 0, cfVmJitRegisterOperand(1));
+
+        // (p0 + p1) + (p2 + p3), as in interpreter: xmm1 = (p1, p0, p3, p2), xmm0 += xmm1, xmm0.x += xmm0.z
+        cfVmJitEmitInstruction(self, 0, false, 0x0F28, 1, cfVmJitRegisterOperand(0));
+        cfVmJitEmitInstruction(self, 0, false, 0x0FC6, 1, cfVmJitRegisterOperand(1));
+        cfVmJitEmitByte(self, 0xB1);
+        cfVmJitEmitInstruction(self, 0, false, 0x0F58, 0, cfVmJitRegisterOperand(1));
+        cfVmJitEmitInstruction(self, 0, false, 0x0F12, 1, cfVmJitRegisterOperand(0));
+        cfVmJitEmitInstruction(self, 0xF3, false, 0x0F58, 0, cfVmJitRegisterOperand(1));
+        cfVmJitEmitInstruction(self, 0xF3, false, 0x0F11, 0, cfVmJitStackOperand(self, 8));
+        self->stackOffset -= 7 * CF_VM_JIT_OPERAND_SIZE;
+        break;
+    }
+
+    case CF_OPCODE_VBCAST: {
+        cfVmJitEmitCheckPop(self, 1, instruction);
+        cfVmJitEmitCheckPush(self, 3, instruction);
+        cfVmJitEmitInstruction(self, 0xF3, false, 0x0F10, 0, cfVmJitStackOperand(self, 1));
+        cfVmJitEmitInstruction(self, 0, false, 0x0FC6, 0, cfVmJitRegisterOperand(0));
+        cfVmJitEmitByte(self, 0x00);
+        cfVmJitEmitInstruction(self, 0, false, 0x0F11, 0, cfVmJitStackOperand(self, 1));
+        self->stackOffset += 3 * CF_VM_JIT_OPERAND_SIZE;
+        break;
+    }
+
+    case CF_OPCODE_VSQRT: {
+        cfVmJitEmitCheckPop(self, 4, instruction);
+        cfVmJitEmitInstruction(self, 0, false, 0x0F10, 0, cfVmJitStackOperand(self, 4));
+        cfVmJitEmitInstruction(self, 0, false, 0x0F51, 0, cfVmJitRegisterOperand(0));
+        cfVmJitEmitInstruction(self, 0, false, 0x0F11, 0, cfVmJitStackOperand(self, 4));
+        break;
+    }
+
+    default:
+        cfVmJitEmitInterpreterCall(self, instruction);
+    }
+} // cfVmJitCompileInstruction
+
+/**
+ * @brief compiled code entry emitting function
+ *
+ * @param[in,out] self compiler pointer
+ *
+ * @note entry is 'void (CfVm *self)' function, that loads VM state into host registers and starts execution.
+ */
+static void cfVmJitEmitEntry( CfVmJitCompiler *const self ) {
+    static const uint8_t calleeSaved[] = {
+        CF_VM_JIT_RBX, CF_VM_JIT_RBP, CF_VM_JIT_R12, CF_VM_JIT_R13, CF_VM_JIT_R14, CF_VM_JIT_R15,
+    };
+
+    // compiled code never returns (it's left by longjmp), but callee-saved registers are preserved anyway
+    for (uint32_t i = 0; i < sizeof(calleeSaved); i++) {
+        if (calleeSaved[i] >= 8)
+            cfVmJitEmitByte(self, 0x41);
+        cfVmJitEmitByte(self, 0x50 + (calleeSaved[i] & 7));
+    }
+
+    // align stack to 16 bytes for calls
+    cfVmJitEmitAluImmediate(self, true, 5, cfVmJitRegisterOperand(CF_VM_JIT_RSP), 8);
+
+    cfVmJitEmitInstruction(self, 0, true, 0x89, CF_VM_JIT_RDI, cfVmJitRegisterOperand(CF_VM_JIT_SELF));
+    cfVmJitEmitInstruction(self, 0, true, 0x8B, CF_VM_JIT_RAM,
+        cfVmJitMemoryOperand(CF_VM_JIT_SELF, (int32_t)offsetof(CfVm, ram)));
+    cfVmJitEmitInstruction(self, 0, true, 0x8B, CF_VM_JIT_OPERAND_STACK_TOP,
+        cfVmJitMemoryOperand(CF_VM_JIT_SELF, (int32_t)offsetof(CfVm, operandStack)));
+    cfVmJitEmitInstruction(self, 0, true, 0x8B, CF_VM_JIT_CALL_STACK_TOP,
+        cfVmJitMemoryOperand(CF_VM_JIT_SELF, (int32_t)offsetof(CfVm, callStack)));
+
+    for (uint32_t i = 0; i < CF_REGISTER_COUNT; i++)
+        if (cfVmJitRegisterMap[i] != CF_VM_JIT_NO_INDEX)
+            cfVmJitEmitInstruction(self, 0, false, 0x8B, cfVmJitRegisterMap[i], cfVmJitVmRegisterOperand(i));
+} // cfVmJitEmitEntry
+
+/**
+ * @brief out-of-line code emitting function
+ *
+ * @param[in,out] self compiler pointer
+ */
+static void cfVmJitEmitStubs( CfVmJitCompiler *const self ) {
+    // common stub tails (call corresponding handler)
+    const uintptr_t handlers[2] = {
+        (uintptr_t)&cfVmJitTerminate,
+        (uintptr_t)&cfVmJitSegmentationFault,
+    };
+    size_t tails[2];
+
+    for (uint32_t i = 0; i < 2; i++) {
+        tails[i] = self->length;
+        cfVmJitEmitInstruction(self, 0, true, 0x89, CF_VM_JIT_SELF, cfVmJitRegisterOperand(CF_VM_JIT_RDI));
+        cfVmJitEmitMoveImmediate64(self, CF_VM_JIT_RAX, handlers[i]);
+        cfVmJitEmitInstruction(self, 0, false, 0xFF, 2, cfVmJitRegisterOperand(CF_VM_JIT_RAX));
+
+        // ud2
+        cfVmJitEmitByte(self, 0x0F);
+        cfVmJitEmitByte(self, 0x0B);
+    }
+
+    const CfVmJitStub *const stubs = (const CfVmJitStub *)cfDarrData(self->stubs);
+    const size_t stubCount = cfDarrLength(self->stubs);
+
+    for (size_t i = 0; i < stubCount; i++) {
+        cfVmJitPatch(self, stubs[i].position, self->length);
+
+        if (stubs[i].kind == CF_VM_JIT_STUB_KIND_SEGMENTATION_FAULT)
+            cfVmJitEmitInstruction(self, 0, false, 0x89, CF_VM_JIT_RAX, cfVmJitRegisterOperand(CF_VM_JIT_RSI));
+        else
+            cfVmJitEmitMoveImmediate32(self, CF_VM_JIT_RSI, stubs[i].reason);
+        cfVmJitEmitMoveImmediate64(self, CF_VM_JIT_RDX, (uint64_t)(uintptr_t)stubs[i].instruction);
+        cfVmJitPatch(self, cfVmJitEmitJump(self, CF_VM_JIT_CONDITION_ALWAYS), tails[stubs[i].kind]);
+    }
+} // cfVmJitEmitStubs
+
+/**
+ * @brief flag register layout checking function
+ *
+ * @return true if comparison bits are placed at positions compiled code expects
+ */
+static bool cfVmJitCheckFlagLayout( void ) {
+    CfRegisters registers = { .indexed = {0} };
+    uint8_t bits[2];
+
+    registers.fl.cmpIsLt = 1;
+    memcpy(&bits[0], &registers.fl, 1);
+    registers.fl.cmpIsLt = 0;
+    registers.fl.cmpIsEq = 1;
+    memcpy(&bits[1], &registers.fl, 1);
+
+    return bits[0] == CF_VM_JIT_FLAG_LT && bits[1] == CF_VM_JIT_FLAG_EQ;
+} // cfVmJitCheckFlagLayout
+
+bool cfVmJitCompile( CfVm *const self ) {
+    assert(self != NULL);
+    assert(self->code != NULL);
+
+    if (!cfVmJitCheckFlagLayout())
+        return false;
+
+    // return table is placed in the same mapping right after code
+    const size_t codeCapacity = CF_VM_JIT_MAX_INSTRUCTION_SIZE * (self->codeLength + 1);
+
+    CfVmJitCompiler compiler = {
+        .vm        = self,
+        .isChecked = !self->isCodeVerified,
+        .capacity  = codeCapacity,
+        .labels    = (uint32_t *)calloc(self->codeLength, sizeof(uint32_t)),
+        .isTarget  = (bool *)calloc(self->codeLength, sizeof(bool)),
+        .patches   = cfDarrCtor(sizeof(CfVmJitPatch)),
+        .stubs     = cfDarrCtor(sizeof(CfVmJitStub)),
+    };
+    bool isOk = false;
+
+    // code is written to writable mapping and then it's made executable
+    const size_t mappingSize = codeCapacity + sizeof(void *) * self->codeLength;
+    void *buffer = mmap(NULL, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (false
+        || buffer == MAP_FAILED
+        || compiler.labels == NULL
+        || compiler.isTarget == NULL
+        || compiler.patches == NULL
+        || compiler.stubs == NULL
+    )
+        goto cfVmJitCompile__cleanup;
+
+    compiler.buffer = (uint8_t *)buffer;
+    compiler.returnTable = (void **)(compiler.buffer + codeCapacity);
+
+    // find instructions that may be reached not from the previous one
+    for (size_t i = 0; i < self->codeLength; i++) {
+        const CfVmInstruction *const instruction = &self->code[i];
+
+        if (cfVmOpcodeHasJumpTarget(instruction->opcode) && instruction->immediate < self->codeLength)
+            compiler.isTarget[instruction->immediate] = true;
+        if (instruction->opcode == CF_OPCODE_CALL && i + 1 < self->codeLength)
+            compiler.isTarget[i + 1] = true;
+    }
+
+    cfVmJitEmitEntry(&compiler);
+
+    // entry code falls through to the first instruction, so jump is required to start from another one
+    if (self->entry != 0) {
+        const CfVmJitPatch patch = {
+            .position = cfVmJitEmitJump(&compiler, CF_VM_JIT_CONDITION_ALWAYS),
+            .target   = self->entry,
+        };
+
+        compiler.isTarget[self->entry] = true;
+        if (CF_DARR_OK != cfDarrPush(&compiler.patches, &patch))
+            compiler.isOverflowed = true;
+    }
+
+    for (uint32_t i = 0; i < self->codeLength; i++) {
+        // operand stack top is written to register before label
+        if (compiler.isTarget[i]) {
+            cfVmJitEmitFlush(&compiler);
+            compiler.checkedLow = 0;
+            compiler.checkedHigh = 0;
+        }
+
+        compiler.labels[i] = (uint32_t)compiler.length;
+        cfVmJitCompileInstruction(&compiler, i);
+    }
+
+    cfVmJitEmitStubs(&compiler);
+
+    {
+        const CfVmJitPatch *const patches = (const CfVmJitPatch *)cfDarrData(compiler.patches);
+        const size_t patchCount = cfDarrLength(compiler.patches);
+
+        for (size_t i = 0; i < patchCount; i++)
+            cfVmJitPatch(&compiler, patches[i].position, compiler.labels[patches[i].target]);
+    }
+
+    // only instructions that follow calls are reachable by ret, but table is indexed by any instruction index
+    for (size_t i = 0; i < self->codeLength; i++)
+        compiler.returnTable[i] = compiler.buffer + compiler.labels[i];
+
+    if (compiler.isOverflowed || 0 != mprotect(buffer, mappingSize, PROT_READ | PROT_EXEC))
+        goto cfVmJitCompile__cleanup;
+
+    self->nativeCode = buffer;
+    self->nativeCodeSize = mappingSize;
+    isOk = true;
+
+cfVmJitCompile__cleanup:
+    if (!isOk && buffer != MAP_FAILED)
+        munmap(buffer, mappingSize);
+    free(compiler.labels);
+    free(compiler.isTarget);
+    cfDarrDtor(compiler.patches);
+    cfDarrDtor(compiler.stubs);
+
+    return isOk;
+} // cfVmJitCompile
+
+void cfVmJitRun( CfVm *const self ) {
+    assert(self->nativeCode != NULL);
+
+    ((void (*)( CfVm * ))self->nativeCode)(self);
+} // cfVmJitRun
+
+void cfVmJitRelease( CfVm *const self ) {
+    if (self->nativeCode != NULL)
+        munmap(self->nativeCode, self->nativeCodeSize);
+    self->nativeCode = NULL;
+    self->nativeCodeSize = 0;
+} // cfVmJitRelease
+
+#endif // defined(CF_VM_JIT)
+
+// cf_vm_jit.c
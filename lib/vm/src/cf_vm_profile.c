@@ -0,0 +1,117 @@
+/**
+ * @brief VM execution profile implementation file
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+
+    /// @brief profile clock is CPU timestamp counter
+    #define CF_VM_PROFILE_CLOCK_TSC
+#endif
+
+#include "cf_vm_internal.h"
+
+uint64_t cfVmProfileClock( void ) {
+#ifdef CF_VM_PROFILE_CLOCK_TSC
+    return __rdtsc();
+#else
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000 + (uint64_t)time.tv_nsec;
+#endif
+} // cfVmProfileClock
+
+/**
+ * @brief opcode name getting function
+ *
+ * @param[in]  opcode opcode to get name of (CfOpcode or CfVmOpcode)
+ * @param[out] dst    name destination (non-null, at least 32 bytes)
+ *
+ * @note name is lowercase enumeration constant name without CF_OPCODE_/CF_VM_OPCODE_ prefix
+ * (e.g. "add" or "push_value"), so it doesn't contain whitespaces.
+ */
+static void cfVmGetOpcodeName( const uint8_t opcode, char *const dst ) {
+    const char *name = NULL;
+
+    switch (opcode) {
+
+#define OPCODE_NAME(opcode) \
+    case opcode: name = #opcode; break;
+
+    CF_VM_FOR_EACH_OPCODE(OPCODE_NAME)
+
+#undef OPCODE_NAME
+
+    default:
+        snprintf(dst, 32, "opcode_%02x", opcode);
+        return;
+    }
+
+    // remove enumeration prefix
+    if (0 == strncmp(name, "CF_VM_OPCODE_", 13))
+        name += 13;
+    else if (0 == strncmp(name, "CF_OPCODE_", 10))
+        name += 10;
+
+    size_t length = 0;
+    for (; name[length] != '\0' && length < 31; length++)
+        dst[length] = (char)tolower((unsigned char)name[length]);
+    dst[length] = '\0';
+} // cfVmGetOpcodeName
+
+bool cfVmProfileWrite( const CfVm *const self, const char *const path ) {
+    FILE *file = fopen(path, "w");
+
+    if (file == NULL)
+        return false;
+
+#ifdef CF_VM_PROFILE_CLOCK_TSC
+    fprintf(file, "cfprofile %d tsc\n", CF_VM_PROFILE_VERSION);
+#else
+    fprintf(file, "cfprofile %d ns\n", CF_VM_PROFILE_VERSION);
+#endif
+
+    CfVmProfileEntry opcodeProfile[256] = {};
+    char name[32];
+
+    // decoded instructions are ordered by offset, so no sorting is required
+    for (size_t i = 0; i < self->codeLength; i++) {
+        const CfVmProfileEntry *const entry = &self->profile[i];
+
+        if (entry->count == 0)
+            continue;
+
+        cfVmGetOpcodeName(self->code[i].opcode, name);
+        fprintf(file, "i %u %s %llu %llu\n",
+            self->code[i].offset,
+            name,
+            (unsigned long long)entry->count,
+            (unsigned long long)entry->time
+        );
+
+        opcodeProfile[self->code[i].opcode].count += entry->count;
+        opcodeProfile[self->code[i].opcode].time += entry->time;
+    }
+
+    for (size_t opcode = 0; opcode < 256; opcode++) {
+        if (opcodeProfile[opcode].count == 0)
+            continue;
+
+        cfVmGetOpcodeName((uint8_t)opcode, name);
+        fprintf(file, "o %s %llu %llu\n",
+            name,
+            (unsigned long long)opcodeProfile[opcode].count,
+            (unsigned long long)opcodeProfile[opcode].time
+        );
+    }
+
+    const bool isOk = !ferror(file);
+    return fclose(file) == 0 && isOk;
+} // cfVmProfileWrite
+
+// cf_vm_profile.c
@@ -0,0 +1,232 @@
+/**
+ * @brief VM RAM management implementation file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <signal.h>
+    #include <pthread.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+
+    /// @brief RAM may be mapped from file
+    #define CF_VM_RAM_MMAP
+#endif
+
+#include "cf_vm_internal.h"
+
+#ifdef CF_VM_RAM_MMAP
+/**
+ * @brief host page size getting function
+ *
+ * @return page size
+ */
+static size_t cfVmRamGetPageSize( void ) {
+    return (size_t)sysconf(_SC_PAGESIZE);
+} // cfVmRamGetPageSize
+#endif
+
+#ifdef CF_VM_GUARD_PAGES
+/// @brief VM which RAM faults of current thread are attributed to (null if no VM code is executed)
+static __thread CfVm *cfVmRamCurrent = NULL;
+
+/// @brief fault handler installation control
+static pthread_once_t cfVmRamHandlerOnce = PTHREAD_ONCE_INIT;
+
+/// @brief fault signal handlers installed before VM one
+static struct sigaction cfVmRamPreviousSegvAction;
+static struct sigaction cfVmRamPreviousBusAction;
+
+/// @brief size of RAM reservation part that follows committed pages (covers any uint32_t address and 4-byte access after it)
+#define CF_VM_GUARD_SIZE (((size_t)1 << 32) + ((size_t)1 << 16))
+
+/**
+ * @brief memory fault handler
+ *
+ * @param[in] signal  signal number (SIGSEGV or SIGBUS)
+ * @param[in] info    signal info
+ * @param[in] context interrupted context
+ *
+ * @note faults in RAM reservation of currently executed VM terminate it (by longjmp, so handler
+ * is installed with SA_NODEFER), all other ones are passed to previously installed handler.
+ */
+static void cfVmRamHandleFault( int signal, siginfo_t *info, void *context ) {
+    CfVm *const self = cfVmRamCurrent;
+    const uint8_t *const addr = (const uint8_t *)info->si_addr;
+
+    if (true
+        && self != NULL
+        && addr >= (const uint8_t *)self->ramMapping
+        && addr < (const uint8_t *)self->ramMapping + self->ramMappingSize
+    ) {
+        // fault address is the first inaccessible byte, so it may be greater than address of access itself
+        cfVmRamCurrent = NULL;
+        self->termInfo.segmentationFault.memorySize = self->ramSize;
+        self->termInfo.segmentationFault.addr = (uint32_t)(addr - self->ram);
+        cfVmTerminate(self, CF_TERM_REASON_SEGMENTATION_FAULT);
+    }
+
+    const struct sigaction *const previous = signal == SIGSEGV
+        ? &cfVmRamPreviousSegvAction
+        : &cfVmRamPreviousBusAction;
+
+    if (previous->sa_flags & SA_SIGINFO) {
+        previous->sa_sigaction(signal, info, context);
+    } else if (previous->sa_handler == SIG_DFL || previous->sa_handler == SIG_IGN) {
+        // faulting instruction is restarted after return, so default action is performed then
+        sigaction(signal, previous, NULL);
+    } else {
+        previous->sa_handler(signal);
+    }
+} // cfVmRamHandleFault
+
+/**
+ * @brief memory fault handler installing function
+ */
+static void cfVmRamInstallHandler( void ) {
+    struct sigaction action = {};
+
+    action.sa_sigaction = cfVmRamHandleFault;
+    action.sa_flags = SA_SIGINFO | SA_NODEFER | SA_ONSTACK;
+    sigemptyset(&action.sa_mask);
+
+    sigaction(SIGSEGV, &action, &cfVmRamPreviousSegvAction);
+    sigaction(SIGBUS, &action, &cfVmRamPreviousBusAction);
+} // cfVmRamInstallHandler
+
+/**
+ * @brief RAM reservation creating function
+ *
+ * @param[in,out] self    VM to reserve RAM of (ramMapping, ramMappingSize and ram are set)
+ * @param[in]     ramSize RAM size
+ *
+ * @return true if succeeded, false otherwise
+ *
+ * @note RAM is placed at the end of committed pages, so any access beyond its end faults.
+ */
+static bool cfVmRamReserve( CfVm *const self, const size_t ramSize ) {
+    const size_t pageSize = cfVmRamGetPageSize();
+    const size_t committedSize = (ramSize + pageSize - 1) / pageSize * pageSize;
+    const size_t mappingSize = committedSize + CF_VM_GUARD_SIZE;
+
+    if (0 != pthread_once(&cfVmRamHandlerOnce, cfVmRamInstallHandler))
+        return false;
+
+    void *const mapping = mmap(NULL, mappingSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    if (mapping == MAP_FAILED)
+        return false;
+
+    self->ramMapping = mapping;
+    self->ramMappingSize = mappingSize;
+    self->ramSize = ramSize;
+    self->ram = (uint8_t *)mapping + committedSize - ramSize;
+    return true;
+} // cfVmRamReserve
+
+void cfVmRamSetCurrent( CfVm *const self ) {
+    cfVmRamCurrent = self;
+} // cfVmRamSetCurrent
+#endif
+
+bool cfVmAllocateRam( CfVm *const self, const size_t ramSize ) {
+#ifdef CF_VM_GUARD_PAGES
+    if (!cfVmRamReserve(self, ramSize))
+        return false;
+
+    // committed pages are zero-filled anonymous ones
+    const size_t committedSize = self->ram + ramSize - (uint8_t *)self->ramMapping;
+    return 0 == mprotect(self->ramMapping, committedSize, PROT_READ | PROT_WRITE);
+#else
+    self->ramSize = ramSize;
+    self->ram = (uint8_t *)calloc(ramSize, 1);
+    return self->ram != NULL;
+#endif
+} // cfVmAllocateRam
+
+bool cfVmMapRam( CfVm *const self, const size_t ramSize, const int file, const uint64_t offset ) {
+#ifdef CF_VM_GUARD_PAGES
+    const size_t pageSize = cfVmRamGetPageSize();
+    const size_t committedSize = (ramSize + pageSize - 1) / pageSize * pageSize;
+
+    // RAM end is placed at page end, so mapping starts from page boundary only if RAM end is at it in file too
+    if (ramSize == 0 || (offset + ramSize) % pageSize != 0 || offset + ramSize < committedSize)
+        return false;
+
+    if (!cfVmRamReserve(self, ramSize))
+        return false;
+
+    if (MAP_FAILED == mmap(
+        self->ramMapping,
+        committedSize,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_FIXED,
+        file,
+        (off_t)(offset + ramSize - committedSize)
+    )) {
+        cfVmReleaseRam(self);
+        return false;
+    }
+
+    return true;
+#elif defined(CF_VM_RAM_MMAP)
+    const size_t pageSize = cfVmRamGetPageSize();
+    const uint64_t mappingOffset = offset / pageSize * pageSize;
+    const size_t mappingSize = (size_t)(offset - mappingOffset) + ramSize;
+
+    if (ramSize == 0)
+        return false;
+
+    void *const mapping = mmap(NULL, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, (off_t)mappingOffset);
+
+    if (mapping == MAP_FAILED)
+        return false;
+
+    self->ramMapping = mapping;
+    self->ramMappingSize = mappingSize;
+    self->ramSize = ramSize;
+    self->ram = (uint8_t *)mapping + (offset - mappingOffset);
+    return true;
+#else
+    (void)self;
+    (void)ramSize;
+    (void)file;
+    (void)offset;
+    return false;
+#endif
+} // cfVmMapRam
+
+bool cfVmLoadSegments( CfVm *const self ) {
+    const CfExecutable *const executable = self->executable;
+
+    for (size_t i = 0; i < executable->segmentCount; i++) {
+        const CfSegment *const segment = &executable->segments[i];
+
+        if ((uint64_t)segment->address + segment->size > self->ramSize)
+            return false;
+
+        // RAM is zero-filled already, so zero-initialized segments are just checked
+        if (segment->kind != CF_SEGMENT_KIND_ZERO && segment->size != 0)
+            memcpy(self->ram + segment->address, segment->data, segment->size);
+    }
+
+    return true;
+} // cfVmLoadSegments
+
+void cfVmReleaseRam( CfVm *const self ) {
+#ifdef CF_VM_RAM_MMAP
+    if (self->ramMapping != NULL) {
+        munmap(self->ramMapping, self->ramMappingSize);
+        self->ramMapping = NULL;
+        self->ram = NULL;
+        return;
+    }
+#endif
+
+    free(self->ram);
+    self->ram = NULL;
+} // cfVmReleaseRam
+
+// cf_vm_ram.c
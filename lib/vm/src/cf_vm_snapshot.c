@@ -0,0 +1,199 @@
+/**
+ * @brief VM snapshot implementation file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cf_vm_internal.h"
+
+/// @brief size of RAM page checked for zeroness during snapshot writing
+#define CF_VM_SNAPSHOT_PAGE_SIZE ((size_t)4096)
+
+/**
+ * @brief memory zeroness checking function
+ *
+ * @param[in] data memory to check (non-null)
+ * @param[in] size memory size
+ *
+ * @return true if all memory bytes are zero, false otherwise
+ */
+static bool cfVmSnapshotIsZero( const uint8_t *const data, const size_t size ) {
+    for (size_t i = 0; i < size; i++)
+        if (data[i] != 0)
+            return false;
+    return true;
+} // cfVmSnapshotIsZero
+
+/**
+ * @brief VM snapshot into opened file writing function
+ *
+ * @param[in] self VM to write snapshot of
+ * @param[in] file file to write snapshot to (non-null, empty)
+ *
+ * @return true if succeeded, false otherwise
+ */
+static bool cfVmSnapshotWriteFile( const CfVm *const self, FILE *const file ) {
+    const size_t operandStackDepth = self->operandStackTop - self->operandStack;
+    const size_t callStackDepth = self->callStackTop - self->callStack;
+    const size_t stateSize = sizeof(CfVmSnapshotHeader) + sizeof(uint32_t) * (operandStackDepth + callStackDepth);
+
+    CfVmSnapshotHeader header = {
+        .version           = CF_VM_SNAPSHOT_VERSION,
+        .instructionOffset = self->instructionCounter->offset,
+        .codeHash          = cfHash(self->executable->code, self->executable->codeLength),
+        .ramOffset         = (stateSize + self->ramSize + CF_VM_SNAPSHOT_RAM_ALIGNMENT - 1)
+            / CF_VM_SNAPSHOT_RAM_ALIGNMENT
+            * CF_VM_SNAPSHOT_RAM_ALIGNMENT
+            - self->ramSize,
+        .ramSize           = self->ramSize,
+        .operandStackSize  = self->operandStackSize,
+        .operandStackDepth = operandStackDepth,
+        .callStackSize     = self->callStackSize,
+        .callStackDepth    = callStackDepth,
+        .registers         = self->registers,
+    };
+    memcpy(header.magic, CF_VM_SNAPSHOT_MAGIC, sizeof(header.magic));
+
+    if (false
+        || 1 != fwrite(&header, sizeof(header), 1, file)
+        || operandStackDepth != fwrite(self->operandStack, sizeof(uint32_t), operandStackDepth, file)
+    )
+        return false;
+
+    // return instruction indices are written as code offsets, because they depend on decoder (not on executable only)
+    for (size_t i = 0; i < callStackDepth; i++) {
+        const uint32_t offset = self->code[self->callStack[i]].offset;
+
+        if (1 != fwrite(&offset, sizeof(offset), 1, file))
+            return false;
+    }
+
+    // zero pages are skipped, so they are read as zeroes (and don't occupy disk space on most file systems)
+    bool isLastPageSkipped = false;
+    for (size_t pageOffset = 0; pageOffset < self->ramSize; pageOffset += CF_VM_SNAPSHOT_PAGE_SIZE) {
+        const size_t pageSize = self->ramSize - pageOffset < CF_VM_SNAPSHOT_PAGE_SIZE
+            ? self->ramSize - pageOffset
+            : CF_VM_SNAPSHOT_PAGE_SIZE;
+
+        isLastPageSkipped = cfVmSnapshotIsZero(self->ram + pageOffset, pageSize);
+        if (isLastPageSkipped)
+            continue;
+
+        if (false
+            || 0 != fseek(file, (long)(header.ramOffset + pageOffset), SEEK_SET)
+            || pageSize != fwrite(self->ram + pageOffset, 1, pageSize, file)
+        )
+            return false;
+    }
+
+    // file is extended to the RAM end (and to the RAM start, if RAM is empty)
+    if (isLastPageSkipped || self->ramSize == 0) {
+        const uint8_t zero = 0;
+        const size_t fileSize = header.ramOffset + self->ramSize;
+
+        if (false
+            || 0 != fseek(file, (long)(fileSize - 1), SEEK_SET)
+            || 1 != fwrite(&zero, 1, 1, file)
+        )
+            return false;
+    }
+
+    return true;
+} // cfVmSnapshotWriteFile
+
+bool cfVmSnapshotWrite( const CfVm *const self, const char *const path ) {
+    // snapshot is written into temporary file and then renamed, so snapshot RAM of VM (and of
+    // any other VM) started from snapshot with the same path isn't truncated while it's mapped
+    const size_t pathLength = strlen(path);
+    char *const temporaryPath = (char *)malloc(pathLength + 5);
+
+    if (temporaryPath == NULL)
+        return false;
+    memcpy(temporaryPath, path, pathLength);
+    memcpy(temporaryPath + pathLength, ".tmp", 5);
+
+    FILE *file = fopen(temporaryPath, "wb");
+    bool isOk = file != NULL;
+
+    if (isOk) {
+        isOk = cfVmSnapshotWriteFile(self, file) && !ferror(file);
+        isOk = fclose(file) == 0 && isOk;
+        isOk = isOk && 0 == rename(temporaryPath, path);
+
+        if (!isOk)
+            remove(temporaryPath);
+    }
+
+    free(temporaryPath);
+    return isOk;
+} // cfVmSnapshotWrite
+
+bool cfVmSnapshotReadHeader( FILE *const file, const CfExecutable *const executable, CfVmSnapshotHeader *const dst ) {
+    if (1 != fread(dst, sizeof(CfVmSnapshotHeader), 1, file))
+        return false;
+
+    const CfHash codeHash = cfHash(executable->code, executable->codeLength);
+    const uint64_t stateSize = sizeof(CfVmSnapshotHeader)
+        + sizeof(uint32_t) * (dst->operandStackDepth + dst->callStackDepth);
+
+    return true
+        && 0 == memcmp(dst->magic, CF_VM_SNAPSHOT_MAGIC, sizeof(dst->magic))
+        && dst->version == CF_VM_SNAPSHOT_VERSION
+        && cfHashCompare(&dst->codeHash, &codeHash)
+        && dst->operandStackSize != 0
+        && dst->operandStackDepth <= dst->operandStackSize
+        && dst->callStackSize != 0
+        && dst->callStackDepth <= dst->callStackSize
+        && dst->ramOffset >= stateSize
+    ;
+} // cfVmSnapshotReadHeader
+
+bool cfVmSnapshotLoadRam( CfVm *const self, FILE *const file, const CfVmSnapshotHeader *const header ) {
+    // mapping beyond file end isn't backed by file, so file size is checked before
+    if (false
+        || 0 != fseek(file, 0, SEEK_END)
+        || (uint64_t)ftell(file) < header->ramOffset + header->ramSize
+    )
+        return false;
+
+    // pages are loaded on first access and copied on first write, so VM start doesn't depend on RAM size
+    if (cfVmMapRam(self, header->ramSize, fileno(file), header->ramOffset))
+        return true;
+
+    return true
+        && cfVmAllocateRam(self, header->ramSize)
+        && 0 == fseek(file, (long)header->ramOffset, SEEK_SET)
+        && self->ramSize == fread(self->ram, 1, self->ramSize, file)
+    ;
+} // cfVmSnapshotLoadRam
+
+bool cfVmSnapshotRestore( CfVm *const self, FILE *const file, const CfVmSnapshotHeader *const header ) {
+    if (false
+        || 0 != fseek(file, (long)sizeof(CfVmSnapshotHeader), SEEK_SET)
+        || header->operandStackDepth != fread(self->operandStack, sizeof(uint32_t), header->operandStackDepth, file)
+    )
+        return false;
+    self->operandStackTop = self->operandStack + header->operandStackDepth;
+
+    for (size_t i = 0; i < header->callStackDepth; i++) {
+        uint32_t offset;
+
+        if (1 != fread(&offset, sizeof(offset), 1, file))
+            return false;
+
+        const CfVmInstruction *const instruction = cfVmFindInstruction(self, offset);
+
+        if (instruction == NULL)
+            return false;
+        self->callStack[i] = (uint32_t)(instruction - self->code);
+    }
+    self->callStackTop = self->callStack + header->callStackDepth;
+
+    self->instructionCounter = cfVmFindInstruction(self, header->instructionOffset);
+    self->registers = header->registers;
+
+    return self->instructionCounter != NULL;
+} // cfVmSnapshotRestore
+
+// cf_vm_snapshot.c
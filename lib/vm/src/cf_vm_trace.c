@@ -0,0 +1,219 @@
+/**
+ * @brief hot loop trace recorder implementation file
+ *
+ * @note trace is straight-line copy of instructions executed by single iteration of hot loop. Conditional
+ * jumps of iteration are turned into guards (jumps out of trace, negated if they were taken during recording),
+ * unconditional ones are removed and loop back edge is replaced by CF_VM_OPCODE_TRACE_LOOP. So loop body
+ * is executed by check-free interpreter without jumps between distant blocks and their budget charging.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cf_vm_internal.h"
+
+/// @brief count of taken back edges to loop header required to record its trace
+#define CF_VM_TRACE_HOT_THRESHOLD 64
+
+/// @brief maximal trace length (in instructions, including back edge)
+#define CF_VM_TRACE_MAX_LENGTH 512
+
+/// @brief trace cache representation structure
+typedef struct CfVmTraceCache_ {
+    int32_t         * counters;    ///< back edge counters of loop headers (negative if loop can't be traced, shared with VM)
+    CfVmInstruction **traces;      ///< loop traces (null if header trace isn't recorded)
+    bool              isRecording; ///< true if trace is recorded at the moment (so nested loops aren't entered)
+    CfVmInstruction   buffer[CF_VM_TRACE_MAX_LENGTH]; ///< trace recording buffer
+} CfVmTraceCache;
+
+bool cfVmTraceCreate( CfVm *const self ) {
+    assert(self->isCodeVerified);
+
+    CfVmTraceCache *const cache = (CfVmTraceCache *)calloc(1, sizeof(CfVmTraceCache));
+    if (cache == NULL)
+        return false;
+
+    cache->counters = (int32_t *)calloc(self->codeLength, sizeof(int32_t));
+    cache->traces = (CfVmInstruction **)calloc(self->codeLength, sizeof(CfVmInstruction *));
+    self->traces = cache;
+    self->loopCounters = cache->counters;
+
+    if (cache->counters == NULL || cache->traces == NULL) {
+        cfVmTraceRelease(self);
+        return false;
+    }
+
+    return true;
+} // cfVmTraceCreate
+
+void cfVmTraceRelease( CfVm *const self ) {
+    CfVmTraceCache *const cache = self->traces;
+
+    if (cache == NULL)
+        return;
+
+    if (cache->traces != NULL)
+        for (size_t i = 0; i < self->codeLength; i++)
+            free(cache->traces[i]);
+
+    free(cache->traces);
+    free(cache->counters);
+    free(cache);
+
+    self->traces = NULL;
+    self->loopCounters = NULL;
+} // cfVmTraceRelease
+
+/**
+ * @brief conditional jump negating function
+ *
+ * @param[in] opcode conditional jump opcode
+ *
+ * @return opcode of jump that is taken if and only if jump of opcode isn't
+ */
+static uint8_t cfVmTraceNegateJump( const uint8_t opcode ) {
+    switch (opcode) {
+    case CF_OPCODE_JLE : return CF_OPCODE_JG;
+    case CF_OPCODE_JL  : return CF_OPCODE_JGE;
+    case CF_OPCODE_JGE : return CF_OPCODE_JL;
+    case CF_OPCODE_JG  : return CF_OPCODE_JLE;
+    case CF_OPCODE_JE  : return CF_OPCODE_JNE;
+    case CF_OPCODE_JNE : return CF_OPCODE_JE;
+    case CF_OPCODE_JZ  : return CF_OPCODE_JNZ;
+    case CF_OPCODE_JNZ : return CF_OPCODE_JZ;
+    default            : return opcode;
+    }
+} // cfVmTraceNegateJump
+
+/**
+ * @brief loop trace recording function
+ *
+ * @param[in,out] self   VM to record trace in (instruction counter points to loop header)
+ * @param[in]     header loop header index
+ *
+ * @return recorded trace (null if loop can't be traced, e.g. if it contains calls, is too long or
+ * consists of single block)
+ *
+ * @note single loop iteration is executed by recorder, so instruction counter points to
+ * loop header if trace is recorded and to instruction recording is stopped at otherwise.
+ */
+static CfVmInstruction * cfVmTraceRecord( CfVm *const self, const uint32_t header ) {
+    CfVmTraceCache *const cache = self->traces;
+    size_t length = 0;
+    size_t blockCount = 0;
+    bool isOk = true;
+
+    // jumps to loop headers executed during recording are executed by interpreter as common ones
+    cache->isRecording = true;
+
+    do {
+        const CfVmInstruction *instruction = self->instructionCounter;
+        cfVmRunBlock(self);
+        blockCount++;
+
+        // block is executed until the first control transfer, so instructions before it are recorded
+        for (; isOk && !cfVmOpcodeHasJumpTarget(instruction->opcode) && instruction->opcode != CF_OPCODE_RET; instruction++) {
+            if (length == CF_VM_TRACE_MAX_LENGTH - 1)
+                isOk = false;
+            else
+                cache->buffer[length++] = *instruction;
+        }
+
+        if (!isOk)
+            break;
+
+        switch (instruction->opcode) {
+        case CF_OPCODE_JMP:
+            // unconditional jumps are not required in straight-line code
+            break;
+
+        case CF_OPCODE_JLE:
+        case CF_OPCODE_JL:
+        case CF_OPCODE_JGE:
+        case CF_OPCODE_JG:
+        case CF_OPCODE_JE:
+        case CF_OPCODE_JNE:
+        case CF_OPCODE_JZ:
+        case CF_OPCODE_JNZ: {
+            if (length == CF_VM_TRACE_MAX_LENGTH - 1) {
+                isOk = false;
+                break;
+            }
+
+            // guard leaves trace to the direction that wasn't taken during recording
+            CfVmInstruction guard = *instruction;
+            if (self->instructionCounter != instruction + 1) {
+                guard.opcode = cfVmTraceNegateJump(instruction->opcode);
+                guard.immediate = (uint32_t)(instruction + 1 - self->code);
+            }
+            guard.isBackwardJump = false;
+            cache->buffer[length++] = guard;
+            break;
+        }
+
+        default:
+            // calls and returns make loop untraceable
+            isOk = false;
+        }
+    } while (isOk && self->instructionCounter != self->code + header);
+
+    cache->isRecording = false;
+
+    // single-block loop is straight-line already, so its trace would only add back edge dispatch
+    if (!isOk || blockCount == 1)
+        return NULL;
+
+    cache->buffer[length++] = (CfVmInstruction) {
+        .opcode    = CF_VM_OPCODE_TRACE_LOOP,
+        .immediate = (uint32_t)(length - 1),
+        .offset    = self->code[header].offset,
+    };
+
+    CfVmInstruction *const trace = (CfVmInstruction *)malloc(length * sizeof(CfVmInstruction));
+    if (trace == NULL)
+        return NULL;
+
+    memcpy(trace, cache->buffer, length * sizeof(CfVmInstruction));
+
+#ifdef CF_VM_THREADED_DISPATCH
+    cfVmThreadCode(trace, length, true);
+#endif
+
+    return trace;
+} // cfVmTraceRecord
+
+const CfVmInstruction * cfVmTraceEnter( CfVm *const self, const uint32_t header ) {
+    CfVmTraceCache *const cache = self->traces;
+
+    // recorder executes code instructions only
+    if (cache->isRecording)
+        return self->code + header;
+
+    if (cache->traces[header] != NULL)
+        return cache->traces[header];
+
+    // loops that can't be traced are not entered by interpreter
+    if (++cache->counters[header] < CF_VM_TRACE_HOT_THRESHOLD)
+        return self->code + header;
+
+    cache->traces[header] = cfVmTraceRecord(self, header);
+
+    // loop is never traced again if recording failed
+    if (cache->traces[header] == NULL) {
+        cache->counters[header] = -1;
+        return self->instructionCounter;
+    }
+
+    return cache->traces[header];
+} // cfVmTraceEnter
+
+const CfVmInstruction * cfVmTraceGetSource( const CfVm *const self, const CfVmInstruction *const instruction ) {
+    if (instruction >= self->code && instruction < self->code + self->codeLength)
+        return instruction;
+
+    // trace instructions keep offsets of instructions they're copied from
+    return cfVmFindInstruction(self, instruction->offset);
+} // cfVmTraceGetSource
+
+// cf_vm_trace.c
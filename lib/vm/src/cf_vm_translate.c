@@ -0,0 +1,1344 @@
+/**
+ * @brief VM stack code into register-based code translator and translated code interpreter implementation file
+ *
+ * @note operands of translated instructions are virtual registers: operand stack slots (relative to operand
+ * stack top at basic block entry), VM registers and block constants. Values pushed by 'push' are kept in
+ * translator's symbolic stack until they're consumed, so sequence like 'push ax; push 1; add; pop ax' is
+ * executed as single 'add ax, ax, 1' instruction. Slot of each operand is known at translation time only
+ * for verified code, so other code is never translated.
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cf_vm_internal.h"
+
+/// @brief all translated instruction opcodes enumeration macro (X-macro, used to build opcode enumeration and dispatch table)
+#define CF_VM_FOR_EACH_TRANSLATED_OPCODE(x) \
+    x(MOVE)                                 \
+    x(ADD)                                  \
+    x(SUB)                                  \
+    x(SHL)                                  \
+    x(SHR)                                  \
+    x(SAR)                                  \
+    x(OR)                                   \
+    x(XOR)                                  \
+    x(AND)                                  \
+    x(IMUL)                                 \
+    x(MUL)                                  \
+    x(IDIV)                                 \
+    x(DIV)                                  \
+    x(FADD)                                 \
+    x(FSUB)                                 \
+    x(FMUL)                                 \
+    x(FDIV)                                 \
+    x(FTOI)                                 \
+    x(ITOF)                                 \
+    x(FSIN)                                 \
+    x(FCOS)                                 \
+    x(FNEG)                                 \
+    x(FSQRT)                                \
+    x(CMP)                                  \
+    x(ICMP)                                 \
+    x(FCMP)                                 \
+    x(CSET)                                 \
+    x(ICSET)                                \
+    x(FCSET)                                \
+    x(LOAD)                                 \
+    x(STORE)                                \
+    x(INTERPRET)                            \
+    x(JUMP)                                 \
+    x(CMP_JUMP)                             \
+    x(ICMP_JUMP)                            \
+    x(FCMP_JUMP)                            \
+    x(ZERO_JUMP)                            \
+    x(CALL)                                 \
+    x(RET)
+
+/// @brief translated instruction opcode
+typedef enum CfVmTranslatedOpcode_ {
+#define DECLARE_OPCODE(name) CF_VM_TRANSLATED_OPCODE_##name,
+    CF_VM_FOR_EACH_TRANSLATED_OPCODE(DECLARE_OPCODE)
+#undef DECLARE_OPCODE
+} CfVmTranslatedOpcode;
+
+/// @brief virtual register bank
+typedef enum CfVmTranslatedBank_ {
+    CF_VM_TRANSLATED_BANK_FRAME,    ///< operand stack slot (relative to operand stack top at block entry)
+    CF_VM_TRANSLATED_BANK_REGISTER, ///< VM register
+    CF_VM_TRANSLATED_BANK_CONSTANT, ///< block constant (constant 0 is write-only scratch for discarded values)
+
+    CF_VM_TRANSLATED_BANK_COUNT,    ///< bank count
+} CfVmTranslatedBank;
+
+/// @brief virtual register (translated instruction operand)
+typedef struct CfVmTranslatedOperand_ {
+    uint8_t bank;  ///< bank of virtual register (CfVmTranslatedBank)
+    int16_t index; ///< index of virtual register in bank
+} CfVmTranslatedOperand;
+
+/// @brief operand of instructions that don't use it
+#define CF_VM_TRANSLATED_OPERAND_UNUSED ((CfVmTranslatedOperand) { .bank = CF_VM_TRANSLATED_BANK_FRAME, .index = 0 })
+
+/// @brief compare-and-set style condition masks of flag jumps (bit (isLt * 2 + isEq) is set if condition holds)
+#define CF_VM_TRANSLATED_CONDITION_ALWAYS ((uint32_t)0x7)
+#define CF_VM_TRANSLATED_CONDITION_LE     ((uint32_t)0x6)
+#define CF_VM_TRANSLATED_CONDITION_LT     ((uint32_t)0x4)
+#define CF_VM_TRANSLATED_CONDITION_GE     ((uint32_t)0x3)
+#define CF_VM_TRANSLATED_CONDITION_GT     ((uint32_t)0x1)
+#define CF_VM_TRANSLATED_CONDITION_EQ     ((uint32_t)0x2)
+#define CF_VM_TRANSLATED_CONDITION_NE     ((uint32_t)0x5)
+
+/// @brief maximal count of source instructions translated into single block (keeps operand indices in int16_t range)
+#define CF_VM_TRANSLATED_MAX_BLOCK_LENGTH ((int32_t)256)
+
+/// @brief symbolic stack window size (each instruction pushes or pops at most two operands)
+#define CF_VM_TRANSLATED_STACK_WINDOW (CF_VM_TRANSLATED_MAX_BLOCK_LENGTH * 4 + 1)
+
+struct CfVmTranslatedBlock_;
+
+/// @brief translated instruction representation structure
+typedef struct CfVmTranslatedInstruction_ {
+    uint8_t               opcode;      ///< instruction opcode (CfVmTranslatedOpcode)
+    CfVmTranslatedOperand destination; ///< destination virtual register
+    CfVmTranslatedOperand lhs;         ///< first source virtual register (address base for memory access)
+    CfVmTranslatedOperand rhs;         ///< second source virtual register (stored value for STORE)
+    uint32_t              immediate;   ///< memory access offset, condition mask or (for ZERO_JUMP) 1 if jump is taken on zero
+    uint32_t              target;      ///< jump or call target instruction index
+    int32_t               depth;       ///< operand stack depth (relative to block entry) the instruction is executed at
+                                       ///< (for jumps and ret, after tested value is popped)
+    uint32_t              source;      ///< source instruction index (the next one is the fallthrough successor of jumps)
+    struct CfVmTranslatedBlock_ * successors[2]; ///< jump (or call) target and fallthrough blocks (resolved on first use)
+    const void *          handler;     ///< interpreter handler address (set on first block entry, threaded dispatch only)
+} CfVmTranslatedInstruction;
+
+/// @brief translated basic block representation structure
+typedef struct CfVmTranslatedBlock_ {
+    CfVmTranslatedInstruction * instructions;     ///< instructions (the last one is jump, call or ret or doesn't finish)
+    size_t                      instructionCount; ///< instruction count
+    uint32_t                  * constants;        ///< block constants
+    bool                        isThreaded;       ///< true if handler addresses are written to instructions
+} CfVmTranslatedBlock;
+
+/// @brief translation state (translated block cache and translator buffers) representation structure
+typedef struct CfVmTranslation_ {
+    CfVmTranslatedBlock ** blocks;       ///< instruction index -> block started by instruction (null if not translated yet)
+
+    CfDarr                 instructions; ///< instructions of block being translated
+    CfDarr                 constants;    ///< constants of block being translated
+    int32_t                depth;        ///< current operand stack depth (relative to block entry)
+    int32_t                lowDepth;     ///< lowest operand stack depth reached in block
+    CfVmTranslatedOperand  stack[CF_VM_TRANSLATED_STACK_WINDOW]; ///< symbolic operand stack (indexed by depth + window half)
+} CfVmTranslation;
+
+/**
+ * @brief frame virtual register getting function
+ *
+ * @param[in] depth operand stack depth of slot (relative to block entry)
+ *
+ * @return operand stack slot virtual register
+ */
+static CfVmTranslatedOperand cfVmTranslationFrame( const int32_t depth ) {
+    return (CfVmTranslatedOperand){ .bank = CF_VM_TRANSLATED_BANK_FRAME, .index = (int16_t)depth };
+} // cfVmTranslationFrame
+
+/**
+ * @brief VM register virtual register getting function
+ *
+ * @param[in] registerIndex VM register index
+ *
+ * @return VM register virtual register
+ */
+static CfVmTranslatedOperand cfVmTranslationRegister( const uint8_t registerIndex ) {
+    return (CfVmTranslatedOperand){ .bank = CF_VM_TRANSLATED_BANK_REGISTER, .index = registerIndex };
+} // cfVmTranslationRegister
+
+/**
+ * @brief virtual register equality checking function
+ *
+ * @param[in] lhs first virtual register
+ * @param[in] rhs second virtual register
+ *
+ * @return true if virtual registers are the same
+ */
+static bool cfVmTranslationOperandEquals( const CfVmTranslatedOperand lhs, const CfVmTranslatedOperand rhs ) {
+    return lhs.bank == rhs.bank && lhs.index == rhs.index;
+} // cfVmTranslationOperandEquals
+
+/**
+ * @brief symbolic stack element getting function
+ *
+ * @param[in,out] self  translation pointer
+ * @param[in]     depth operand stack depth of element (relative to block entry)
+ *
+ * @return symbolic stack element pointer (virtual register holding value of operand stack slot)
+ */
+static CfVmTranslatedOperand * cfVmTranslationStackAt( CfVmTranslation *const self, const int32_t depth ) {
+    return &self->stack[depth + CF_VM_TRANSLATED_STACK_WINDOW / 2];
+} // cfVmTranslationStackAt
+
+/**
+ * @brief block constant virtual register getting function
+ *
+ * @param[in,out] self  translation pointer
+ * @param[in]     value constant value
+ * @param[out]    dst   virtual register destination (non-null)
+ *
+ * @return true if succeeded, false if allocation failed
+ */
+static bool cfVmTranslationConstant( CfVmTranslation *const self, const uint32_t value, CfVmTranslatedOperand *const dst ) {
+    const uint32_t *const constants = (const uint32_t *)cfDarrData(self->constants);
+    const size_t constantCount = cfDarrLength(self->constants);
+
+    // constant 0 is scratch, so it's not reused
+    for (size_t i = 1; i < constantCount; i++) {
+        if (constants[i] == value) {
+            *dst = (CfVmTranslatedOperand){ .bank = CF_VM_TRANSLATED_BANK_CONSTANT, .index = (int16_t)i };
+            return true;
+        }
+    }
+
+    *dst = (CfVmTranslatedOperand){ .bank = CF_VM_TRANSLATED_BANK_CONSTANT, .index = (int16_t)constantCount };
+    return CF_DARR_OK == cfDarrPush(&self->constants, &value);
+} // cfVmTranslationConstant
+
+/**
+ * @brief translated instruction emitting function
+ *
+ * @param[in,out] self        translation pointer
+ * @param[in]     instruction instruction to emit
+ *
+ * @return true if succeeded, false if allocation failed
+ */
+static bool cfVmTranslationEmit( CfVmTranslation *const self, const CfVmTranslatedInstruction instruction ) {
+    return CF_DARR_OK == cfDarrPush(&self->instructions, &instruction);
+} // cfVmTranslationEmit
+
+/**
+ * @brief symbolic stack elements materializing function
+ *
+ * @param[in,out] self          translation pointer
+ * @param[in]     source        index of instruction being translated
+ * @param[in]     registerIndex index of VM register elements holding value of should be written to their slots
+ *                              (CF_REGISTER_COUNT if all elements should be written)
+ *
+ * @return true if succeeded, false if allocation failed
+ */
+static bool cfVmTranslationMaterialize( CfVmTranslation *const self, const uint32_t source, const uint32_t registerIndex ) {
+    for (int32_t depth = self->lowDepth; depth < self->depth; depth++) {
+        CfVmTranslatedOperand *const element = cfVmTranslationStackAt(self, depth);
+        const CfVmTranslatedOperand slot = cfVmTranslationFrame(depth);
+
+        if (false
+            || cfVmTranslationOperandEquals(*element, slot)
+            || (true
+                && registerIndex != CF_REGISTER_COUNT
+                && !cfVmTranslationOperandEquals(*element, cfVmTranslationRegister((uint8_t)registerIndex))
+            )
+        )
+            continue;
+
+        const CfVmTranslatedInstruction move = {
+            .opcode      = CF_VM_TRANSLATED_OPCODE_MOVE,
+            .destination = slot,
+            .lhs         = *element,
+            .rhs         = CF_VM_TRANSLATED_OPERAND_UNUSED,
+            .immediate   = 0,
+            .target      = 0,
+            .depth       = 0,
+            .source      = source,
+            .successors  = { NULL, NULL },
+            .handler     = NULL,
+        };
+        if (!cfVmTranslationEmit(self, move))
+            return false;
+        *element = slot;
+    }
+
+    return true;
+} // cfVmTranslationMaterialize
+
+/**
+ * @brief symbolic stack pushing function
+ *
+ * @param[in,out] self    translation pointer
+ * @param[in]     operand virtual register holding pushed value
+ */
+static void cfVmTranslationPush( CfVmTranslation *const self, const CfVmTranslatedOperand operand ) {
+    *cfVmTranslationStackAt(self, self->depth++) = operand;
+} // cfVmTranslationPush
+
+/**
+ * @brief symbolic stack popping function
+ *
+ * @param[in,out] self translation pointer
+ *
+ * @return virtual register holding popped value
+ */
+static CfVmTranslatedOperand cfVmTranslationPop( CfVmTranslation *const self ) {
+    const CfVmTranslatedOperand operand = *cfVmTranslationStackAt(self, --self->depth);
+
+    if (self->depth < self->lowDepth)
+        self->lowDepth = self->depth;
+    return operand;
+} // cfVmTranslationPop
+
+/**
+ * @brief register + immediate value virtual register getting function
+ *
+ * @param[in,out] self          translation pointer
+ * @param[in]     source        index of instruction being translated
+ * @param[in]     registerIndex VM register index
+ * @param[in]     immediate     immediate to add
+ * @param[in]     destination   virtual register sum is written to (if sum isn't VM register or constant itself)
+ * @param[out]    dst           virtual register holding value destination (non-null)
+ *
+ * @return true if succeeded, false if allocation failed
+ */
+static bool cfVmTranslationValue(
+    CfVmTranslation       *const self,
+    const uint32_t               source,
+    const uint8_t                registerIndex,
+    const uint32_t               immediate,
+    const CfVmTranslatedOperand  destination,
+    CfVmTranslatedOperand *const dst
+) {
+    if (registerIndex == CF_REGISTER_CZ)
+        return cfVmTranslationConstant(self, immediate, dst);
+
+    if (immediate == 0) {
+        *dst = cfVmTranslationRegister(registerIndex);
+        return true;
+    }
+
+    CfVmTranslatedInstruction add = {
+        .opcode      = CF_VM_TRANSLATED_OPCODE_ADD,
+        .destination = destination,
+        .lhs         = cfVmTranslationRegister(registerIndex),
+        .rhs         = CF_VM_TRANSLATED_OPERAND_UNUSED,
+        .immediate   = 0,
+        .target      = 0,
+        .depth       = 0,
+        .source      = source,
+        .successors  = { NULL, NULL },
+        .handler     = NULL,
+    };
+    *dst = destination;
+    return true
+        && cfVmTranslationConstant(self, immediate, &add.rhs)
+        && cfVmTranslationEmit(self, add)
+    ;
+} // cfVmTranslationValue
+
+/**
+ * @brief pushed value translating function
+ *
+ * @param[in,out] self          translation pointer
+ * @param[in]     source        index of instruction being translated
+ * @param[in]     isMemory      true if value is read from memory
+ * @param[in]     registerIndex VM register index
+ * @param[in]     immediate     immediate to add to register
+ *
+ * @return true if succeeded, false if allocation failed
+ */
+static bool cfVmTranslationPushValue(
+    CfVmTranslation *const self,
+    const uint32_t         source,
+    const bool             isMemory,
+    const uint8_t          registerIndex,
+    const uint32_t         immediate
+) {
+    const CfVmTranslatedOperand slot = cfVmTranslationFrame(self->depth);
+
+    if (!isMemory) {
+        CfVmTranslatedOperand value;
+        if (!cfVmTranslationValue(self, source, registerIndex, immediate, slot, &value))
+            return false;
+        cfVmTranslationPush(self, value);
+        return true;
+    }
+
+    // memory is read immediately to keep memory access order
+    const CfVmTranslatedInstruction load = {
+        .opcode      = CF_VM_TRANSLATED_OPCODE_LOAD,
+        .destination = slot,
+        .lhs         = cfVmTranslationRegister(registerIndex),
+        .rhs         = CF_VM_TRANSLATED_OPERAND_UNUSED,
+        .immediate   = immediate,
+        .target      = 0,
+        .depth       = 0,
+        .source      = source,
+        .successors  = { NULL, NULL },
+        .handler     = NULL,
+    };
+    cfVmTranslationPush(self, slot);
+    return cfVmTranslationEmit(self, load);
+} // cfVmTranslationPushValue
+
+/**
+ * @brief VM register writing instruction destination translating function
+ *
+ * @param[in,out] self          translation pointer
+ * @param[in]     source        index of instruction being translated
+ * @param[in]     registerIndex index of VM register to write (>= 2)
+ * @param[in]     value         virtual register holding value to write
+ *
+ * @return true if succeeded, false if allocation failed
+ *
+ * @note if value is result of the last emitted instruction, the instruction is retargeted to VM register
+ */
+static bool cfVmTranslationWriteRegister(
+    CfVmTranslation      *const self,
+    const uint32_t              source,
+    const uint8_t               registerIndex,
+    const CfVmTranslatedOperand value
+) {
+    const CfVmTranslatedOperand destination = cfVmTranslationRegister(registerIndex);
+
+    if (cfVmTranslationOperandEquals(value, destination))
+        return true;
+
+    // pending values of register are overwritten
+    const size_t instructionCount = cfDarrLength(self->instructions);
+    if (!cfVmTranslationMaterialize(self, source, registerIndex))
+        return false;
+
+    if (true
+        && instructionCount != 0
+        && instructionCount == cfDarrLength(self->instructions)
+        && value.bank == CF_VM_TRANSLATED_BANK_FRAME
+        && value.index == self->depth
+    ) {
+        CfVmTranslatedInstruction *const last = (CfVmTranslatedInstruction *)cfDarrData(self->instructions) + instructionCount - 1;
+
+        switch ((CfVmTranslatedOpcode)last->opcode) {
+        case CF_VM_TRANSLATED_OPCODE_MOVE:
+        case CF_VM_TRANSLATED_OPCODE_ADD:
+        case CF_VM_TRANSLATED_OPCODE_SUB:
+        case CF_VM_TRANSLATED_OPCODE_SHL:
+        case CF_VM_TRANSLATED_OPCODE_SHR:
+        case CF_VM_TRANSLATED_OPCODE_SAR:
+        case CF_VM_TRANSLATED_OPCODE_OR:
+        case CF_VM_TRANSLATED_OPCODE_XOR:
+        case CF_VM_TRANSLATED_OPCODE_AND:
+        case CF_VM_TRANSLATED_OPCODE_IMUL:
+        case CF_VM_TRANSLATED_OPCODE_MUL:
+        case CF_VM_TRANSLATED_OPCODE_IDIV:
+        case CF_VM_TRANSLATED_OPCODE_DIV:
+        case CF_VM_TRANSLATED_OPCODE_FADD:
+        case CF_VM_TRANSLATED_OPCODE_FSUB:
+        case CF_VM_TRANSLATED_OPCODE_FMUL:
+        case CF_VM_TRANSLATED_OPCODE_FDIV:
+        case CF_VM_TRANSLATED_OPCODE_FTOI:
+        case CF_VM_TRANSLATED_OPCODE_ITOF:
+        case CF_VM_TRANSLATED_OPCODE_FSIN:
+        case CF_VM_TRANSLATED_OPCODE_FCOS:
+        case CF_VM_TRANSLATED_OPCODE_FNEG:
+        case CF_VM_TRANSLATED_OPCODE_FSQRT:
+        case CF_VM_TRANSLATED_OPCODE_CSET:
+        case CF_VM_TRANSLATED_OPCODE_ICSET:
+        case CF_VM_TRANSLATED_OPCODE_FCSET:
+        case CF_VM_TRANSLATED_OPCODE_LOAD:
+            if (cfVmTranslationOperandEquals(last->destination, value)) {
+                last->destination = destination;
+                return true;
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    const CfVmTranslatedInstruction move = {
+        .opcode      = CF_VM_TRANSLATED_OPCODE_MOVE,
+        .destination = destination,
+        .lhs         = value,
+        .rhs         = CF_VM_TRANSLATED_OPERAND_UNUSED,
+        .immediate   = 0,
+        .target      = 0,
+        .depth       = 0,
+        .source      = source,
+        .successors  = { NULL, NULL },
+        .handler     = NULL,
+    };
+    return cfVmTranslationEmit(self, move);
+} // cfVmTranslationWriteRegister
+
+/**
+ * @brief flag jump condition mask getting function
+ *
+ * @param[in] opcode flag jump opcode
+ *
+ * @return condition mask, 0 if opcode isn't flag jump
+ */
+static uint32_t cfVmTranslationConditionMask( const uint8_t opcode ) {
+    switch (opcode) {
+    case CF_OPCODE_JMP: return CF_VM_TRANSLATED_CONDITION_ALWAYS;
+    case CF_OPCODE_JLE: return CF_VM_TRANSLATED_CONDITION_LE;
+    case CF_OPCODE_JL:  return CF_VM_TRANSLATED_CONDITION_LT;
+    case CF_OPCODE_JGE: return CF_VM_TRANSLATED_CONDITION_GE;
+    case CF_OPCODE_JG:  return CF_VM_TRANSLATED_CONDITION_GT;
+    case CF_OPCODE_JE:  return CF_VM_TRANSLATED_CONDITION_EQ;
+    case CF_OPCODE_JNE: return CF_VM_TRANSLATED_CONDITION_NE;
+    default:            return 0;
+    }
+} // cfVmTranslationConditionMask
+
+/**
+ * @brief single source instruction translating function
+ *
+ * @param[in,out] self      translation pointer
+ * @param[in]     vm        VM pointer
+ * @param[in]     index     index of instruction to translate
+ * @param[out]    nextIndex index of next instruction to translate destination (non-null)
+ * @param[out]    endsBlock block end flag destination (non-null)
+ *
+ * @return true if succeeded, false if allocation failed
+ */
+static bool cfVmTranslationTranslateInstruction(
+    CfVmTranslation *const self,
+    const CfVm      *const vm,
+    const uint32_t         index,
+    uint32_t        *const nextIndex,
+    bool            *const endsBlock
+) {
+    const CfVmInstruction *const instruction = &vm->code[index];
+
+    *nextIndex = index + 1;
+    *endsBlock = false;
+
+    switch (instruction->opcode) {
+    case CF_OPCODE_ADD:
+    case CF_OPCODE_SUB:
+    case CF_OPCODE_SHL:
+    case CF_OPCODE_SHR:
+    case CF_OPCODE_SAR:
+    case CF_OPCODE_OR:
+    case CF_OPCODE_XOR:
+    case CF_OPCODE_AND:
+    case CF_OPCODE_IMUL:
+    case CF_OPCODE_MUL:
+    case CF_OPCODE_IDIV:
+    case CF_OPCODE_DIV:
+    case CF_OPCODE_FADD:
+    case CF_OPCODE_FSUB:
+    case CF_OPCODE_FMUL:
+    case CF_OPCODE_FDIV:
+    case CF_OPCODE_CSET:
+    case CF_OPCODE_ICSET:
+    case CF_OPCODE_FCSET: {
+        uint8_t opcode = CF_VM_TRANSLATED_OPCODE_ADD;
+
+        switch (instruction->opcode) {
+        case CF_OPCODE_ADD:   opcode = CF_VM_TRANSLATED_OPCODE_ADD;   break;
+        case CF_OPCODE_SUB:   opcode = CF_VM_TRANSLATED_OPCODE_SUB;   break;
+        case CF_OPCODE_SHL:   opcode = CF_VM_TRANSLATED_OPCODE_SHL;   break;
+        case CF_OPCODE_SHR:   opcode = CF_VM_TRANSLATED_OPCODE_SHR;   break;
+        case CF_OPCODE_SAR:   opcode = CF_VM_TRANSLATED_OPCODE_SAR;   break;
+        case CF_OPCODE_OR:    opcode = CF_VM_TRANSLATED_OPCODE_OR;    break;
+        case CF_OPCODE_XOR:   opcode = CF_VM_TRANSLATED_OPCODE_XOR;   break;
+        case CF_OPCODE_AND:   opcode = CF_VM_TRANSLATED_OPCODE_AND;   break;
+        case CF_OPCODE_IMUL:  opcode = CF_VM_TRANSLATED_OPCODE_IMUL;  break;
+        case CF_OPCODE_MUL:   opcode = CF_VM_TRANSLATED_OPCODE_MUL;   break;
+        case CF_OPCODE_IDIV:  opcode = CF_VM_TRANSLATED_OPCODE_IDIV;  break;
+        case CF_OPCODE_DIV:   opcode = CF_VM_TRANSLATED_OPCODE_DIV;   break;
+        case CF_OPCODE_FADD:  opcode = CF_VM_TRANSLATED_OPCODE_FADD;  break;
+        case CF_OPCODE_FSUB:  opcode = CF_VM_TRANSLATED_OPCODE_FSUB;  break;
+        case CF_OPCODE_FMUL:  opcode = CF_VM_TRANSLATED_OPCODE_FMUL;  break;
+        case CF_OPCODE_FDIV:  opcode = CF_VM_TRANSLATED_OPCODE_FDIV;  break;
+        case CF_OPCODE_CSET:  opcode = CF_VM_TRANSLATED_OPCODE_CSET;  break;
+        case CF_OPCODE_ICSET: opcode = CF_VM_TRANSLATED_OPCODE_ICSET; break;
+        case CF_OPCODE_FCSET: opcode = CF_VM_TRANSLATED_OPCODE_FCSET; break;
+        }
+
+        const CfVmTranslatedOperand rhs = cfVmTranslationPop(self);
+        const CfVmTranslatedOperand lhs = cfVmTranslationPop(self);
+        const CfVmTranslatedInstruction result = {
+            .opcode      = opcode,
+            .destination = cfVmTranslationFrame(self->depth),
+            .lhs         = lhs,
+            .rhs         = rhs,
+            .immediate   = instruction->immediate,
+            .target      = 0,
+            .depth       = 0,
+            .source      = index,
+            .successors  = { NULL, NULL },
+            .handler     = NULL,
+        };
+        cfVmTranslationPush(self, result.destination);
+
+        // compare-and-set writes flags
+        if (result.opcode == CF_VM_TRANSLATED_OPCODE_CSET
+            || result.opcode == CF_VM_TRANSLATED_OPCODE_ICSET
+            || result.opcode == CF_VM_TRANSLATED_OPCODE_FCSET
+        ) {
+            if (!cfVmTranslationMaterialize(self, index, CF_REGISTER_FL))
+                return false;
+        }
+
+        return cfVmTranslationEmit(self, result);
+    }
+
+    case CF_OPCODE_FTOI:
+    case CF_OPCODE_ITOF:
+    case CF_OPCODE_FSIN:
+    case CF_OPCODE_FCOS:
+    case CF_OPCODE_FNEG:
+    case CF_OPCODE_FSQRT: {
+        uint8_t opcode = CF_VM_TRANSLATED_OPCODE_FTOI;
+
+        switch (instruction->opcode) {
+        case CF_OPCODE_FTOI:  opcode = CF_VM_TRANSLATED_OPCODE_FTOI;  break;
+        case CF_OPCODE_ITOF:  opcode = CF_VM_TRANSLATED_OPCODE_ITOF;  break;
+        case CF_OPCODE_FSIN:  opcode = CF_VM_TRANSLATED_OPCODE_FSIN;  break;
+        case CF_OPCODE_FCOS:  opcode = CF_VM_TRANSLATED_OPCODE_FCOS;  break;
+        case CF_OPCODE_FNEG:  opcode = CF_VM_TRANSLATED_OPCODE_FNEG;  break;
+        case CF_OPCODE_FSQRT: opcode = CF_VM_TRANSLATED_OPCODE_FSQRT; break;
+        }
+
+        const CfVmTranslatedOperand lhs = cfVmTranslationPop(self);
+        const CfVmTranslatedInstruction result = {
+            .opcode      = opcode,
+            .destination = cfVmTranslationFrame(self->depth),
+            .lhs         = lhs,
+            .rhs         = CF_VM_TRANSLATED_OPERAND_UNUSED,
+            .immediate   = 0,
+            .target      = 0,
+            .depth       = 0,
+            .source      = index,
+            .successors  = { NULL, NULL },
+            .handler     = NULL,
+        };
+        cfVmTranslationPush(self, result.destination);
+        return cfVmTranslationEmit(self, result);
+    }
+
+    case CF_OPCODE_CMP:
+    case CF_OPCODE_ICMP:
+    case CF_OPCODE_FCMP: {
+        const CfVmTranslatedOperand rhs = cfVmTranslationPop(self);
+        const CfVmTranslatedOperand lhs = cfVmTranslationPop(self);
+        CfVmTranslatedInstruction result = {
+            .opcode      = CF_VM_TRANSLATED_OPCODE_CMP,
+            .destination = CF_VM_TRANSLATED_OPERAND_UNUSED,
+            .lhs         = lhs,
+            .rhs         = rhs,
+            .immediate   = 0,
+            .target      = 0,
+            .depth       = 0,
+            .source      = index,
+            .successors  = { NULL, NULL },
+            .handler     = NULL,
+        };
+
+        if (!cfVmTranslationMaterialize(self, index, CF_REGISTER_FL))
+            return false;
+
+        // comparison followed by flag jump is translated into single compare-and-jump instruction
+        const uint32_t mask = index + 1 < vm->codeLength
+            ? cfVmTranslationConditionMask(vm->code[index + 1].opcode)
+            : 0;
+
+        if (mask == 0 || mask == CF_VM_TRANSLATED_CONDITION_ALWAYS) {
+            switch (instruction->opcode) {
+            case CF_OPCODE_CMP:  result.opcode = CF_VM_TRANSLATED_OPCODE_CMP;  break;
+            case CF_OPCODE_ICMP: result.opcode = CF_VM_TRANSLATED_OPCODE_ICMP; break;
+            case CF_OPCODE_FCMP: result.opcode = CF_VM_TRANSLATED_OPCODE_FCMP; break;
+            }
+            return cfVmTranslationEmit(self, result);
+        }
+
+        switch (instruction->opcode) {
+        case CF_OPCODE_CMP:  result.opcode = CF_VM_TRANSLATED_OPCODE_CMP_JUMP;  break;
+        case CF_OPCODE_ICMP: result.opcode = CF_VM_TRANSLATED_OPCODE_ICMP_JUMP; break;
+        case CF_OPCODE_FCMP: result.opcode = CF_VM_TRANSLATED_OPCODE_FCMP_JUMP; break;
+        }
+
+        // jump instruction is the source of compare-and-jump, so its successor is fallthrough block
+        result.immediate = mask;
+        result.target = vm->code[index + 1].immediate;
+        result.depth = self->depth;
+        result.source = index + 1;
+        *endsBlock = true;
+
+        return true
+            && cfVmTranslationMaterialize(self, index, CF_REGISTER_COUNT)
+            && cfVmTranslationEmit(self, result)
+        ;
+    }
+
+    case CF_OPCODE_JMP:
+    case CF_OPCODE_JLE:
+    case CF_OPCODE_JL:
+    case CF_OPCODE_JGE:
+    case CF_OPCODE_JG:
+    case CF_OPCODE_JE:
+    case CF_OPCODE_JNE: {
+        const CfVmTranslatedInstruction jump = {
+            .opcode      = CF_VM_TRANSLATED_OPCODE_JUMP,
+            .destination = CF_VM_TRANSLATED_OPERAND_UNUSED,
+            .lhs         = CF_VM_TRANSLATED_OPERAND_UNUSED,
+            .rhs         = CF_VM_TRANSLATED_OPERAND_UNUSED,
+            .immediate   = cfVmTranslationConditionMask(instruction->opcode),
+            .target      = instruction->immediate,
+            .depth       = self->depth,
+            .source      = index,
+            .successors  = { NULL, NULL },
+            .handler     = NULL,
+        };
+        *endsBlock = true;
+
+        return true
+            && cfVmTranslationMaterialize(self, index, CF_REGISTER_COUNT)
+            && cfVmTranslationEmit(self, jump)
+        ;
+    }
+
+    case CF_OPCODE_JZ:
+    case CF_OPCODE_JNZ: {
+        const CfVmTranslatedOperand value = cfVmTranslationPop(self);
+        const CfVmTranslatedInstruction jump = {
+            .opcode      = CF_VM_TRANSLATED_OPCODE_ZERO_JUMP,
+            .destination = CF_VM_TRANSLATED_OPERAND_UNUSED,
+            .lhs         = value,
+            .rhs         = CF_VM_TRANSLATED_OPERAND_UNUSED,
+            .immediate   = instruction->opcode == CF_OPCODE_JZ,
+            .target      = instruction->immediate,
+            .depth       = self->depth,
+            .source      = index,
+            .successors  = { NULL, NULL },
+            .handler     = NULL,
+        };
+        *endsBlock = true;
+
+        return true
+            && cfVmTranslationMaterialize(self, index, CF_REGISTER_COUNT)
+            && cfVmTranslationEmit(self, jump)
+        ;
+    }
+
+    case CF_OPCODE_CALL:
+    case CF_OPCODE_RET: {
+        const CfVmTranslatedInstruction transfer = {
+            .opcode      = instruction->opcode == CF_OPCODE_CALL
+                ? CF_VM_TRANSLATED_OPCODE_CALL
+                : CF_VM_TRANSLATED_OPCODE_RET,
+            .destination = CF_VM_TRANSLATED_OPERAND_UNUSED,
+            .lhs         = CF_VM_TRANSLATED_OPERAND_UNUSED,
+            .rhs         = CF_VM_TRANSLATED_OPERAND_UNUSED,
+            .immediate   = 0,
+            .target      = instruction->immediate,
+            .depth       = self->depth,
+            .source      = index,
+            .successors  = { NULL, NULL },
+            .handler     = NULL,
+        };
+        *endsBlock = true;
+
+        return true
+            && cfVmTranslationMaterialize(self, index, CF_REGISTER_COUNT)
+            && cfVmTranslationEmit(self, transfer)
+        ;
+    }
+
+    case CF_OPCODE_MGS: {
+        // memory size is constant during execution
+        CfVmTranslatedOperand size;
+        if (!cfVmTranslationConstant(self, (uint32_t)vm->ramSize, &size))
+            return false;
+        cfVmTranslationPush(self, size);
+        return true;
+    }
+
+    case CF_VM_OPCODE_PUSH_VALUE:
+    case CF_VM_OPCODE_PUSH_MEMORY:
+        return cfVmTranslationPushValue(
+            self,
+            index,
+            instruction->opcode == CF_VM_OPCODE_PUSH_MEMORY,
+            instruction->registerIndex,
+            instruction->immediate
+        );
+
+    case CF_VM_OPCODE_PUSH_PAIR_VALUE_VALUE:
+    case CF_VM_OPCODE_PUSH_PAIR_VALUE_MEMORY:
+    case CF_VM_OPCODE_PUSH_PAIR_MEMORY_VALUE:
+    case CF_VM_OPCODE_PUSH_PAIR_MEMORY_MEMORY: {
+        // pair immediates are 16-bit signed integers
+        const bool isFirstMemory = false
+            || instruction->opcode == CF_VM_OPCODE_PUSH_PAIR_MEMORY_VALUE
+            || instruction->opcode == CF_VM_OPCODE_PUSH_PAIR_MEMORY_MEMORY
+        ;
+        const bool isSecondMemory = false
+            || instruction->opcode == CF_VM_OPCODE_PUSH_PAIR_VALUE_MEMORY
+            || instruction->opcode == CF_VM_OPCODE_PUSH_PAIR_MEMORY_MEMORY
+        ;
+
+        return true
+            && cfVmTranslationPushValue(
+                self,
+                index,
+                isFirstMemory,
+                instruction->info.registerIndex,
+                (uint32_t)(int32_t)(int16_t)instruction->immediate
+            )
+            && cfVmTranslationPushValue(
+                self,
+                index,
+                isSecondMemory,
+                instruction->secondInfo.registerIndex,
+                (uint32_t)(int32_t)(int16_t)(instruction->immediate >> 16)
+            )
+        ;
+    }
+
+    case CF_VM_OPCODE_POP_REGISTER:
+        return cfVmTranslationWriteRegister(self, index, instruction->registerIndex, cfVmTranslationPop(self));
+
+    case CF_VM_OPCODE_POP_DISCARD:
+        cfVmTranslationPop(self);
+        return true;
+
+    case CF_VM_OPCODE_POP_MEMORY: {
+        const CfVmTranslatedInstruction store = {
+            .opcode      = CF_VM_TRANSLATED_OPCODE_STORE,
+            .destination = CF_VM_TRANSLATED_OPERAND_UNUSED,
+            .lhs         = cfVmTranslationRegister(instruction->registerIndex),
+            .rhs         = cfVmTranslationPop(self),
+            .immediate   = instruction->immediate,
+            .target      = 0,
+            .depth       = 0,
+            .source      = index,
+            .successors  = { NULL, NULL },
+            .handler     = NULL,
+        };
+        return cfVmTranslationEmit(self, store);
+    }
+
+    case CF_VM_OPCODE_MOVE_VALUE: {
+        const CfVmTranslatedOperand destination = cfVmTranslationRegister(instruction->destinationRegister);
+        CfVmTranslatedOperand value;
+
+        if (!cfVmTranslationMaterialize(self, index, instruction->destinationRegister))
+            return false;
+        if (!cfVmTranslationValue(self, index, instruction->registerIndex, instruction->immediate, destination, &value))
+            return false;
+        return cfVmTranslationWriteRegister(self, index, instruction->destinationRegister, value);
+    }
+
+    case CF_VM_OPCODE_MOVE_MEMORY: {
+        // writes to cz and fl registers are ignored, but memory is read anyway
+        CfVmTranslatedInstruction load = {
+            .opcode      = CF_VM_TRANSLATED_OPCODE_LOAD,
+            .destination = { .bank = CF_VM_TRANSLATED_BANK_CONSTANT, .index = 0 },
+            .lhs         = cfVmTranslationRegister(instruction->registerIndex),
+            .rhs         = CF_VM_TRANSLATED_OPERAND_UNUSED,
+            .immediate   = instruction->immediate,
+            .target      = 0,
+            .depth       = 0,
+            .source      = index,
+            .successors  = { NULL, NULL },
+            .handler     = NULL,
+        };
+
+        if (instruction->destinationRegister >= 2) {
+            load.destination = cfVmTranslationRegister(instruction->destinationRegister);
+            if (!cfVmTranslationMaterialize(self, index, instruction->destinationRegister))
+                return false;
+        }
+        return cfVmTranslationEmit(self, load);
+    }
+
+    case CF_VM_OPCODE_NOP:
+        return true;
+
+    default: {
+        // sandbox calls, traps, vector and bulk memory instructions are executed by single instruction interpreter
+        const CfVmTranslatedInstruction interpret = {
+            .opcode      = CF_VM_TRANSLATED_OPCODE_INTERPRET,
+            .destination = CF_VM_TRANSLATED_OPERAND_UNUSED,
+            .lhs         = CF_VM_TRANSLATED_OPERAND_UNUSED,
+            .rhs         = CF_VM_TRANSLATED_OPERAND_UNUSED,
+            .immediate   = 0,
+            .target      = 0,
+            .depth       = self->depth,
+            .source      = index,
+            .successors  = { NULL, NULL },
+            .handler     = NULL,
+        };
+
+        if (!cfVmTranslationMaterialize(self, index, CF_REGISTER_COUNT))
+            return false;
+
+        int32_t popCount, pushCount;
+        cfVmGetStackEffect(instruction, &popCount, &pushCount);
+
+        for (int32_t i = 0; i < popCount; i++)
+            cfVmTranslationPop(self);
+        for (int32_t i = 0; i < pushCount; i++)
+            cfVmTranslationPush(self, cfVmTranslationFrame(self->depth));
+
+        // execution doesn't continue after these instructions
+        *endsBlock = false
+            || instruction->opcode == CF_OPCODE_HALT
+            || instruction->opcode == CF_OPCODE_UNREACHABLE
+            || (instruction->opcode == CF_OPCODE_SYSCALL && instruction->immediate >= _CF_SYSTEM_CALL_MAX)
+            || instruction->opcode >= CF_VM_OPCODE_INVALID_POP_INFO
+        ;
+
+        return cfVmTranslationEmit(self, interpret);
+    }
+    }
+} // cfVmTranslationTranslateInstruction
+
+/**
+ * @brief basic block translating function
+ *
+ * @param[in,out] self  translation pointer
+ * @param[in]     vm    VM pointer
+ * @param[in]     entry index of block first instruction
+ *
+ * @return translated block (allocated with malloc), null if allocation failed
+ */
+static CfVmTranslatedBlock * cfVmTranslationTranslateBlock(
+    CfVmTranslation *const self,
+    const CfVm      *const vm,
+    const uint32_t         entry
+) {
+    const uint32_t scratch = 0;
+
+    cfDarrClear(self->instructions);
+    cfDarrClear(self->constants);
+    if (CF_DARR_OK != cfDarrPush(&self->constants, &scratch))
+        return NULL;
+
+    self->depth = 0;
+    self->lowDepth = 0;
+    for (int32_t depth = -CF_VM_TRANSLATED_STACK_WINDOW / 2; depth <= CF_VM_TRANSLATED_STACK_WINDOW / 2; depth++)
+        *cfVmTranslationStackAt(self, depth) = cfVmTranslationFrame(depth);
+
+    // verified code reaches only instructions that are followed by other ones
+    uint32_t index = entry;
+    for (int32_t length = 0; index < vm->codeLength; length++) {
+        bool endsBlock;
+
+        if (length == CF_VM_TRANSLATED_MAX_BLOCK_LENGTH) {
+            // too long blocks are continued by other block
+            const CfVmTranslatedInstruction jump = {
+                .opcode      = CF_VM_TRANSLATED_OPCODE_JUMP,
+                .destination = CF_VM_TRANSLATED_OPERAND_UNUSED,
+                .lhs         = CF_VM_TRANSLATED_OPERAND_UNUSED,
+                .rhs         = CF_VM_TRANSLATED_OPERAND_UNUSED,
+                .immediate   = CF_VM_TRANSLATED_CONDITION_ALWAYS,
+                .target      = index,
+                .depth       = self->depth,
+                .source      = index,
+                .successors  = { NULL, NULL },
+                .handler     = NULL,
+            };
+
+            if (!cfVmTranslationMaterialize(self, index, CF_REGISTER_COUNT) || !cfVmTranslationEmit(self, jump))
+                return NULL;
+            break;
+        }
+
+        if (!cfVmTranslationTranslateInstruction(self, vm, index, &index, &endsBlock))
+            return NULL;
+        if (endsBlock)
+            break;
+    }
+
+    // block, instructions and constants are allocated at once
+    const size_t instructionCount = cfDarrLength(self->instructions);
+    const size_t constantCount = cfDarrLength(self->constants);
+    CfVmTranslatedBlock *const block = (CfVmTranslatedBlock *)malloc(0
+        + sizeof(CfVmTranslatedBlock)
+        + sizeof(CfVmTranslatedInstruction) * instructionCount
+        + sizeof(uint32_t) * constantCount
+    );
+
+    if (block == NULL)
+        return NULL;
+
+    block->instructions = (CfVmTranslatedInstruction *)(block + 1);
+    block->instructionCount = instructionCount;
+    block->constants = (uint32_t *)(block->instructions + instructionCount);
+    block->isThreaded = false;
+
+    memcpy(block->instructions, cfDarrData(self->instructions), sizeof(CfVmTranslatedInstruction) * instructionCount);
+    memcpy(block->constants, cfDarrData(self->constants), sizeof(uint32_t) * constantCount);
+
+    return block;
+} // cfVmTranslationTranslateBlock
+
+/**
+ * @brief block by its first instruction index getting function (block is translated if it's not cached yet)
+ *
+ * @param[in,out] self  VM pointer
+ * @param[in]     entry index of block first instruction (valid)
+ *
+ * @return block pointer (execution is terminated if translation failed)
+ */
+static CfVmTranslatedBlock * cfVmTranslationGetBlock( CfVm *const self, const uint32_t entry ) {
+    CfVmTranslation *const translation = self->translation;
+
+    if (translation->blocks[entry] == NULL) {
+        translation->blocks[entry] = cfVmTranslationTranslateBlock(translation, self, entry);
+
+        if (translation->blocks[entry] == NULL) {
+            self->instructionCounter = self->code + entry + 1;
+            cfVmTerminate(self, CF_TERM_REASON_INTERNAL_ERROR);
+        }
+    }
+
+    return translation->blocks[entry];
+} // cfVmTranslationGetBlock
+
+bool cfVmTranslationCreate( CfVm *const self ) {
+    assert(self->isCodeVerified);
+
+    CfVmTranslation *const translation = (CfVmTranslation *)calloc(1, sizeof(CfVmTranslation));
+    if (translation == NULL)
+        return false;
+
+    translation->blocks = (CfVmTranslatedBlock **)calloc(self->codeLength, sizeof(CfVmTranslatedBlock *));
+    translation->instructions = cfDarrCtor(sizeof(CfVmTranslatedInstruction));
+    translation->constants = cfDarrCtor(sizeof(uint32_t));
+    self->translation = translation;
+
+    if (false
+        || translation->blocks == NULL
+        || translation->instructions == NULL
+        || translation->constants == NULL
+        || NULL == (translation->blocks[0] = cfVmTranslationTranslateBlock(translation, self, 0))
+    ) {
+        cfVmTranslationRelease(self);
+        return false;
+    }
+
+    return true;
+} // cfVmTranslationCreate
+
+void cfVmTranslationRelease( CfVm *const self ) {
+    CfVmTranslation *const translation = self->translation;
+
+    if (translation == NULL)
+        return;
+
+    if (translation->blocks != NULL)
+        for (size_t i = 0; i < self->codeLength; i++)
+            free(translation->blocks[i]);
+
+    free(translation->blocks);
+    cfDarrDtor(translation->instructions);
+    cfDarrDtor(translation->constants);
+    free(translation);
+
+    self->translation = NULL;
+} // cfVmTranslationRelease
+
+#ifdef CF_VM_THREADED_DISPATCH
+    /// @brief handler label of certain translated opcode name
+    #define CF_VM_LABEL(name) cfVmTranslatedHandler_##name
+
+    /// @brief instruction handler start
+    #define CF_VM_CASE(name) case CF_VM_TRANSLATED_OPCODE_##name: CF_VM_LABEL(name):
+
+    /// @brief next instruction dispatch (directly by handler address stored in instruction)
+    #define CF_VM_NEXT() goto *(instruction = ip++)->handler
+#else
+    #define CF_VM_CASE(name) case CF_VM_TRANSLATED_OPCODE_##name:
+    #define CF_VM_NEXT() break
+#endif
+
+void cfVmTranslationRun( CfVm *const self ) {
+    assert(self->translation != NULL);
+
+#ifdef CF_VM_THREADED_DISPATCH
+    // translated opcode -> handler address table
+    static const void *const handlers[] = {
+#define DECLARE_HANDLER(name) &&CF_VM_LABEL(name),
+        CF_VM_FOR_EACH_TRANSLATED_OPCODE(DECLARE_HANDLER)
+#undef DECLARE_HANDLER
+    };
+#endif
+
+// virtual register access
+#define OPERAND(operand) (banks[(operand).bank][(operand).index])
+
+// translated code terminates at source instruction
+#define TERMINATE(reason)                                                      \
+    do {                                                                       \
+        self->instructionCounter = self->code + instruction->source + 1;      \
+        cfVmTerminate(self, (reason));                                         \
+    } while (false)
+
+// block entering (operand stack frame is updated by caller)
+#define ENTER_BLOCK(enteredBlock)                                                   \
+    do {                                                                            \
+        const CfVmTranslatedBlock *const entered = (enteredBlock);                  \
+        banks[CF_VM_TRANSLATED_BANK_FRAME] = frame;                                 \
+        banks[CF_VM_TRANSLATED_BANK_CONSTANT] = entered->constants;                 \
+        ip = entered->instructions;                                                 \
+    } while (false)
+
+// jump successor resolving (successor blocks are translated and threaded on first use only)
+#define RESOLVE_SUCCESSOR(successorIndex)                                           \
+    do {                                                                            \
+        CfVmTranslatedBlock **const successor = &instruction->successors[(successorIndex)]; \
+        if (*successor == NULL) {                                                   \
+            *successor = cfVmTranslationGetBlock(self, (successorIndex) == 0        \
+                ? instruction->target                                               \
+                : instruction->source + 1                                           \
+            );                                                                      \
+            THREAD_BLOCK(*successor);                                               \
+        }                                                                           \
+    } while (false)
+
+// successor is selected by branch: with data-dependent selection next block instructions can't be
+// fetched speculatively, so all instructions of the next block wait for jump condition computation
+#define ENTER_SUCCESSOR(isTaken)                                                    \
+    do {                                                                            \
+        if (isTaken) {                                                              \
+            RESOLVE_SUCCESSOR(0);                                                   \
+            ENTER_BLOCK(instruction->successors[0]);                                \
+        } else {                                                                    \
+            RESOLVE_SUCCESSOR(1);                                                   \
+            ENTER_BLOCK(instruction->successors[1]);                                \
+        }                                                                           \
+    } while (false)
+
+#ifdef CF_VM_THREADED_DISPATCH
+    #define THREAD_BLOCK(threadedBlock)                                             \
+        do {                                                                        \
+            CfVmTranslatedBlock *const threaded = (threadedBlock);                  \
+            if (!threaded->isThreaded) {                                            \
+                for (size_t i = 0; i < threaded->instructionCount; i++)             \
+                    threaded->instructions[i].handler =                             \
+                        handlers[threaded->instructions[i].opcode];                 \
+                threaded->isThreaded = true;                                        \
+            }                                                                       \
+        } while (false)
+#else
+    #define THREAD_BLOCK(threadedBlock) ((void)(threadedBlock))
+#endif
+
+#define GENERIC_BINARY_OPERATION(ty, operation)                                    \
+    {                                                                              \
+        ty lhs, rhs;                                                               \
+        memcpy(&lhs, &OPERAND(instruction->lhs), sizeof(ty));                      \
+        memcpy(&rhs, &OPERAND(instruction->rhs), sizeof(ty));                      \
+        lhs = lhs operation rhs;                                                   \
+        memcpy(&OPERAND(instruction->destination), &lhs, sizeof(ty));              \
+        CF_VM_NEXT();                                                              \
+    }
+
+#define GENERIC_UNARY_OPERATION(ty, name, op)                                      \
+    {                                                                              \
+        ty name;                                                                   \
+        memcpy(&name, &OPERAND(instruction->lhs), sizeof(ty));                     \
+        name = op;                                                                 \
+        memcpy(&OPERAND(instruction->destination), &name, sizeof(ty));             \
+        CF_VM_NEXT();                                                              \
+    }
+
+#define GENERIC_CONVERSION(src, dst)                                               \
+    {                                                                              \
+        src s;                                                                     \
+        memcpy(&s, &OPERAND(instruction->lhs), sizeof(src));                       \
+        const dst d = (dst)s;                                                      \
+        memcpy(&OPERAND(instruction->destination), &d, sizeof(dst));               \
+        CF_VM_NEXT();                                                              \
+    }
+
+// comparison operands reading and flag setting (condition index is (isLt * 2 + isEq))
+#define GENERIC_COMPARE(ty)                                                        \
+    ty lhs, rhs;                                                                   \
+    memcpy(&lhs, &OPERAND(instruction->lhs), sizeof(ty));                          \
+    memcpy(&rhs, &OPERAND(instruction->rhs), sizeof(ty));                          \
+    self->registers.fl.cmpIsEq = (lhs == rhs);                                     \
+    self->registers.fl.cmpIsLt = (lhs  < rhs);                                     \
+    const uint32_t condition = (uint32_t)(lhs < rhs) * 2 + (uint32_t)(lhs == rhs);
+
+#define GENERIC_COMPARISON(ty)                                                     \
+    {                                                                              \
+        GENERIC_COMPARE(ty)                                                        \
+        (void)condition;                                                           \
+        CF_VM_NEXT();                                                              \
+    }
+
+#define GENERIC_COMPARISON_SET(ty)                                                 \
+    {                                                                              \
+        GENERIC_COMPARE(ty)                                                        \
+        OPERAND(instruction->destination) = (instruction->immediate >> condition) & 1; \
+        CF_VM_NEXT();                                                              \
+    }
+
+#define GENERIC_COMPARISON_JUMP(ty)                                                \
+    {                                                                              \
+        GENERIC_COMPARE(ty)                                                        \
+        frame += instruction->depth;                                               \
+        ENTER_SUCCESSOR((instruction->immediate >> condition) & 1);                \
+        CF_VM_NEXT();                                                              \
+    }
+
+    uint32_t *const operandStackEnd = self->operandStack + self->operandStackSize;
+    uint32_t *callStackTop = self->callStack;
+    uint32_t *const callStackEnd = self->callStack + self->callStackSize;
+
+    // operand stack top at current block entry
+    uint32_t *frame = self->operandStack;
+    uint32_t *banks[CF_VM_TRANSLATED_BANK_COUNT] = {
+        frame,                   // CF_VM_TRANSLATED_BANK_FRAME
+        self->registers.indexed, // CF_VM_TRANSLATED_BANK_REGISTER
+        NULL,                    // CF_VM_TRANSLATED_BANK_CONSTANT
+    };
+
+    CfVmTranslatedInstruction *instruction = NULL;
+    CfVmTranslatedInstruction *ip = NULL;
+
+    CfVmTranslatedBlock *const entryBlock = cfVmTranslationGetBlock(self, self->entry);
+    THREAD_BLOCK(entryBlock);
+    ENTER_BLOCK(entryBlock);
+
+    // start infinite execution loop (in threaded mode switch is used for the first dispatch only)
+    for (;;) {
+        instruction = ip++;
+
+        switch ((CfVmTranslatedOpcode)instruction->opcode) {
+        CF_VM_CASE(MOVE) {
+            OPERAND(instruction->destination) = OPERAND(instruction->lhs);
+            CF_VM_NEXT();
+        }
+
+        CF_VM_CASE(ADD)   GENERIC_BINARY_OPERATION(uint32_t,  +)
+        CF_VM_CASE(SUB)   GENERIC_BINARY_OPERATION(uint32_t,  -)
+        CF_VM_CASE(SHL)   GENERIC_BINARY_OPERATION(uint32_t, <<)
+        CF_VM_CASE(SHR)   GENERIC_BINARY_OPERATION(uint32_t, >>)
+        CF_VM_CASE(SAR)   GENERIC_BINARY_OPERATION( int32_t, >>)
+        CF_VM_CASE(OR)    GENERIC_BINARY_OPERATION(uint32_t,  |)
+        CF_VM_CASE(XOR)   GENERIC_BINARY_OPERATION(uint32_t,  ^)
+        CF_VM_CASE(AND)   GENERIC_BINARY_OPERATION(uint32_t,  &)
+        CF_VM_CASE(IMUL)  GENERIC_BINARY_OPERATION( int32_t,  *)
+        CF_VM_CASE(MUL)   GENERIC_BINARY_OPERATION(uint32_t,  *)
+        CF_VM_CASE(IDIV)  GENERIC_BINARY_OPERATION( int32_t,  /)
+        CF_VM_CASE(DIV)   GENERIC_BINARY_OPERATION(uint32_t,  /)
+        CF_VM_CASE(FADD)  GENERIC_BINARY_OPERATION(   float,  +)
+        CF_VM_CASE(FSUB)  GENERIC_BINARY_OPERATION(   float,  -)
+        CF_VM_CASE(FMUL)  GENERIC_BINARY_OPERATION(   float,  *)
+        CF_VM_CASE(FDIV)  GENERIC_BINARY_OPERATION(   float,  /)
+
+        CF_VM_CASE(FTOI)  GENERIC_CONVERSION(float, int32_t)
+        CF_VM_CASE(ITOF)  GENERIC_CONVERSION(int32_t, float)
+
+        CF_VM_CASE(FSIN)  GENERIC_UNARY_OPERATION(float, f, sinf(f))
+        CF_VM_CASE(FCOS)  GENERIC_UNARY_OPERATION(float, f, cosf(f))
+        CF_VM_CASE(FNEG)  GENERIC_UNARY_OPERATION(float, f, -f)
+        CF_VM_CASE(FSQRT) GENERIC_UNARY_OPERATION(float, f, sqrtf(f))
+
+        CF_VM_CASE(CMP)   GENERIC_COMPARISON(uint32_t)
+        CF_VM_CASE(ICMP)  GENERIC_COMPARISON( int32_t)
+        CF_VM_CASE(FCMP)  GENERIC_COMPARISON(   float)
+
+        CF_VM_CASE(CSET)  GENERIC_COMPARISON_SET(uint32_t)
+        CF_VM_CASE(ICSET) GENERIC_COMPARISON_SET( int32_t)
+        CF_VM_CASE(FCSET) GENERIC_COMPARISON_SET(   float)
+
+        CF_VM_CASE(LOAD) {
+            const uint32_t addr = OPERAND(instruction->lhs) + instruction->immediate;
+
+            if ((size_t)addr + 4 > self->ramSize)
+                self->instructionCounter = self->code + instruction->source + 1;
+            memcpy(&OPERAND(instruction->destination), cfVmGetMemoryPointer(self, addr), sizeof(uint32_t));
+            CF_VM_NEXT();
+        }
+
+        CF_VM_CASE(STORE) {
+            const uint32_t addr = OPERAND(instruction->lhs) + instruction->immediate;
+
+            if ((size_t)addr + 4 > self->ramSize)
+                self->instructionCounter = self->code + instruction->source + 1;
+            memcpy(cfVmGetMemoryPointer(self, addr), &OPERAND(instruction->rhs), sizeof(uint32_t));
+            CF_VM_NEXT();
+        }
+
+        CF_VM_CASE(INTERPRET) {
+            cfVmInterpretInstruction(self, &self->code[instruction->source], frame + instruction->depth);
+            CF_VM_NEXT();
+        }
+
+        CF_VM_CASE(JUMP) {
+            const uint32_t condition = (uint32_t)self->registers.fl.cmpIsLt * 2 + (uint32_t)self->registers.fl.cmpIsEq;
+
+            frame += instruction->depth;
+            ENTER_SUCCESSOR((instruction->immediate >> condition) & 1);
+            CF_VM_NEXT();
+        }
+
+        CF_VM_CASE(CMP_JUMP)  GENERIC_COMPARISON_JUMP(uint32_t)
+        CF_VM_CASE(ICMP_JUMP) GENERIC_COMPARISON_JUMP( int32_t)
+        CF_VM_CASE(FCMP_JUMP) GENERIC_COMPARISON_JUMP(   float)
+
+        CF_VM_CASE(ZERO_JUMP) {
+            const bool isZero = OPERAND(instruction->lhs) == 0;
+
+            frame += instruction->depth;
+            ENTER_SUCCESSOR(isZero == (instruction->immediate != 0));
+            CF_VM_NEXT();
+        }
+
+        CF_VM_CASE(CALL) {
+            uint32_t *const top = frame + instruction->depth;
+
+            if (callStackTop == callStackEnd)
+                TERMINATE(CF_TERM_REASON_CALL_STACK_OVERFLOW);
+
+            // function entry holds maximal operand stack depth of whole function
+            if (operandStackEnd - top < self->code[instruction->target].maxStackDepth)
+                TERMINATE(CF_TERM_REASON_STACK_OVERFLOW);
+
+            // return block is translated here, so ret takes it from block cache without check
+            RESOLVE_SUCCESSOR(1);
+            *callStackTop++ = instruction->source + 1;
+
+            frame = top;
+            ENTER_SUCCESSOR(true);
+            CF_VM_NEXT();
+        }
+
+        CF_VM_CASE(RET) {
+            frame += instruction->depth;
+            ENTER_BLOCK(self->translation->blocks[*--callStackTop]);
+            CF_VM_NEXT();
+        }
+
+        default: {
+            // translator never produces other opcodes
+            TERMINATE(CF_TERM_REASON_INTERNAL_ERROR);
+        }
+        }
+    }
+
+#undef GENERIC_COMPARISON_JUMP
+#undef GENERIC_COMPARISON_SET
+#undef GENERIC_COMPARISON
+#undef GENERIC_COMPARE
+#undef GENERIC_CONVERSION
+#undef GENERIC_UNARY_OPERATION
+#undef GENERIC_BINARY_OPERATION
+#undef THREAD_BLOCK
+#undef ENTER_SUCCESSOR
+#undef RESOLVE_SUCCESSOR
+#undef ENTER_BLOCK
+#undef TERMINATE
+#undef OPERAND
+} // cfVmTranslationRun
+
+#undef CF_VM_NEXT
+#undef CF_VM_CASE
+#undef CF_VM_LABEL
+
+// cf_vm_translate.c
@@ -0,0 +1,538 @@
+/**
+ * @brief pre-decoded code verifier implementation file
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cf_vm_internal.h"
+
+/// @brief function (call target) verification state
+typedef struct CfVmFunctionInfo_ {
+    uint32_t entry;       ///< entry instruction index
+    bool     doesReturn;  ///< true if function returns (returnDepth is valid then)
+    int32_t  returnDepth; ///< operand stack depth on return (relative to function entry)
+    int32_t  minDepth;    ///< minimal operand stack depth reached (relative to function entry)
+    int32_t  maxDepth;    ///< maximal operand stack depth reached (relative to function entry)
+} CfVmFunctionInfo;
+
+/// @brief verifier state representation structure
+typedef struct CfVmVerifier_ {
+    CfVmInstruction * code;          ///< code to verify
+    size_t            codeLength;    ///< code length
+
+    uint32_t        * owner;         ///< instruction index -> index of function instruction belongs to
+    int32_t         * depth;         ///< instruction index -> operand stack depth before instruction (relative to function entry)
+    uint32_t        * functionIndex; ///< instruction index -> index of function it's entry of
+
+    CfDarr            functions;     ///< function info array
+    CfDarr            worklist;      ///< indices of instructions to visit
+    uint32_t          entry;         ///< top-level code entry instruction index
+} CfVmVerifier;
+
+/// @brief verification step result
+typedef enum CfVmVerifyResult_ {
+    CF_VM_VERIFY_RESULT_OK,     ///< step succeeded
+    CF_VM_VERIFY_RESULT_FAILED, ///< code can't be verified
+} CfVmVerifyResult;
+
+void cfVmGetStackEffect(
+    const CfVmInstruction *const instruction,
+    int32_t               *const popCount,
+    int32_t               *const pushCount
+) {
+    *popCount = 0;
+    *pushCount = 0;
+
+    switch (instruction->opcode) {
+    case CF_OPCODE_ADD:
+    case CF_OPCODE_SUB:
+    case CF_OPCODE_SHL:
+    case CF_OPCODE_SHR:
+    case CF_OPCODE_SAR:
+    case CF_OPCODE_OR:
+    case CF_OPCODE_XOR:
+    case CF_OPCODE_AND:
+    case CF_OPCODE_IMUL:
+    case CF_OPCODE_MUL:
+    case CF_OPCODE_IDIV:
+    case CF_OPCODE_DIV:
+    case CF_OPCODE_FADD:
+    case CF_OPCODE_FSUB:
+    case CF_OPCODE_FMUL:
+    case CF_OPCODE_FDIV:
+        *popCount = 2;
+        *pushCount = 1;
+        break;
+
+    case CF_OPCODE_CSET:
+    case CF_OPCODE_ICSET:
+    case CF_OPCODE_FCSET:
+        *popCount = 2;
+        *pushCount = 1;
+        break;
+
+    case CF_OPCODE_CMP:
+    case CF_OPCODE_ICMP:
+    case CF_OPCODE_FCMP:
+        *popCount = 2;
+        break;
+
+    case CF_OPCODE_FTOI:
+    case CF_OPCODE_ITOF:
+    case CF_OPCODE_FSIN:
+    case CF_OPCODE_FCOS:
+    case CF_OPCODE_FNEG:
+    case CF_OPCODE_FSQRT:
+    case CF_OPCODE_IGKS:
+        *popCount = 1;
+        *pushCount = 1;
+        break;
+
+    case CF_OPCODE_VSM:
+    case CF_OPCODE_MEOW:
+    case CF_VM_OPCODE_POP_REGISTER:
+    case CF_VM_OPCODE_POP_DISCARD:
+    case CF_VM_OPCODE_POP_MEMORY:
+    case CF_VM_OPCODE_POP_MEMORY_INDEXED:
+    case CF_VM_OPCODE_POP_MEMORY_U8:
+    case CF_VM_OPCODE_POP_MEMORY_U16:
+    case CF_OPCODE_JZ:
+    case CF_OPCODE_JNZ:
+        *popCount = 1;
+        break;
+
+    case CF_OPCODE_TIME:
+    case CF_OPCODE_MGS:
+    case CF_OPCODE_IWKD:
+    case CF_VM_OPCODE_PUSH_VALUE:
+    case CF_VM_OPCODE_PUSH_MEMORY:
+    case CF_VM_OPCODE_PUSH_VALUE_INDEXED:
+    case CF_VM_OPCODE_PUSH_MEMORY_INDEXED:
+    case CF_VM_OPCODE_PUSH_MEMORY_U8:
+    case CF_VM_OPCODE_PUSH_MEMORY_U16:
+        *pushCount = 1;
+        break;
+
+    case CF_VM_OPCODE_PUSH_PAIR_VALUE_VALUE:
+    case CF_VM_OPCODE_PUSH_PAIR_VALUE_MEMORY:
+    case CF_VM_OPCODE_PUSH_PAIR_MEMORY_VALUE:
+    case CF_VM_OPCODE_PUSH_PAIR_MEMORY_MEMORY:
+        *pushCount = 2;
+        break;
+
+    case CF_OPCODE_VLD:
+        *pushCount = 4;
+        break;
+
+    case CF_OPCODE_VST:
+        *popCount = 4;
+        break;
+
+    case CF_OPCODE_VADD:
+    case CF_OPCODE_VSUB:
+    case CF_OPCODE_VMUL:
+        *popCount = 8;
+        *pushCount = 4;
+        break;
+
+    case CF_OPCODE_VDOT:
+        *popCount = 8;
+        *pushCount = 1;
+        break;
+
+    case CF_OPCODE_VBCAST:
+        *popCount = 1;
+        *pushCount = 4;
+        break;
+
+    case CF_OPCODE_MCPY:
+    case CF_OPCODE_MSET:
+        *popCount = 3;
+        break;
+
+    case CF_OPCODE_VSQRT:
+        *popCount = 4;
+        *pushCount = 4;
+        break;
+
+    case CF_OPCODE_SYSCALL:
+        // unknown system calls terminate execution
+        switch (instruction->immediate) {
+        case CF_SYSTEM_CALL_READ_FLOAT64:
+            *pushCount = 1;
+            break;
+        case CF_SYSTEM_CALL_WRITE_FLOAT64:
+            *popCount = 1;
+            break;
+        case CF_SYSTEM_CALL_READ_F32_ARRAY:
+        case CF_SYSTEM_CALL_READ_I32_ARRAY:
+            *popCount = 2;
+            *pushCount = 1;
+            break;
+        case CF_SYSTEM_CALL_WRITE_F32_ARRAY:
+        case CF_SYSTEM_CALL_WRITE_I32_ARRAY:
+            *popCount = 2;
+            break;
+        }
+        break;
+    }
+} // cfVmGetStackEffect
+
+/**
+ * @brief instruction visit scheduling function
+ *
+ * @param[in,out] self     verifier pointer
+ * @param[in]     function index of function instruction is visited from
+ * @param[in]     index    instruction index
+ * @param[in]     depth    operand stack depth before instruction
+ *
+ * @return FAILED if instruction is already visited from other function or with other stack depth, OK otherwise
+ */
+static CfVmVerifyResult cfVmVerifierVisit(
+    CfVmVerifier *const self,
+    const uint32_t      function,
+    const uint32_t      index,
+    const int32_t       depth
+) {
+    if (index >= self->codeLength)
+        return CF_VM_VERIFY_RESULT_FAILED;
+
+    if (self->owner[index] == CF_VM_INVALID_TARGET) {
+        self->owner[index] = function;
+        self->depth[index] = depth;
+
+        return CF_DARR_OK == cfDarrPush(&self->worklist, &index)
+            ? CF_VM_VERIFY_RESULT_OK
+            : CF_VM_VERIFY_RESULT_FAILED;
+    }
+
+    return self->owner[index] == function && self->depth[index] == depth
+        ? CF_VM_VERIFY_RESULT_OK
+        : CF_VM_VERIFY_RESULT_FAILED;
+} // cfVmVerifierVisit
+
+/**
+ * @brief function by entry index getting function (function is added if it's not known yet)
+ *
+ * @param[in,out] self  verifier pointer
+ * @param[in]     entry function entry instruction index (valid)
+ * @param[out]    dst   function index destination (non-null)
+ *
+ * @return OK if succeeded, FAILED if allocation failed
+ */
+static CfVmVerifyResult cfVmVerifierGetFunction(
+    CfVmVerifier *const self,
+    const uint32_t      entry,
+    uint32_t     *const dst
+) {
+    if (self->functionIndex[entry] == CF_VM_INVALID_TARGET) {
+        const CfVmFunctionInfo info = { .entry = entry };
+
+        if (CF_DARR_OK != cfDarrPush(&self->functions, &info))
+            return CF_VM_VERIFY_RESULT_FAILED;
+        self->functionIndex[entry] = (uint32_t)(cfDarrLength(self->functions) - 1);
+    }
+
+    *dst = self->functionIndex[entry];
+    return CF_VM_VERIFY_RESULT_OK;
+} // cfVmVerifierGetFunction
+
+/**
+ * @brief single function control flow walking function
+ *
+ * @param[in,out] self     verifier pointer
+ * @param[in]     function index of function to walk
+ *
+ * @return OK if function walked, FAILED if it can't be verified
+ *
+ * @note summaries of called functions are taken from previous walks, so calls
+ * to function that is not known to return yet are treated as non-returning ones.
+ */
+static CfVmVerifyResult cfVmVerifierWalkFunction( CfVmVerifier *const self, const uint32_t function ) {
+    // forget results of previous walk
+    for (size_t i = 0; i < self->codeLength; i++)
+        if (self->owner[i] == function)
+            self->owner[i] = CF_VM_INVALID_TARGET;
+
+    const uint32_t entry = ((CfVmFunctionInfo *)cfDarrData(self->functions))[function].entry;
+    CfVmFunctionInfo summary = { .entry = entry };
+
+    if (CF_VM_VERIFY_RESULT_OK != cfVmVerifierVisit(self, function, entry, 0))
+        return CF_VM_VERIFY_RESULT_FAILED;
+
+    uint32_t index;
+    while (CF_DARR_OK == cfDarrPop(&self->worklist, &index)) {
+        const CfVmInstruction *const instruction = &self->code[index];
+        const int32_t depth = self->depth[index];
+        CfVmVerifyResult result = CF_VM_VERIFY_RESULT_OK;
+
+        switch (instruction->opcode) {
+        // reachable traps
+        case CF_VM_OPCODE_INVALID_POP_INFO:
+        case CF_VM_OPCODE_UNKNOWN_OPCODE:
+        case CF_VM_OPCODE_CODE_END:
+            result = CF_VM_VERIFY_RESULT_FAILED;
+            break;
+
+        // execution end
+        case CF_OPCODE_HALT:
+        case CF_OPCODE_UNREACHABLE:
+            break;
+
+        case CF_OPCODE_JMP:
+            result = cfVmVerifierVisit(self, function, instruction->immediate, depth);
+            break;
+
+        case CF_OPCODE_JLE:
+        case CF_OPCODE_JL:
+        case CF_OPCODE_JGE:
+        case CF_OPCODE_JG:
+        case CF_OPCODE_JE:
+        case CF_OPCODE_JNE:
+            result = cfVmVerifierVisit(self, function, instruction->immediate, depth);
+            if (result == CF_VM_VERIFY_RESULT_OK)
+                result = cfVmVerifierVisit(self, function, index + 1, depth);
+            break;
+
+        case CF_OPCODE_JZ:
+        case CF_OPCODE_JNZ:
+            // tested value is popped on both paths
+            if (depth - 1 < summary.minDepth)
+                summary.minDepth = depth - 1;
+            result = cfVmVerifierVisit(self, function, instruction->immediate, depth - 1);
+            if (result == CF_VM_VERIFY_RESULT_OK)
+                result = cfVmVerifierVisit(self, function, index + 1, depth - 1);
+            break;
+
+        case CF_OPCODE_CALL: {
+            uint32_t callee;
+
+            if (false
+                || instruction->immediate >= self->codeLength
+                || CF_VM_VERIFY_RESULT_OK != cfVmVerifierGetFunction(self, instruction->immediate, &callee)
+            ) {
+                result = CF_VM_VERIFY_RESULT_FAILED;
+                break;
+            }
+
+            const CfVmFunctionInfo calleeInfo = ((CfVmFunctionInfo *)cfDarrData(self->functions))[callee];
+
+            // code after call to non-returning function is unreachable
+            if (!calleeInfo.doesReturn)
+                break;
+
+            if (depth + calleeInfo.minDepth < summary.minDepth)
+                summary.minDepth = depth + calleeInfo.minDepth;
+            result = cfVmVerifierVisit(self, function, index + 1, depth + calleeInfo.returnDepth);
+            break;
+        }
+
+        case CF_OPCODE_RET:
+            // return from top-level code is call stack underflow
+            if (function == 0 || (summary.doesReturn && summary.returnDepth != depth)) {
+                result = CF_VM_VERIFY_RESULT_FAILED;
+                break;
+            }
+            summary.doesReturn = true;
+            summary.returnDepth = depth;
+            break;
+
+        case CF_OPCODE_SYSCALL:
+            // unknown system call terminates execution
+            if (instruction->immediate >= _CF_SYSTEM_CALL_MAX)
+                break;
+            // fallthrough
+
+        default: {
+            int32_t popCount, pushCount;
+            cfVmGetStackEffect(instruction, &popCount, &pushCount);
+
+            if (depth - popCount < summary.minDepth)
+                summary.minDepth = depth - popCount;
+            if (depth - popCount + pushCount > summary.maxDepth)
+                summary.maxDepth = depth - popCount + pushCount;
+            result = cfVmVerifierVisit(self, function, index + 1, depth - popCount + pushCount);
+            break;
+        }
+        }
+
+        if (result != CF_VM_VERIFY_RESULT_OK)
+            return CF_VM_VERIFY_RESULT_FAILED;
+    }
+
+    // top-level code is started with empty operand stack
+    if (function == 0 && summary.minDepth < 0)
+        return CF_VM_VERIFY_RESULT_FAILED;
+
+    ((CfVmFunctionInfo *)cfDarrData(self->functions))[function] = summary;
+    return CF_VM_VERIFY_RESULT_OK;
+} // cfVmVerifierWalkFunction
+
+/**
+ * @brief all functions summaries computing function
+ *
+ * @param[in,out] self verifier pointer
+ *
+ * @return OK if all functions verified, FAILED otherwise
+ */
+static CfVmVerifyResult cfVmVerifierWalk( CfVmVerifier *const self ) {
+    uint32_t mainFunction;
+    if (CF_VM_VERIFY_RESULT_OK != cfVmVerifierGetFunction(self, self->entry, &mainFunction))
+        return CF_VM_VERIFY_RESULT_FAILED;
+
+    // function summaries are only extended by walks, so they reach fixed point
+    // in function-count walks, unless some recursion consumes unlimited count of operands.
+    for (size_t pass = 0; pass <= cfDarrLength(self->functions) + 1; pass++) {
+        bool changed = false;
+
+        // functions may be added during walk
+        for (uint32_t function = 0; function < cfDarrLength(self->functions); function++) {
+            const CfVmFunctionInfo prev = ((CfVmFunctionInfo *)cfDarrData(self->functions))[function];
+
+            if (CF_VM_VERIFY_RESULT_OK != cfVmVerifierWalkFunction(self, function))
+                return CF_VM_VERIFY_RESULT_FAILED;
+
+            const CfVmFunctionInfo curr = ((CfVmFunctionInfo *)cfDarrData(self->functions))[function];
+
+            changed = changed
+                || prev.doesReturn != curr.doesReturn
+                || prev.returnDepth != curr.returnDepth
+                || prev.minDepth != curr.minDepth
+            ;
+        }
+
+        if (!changed)
+            return CF_VM_VERIFY_RESULT_OK;
+    }
+
+    return CF_VM_VERIFY_RESULT_FAILED;
+} // cfVmVerifierWalk
+
+/**
+ * @brief basic block ending instruction checking function
+ *
+ * @param[in] opcode instruction opcode
+ *
+ * @return true if instruction may transfer control not to the next instruction, false otherwise
+ */
+static bool cfVmOpcodeEndsBlock( const uint8_t opcode ) {
+    switch (opcode) {
+    case CF_OPCODE_HALT:
+    case CF_OPCODE_UNREACHABLE:
+    case CF_OPCODE_JMP:
+    case CF_OPCODE_JLE:
+    case CF_OPCODE_JL:
+    case CF_OPCODE_JGE:
+    case CF_OPCODE_JG:
+    case CF_OPCODE_JE:
+    case CF_OPCODE_JNE:
+    case CF_OPCODE_JZ:
+    case CF_OPCODE_JNZ:
+    case CF_OPCODE_CALL:
+    case CF_OPCODE_RET:
+        return true;
+    default:
+        return false;
+    }
+} // cfVmOpcodeEndsBlock
+
+/**
+ * @brief basic block maximal stack depths writing function
+ *
+ * @param[in,out] self verifier pointer (all code is verified)
+ * @param[in,out] isLeader instruction index -> is basic block leader flag array (zero-initialized)
+ */
+static void cfVmVerifierWriteBlockDepths( CfVmVerifier *const self, bool *const isLeader ) {
+    CfVmInstruction *const code = self->code;
+
+    // find basic block leaders
+    for (size_t i = 0; i < self->codeLength; i++) {
+        if (self->owner[i] == CF_VM_INVALID_TARGET)
+            continue;
+
+        isLeader[i] = isLeader[i]
+            || i == 0
+            || self->functionIndex[i] != CF_VM_INVALID_TARGET
+            || self->owner[i - 1] != self->owner[i]
+            || cfVmOpcodeEndsBlock(code[i - 1].opcode)
+        ;
+
+        if (cfVmOpcodeHasJumpTarget(code[i].opcode))
+            isLeader[code[i].immediate] = true;
+    }
+
+    // compute maximal depth of each block
+    CfVmInstruction *leader = NULL;
+
+    for (size_t i = 0; i < self->codeLength; i++) {
+        code[i].maxStackDepth = 0;
+
+        if (self->owner[i] == CF_VM_INVALID_TARGET)
+            continue;
+
+        if (isLeader[i]) {
+            leader = &code[i];
+            leader->maxStackDepth = self->depth[i];
+        }
+
+        int32_t popCount, pushCount;
+        cfVmGetStackEffect(&code[i], &popCount, &pushCount);
+
+        const int32_t depth = self->depth[i] - popCount + pushCount;
+        if (depth > leader->maxStackDepth)
+            leader->maxStackDepth = depth;
+    }
+
+    // function entries hold maximal depth of whole function
+    const CfVmFunctionInfo *const functions = (const CfVmFunctionInfo *)cfDarrData(self->functions);
+    for (size_t i = 0; i < cfDarrLength(self->functions); i++)
+        code[functions[i].entry].maxStackDepth = functions[i].maxDepth;
+} // cfVmVerifierWriteBlockDepths
+
+bool cfVmVerify( CfVmInstruction *code, size_t codeLength, uint32_t entry ) {
+    assert(code != NULL);
+
+    CfVmVerifier verifier = {
+        .code          = code,
+        .codeLength    = codeLength,
+        .owner         = (uint32_t *)malloc(sizeof(uint32_t) * codeLength),
+        .depth         = (int32_t *)calloc(codeLength, sizeof(int32_t)),
+        .functionIndex = (uint32_t *)malloc(sizeof(uint32_t) * codeLength),
+        .functions     = cfDarrCtor(sizeof(CfVmFunctionInfo)),
+        .worklist      = cfDarrCtor(sizeof(uint32_t)),
+        .entry         = entry,
+    };
+    bool *isLeader = (bool *)calloc(codeLength, sizeof(bool));
+    bool verified = false;
+
+    if (false
+        || isLeader == NULL
+        || verifier.owner == NULL
+        || verifier.depth == NULL
+        || verifier.functionIndex == NULL
+        || verifier.functions == NULL
+        || verifier.worklist == NULL
+    )
+        goto cfVmVerify__cleanup;
+
+    memset(verifier.owner, 0xFF, sizeof(uint32_t) * codeLength);
+    memset(verifier.functionIndex, 0xFF, sizeof(uint32_t) * codeLength);
+
+    verified = (CF_VM_VERIFY_RESULT_OK == cfVmVerifierWalk(&verifier));
+    if (verified)
+        cfVmVerifierWriteBlockDepths(&verifier, isLeader);
+
+cfVmVerify__cleanup:
+    free(isLeader);
+    free(verifier.owner);
+    free(verifier.depth);
+    free(verifier.functionIndex);
+    cfDarrDtor(verifier.functions);
+    cfDarrDtor(verifier.worklist);
+
+    return verified;
+} // cfVmVerify
+
+// cf_vm_verify.c
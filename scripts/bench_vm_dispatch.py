@@ -0,0 +1,91 @@
+# VM dispatch mode (switch vs threaded vs register translation vs JIT) comparison script
+#
+# Usage: python3 scripts/bench_vm_dispatch.py [build directory prefix]
+#
+# Builds project twice (with CF_VM_THREADED_DISPATCH OFF and ON), assembles
+# examples and runs them with bench_vm_dispatch utility. Both builds execute
+# exactly the same instruction sequences, so time ratio is per-instruction dispatch gain.
+# Translation and JIT modes run the same executables on threaded build with register-based code
+# translation (verified executables only, others are interpreted) and native code compilation enabled.
+
+import os
+import subprocess
+import sys
+
+root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+build_prefix = sys.argv[1] if len(sys.argv) > 1 else os.path.join(root, 'build-bench')
+
+# mode -> (CF_VM_THREADED_DISPATCH value, bench_vm_dispatch extra arguments)
+modes = {
+    'switch': ('OFF', []),
+    'threaded': ('ON', []),
+    'register': ('ON', ['-t']),
+    'jit': ('ON', ['-j']),
+}
+
+# (name, sources, bench_vm_dispatch arguments, stdin)
+benchmarks = [
+    ('sin', ['examples/sin.cfasm'], ['-r', '5', '-f', '2000'], ''),
+    ('fisqrt', ['examples/fisqrt.cfasm'], ['-r', '200', '-m', '65536'], '2.0\n' * 200),
+    ('ray_tracer', [
+        'examples/ray_tracer/src/main.cfasm',
+        'examples/ray_tracer/src/vec.cfasm',
+        'examples/ray_tracer/src/camera.cfasm',
+    ], ['-r', '3', '-f', '5'], ''),
+]
+
+def run(args, stdin = None) -> str:
+    return subprocess.run(args, input = stdin, capture_output = True, text = True, check = True).stdout
+
+def build(option: str) -> str:
+    build_dir = build_prefix + '-' + ('threaded' if option == 'ON' else 'switch')
+    run([
+        'cmake', '-S', root, '-B', build_dir,
+        '-DCMAKE_BUILD_TYPE=Release',
+        '-DCF_BUILD_BENCHMARKS=ON',
+        '-DCF_VM_THREADED_DISPATCH=' + option,
+    ])
+    run(['cmake', '--build', build_dir, '-j', '--target', 'cf_assembler', 'cf_linker', 'bench_vm_dispatch'])
+    return build_dir
+
+def assemble(build_dir: str, name: str, sources: list) -> str:
+    objects = []
+    for source in sources:
+        object_path = os.path.join(build_dir, name + '_' + os.path.basename(source) + '.cfobj')
+        run([os.path.join(build_dir, 'app/assembler/cf_assembler'), '-o', object_path, os.path.join(root, source)])
+        objects.append(object_path)
+
+    executable_path = os.path.join(build_dir, name + '.cfexe')
+    run([os.path.join(build_dir, 'app/linker/cf_linker'), '-o', executable_path] + objects)
+    return executable_path
+
+def parse_result(line: str) -> dict:
+    return dict(map(lambda kv: kv.split('='), line.split()))
+
+results = {}
+build_dirs = {}
+for (mode, (option, mode_args)) in modes.items():
+    if option not in build_dirs:
+        build_dirs[option] = build(option)
+    build_dir = build_dirs[option]
+
+    for (name, sources, args, stdin) in benchmarks:
+        executable = assemble(build_dir, name, sources)
+        output = run([os.path.join(build_dir, 'bench/vm_dispatch/bench_vm_dispatch')] + args + mode_args + [executable], stdin)
+        results[(mode, name)] = parse_result(output.strip().split('\n')[-1])
+
+print(
+    f"{'benchmark':<12} {'switch, s':>12} {'threaded, s':>12} {'register, s':>12} {'jit, s':>12}"
+    f" {'threaded':>9} {'register':>9} {'jit':>9}"
+)
+for (name, _, _, _) in benchmarks:
+    switch_time = float(results[('switch', name)]['best'])
+    threaded_time = float(results[('threaded', name)]['best'])
+    register_time = float(results[('register', name)]['best'])
+    jit_time = float(results[('jit', name)]['best'])
+    print(
+        f"{name:<12} {switch_time:>12.6f} {threaded_time:>12.6f} {register_time:>12.6f} {jit_time:>12.6f}"
+        f" {switch_time / threaded_time:>8.3f}x {switch_time / register_time:>8.3f}x {switch_time / jit_time:>8.3f}x"
+    )
+
+# bench_vm_dispatch.py
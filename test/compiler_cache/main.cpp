@@ -0,0 +1,205 @@
+/**
+ * @brief compilation cache test file
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include "compiler_cache.h"
+
+/// @brief test object code length
+#define TEST_CODE_LENGTH 4096
+
+/**
+ * @brief cache entry path building function (entry naming must be the same as in cache)
+ *
+ * @param[in]  directory cache directory
+ * @param[in]  key       entry key
+ * @param[out] dst       path destination (256 bytes)
+ */
+static void getEntryPath( const char *directory, const CfHash *key, char *dst ) {
+    int length = snprintf(dst, 256, "%s/", directory);
+
+    for (size_t i = 0; i < 8; i++)
+        length += snprintf(dst + length, 256 - length, "%08X", key->hash[i]);
+    snprintf(dst + length, 256 - length, ".cfobj");
+} // getEntryPath
+
+/**
+ * @brief cache entry last use time setting function
+ *
+ * @param[in] directory cache directory
+ * @param[in] key       entry key
+ * @param[in] time      last use time (in seconds)
+ */
+static void setEntryTime( const char *directory, const CfHash *key, time_t time ) {
+    char path[256];
+    struct utimbuf times = { time, time };
+
+    getEntryPath(directory, key, path);
+    utime(path, &times);
+} // setEntryTime
+
+/**
+ * @brief object from cache loading function
+ *
+ * @param[in] cache cache to load object from
+ * @param[in] key   object key
+ * @param[in] fill  expected object code byte (-1 if object should be missing)
+ *
+ * @return true if object is loaded (or missing) as expected, false otherwise
+ */
+static bool checkLoad( const CompilerCache *cache, const CfHash *key, int fill ) {
+    CfObject object = {};
+
+    if (!compilerCacheLoad(cache, key, &object))
+        return fill == -1;
+
+    bool isSame = fill != -1 && object.codeLength == TEST_CODE_LENGTH;
+    for (size_t i = 0; isSame && i < TEST_CODE_LENGTH; i++)
+        isSame = object.code[i] == (uint8_t)fill;
+
+    cfObjectDtor(&object);
+    return isSame;
+} // checkLoad
+
+int main( void ) {
+    char directory[] = "/tmp/cf_compiler_cache_test.XXXXXX";
+
+    if (mkdtemp(directory) == NULL) {
+        printf("cannot create cache directory\n");
+        return 1;
+    }
+
+    const char *sources[] = {
+        "fn main() { }",
+        "fn main() { } ",
+        "fn f() { }",
+    };
+    CfHash keys[3];
+    uint8_t code[3][TEST_CODE_LENGTH];
+    CfObject objects[3] = {};
+
+    // objects are hashed during writing, so link and label arrays must be non-null even if empty
+    CfLink link = {};
+    CfLabel label = {};
+
+    for (int i = 0; i < 3; i++) {
+        keys[i] = compilerCacheKey(sources[i], strlen(sources[i]));
+        memset(code[i], 'a' + i, TEST_CODE_LENGTH);
+
+        objects[i].sourceName = "test.cf";
+        objects[i].codeLength = TEST_CODE_LENGTH;
+        objects[i].code = code[i];
+        objects[i].links = &link;
+        objects[i].labels = &label;
+    }
+
+    CompilerCache cache;
+    int result = 1;
+
+    if (!compilerCacheOpen(&cache, directory, COMPILER_CACHE_DEFAULT_MAX_SIZE)) {
+        printf("cannot open cache\n");
+        goto main__cleanup;
+    }
+
+    // changed source text must produce other key
+    if (cfHashCompare(&keys[0], &keys[1])) {
+        printf("keys of different sources match\n");
+        goto main__cleanup;
+    }
+
+    // key prefix is hashed too, so cache version and options change must produce other key
+    {
+        const size_t length = strlen(sources[0]);
+        const CfHash current = compilerCacheKeyVersioned(sources[0], length, COMPILER_CACHE_VERSION, 0);
+        const CfHash nextVersion = compilerCacheKeyVersioned(sources[0], length, COMPILER_CACHE_VERSION + 1, 0);
+        const CfHash otherOptions = compilerCacheKeyVersioned(sources[0], length, COMPILER_CACHE_VERSION, 1);
+
+        if (!cfHashCompare(&current, &keys[0])) {
+            printf("key of current version mismatch\n");
+            goto main__cleanup;
+        }
+
+        if (cfHashCompare(&current, &nextVersion) || cfHashCompare(&current, &otherOptions)) {
+            printf("keys of different cache versions or options match\n");
+            goto main__cleanup;
+        }
+    }
+
+    if (!checkLoad(&cache, &keys[0], -1)) {
+        printf("empty cache hit\n");
+        goto main__cleanup;
+    }
+
+    compilerCacheStore(&cache, &keys[0], &objects[0]);
+
+    if (!checkLoad(&cache, &keys[0], 'a')) {
+        printf("stored object isn't loaded\n");
+        goto main__cleanup;
+    }
+
+    if (!checkLoad(&cache, &keys[1], -1)) {
+        printf("changed source hit\n");
+        goto main__cleanup;
+    }
+
+    {
+        compilerCacheStore(&cache, &keys[1], &objects[1]);
+        compilerCacheStore(&cache, &keys[2], &objects[2]);
+
+        char path[256];
+        struct stat status;
+
+        getEntryPath(directory, &keys[0], path);
+        if (0 != stat(path, &status)) {
+            printf("cache entry is missing\n");
+            goto main__cleanup;
+        }
+
+        // first entry is used after others, so second one is least recently used
+        setEntryTime(directory, &keys[0], 1000);
+        setEntryTime(directory, &keys[1], 2000);
+        setEntryTime(directory, &keys[2], 3000);
+
+        if (!checkLoad(&cache, &keys[0], 'a')) {
+            printf("stored object isn't loaded\n");
+            goto main__cleanup;
+        }
+
+        cache.maxSize = 2 * (uint64_t)status.st_size;
+        compilerCacheTrim(&cache);
+
+        if (false
+            || !checkLoad(&cache, &keys[0], 'a')
+            || !checkLoad(&cache, &keys[1], -1)
+            || !checkLoad(&cache, &keys[2], 'c')
+        ) {
+            printf("least recently used entry isn't evicted\n");
+            goto main__cleanup;
+        }
+    }
+
+    printf("compilation cache tests passed\n");
+    result = 0;
+
+main__cleanup:
+    for (int i = 0; i < 3; i++) {
+        char path[256];
+
+        getEntryPath(directory, &keys[i], path);
+        remove(path);
+    }
+    rmdir(directory);
+
+    return result;
+} // main
+
+// main.cpp
@@ -0,0 +1,236 @@
+/**
+ * @brief hash test file
+ */
+
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+#include "cf_hash_internal.h"
+
+/**
+ * @brief hash printing function
+ *
+ * @param[in] hash hash to print
+ */
+static void printHash( const CfHash &hash ) {
+    for (size_t i = 0; i < 8; i++)
+        printf("%08X", hash.hash[i]);
+    printf("\n");
+} // printHash
+
+/**
+ * @brief known answer testing function
+ *
+ * @return 0 if succeeded, 1 if failed
+ */
+static int testKnownAnswers( void ) {
+    const struct {
+        const char * message; ///< message to hash
+        CfHash       hash;    ///< its SHA256
+    } tests[] = {
+        {
+            "",
+            {{ 0xE3B0C442, 0x98FC1C14, 0x9AFBF4C8, 0x996FB924, 0x27AE41E4, 0x649B934C, 0xA495991B, 0x7852B855 }},
+        },
+        {
+            "abc",
+            {{ 0xBA7816BF, 0x8F01CFEA, 0x414140DE, 0x5DAE2223, 0xB00361A3, 0x96177A9C, 0xB410FF61, 0xF20015AD }},
+        },
+        {
+            "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+            {{ 0x248D6A61, 0xD20638B8, 0xE5C02693, 0x0C3E6039, 0xA33CE459, 0x64FF2167, 0xF6ECEDD4, 0x19DB06C1 }},
+        },
+    };
+
+    for (const auto &test : tests) {
+        const CfHash hash = cfHash(test.message, strlen(test.message));
+
+        if (!cfHashCompare(&hash, &test.hash)) {
+            printf("hash of \"%s\" mismatch: ", test.message);
+            printHash(hash);
+            return 1;
+        }
+    }
+
+    return 0;
+} // testKnownAnswers
+
+/**
+ * @brief iterative hashing testing function (data hashed by several steps must have the same hash as whole data)
+ *
+ * @return 0 if succeeded, 1 if failed
+ */
+static int testSteps( void ) {
+    std::vector<uint8_t> data(1000);
+
+    srand(42);
+    for (uint8_t &byte : data)
+        byte = (uint8_t)rand();
+
+    // split points of two steps
+    for (size_t size = 0; size <= 300; size += 7) {
+        const CfHash expected = cfHash(data.data(), size);
+
+        for (size_t split = 0; split <= size; split++) {
+            CfHasher hasher;
+
+            cfHasherInitialize(&hasher);
+            cfHasherStep(&hasher, data.data(), split);
+            cfHasherStep(&hasher, data.data() + split, size - split);
+
+            const CfHash hash = cfHasherTerminate(&hasher);
+
+            if (!cfHashCompare(&hash, &expected)) {
+                printf("hash of %zu bytes hashed by steps of %zu and %zu bytes mismatch\n", size, split, size - split);
+                return 1;
+            }
+        }
+    }
+
+    // steps of different sizes (single-byte ones too)
+    for (size_t stepSize = 1; stepSize <= 130; stepSize++) {
+        const CfHash expected = cfHash(data.data(), data.size());
+        CfHasher hasher;
+
+        cfHasherInitialize(&hasher);
+        for (size_t offset = 0; offset < data.size(); offset += stepSize)
+            cfHasherStep(
+                &hasher,
+                data.data() + offset,
+                data.size() - offset < stepSize ? data.size() - offset : stepSize
+            );
+
+        const CfHash hash = cfHasherTerminate(&hasher);
+
+        if (!cfHashCompare(&hash, &expected)) {
+            printf("hash of data hashed by steps of %zu bytes mismatch\n", stepSize);
+            return 1;
+        }
+    }
+
+    return 0;
+} // testSteps
+
+/**
+ * @brief multiple data block hashing testing function
+ *
+ * @return 0 if succeeded, 1 if failed
+ */
+static int testMany( void ) {
+    std::vector<std::vector<uint8_t>> buffers;
+
+    srand(17);
+    for (size_t i = 0; i < 19; i++) {
+        std::vector<uint8_t> buffer(i * 97 % 700);
+
+        for (uint8_t &byte : buffer)
+            byte = (uint8_t)rand();
+        buffers.push_back(buffer);
+    }
+
+    // counts around lane count boundaries
+    for (size_t count = 0; count <= buffers.size(); count++) {
+        std::vector<const void *> data;
+        std::vector<size_t> sizes;
+        std::vector<CfHash> hashes(count);
+
+        for (size_t i = 0; i < count; i++) {
+            data.push_back(buffers[i].data());
+            sizes.push_back(buffers[i].size());
+        }
+
+        cfHashMany(data.data(), sizes.data(), count, hashes.data());
+
+        for (size_t i = 0; i < count; i++) {
+            const CfHash expected = cfHash(buffers[i].data(), buffers[i].size());
+
+            if (!cfHashCompare(&hashes[i], &expected)) {
+                printf("hash %zu of %zu hashed at once mismatch\n", i, count);
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+} // testMany
+
+#ifdef CF_HASH_X86
+/**
+ * @brief AVX2 multi-buffer step testing function (it's called directly, because
+ * cfHashMany doesn't use it on CPUs with SHA extensions)
+ *
+ * @return 0 if succeeded, 1 if failed
+ */
+static int testAvx2Lanes( void ) {
+    const size_t maxBlockCount = 12;
+
+    if (!cfHashX86HasAvx2()) {
+        printf("AVX2 isn't supported, multi-buffer step isn't tested\n");
+        return 0;
+    }
+
+    std::vector<uint8_t> data[CF_HASH_LANE_COUNT];
+    const uint8_t *blocks[CF_HASH_LANE_COUNT];
+
+    srand(23);
+    for (size_t lane = 0; lane < CF_HASH_LANE_COUNT; lane++) {
+        data[lane].resize(maxBlockCount * CF_HASH_BLOCK_SIZE);
+        for (uint8_t &byte : data[lane])
+            byte = (uint8_t)rand();
+        blocks[lane] = data[lane].data();
+    }
+
+    for (size_t blockCount = 0; blockCount <= maxBlockCount; blockCount++) {
+        CfHash hashes[CF_HASH_LANE_COUNT];
+
+        // lanes start from different states (hashes of lane-specific prefixes)
+        for (size_t lane = 0; lane < CF_HASH_LANE_COUNT; lane++) {
+            CfHasher hasher;
+
+            cfHasherInitialize(&hasher);
+            cfHasherStep(&hasher, data[lane].data(), lane * CF_HASH_BLOCK_SIZE);
+            hashes[lane] = hasher.hash;
+        }
+
+        cfHashX86StepAvx2(hashes, blocks, blockCount);
+
+        // whole blocks are hashed by scalar (or SHA-NI) step function, so hasher state after them is reference
+        for (size_t lane = 0; lane < CF_HASH_LANE_COUNT; lane++) {
+            CfHasher hasher;
+
+            cfHasherInitialize(&hasher);
+            cfHasherStep(&hasher, data[lane].data(), lane * CF_HASH_BLOCK_SIZE);
+            cfHasherStep(&hasher, blocks[lane], blockCount * CF_HASH_BLOCK_SIZE);
+
+            if (!cfHashCompare(&hashes[lane], &hasher.hash)) {
+                printf("AVX2 lane %zu state after %zu blocks mismatch\n", lane, blockCount);
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+} // testAvx2Lanes
+#endif
+
+int main( void ) {
+    int result = 0;
+
+    result |= testKnownAnswers();
+    result |= testSteps();
+    result |= testMany();
+#ifdef CF_HASH_X86
+    result |= testAvx2Lanes();
+#endif
+
+    if (result == 0)
+        printf("hash tests passed\n");
+
+    return result;
+} // main
+
+// main.cpp
@@ -0,0 +1,385 @@
+/**
+ * @brief LZ compression and compressed container test file
+ */
+
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+#include <cf_lz.h>
+#include <cf_executable.h>
+#include <cf_object.h>
+
+/**
+ * @brief test data generation function
+ *
+ * @param[in] seed random seed
+ * @param[in] size data size
+ * @param[in] kind data kind (0 - zeroes, 1 - random, 2 - repeated random words, 3 - mixed)
+ *
+ * @return data
+ */
+static std::vector<uint8_t> generateData( uint32_t seed, size_t size, int kind ) {
+    std::vector<uint8_t> data(size);
+
+    srand(seed);
+
+    for (size_t i = 0; i < size; i++) {
+        switch (kind) {
+        case 0: data[i] = 0; break;
+        case 1: data[i] = (uint8_t)rand(); break;
+        case 2: data[i] = i >= 64 && rand() % 8 != 0 ? data[i - 64 + rand() % 4 * 16] : (uint8_t)rand(); break;
+        case 3: data[i] = (i / 4096) % 2 == 0 ? (uint8_t)rand() : (uint8_t)(i % 7); break;
+        }
+    }
+
+    return data;
+} // generateData
+
+/**
+ * @brief data compression function
+ *
+ * @param[in] data data to compress
+ *
+ * @return compressed data
+ */
+static std::vector<uint8_t> compress( const std::vector<uint8_t> &data ) {
+    std::vector<uint8_t> compressed(cfLzCompressBound(data.size()));
+
+    compressed.resize(cfLzCompress(data.data(), data.size(), compressed.data()));
+    return compressed;
+} // compress
+
+/**
+ * @brief compression round trip testing function
+ *
+ * @param[in] data data to compress
+ *
+ * @return 0 if succeeded, 1 if failed
+ */
+static int testRoundTrip( const std::vector<uint8_t> &data ) {
+    const std::vector<uint8_t> compressed = compress(data);
+    std::vector<uint8_t> decompressed(data.size() + 1);
+
+    if (compressed.size() > cfLzCompressBound(data.size())) {
+        printf("compressed size of %zu bytes exceeds bound\n", data.size());
+        return 1;
+    }
+
+    if (false
+        || !cfLzDecompress(compressed.data(), compressed.size(), decompressed.data(), data.size())
+        || 0 != memcmp(decompressed.data(), data.data(), data.size())
+    ) {
+        printf("round trip of %zu bytes failed\n", data.size());
+        return 1;
+    }
+
+    // decompressed size is part of format, so other sizes are rejected
+    if (cfLzDecompress(compressed.data(), compressed.size(), decompressed.data(), data.size() + 1)) {
+        printf("round trip of %zu bytes succeeded with larger destination\n", data.size());
+        return 1;
+    }
+    if (data.size() != 0 && cfLzDecompress(compressed.data(), compressed.size(), decompressed.data(), data.size() - 1)) {
+        printf("round trip of %zu bytes succeeded with smaller destination\n", data.size());
+        return 1;
+    }
+
+    // file is decompressed block by block, so it's checked separately
+    FILE *file = tmpfile();
+    if (file == NULL) {
+        printf("temporary file opening failed\n");
+        return 1;
+    }
+
+    fwrite(compressed.data(), 1, compressed.size(), file);
+    rewind(file);
+    memset(decompressed.data(), 0, decompressed.size());
+
+    const bool isFileOk = true
+        && cfLzDecompressFile(file, decompressed.data(), data.size())
+        && 0 == memcmp(decompressed.data(), data.data(), data.size())
+    ;
+    fclose(file);
+
+    if (!isFileOk) {
+        printf("file round trip of %zu bytes failed\n", data.size());
+        return 1;
+    }
+
+    return 0;
+} // testRoundTrip
+
+/**
+ * @brief truncated compressed data rejection testing function
+ *
+ * @param[in] data data to compress
+ *
+ * @return 0 if succeeded, 1 if failed
+ */
+static int testTruncated( const std::vector<uint8_t> &data ) {
+    const std::vector<uint8_t> compressed = compress(data);
+    std::vector<uint8_t> decompressed(data.size());
+
+    for (size_t size = 0; size < compressed.size(); size++) {
+        // truncated data is copied, so out-of-bounds reads are detected by sanitizers
+        const std::vector<uint8_t> truncated(compressed.begin(), compressed.begin() + size);
+
+        if (cfLzDecompress(truncated.data(), truncated.size(), decompressed.data(), data.size())) {
+            printf("data of %zu bytes truncated to %zu bytes is accepted\n", data.size(), size);
+            return 1;
+        }
+    }
+
+    FILE *file = tmpfile();
+    if (file == NULL) {
+        printf("temporary file opening failed\n");
+        return 1;
+    }
+
+    fwrite(compressed.data(), 1, compressed.size() - 1, file);
+    rewind(file);
+
+    const bool isAccepted = cfLzDecompressFile(file, decompressed.data(), data.size());
+    fclose(file);
+
+    if (isAccepted) {
+        printf("truncated file of %zu bytes is accepted\n", data.size());
+        return 1;
+    }
+
+    return 0;
+} // testTruncated
+
+/**
+ * @brief hand-written block decompression function
+ *
+ * @param[in] contents         compressed block contents (header is added)
+ * @param[in] decompressedSize decompressed block size
+ * @param[in] expected         expected decompressed block (null if block should be rejected)
+ *
+ * @return 0 if succeeded, 1 if failed
+ */
+static int testBlock(
+    const std::vector<uint8_t> &contents,
+    const size_t                decompressedSize,
+    const char                 *expected
+) {
+    std::vector<uint8_t> block = {
+        (uint8_t)(contents.size() >>  0),
+        (uint8_t)(contents.size() >>  8),
+        (uint8_t)(contents.size() >> 16),
+        (uint8_t)(contents.size() >> 24),
+    };
+    std::vector<uint8_t> decompressed(decompressedSize);
+
+    block.insert(block.end(), contents.begin(), contents.end());
+
+    const bool isAccepted = cfLzDecompress(block.data(), block.size(), decompressed.data(), decompressedSize);
+
+    if (expected == NULL ? isAccepted : !isAccepted || 0 != memcmp(decompressed.data(), expected, decompressedSize)) {
+        printf("hand-written block of %zu bytes is %s\n", decompressedSize, isAccepted ? "accepted" : "rejected");
+        return 1;
+    }
+
+    return 0;
+} // testBlock
+
+/**
+ * @brief corrupt back-reference rejection testing function
+ *
+ * @return 0 if succeeded, 1 if failed
+ */
+static int testBackReferences( void ) {
+    int result = 0;
+
+    // 'ab' literals and 6-byte match at distance 2, then 'c' literal
+    result |= testBlock({0x22, 'a', 'b', 0x02, 0x00, 0x10, 'c'}, 9, "ababababc");
+
+    // distance is out of decompressed data
+    result |= testBlock({0x22, 'a', 'b', 0x03, 0x00, 0x10, 'c'}, 9, NULL);
+
+    // zero distance
+    result |= testBlock({0x22, 'a', 'b', 0x00, 0x00, 0x10, 'c'}, 9, NULL);
+
+    // match is out of decompressed block
+    result |= testBlock({0x2F, 'a', 'b', 0x01, 0x00, 0x00, 0x10, 'c'}, 9, NULL);
+
+    // match distance is truncated
+    result |= testBlock({0x22, 'a', 'b', 0x02}, 9, NULL);
+
+    // bit-flipped data is rejected or decompressed without out-of-bounds accesses
+    const std::vector<uint8_t> data = generateData(7, 20000, 2);
+    const std::vector<uint8_t> compressed = compress(data);
+    std::vector<uint8_t> decompressed(data.size());
+
+    for (size_t i = 0; i < compressed.size(); i++) {
+        std::vector<uint8_t> corrupt = compressed;
+
+        corrupt[i] ^= 1 << (i % 8);
+        cfLzDecompress(corrupt.data(), corrupt.size(), decompressed.data(), decompressed.size());
+    }
+
+    return result;
+} // testBackReferences
+
+/**
+ * @brief compressed executable round trip testing function
+ *
+ * @return 0 if succeeded, 1 if failed
+ */
+static int testExecutable( void ) {
+    const std::vector<uint8_t> code = generateData(11, 10000, 2);
+    const std::vector<uint8_t> segmentData = generateData(13, 3000, 3);
+    CfSegment segments[2] = {
+        { CF_SEGMENT_KIND_DATA, 0x1000, (uint32_t)segmentData.size(), segmentData.data() },
+        { CF_SEGMENT_KIND_ZERO, 0x8000, 0x1000,                       NULL               },
+    };
+    const CfExecutable executable = {
+        .code         = (void *)code.data(),
+        .codeLength   = code.size(),
+        .entryPoint   = 0,
+        .segments     = segments,
+        .segmentCount = 2,
+    };
+
+    FILE *file = tmpfile();
+    if (file == NULL || !cfExecutableWriteCompressed(file, &executable)) {
+        printf("compressed executable writing failed\n");
+        return 1;
+    }
+
+    const long size = ftell(file);
+    rewind(file);
+
+    CfExecutable read;
+    CfExecutableReadStatus status = cfExecutableRead(file, &read);
+
+    if (status != CF_EXECUTABLE_READ_STATUS_OK) {
+        printf("compressed executable reading failed: %s\n", cfExecutableReadStatusStr(status));
+        fclose(file);
+        return 1;
+    }
+
+    const bool isSame = true
+        && read.codeLength == code.size()
+        && 0 == memcmp(read.code, code.data(), code.size())
+        && read.segmentCount == 2
+        && read.segments[0].size == segmentData.size()
+        && 0 == memcmp(read.segments[0].data, segmentData.data(), segmentData.size())
+        && read.segments[1].kind == CF_SEGMENT_KIND_ZERO
+        && read.segments[1].size == 0x1000
+    ;
+    cfExecutableDtor(&read);
+
+    if (!isSame) {
+        printf("compressed executable round trip failed\n");
+        fclose(file);
+        return 1;
+    }
+
+    // truncated compressed executable is rejected
+    std::vector<uint8_t> image(size);
+    rewind(file);
+    fread(image.data(), 1, image.size(), file);
+    fclose(file);
+
+    file = tmpfile();
+    if (file == NULL) {
+        printf("temporary file opening failed\n");
+        return 1;
+    }
+    fwrite(image.data(), 1, image.size() - 16, file);
+    rewind(file);
+
+    status = cfExecutableRead(file, &read);
+    fclose(file);
+
+    if (status == CF_EXECUTABLE_READ_STATUS_OK) {
+        cfExecutableDtor(&read);
+        printf("truncated compressed executable is accepted\n");
+        return 1;
+    }
+
+    return 0;
+} // testExecutable
+
+/**
+ * @brief compressed object round trip testing function
+ *
+ * @return 0 if succeeded, 1 if failed
+ */
+static int testObject( void ) {
+    std::vector<uint8_t> code = generateData(17, 5000, 2);
+    CfLink link = { .sourceLine = 1, .codeOffset = 16, .label = "function" };
+    CfLabel label = { .sourceLine = 2, .value = 32, .isRelative = true, .label = "function" };
+    CfObject object = {
+        .sourceName = "test.cfasm",
+        .codeLength = code.size(),
+        .code       = code.data(),
+        .linkCount  = 1,
+        .links      = &link,
+        .labelCount = 1,
+        .labels     = &label,
+    };
+
+    FILE *file = tmpfile();
+    if (file == NULL || !cfObjectWriteCompressed(file, &object)) {
+        printf("compressed object writing failed\n");
+        return 1;
+    }
+    rewind(file);
+
+    CfObject read = {};
+    const CfObjectReadStatus status = cfObjectRead(file, &read);
+    fclose(file);
+
+    if (status != CF_OBJECT_READ_STATUS_OK) {
+        printf("compressed object reading failed: %s\n", cfObjectReadStatusStr(status));
+        return 1;
+    }
+
+    const bool isSame = true
+        && 0 == strcmp(read.sourceName, object.sourceName)
+        && read.codeLength == code.size()
+        && 0 == memcmp(read.code, code.data(), code.size())
+        && read.linkCount == 1
+        && 0 == memcmp(read.links, &link, sizeof(link))
+        && read.labelCount == 1
+        && 0 == memcmp(read.labels, &label, sizeof(label))
+    ;
+    cfObjectDtor(&read);
+
+    if (!isSame) {
+        printf("compressed object round trip failed\n");
+        return 1;
+    }
+
+    return 0;
+} // testObject
+
+int main( void ) {
+    int result = 0;
+
+    const size_t sizes[] = { 0, 1, 4, 15, 100, 4096, CF_LZ_BLOCK_SIZE - 1, CF_LZ_BLOCK_SIZE, 3 * CF_LZ_BLOCK_SIZE + 123 };
+
+    for (int kind = 0; kind < 4; kind++)
+        for (size_t size : sizes)
+            result |= testRoundTrip(generateData(kind * 1000 + (uint32_t)size, size, kind));
+
+    for (int kind = 0; kind < 4; kind++)
+        result |= testTruncated(generateData(kind, 3000, kind));
+
+    result |= testBackReferences();
+    result |= testExecutable();
+    result |= testObject();
+
+    if (result == 0)
+        printf("LZ tests passed\n");
+
+    return result;
+} // main
+
+// main.cpp
@@ -0,0 +1,377 @@
+/**
+ * @brief resumable VM forking test file
+ */
+
+#include <vector>
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+#include <cf_assembler.h>
+#include <cf_linker.h>
+#include <cf_vm.h>
+
+/// @brief test program RAM size
+#define TEST_RAM_SIZE 4096
+
+/**
+ * @brief test program text
+ *
+ * @note the first loop contains call (so it's never traced), the second one is traced and left by guard of
+ * its conditional. Both loops accumulate values in RAM, so forked VMs that share RAM copy must not see writes
+ * of each other.
+ */
+static const char *const testProgramText =
+    "    push 0\n"
+    "    pop ax\n"
+    "    push 0\n"
+    "    pop bx\n"
+    "loop:\n"
+    "    push ax\n"
+    "    call square\n"
+    "    pop cx\n"
+    "    push ax\n"
+    "    push 1\n"
+    "    and\n"
+    "    jz even\n"
+    "    push [0]\n"
+    "    push cx\n"
+    "    add\n"
+    "    pop [0]\n"
+    "    jmp next\n"
+    "even:\n"
+    "    push bx\n"
+    "    push cx\n"
+    "    add\n"
+    "    pop bx\n"
+    "next:\n"
+    "    push bx\n"
+    "    itof\n"
+    "    syscall 1\n"
+    "    push ax+1\n"
+    "    pop ax\n"
+    "    push ax\n"
+    "    push 300\n"
+    "    cmp\n"
+    "    jl loop\n"
+    "    push [0]\n"
+    "    itof\n"
+    "    syscall 1\n"
+    "    push 0\n"
+    "    pop ax\n"
+    "    push 0\n"
+    "    pop dx\n"
+    "loop2:\n"
+    "    push ax\n"
+    "    push 3\n"
+    "    and\n"
+    "    jnz skip\n"
+    "    push [4]\n"
+    "    push ax\n"
+    "    add\n"
+    "    pop [4]\n"
+    "    jmp next2\n"
+    "skip:\n"
+    "    push dx\n"
+    "    push ax\n"
+    "    add\n"
+    "    pop dx\n"
+    "next2:\n"
+    "    push ax+1\n"
+    "    pop ax\n"
+    "    push ax\n"
+    "    push 300\n"
+    "    cmp\n"
+    "    jl loop2\n"
+    "    push [4]\n"
+    "    itof\n"
+    "    syscall 1\n"
+    "    push dx\n"
+    "    itof\n"
+    "    syscall 1\n"
+    "    halt\n"
+    "square:\n"
+    "    push ax\n"
+    "    mul\n"
+    "    ret\n"
+;
+
+/// @brief test sandbox context
+struct TestContext {
+    std::vector<double> output;       ///< written numbers
+    bool                isTerminated; ///< true if termination callback is called
+    CfTermInfo          termInfo;     ///< termination info
+};
+
+static bool testInitialize( void *, const CfExecContext * ) {
+    return true;
+} // testInitialize
+
+static void testTerminate( void *userContext, const CfTermInfo *termInfo ) {
+    TestContext *const context = (TestContext *)userContext;
+
+    context->isTerminated = true;
+    context->termInfo = *termInfo;
+} // testTerminate
+
+static bool testRefreshScreen( void * ) {
+    return true;
+} // testRefreshScreen
+
+static bool testSetVideoMode( void *, CfVideoStorageFormat, CfVideoUpdateMode ) {
+    return true;
+} // testSetVideoMode
+
+static bool testGetExecutionTime( void *, float *dst ) {
+    *dst = 0.0f;
+    return true;
+} // testGetExecutionTime
+
+static double testReadFloat64( void * ) {
+    return 0.0;
+} // testReadFloat64
+
+static void testWriteFloat64( void *userContext, double number ) {
+    ((TestContext *)userContext)->output.push_back(number);
+} // testWriteFloat64
+
+/**
+ * @brief test sandbox building function
+ *
+ * @param[in] context sandbox context
+ *
+ * @return sandbox
+ */
+static CfSandbox makeSandbox( TestContext *context ) {
+    CfSandbox sandbox = {};
+
+    sandbox.userContext = context;
+    sandbox.initialize = testInitialize;
+    sandbox.terminate = testTerminate;
+    sandbox.refreshScreen = testRefreshScreen;
+    sandbox.setVideoMode = testSetVideoMode;
+    sandbox.getExecutionTime = testGetExecutionTime;
+    sandbox.readFloat64 = testReadFloat64;
+    sandbox.writeFloat64 = testWriteFloat64;
+    return sandbox;
+} // makeSandbox
+
+/**
+ * @brief test program building function
+ *
+ * @param[out] dst executable destination
+ *
+ * @return true if succeeded, false otherwise
+ */
+static bool buildProgram( CfExecutable *dst ) {
+    CfObject object = {};
+    const CfStr text = { testProgramText, testProgramText + strlen(testProgramText) };
+    const char *const sourceName = "fork_test.cfasm";
+
+    if (CF_ASSEMBLY_STATUS_OK != cfAssemble(text, CfStr { sourceName, sourceName + strlen(sourceName) }, &object, NULL))
+        return false;
+
+    const bool isLinked = CF_LINK_STATUS_OK == cfLink(&object, 1, dst, NULL);
+
+    cfObjectDtor(&object);
+    return isLinked;
+} // buildProgram
+
+/**
+ * @brief execution result comparison function
+ *
+ * @param[in] name     compared execution name
+ * @param[in] context  context of compared execution
+ * @param[in] expected context of reference execution
+ *
+ * @return 0 if results are same, 1 otherwise
+ */
+static int compareResults( const char *name, const TestContext &context, const TestContext &expected ) {
+    if (!context.isTerminated) {
+        printf("%s: program isn't terminated\n", name);
+        return 1;
+    }
+
+    if (context.termInfo.reason != expected.termInfo.reason || context.termInfo.offset != expected.termInfo.offset) {
+        printf("%s: program is terminated with reason %d at %zu, reason %d at %zu expected\n",
+            name,
+            (int)context.termInfo.reason,
+            context.termInfo.offset,
+            (int)expected.termInfo.reason,
+            expected.termInfo.offset
+        );
+        return 1;
+    }
+
+    if (context.output != expected.output) {
+        printf("%s: output mismatch (%zu numbers written, %zu expected)\n",
+            name,
+            context.output.size(),
+            expected.output.size()
+        );
+        return 1;
+    }
+
+    return 0;
+} // compareResults
+
+/**
+ * @brief single-instruction slice counting function
+ *
+ * @param[in] info execution info (sandbox is replaced)
+ *
+ * @return count of slices program is executed by (-1 if VM can't be created)
+ */
+static int countSlices( const CfExecuteInfo &info ) {
+    TestContext context = {};
+    const CfSandbox sandbox = makeSandbox(&context);
+    CfExecuteInfo countInfo = info;
+
+    countInfo.sandbox = &sandbox;
+
+    CfVm *const vm = cfVmCtor(&countInfo);
+
+    if (vm == NULL)
+        return -1;
+
+    int sliceCount = 0;
+
+    while (cfVmResume(vm, 1, 0) == CF_VM_RESUME_STATUS_YIELDED)
+        sliceCount++;
+
+    cfVmDtor(vm);
+    return sliceCount;
+} // countSlices
+
+/**
+ * @brief single forking test function
+ *
+ * @param[in] info       execution info of parent VM (sandbox is replaced)
+ * @param[in] expected   context of reference execution
+ * @param[in] sliceCount count of single-instruction slices parent VM is resumed for before forking
+ *
+ * @return 0 if succeeded, 1 if failed
+ */
+static int runForkTest( const CfExecuteInfo &info, const TestContext &expected, int sliceCount ) {
+    TestContext parentContext = {};
+    const CfSandbox parentSandbox = makeSandbox(&parentContext);
+    CfExecuteInfo parentInfo = info;
+
+    parentInfo.sandbox = &parentSandbox;
+
+    CfVm *const parent = cfVmCtor(&parentInfo);
+
+    if (parent == NULL) {
+        printf("cannot create VM\n");
+        return 1;
+    }
+
+    for (int i = 0; i < sliceCount; i++)
+        if (cfVmResume(parent, 1, 0) != CF_VM_RESUME_STATUS_YIELDED) {
+            printf("program is terminated before fork\n");
+            cfVmDtor(parent);
+            return 1;
+        }
+
+    // children forked without parent resuming in between share single RAM copy,
+    // and output written before fork is inherited by them
+    TestContext childContexts[2] = { parentContext, parentContext };
+    const CfSandbox childSandboxes[2] = { makeSandbox(&childContexts[0]), makeSandbox(&childContexts[1]) };
+    CfVm *children[2] = {
+        cfVmFork(parent, &childSandboxes[0]),
+        cfVmFork(parent, &childSandboxes[1]),
+    };
+    int result = 0;
+
+    if (children[0] == NULL || children[1] == NULL) {
+        printf("cannot fork VM after %d slices\n", sliceCount);
+        result = 1;
+    }
+
+    // the first child finishes before others are resumed, so its RAM writes would be visible to them if RAM was shared
+    for (int i = 0; result == 0 && i < 2; i++)
+        while (cfVmResume(children[i], 1, 0) == CF_VM_RESUME_STATUS_YIELDED)
+            ;
+
+    while (result == 0 && cfVmResume(parent, 0, 0) == CF_VM_RESUME_STATUS_YIELDED)
+        ;
+
+    if (result == 0) {
+        char name[64];
+
+        snprintf(name, sizeof(name), "parent forked after %d slices", sliceCount);
+        result |= compareResults(name, parentContext, expected);
+
+        for (int i = 0; i < 2; i++) {
+            snprintf(name, sizeof(name), "child %d forked after %d slices", i, sliceCount);
+            result |= compareResults(name, childContexts[i], expected);
+        }
+    }
+
+    cfVmDtor(children[0]);
+    cfVmDtor(children[1]);
+    cfVmDtor(parent);
+    return result;
+} // runForkTest
+
+int main( void ) {
+    CfExecutable executable = {};
+
+    if (!buildProgram(&executable)) {
+        printf("cannot build test program\n");
+        return 1;
+    }
+
+    TestContext expected = {};
+    const CfSandbox sandbox = makeSandbox(&expected);
+    CfExecuteInfo info = {};
+
+    info.executable = &executable;
+    info.sandbox = &sandbox;
+    info.ramSize = TEST_RAM_SIZE;
+
+    int result = 0;
+
+    if (!cfExecute(&info) || !expected.isTerminated || expected.termInfo.reason != CF_TERM_REASON_HALT) {
+        printf("reference execution failed\n");
+        result = 1;
+    }
+
+    CfVmCode *const code = cfVmCodeCtor(&executable);
+
+    if (code == NULL) {
+        printf("cannot decode code\n");
+        result = 1;
+    }
+
+    // parent may have own or shared code, traces are mapped back to code by fork
+    for (int variant = 0; result == 0 && variant < 4; variant++) {
+        CfExecuteInfo parentInfo = info;
+
+        parentInfo.useTraces = (variant & 1) != 0;
+        parentInfo.code = (variant & 2) != 0 ? code : NULL;
+
+        // budget is charged by control transfers, so single-instruction slices suspend parent after each of them
+        // (inside of function, at both branches of conditionals and inside of trace after loop becomes hot)
+        const int sliceCount = countSlices(parentInfo);
+
+        if (sliceCount < 0) {
+            printf("cannot create VM\n");
+            result = 1;
+        }
+
+        for (int forkSliceCount = 0; result == 0 && forkSliceCount < sliceCount; forkSliceCount += 11)
+            result |= runForkTest(parentInfo, expected, forkSliceCount);
+    }
+
+    cfVmCodeDtor(code);
+    cfExecutableDtor(&executable);
+
+    if (result == 0)
+        printf("fork tests passed\n");
+
+    return result;
+} // main
+
+// main.cpp
@@ -0,0 +1,309 @@
+/**
+ * @brief hot loop trace test file
+ */
+
+#include <vector>
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+#include <cf_assembler.h>
+#include <cf_linker.h>
+#include <cf_vm.h>
+
+/// @brief test program RAM size
+#define TEST_RAM_SIZE 1024
+
+/// @brief single test program
+struct TestProgram {
+    const char * name; ///< program name
+    const char * text; ///< program text
+};
+
+/**
+ * @brief test programs
+ *
+ * @note loops are hot long before termination, and their iterations take both branches of conditional,
+ * so trace guards are left in both directions. The second program faults inside of its trace.
+ */
+static const TestProgram testPrograms[] = {
+    {
+        "conditional loop",
+        "    push 0\n"
+        "    pop ax\n"
+        "    push 0\n"
+        "    pop bx\n"
+        "loop:\n"
+        "    push ax\n"
+        "    push 7\n"
+        "    and\n"
+        "    push 3\n"
+        "    cmp\n"
+        "    jl small\n"
+        "    push bx\n"
+        "    push ax\n"
+        "    add\n"
+        "    pop bx\n"
+        "    jmp next\n"
+        "small:\n"
+        "    push bx\n"
+        "    push 1\n"
+        "    sub\n"
+        "    pop bx\n"
+        "    push bx\n"
+        "    itof\n"
+        "    syscall 1\n"
+        "next:\n"
+        "    push ax+1\n"
+        "    pop ax\n"
+        "    push ax\n"
+        "    push 1000\n"
+        "    cmp\n"
+        "    jl loop\n"
+        "    push bx\n"
+        "    itof\n"
+        "    syscall 1\n"
+        "    halt\n"
+    },
+    {
+        "faulting loop",
+        "    push 0\n"
+        "    pop ax\n"
+        "loop:\n"
+        "    push ax\n"
+        "    push 8\n"
+        "    and\n"
+        "    jz skip\n"
+        "    push ax\n"
+        "    pop [ax]\n"
+        "    push ax\n"
+        "    itof\n"
+        "    syscall 1\n"
+        "skip:\n"
+        "    push ax+4\n"
+        "    pop ax\n"
+        "    jmp loop\n"
+    },
+};
+
+/// @brief test sandbox context
+struct TestContext {
+    std::vector<double> output;       ///< written numbers
+    bool                isTerminated; ///< true if termination callback is called
+    CfTermInfo          termInfo;     ///< termination info
+};
+
+static bool testInitialize( void *, const CfExecContext * ) {
+    return true;
+} // testInitialize
+
+static void testTerminate( void *userContext, const CfTermInfo *termInfo ) {
+    TestContext *const context = (TestContext *)userContext;
+
+    context->isTerminated = true;
+    context->termInfo = *termInfo;
+} // testTerminate
+
+static bool testRefreshScreen( void * ) {
+    return true;
+} // testRefreshScreen
+
+static bool testSetVideoMode( void *, CfVideoStorageFormat, CfVideoUpdateMode ) {
+    return true;
+} // testSetVideoMode
+
+static bool testGetExecutionTime( void *, float *dst ) {
+    *dst = 0.0f;
+    return true;
+} // testGetExecutionTime
+
+static double testReadFloat64( void * ) {
+    return 0.0;
+} // testReadFloat64
+
+static void testWriteFloat64( void *userContext, double number ) {
+    ((TestContext *)userContext)->output.push_back(number);
+} // testWriteFloat64
+
+/**
+ * @brief test sandbox building function
+ *
+ * @param[in] context sandbox context
+ *
+ * @return sandbox
+ */
+static CfSandbox makeSandbox( TestContext *context ) {
+    CfSandbox sandbox = {};
+
+    sandbox.userContext = context;
+    sandbox.initialize = testInitialize;
+    sandbox.terminate = testTerminate;
+    sandbox.refreshScreen = testRefreshScreen;
+    sandbox.setVideoMode = testSetVideoMode;
+    sandbox.getExecutionTime = testGetExecutionTime;
+    sandbox.readFloat64 = testReadFloat64;
+    sandbox.writeFloat64 = testWriteFloat64;
+    return sandbox;
+} // makeSandbox
+
+/**
+ * @brief test program building function
+ *
+ * @param[in]  program program to build
+ * @param[out] dst     executable destination
+ *
+ * @return true if succeeded, false otherwise
+ */
+static bool buildProgram( const TestProgram &program, CfExecutable *dst ) {
+    CfObject object = {};
+    const CfStr text = { program.text, program.text + strlen(program.text) };
+    const CfStr sourceName = { program.name, program.name + strlen(program.name) };
+
+    if (CF_ASSEMBLY_STATUS_OK != cfAssemble(text, sourceName, &object, NULL))
+        return false;
+
+    const bool isLinked = CF_LINK_STATUS_OK == cfLink(&object, 1, dst, NULL);
+
+    cfObjectDtor(&object);
+    return isLinked;
+} // buildProgram
+
+/**
+ * @brief execution result comparison function
+ *
+ * @param[in] name     compared execution name
+ * @param[in] context  context of compared execution
+ * @param[in] expected context of reference execution
+ *
+ * @return 0 if results are same, 1 otherwise
+ */
+static int compareResults( const char *name, const TestContext &context, const TestContext &expected ) {
+    if (!context.isTerminated) {
+        printf("%s: program isn't terminated\n", name);
+        return 1;
+    }
+
+    if (context.termInfo.reason != expected.termInfo.reason || context.termInfo.offset != expected.termInfo.offset) {
+        printf("%s: program is terminated with reason %d at %zu, reason %d at %zu expected\n",
+            name,
+            (int)context.termInfo.reason,
+            context.termInfo.offset,
+            (int)expected.termInfo.reason,
+            expected.termInfo.offset
+        );
+        return 1;
+    }
+
+    if (context.output != expected.output) {
+        printf("%s: output mismatch (%zu numbers written, %zu expected)\n",
+            name,
+            context.output.size(),
+            expected.output.size()
+        );
+        return 1;
+    }
+
+    return 0;
+} // compareResults
+
+/**
+ * @brief single program testing function
+ *
+ * @param[in] program program to test
+ *
+ * @return 0 if succeeded, 1 if failed
+ */
+static int runTest( const TestProgram &program ) {
+    CfExecutable executable = {};
+
+    if (!buildProgram(program, &executable)) {
+        printf("%s: cannot build program\n", program.name);
+        return 1;
+    }
+
+    CfExecuteInfo info = {};
+    TestContext expected = {};
+    const CfSandbox expectedSandbox = makeSandbox(&expected);
+
+    info.executable = &executable;
+    info.sandbox = &expectedSandbox;
+    info.ramSize = TEST_RAM_SIZE;
+
+    int result = 0;
+    char name[128];
+
+    // plain interpreter run is reference
+    if (!cfExecute(&info) || !expected.isTerminated) {
+        printf("%s: reference execution failed\n", program.name);
+        result = 1;
+    }
+
+    if (result == 0) {
+        TestContext context = {};
+        const CfSandbox sandbox = makeSandbox(&context);
+        CfExecuteInfo traceInfo = info;
+
+        traceInfo.sandbox = &sandbox;
+        traceInfo.useTraces = true;
+
+        snprintf(name, sizeof(name), "%s, traced", program.name);
+        if (!cfExecute(&traceInfo)) {
+            printf("%s: execution failed\n", name);
+            result = 1;
+        } else {
+            result |= compareResults(name, context, expected);
+        }
+    }
+
+    // slices are charged at control transfers, so short ones suspend execution inside of trace too
+    for (uint64_t sliceBudget : { 1, 2, 5, 64 })
+        for (bool useTraces : { false, true }) {
+            if (result != 0)
+                break;
+
+            TestContext context = {};
+            const CfSandbox sandbox = makeSandbox(&context);
+            CfExecuteInfo resumeInfo = info;
+
+            resumeInfo.sandbox = &sandbox;
+            resumeInfo.useTraces = useTraces;
+
+            snprintf(name, sizeof(name), "%s, %s, resumed by slices of %u instructions",
+                program.name,
+                useTraces ? "traced" : "not traced",
+                (unsigned)sliceBudget
+            );
+
+            CfVm *const vm = cfVmCtor(&resumeInfo);
+
+            if (vm == NULL) {
+                printf("%s: cannot create VM\n", name);
+                result = 1;
+                break;
+            }
+
+            while (cfVmResume(vm, sliceBudget, 0) == CF_VM_RESUME_STATUS_YIELDED)
+                ;
+            cfVmDtor(vm);
+
+            result |= compareResults(name, context, expected);
+        }
+
+    cfExecutableDtor(&executable);
+    return result;
+} // runTest
+
+int main( void ) {
+    int result = 0;
+
+    for (const TestProgram &program : testPrograms)
+        result |= runTest(program);
+
+    if (result == 0)
+        printf("trace tests passed\n");
+
+    return result;
+} // main
+
+// main.cpp
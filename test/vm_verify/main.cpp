@@ -0,0 +1,235 @@
+/**
+ * @brief VM code verifier test file
+ */
+
+#include <vector>
+#include <utility>
+
+#include <cstdint>
+#include <cstdio>
+
+#include "cf_vm_internal.h"
+
+/**
+ * @brief pre-decoded instruction building function
+ *
+ * @param[in] opcode    instruction opcode
+ * @param[in] immediate instruction immediate (jump/call target for control flow instructions)
+ *
+ * @return instruction
+ */
+static CfVmInstruction makeInstruction( const uint8_t opcode, const uint32_t immediate = 0 ) {
+    CfVmInstruction instruction = {};
+
+    instruction.opcode = opcode;
+    instruction.immediate = immediate;
+    return instruction;
+} // makeInstruction
+
+/// @brief single verifier test case
+struct VerifyTest {
+    const char                   * name;       ///< test name
+    std::vector<CfVmInstruction>   code;       ///< code to verify (CODE_END trap is appended)
+    bool                           isValid;    ///< expected verification result
+    std::vector<std::pair<uint32_t, int32_t>> maxStackDepths; ///< expected (instruction index, maxStackDepth) pairs (valid code only)
+};
+
+/**
+ * @brief single test case running function
+ *
+ * @param[in] test test to run
+ *
+ * @return 0 if succeeded, 1 if failed
+ */
+static int runTest( const VerifyTest &test ) {
+    std::vector<CfVmInstruction> code = test.code;
+    code.push_back(makeInstruction(CF_VM_OPCODE_CODE_END));
+
+    const bool isValid = cfVmVerify(code.data(), code.size(), 0);
+
+    if (isValid != test.isValid) {
+        printf("%s: code is %s by verifier\n", test.name, isValid ? "accepted" : "rejected");
+        return 1;
+    }
+
+    for (const auto &[index, maxStackDepth] : test.maxStackDepths)
+        if (code[index].maxStackDepth != maxStackDepth) {
+            printf("%s: instruction %u max stack depth is %d, %d expected\n",
+                test.name,
+                index,
+                code[index].maxStackDepth,
+                maxStackDepth
+            );
+            return 1;
+        }
+
+    return 0;
+} // runTest
+
+int main( void ) {
+    const std::vector<VerifyTest> tests = {
+        {
+            "straight line",
+            {
+                makeInstruction(CF_VM_OPCODE_PUSH_VALUE),
+                makeInstruction(CF_VM_OPCODE_PUSH_VALUE),
+                makeInstruction(CF_OPCODE_ADD),
+                makeInstruction(CF_VM_OPCODE_POP_DISCARD),
+                makeInstruction(CF_OPCODE_HALT),
+            },
+            true,
+            {{0, 2}},
+        },
+        {
+            "operand underflow",
+            {
+                makeInstruction(CF_VM_OPCODE_PUSH_VALUE),
+                makeInstruction(CF_OPCODE_ADD),
+                makeInstruction(CF_OPCODE_HALT),
+            },
+            false,
+            {},
+        },
+        {
+            "balanced branches",
+            {
+                makeInstruction(CF_VM_OPCODE_PUSH_VALUE),
+                makeInstruction(CF_OPCODE_JZ, 4),
+                makeInstruction(CF_VM_OPCODE_PUSH_VALUE),
+                makeInstruction(CF_VM_OPCODE_POP_DISCARD),
+                makeInstruction(CF_OPCODE_HALT),
+            },
+            true,
+            {{0, 1}, {2, 1}, {4, 0}},
+        },
+        {
+            "forward jump into fallthrough block",
+            {
+                // jump target follows non-branch instruction, but it still starts block of nonzero depth
+                makeInstruction(CF_VM_OPCODE_PUSH_VALUE),
+                makeInstruction(CF_VM_OPCODE_PUSH_VALUE),
+                makeInstruction(CF_OPCODE_JZ, 5),
+                makeInstruction(CF_VM_OPCODE_PUSH_VALUE),
+                makeInstruction(CF_VM_OPCODE_POP_DISCARD),
+                makeInstruction(CF_VM_OPCODE_PUSH_VALUE),
+                makeInstruction(CF_OPCODE_HALT),
+            },
+            true,
+            {{0, 2}, {3, 2}, {5, 2}},
+        },
+        {
+            "join depth mismatch",
+            {
+                makeInstruction(CF_VM_OPCODE_PUSH_VALUE),
+                makeInstruction(CF_OPCODE_JZ, 3),
+                makeInstruction(CF_VM_OPCODE_PUSH_VALUE),
+                makeInstruction(CF_OPCODE_HALT),
+            },
+            false,
+            {},
+        },
+        {
+            "loop depth growth",
+            {
+                makeInstruction(CF_VM_OPCODE_PUSH_VALUE),
+                makeInstruction(CF_OPCODE_JMP, 0),
+            },
+            false,
+            {},
+        },
+        {
+            "out of range jump",
+            {
+                makeInstruction(CF_OPCODE_JMP, 100),
+            },
+            false,
+            {},
+        },
+        {
+            "jump to code end",
+            {
+                makeInstruction(CF_OPCODE_JMP, 1),
+            },
+            false,
+            {},
+        },
+        {
+            "out of range call",
+            {
+                makeInstruction(CF_OPCODE_CALL, 100),
+                makeInstruction(CF_OPCODE_HALT),
+            },
+            false,
+            {},
+        },
+        {
+            "call",
+            {
+                // top-level code: depth of callee operands isn't included into its maximal depth
+                makeInstruction(CF_VM_OPCODE_PUSH_VALUE),
+                makeInstruction(CF_OPCODE_CALL, 3),
+                makeInstruction(CF_OPCODE_HALT),
+
+                // callee: consumes single caller operand and returns single result
+                makeInstruction(CF_VM_OPCODE_PUSH_VALUE),
+                makeInstruction(CF_VM_OPCODE_PUSH_VALUE),
+                makeInstruction(CF_OPCODE_ADD),
+                makeInstruction(CF_OPCODE_ADD),
+                makeInstruction(CF_OPCODE_RET),
+            },
+            true,
+            {{0, 1}, {3, 2}},
+        },
+        {
+            "call deeper than caller stack",
+            {
+                // callee consumes operand top-level code doesn't have
+                makeInstruction(CF_OPCODE_CALL, 2),
+                makeInstruction(CF_OPCODE_HALT),
+
+                makeInstruction(CF_VM_OPCODE_PUSH_VALUE),
+                makeInstruction(CF_VM_OPCODE_PUSH_VALUE),
+                makeInstruction(CF_OPCODE_ADD),
+                makeInstruction(CF_OPCODE_ADD),
+                makeInstruction(CF_OPCODE_RET),
+            },
+            false,
+            {},
+        },
+        {
+            "return depth mismatch",
+            {
+                makeInstruction(CF_OPCODE_CALL, 2),
+                makeInstruction(CF_OPCODE_HALT),
+
+                makeInstruction(CF_VM_OPCODE_PUSH_VALUE),
+                makeInstruction(CF_OPCODE_JZ, 5),
+                makeInstruction(CF_OPCODE_RET),
+                makeInstruction(CF_VM_OPCODE_PUSH_VALUE),
+                makeInstruction(CF_OPCODE_RET),
+            },
+            false,
+            {},
+        },
+        {
+            "top-level return",
+            {
+                makeInstruction(CF_OPCODE_RET),
+            },
+            false,
+            {},
+        },
+    };
+
+    int result = 0;
+
+    for (const VerifyTest &test : tests)
+        result |= runTest(test);
+
+    if (result == 0)
+        printf("%zu verifier tests passed\n", tests.size());
+
+    return result;
+} // main
+
+// main.cpp